@@ -0,0 +1,191 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+
+    Test for the job file parser of batchchartrenderer.cpp
+*/
+
+#include "testbatchchartrenderer.h"
+#include "auxiliary/batchchartrenderer.h"
+#include "projections/projector.h"
+
+#include <QtGlobal>
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+#include <QtTest/QTest>
+#else
+#include <QTest>
+#endif
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTimeZone>
+
+#include <cmath>
+
+using Job = BatchChartRenderer::Job;
+
+namespace
+{
+// Write the content to a job file of the given name and read it back
+bool readJobs(const QString &fileName, const QByteArray &content, QVector<Job> &jobs, QString &error)
+{
+    QTemporaryDir dir;
+    if (!dir.isValid())
+        return false;
+    QFile file(dir.filePath(fileName));
+    if (!file.open(QIODevice::WriteOnly) || file.write(content) != content.size())
+        return false;
+    file.close();
+    return BatchChartRenderer::readJobs(file.fileName(), jobs, error);
+}
+
+KStarsDateTime utc(int hour)
+{
+    return KStarsDateTime(QDateTime(QDate(2026, 1, 15), QTime(hour, 0), QTimeZone::utc()));
+}
+}
+
+TestBatchChartRenderer::TestBatchChartRenderer(QObject * parent): QObject(parent)
+{
+}
+
+void TestBatchChartRenderer::testJson()
+{
+    const QByteArray content = R"({ "jobs": [
+        { "ra": 83.82, "dec": "-05:23:28", "fov": 2.5, "time": "2026-01-15T20:00:00",
+          "projection": "Gnomonic", "width": 1024, "height": 768, "output": "m42.png" },
+        { "RA": "05:35:17", "Dec": -5.39, "FOV": "10", "time": "2026-01-15T21:00:00+01:00",
+          "projection": 1, "width": 640, "height": "480", "output": "orion.jpg" }
+    ] })";
+
+    QVector<Job> jobs;
+    QString error;
+    QVERIFY2(readJobs("jobs.json", content, jobs, error), qPrintable(error));
+    QCOMPARE(jobs.size(), 2);
+
+    QCOMPARE(jobs[0].ra.Degrees(), 83.82);
+    QVERIFY(std::abs(jobs[0].dec.Degrees() - (-(5 + 23 / 60.0 + 28 / 3600.0))) < 1e-6);
+    QCOMPARE(jobs[0].fov, 2.5);
+    // Without an offset the time is UTC
+    QCOMPARE(jobs[0].time.toUTC(), utc(20));
+    QCOMPARE(jobs[0].projection, static_cast<int>(Projector::Gnomonic));
+    QCOMPARE(jobs[0].width, 1024);
+    QCOMPARE(jobs[0].height, 768);
+    QCOMPARE(jobs[0].output, QString("m42.png"));
+
+    // Keys in any case, sexagesimal RA in hours, numbers given as strings
+    QVERIFY(std::abs(jobs[1].ra.Degrees() - 15 * (5 + 35 / 60.0 + 17 / 3600.0)) < 1e-6);
+    QCOMPARE(jobs[1].dec.Degrees(), -5.39);
+    QCOMPARE(jobs[1].fov, 10.0);
+    QCOMPARE(jobs[1].time.toUTC(), utc(20));
+    QCOMPARE(jobs[1].projection, static_cast<int>(Projector::AzimuthalEquidistant));
+    QCOMPARE(jobs[1].height, 480);
+
+    // A plain array of jobs
+    jobs.clear();
+    QVERIFY2(readJobs("jobs.json", R"([{ "ra": 10, "dec": 20, "fov": 1, "width": 8, "height": 8, "output": "a.png" }])",
+                      jobs, error), qPrintable(error));
+    QCOMPARE(jobs.size(), 1);
+    QVERIFY(!jobs[0].time.isValid());
+    QCOMPARE(jobs[0].projection, -1);
+}
+
+void TestBatchChartRenderer::testCsv()
+{
+    const QByteArray content =
+        "RA, Dec, FOV, Time, Projection, Width, Height, Output\n"
+        "# Comments and blank lines are skipped\n"
+        "\n"
+        "83.82, -5.39, 2.5, 2026-01-15T20:00:00Z, Stereographic, 1024, 768, \"m42.png\"\n"
+        "\"05:35:17\", \"-05:23:28\", 30, , , 640, 480, orion.png\n";
+
+    QVector<Job> jobs;
+    QString error;
+    QVERIFY2(readJobs("jobs.csv", content, jobs, error), qPrintable(error));
+    QCOMPARE(jobs.size(), 2);
+
+    QCOMPARE(jobs[0].ra.Degrees(), 83.82);
+    QCOMPARE(jobs[0].dec.Degrees(), -5.39);
+    QCOMPARE(jobs[0].fov, 2.5);
+    QCOMPARE(jobs[0].time.toUTC(), utc(20));
+    QCOMPARE(jobs[0].projection, static_cast<int>(Projector::Stereographic));
+    QCOMPARE(jobs[0].width, 1024);
+    QCOMPARE(jobs[0].height, 768);
+    QCOMPARE(jobs[0].output, QString("m42.png"));
+
+    // Empty time and projection are the current ones
+    QVERIFY(std::abs(jobs[1].ra.Degrees() - 15 * (5 + 35 / 60.0 + 17 / 3600.0)) < 1e-6);
+    QVERIFY(std::abs(jobs[1].dec.Degrees() - (-(5 + 23 / 60.0 + 28 / 3600.0))) < 1e-6);
+    QVERIFY(!jobs[1].time.isValid());
+    QCOMPARE(jobs[1].projection, -1);
+    QCOMPARE(jobs[1].output, QString("orion.png"));
+}
+
+void TestBatchChartRenderer::testMalformed_data()
+{
+    QTest::addColumn<QString>("fileName");
+    QTest::addColumn<QByteArray>("content");
+    QTest::addColumn<QString>("expectedError");
+
+    const QByteArray header = "ra,dec,fov,time,projection,width,height,output\n";
+    const QByteArray valid = "10,20,1,,,640,480,a.png\n";
+
+    QTest::newRow("csv missing field") << "jobs.csv" << QByteArray(header + valid + "10,20,1,,,640,480\n")
+                                       << "Line 3: 7 fields for 8 columns";
+    QTest::newRow("csv extra field") << "jobs.csv" << QByteArray(header + "10,20,1,,,640,480,a.png,b.png\n")
+                                     << "Line 2: 9 fields for 8 columns";
+    QTest::newRow("csv unknown column") << "jobs.csv" << QByteArray("ra,dec,zoom,width,height,output\n10,20,1,640,480,a.png\n")
+                                        << "Line 2: Unknown field zoom";
+    QTest::newRow("csv invalid number") << "jobs.csv" << QByteArray(header + "10,20,wide,,,640,480,a.png\n")
+                                        << "Line 2: Invalid fov: wide";
+    QTest::newRow("csv invalid dec") << "jobs.csv" << QByteArray(header + "10,xyz,1,,,640,480,a.png\n")
+                                     << "Line 2: Invalid dec: xyz";
+    QTest::newRow("csv invalid time") << "jobs.csv" << QByteArray(header + "10,20,1,yesterday,,640,480,a.png\n")
+                                      << "Line 2: Invalid time: yesterday";
+    QTest::newRow("csv unknown projection") << "jobs.csv" << QByteArray(header + "10,20,1,,Mercator,640,480,a.png\n")
+                                            << "Line 2: Invalid projection: Mercator";
+    QTest::newRow("csv projection out of range") << "jobs.csv" << QByteArray(header + "10,20,1,,6,640,480,a.png\n")
+            << "Line 2: Invalid projection: 6";
+    QTest::newRow("csv no output") << "jobs.csv" << QByteArray(header + valid + "10,20,1,,,640,480,\n")
+                                   << "Line 3: No output file";
+    QTest::newRow("csv no field of view") << "jobs.csv" << QByteArray(header + "10,20,0,,,640,480,a.png\n")
+                                          << "Line 2: No field of view";
+    QTest::newRow("csv no size") << "jobs.csv" << QByteArray(header + "10,20,1,,,640,-1,a.png\n")
+                                 << "Line 2: No image size";
+    QTest::newRow("json syntax") << "jobs.json" << QByteArray(R"([{ "ra": 10, )") << "";
+    QTest::newRow("json no size") << "jobs.json"
+                                  << QByteArray(R"({ "jobs": [{ "ra": 10, "dec": 20, "fov": 1, "output": "a.png" }] })")
+                                  << "Job 1: No image size";
+    QTest::newRow("json unknown field") << "jobs.json"
+                                        << QByteArray(R"([{ "ra": 10, "dec": 20, "fov": 1, "width": 8, "height": 8, "output": "a.png" },
+                                                         { "ra": 10, "color": "red" }])")
+                                        << "Job 2: Unknown field color";
+    QTest::newRow("unknown extension") << "jobs.txt" << QByteArray(header + valid) << "JSON or CSV";
+}
+
+void TestBatchChartRenderer::testMalformed()
+{
+    QFETCH(QString, fileName);
+    QFETCH(QByteArray, content);
+    QFETCH(QString, expectedError);
+
+    QVector<Job> jobs;
+    QString error;
+    QVERIFY(!readJobs(fileName, content, jobs, error));
+    QVERIFY(!error.isEmpty());
+    QVERIFY2(error.contains(expectedError), qPrintable(error));
+}
+
+void TestBatchChartRenderer::testMissingFile()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QVector<Job> jobs;
+    QString error;
+    QVERIFY(!BatchChartRenderer::readJobs(dir.filePath("missing.json"), jobs, error));
+    QVERIFY(error.contains("missing.json"));
+    QVERIFY(jobs.isEmpty());
+}
+
+QTEST_GUILESS_MAIN(TestBatchChartRenderer)
@@ -0,0 +1,25 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+
+    Test for the job file parser of batchchartrenderer.cpp
+*/
+
+#pragma once
+
+#include <QObject>
+
+class TestBatchChartRenderer: public QObject
+{
+        Q_OBJECT
+    public:
+        explicit TestBatchChartRenderer(QObject * parent = nullptr);
+
+    private Q_SLOTS:
+        void testJson();
+        void testCsv();
+        void testMalformed_data();
+        void testMalformed();
+        void testMissingFile();
+};
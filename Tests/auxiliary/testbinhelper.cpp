@@ -6,12 +6,23 @@
 
 #include "testbinhelper.h"
 
+#include "auxiliary/binfilehelper.h"
+#include "skyobjects/deepstardata.h"
+
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+
+#include <cstring>
+
 TestBinHelper::TestBinHelper(QObject *parent) : QObject(parent)
 {
 }
 
 void TestBinHelper::initTestCase()
 {
+    QStandardPaths::setTestModeEnabled(true);
+    QDir().mkpath(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation));
 }
 
 void TestBinHelper::cleanupTestCase()
@@ -26,13 +37,150 @@ void TestBinHelper::cleanup()
 {
 }
 
-void TestBinHelper::testLoadBinary_data()
+// A catalog in the format of data/README.fileformat with 16-byte DeepStarData records, whose RA is the
+// index entry and Dec the record number. The file is cut short by truncate bytes.
+QString TestBinHelper::writeCatalog(const QString &name, const QVector<quint32> &counts, const quint32 truncate)
 {
+    QByteArray file(124, ' ');
+    file.replace(0, 22, "KStars Star Data v2.0.");
+    const qint16 endian = 0x4B53;
+    file.append(reinterpret_cast<const char *>(&endian), 2);
+    file.append(char(2));
+
+    const char *names[] = { "RA", "Dec", "dRA", "dDec", "B", "V" };
+    const qint8 sizes[] = { 4, 4, 2, 2, 2, 2 };
+    const qint16 nfields = 6;
+    file.append(reinterpret_cast<const char *>(&nfields), 2);
+    for (int i = 0; i < nfields; i++)
+    {
+        dataElement de;
+        strncpy(de.name, names[i], sizeof(de.name) - 1);
+        de.size = sizes[i];
+        de.scale = 1;
+        file.append(reinterpret_cast<const char *>(&de), sizeof(dataElement));
+    }
+
+    const quint32 indexSize = counts.size();
+    file.append(reinterpret_cast<const char *>(&indexSize), 4);
+    quint32 offset = file.size() + indexSize * 12;
+    for (quint32 id = 0; id < indexSize; id++)
+    {
+        file.append(reinterpret_cast<const char *>(&id), 4);
+        file.append(reinterpret_cast<const char *>(&offset), 4);
+        file.append(reinterpret_cast<const char *>(&counts[id]), 4);
+        offset += counts[id] * sizeof(DeepStarData);
+    }
+
+    for (quint32 id = 0; id < indexSize; id++)
+    {
+        for (quint32 j = 0; j < counts[id]; j++)
+        {
+            DeepStarData data;
+            data.RA = id;
+            data.Dec = j;
+            file.append(reinterpret_cast<const char *>(&data), sizeof(DeepStarData));
+        }
+    }
+    file.chop(truncate);
+
+    QFile out(QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)).filePath(name));
+    if (!out.open(QIODevice::WriteOnly) || out.write(file) != file.size())
+        return QString();
+    return name;
 }
 
 void TestBinHelper::testLoadBinary()
 {
-    QSKIP("Not implemented yet.");
+    const QVector<quint32> counts { 3, 0, 5, 2 };
+    const QString name = writeCatalog("testbinhelper.dat", counts);
+    QVERIFY(!name.isEmpty());
+
+    BinFileHelper reader;
+    QVERIFY(reader.openFile(name) != nullptr);
+    QVERIFY(reader.readHeader());
+    QCOMPARE(reader.guessRecordSize(), 16);
+    QCOMPARE(reader.getFieldCount(), 6);
+    QVERIFY(!reader.getByteSwap());
+    QCOMPARE(reader.getRecordCount(), 10UL);
+    QCOMPARE(reader.getRecordCount(2), 5U);
+
+    // Not mapped, so records can only be read from the file
+    QVERIFY(!reader.isMapped());
+    QVERIFY(reader.getRecords(2) == nullptr);
+
+    DeepStarData data;
+    QCOMPARE(BinFileHelper::unsigned_KDE_fseek(reader.getFileHandle(), reader.getOffset(2), SEEK_SET), 0);
+    QCOMPARE(fread(&data, sizeof(DeepStarData), 1, reader.getFileHandle()), size_t(1));
+    QCOMPARE(data.RA, 2);
+    QCOMPARE(data.Dec, 0);
+
+    reader.closeFile();
+    QVERIFY(reader.getFileHandle() == nullptr);
+}
+
+void TestBinHelper::testMapBinary()
+{
+    const QVector<quint32> counts { 3, 0, 5, 2 };
+    const QString name = writeCatalog("testbinhelper.dat", counts);
+    QVERIFY(!name.isEmpty());
+
+    BinFileHelper reader;
+    QVERIFY(reader.openFile(name) != nullptr);
+    // The index must be read first
+    QVERIFY(!reader.mapFile());
+    QVERIFY(reader.readHeader());
+    QVERIFY(reader.mapFile());
+    QVERIFY(reader.isMapped());
+
+    // Each index entry's records decode to the same values as they are read from the file
+    for (int id = 0; id < counts.size(); id++)
+    {
+        const uchar *records = reader.getRecords(id);
+        QVERIFY(records != nullptr);
+        QCOMPARE(static_cast<long>(records - reader.getMappedData()), reader.getOffset(id));
+        for (quint32 j = 0; j < counts[id]; j++)
+        {
+            DeepStarData mapped, read;
+            memcpy(&mapped, records + j * sizeof(DeepStarData), sizeof(DeepStarData));
+            BinFileHelper::unsigned_KDE_fseek(reader.getFileHandle(), reader.getOffset(id) + j * sizeof(DeepStarData), SEEK_SET);
+            QCOMPARE(fread(&read, sizeof(DeepStarData), 1, reader.getFileHandle()), size_t(1));
+            QCOMPARE(mapped.RA, id);
+            QCOMPARE(mapped.Dec, static_cast<qint32>(j));
+            QCOMPARE(memcmp(&mapped, &read, sizeof(DeepStarData)), 0);
+        }
+        // Read ahead is only advice, but must accept any record
+        reader.prefetchRecords(id);
+        reader.prefetchRecords(id, counts[id]);
+        reader.prefetchRecords(id, 1, 1);
+    }
+    QVERIFY(reader.getRecords(-1) == nullptr);
+    QVERIFY(reader.getRecords(counts.size()) == nullptr);
+
+    reader.unmapFile();
+    QVERIFY(!reader.isMapped());
+    QVERIFY(reader.getRecords(0) == nullptr);
+    // The file is still open after unmapping
+    QVERIFY(reader.getFileHandle() != nullptr);
+
+    QVERIFY(reader.mapFile());
+    reader.closeFile();
+    QVERIFY(!reader.isMapped());
+}
+
+void TestBinHelper::testMapTruncated()
+{
+    // The last entry runs past the end of the file, which the index doesn't show
+    const QVector<quint32> counts { 4, 4 };
+    const QString name = writeCatalog("testbinhelper-truncated.dat", counts, sizeof(DeepStarData));
+    QVERIFY(!name.isEmpty());
+
+    BinFileHelper reader;
+    QVERIFY(reader.openFile(name) != nullptr);
+    QVERIFY(reader.readHeader());
+    QVERIFY(reader.mapFile());
+    QVERIFY(reader.getRecords(0) != nullptr);
+    QVERIFY(reader.getRecords(1) == nullptr);
+    reader.prefetchRecords(1);
 }
 
 QTEST_GUILESS_MAIN(TestBinHelper)
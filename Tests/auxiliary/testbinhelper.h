@@ -15,6 +15,7 @@
 #endif
 
 #include <QObject>
+#include <QVector>
 
 class TestBinHelper : public QObject
 {
@@ -29,8 +30,12 @@ class TestBinHelper : public QObject
         void init();
         void cleanup();
 
-        void testLoadBinary_data();
         void testLoadBinary();
+        void testMapBinary();
+        void testMapTruncated();
+
+    private:
+        static QString writeCatalog(const QString &name, const QVector<quint32> &counts, const quint32 truncate = 0);
 };
 
 #endif // TESTBINHELPER_H
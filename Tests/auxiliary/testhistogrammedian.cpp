@@ -0,0 +1,178 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+
+    Test for histogrammedian.cpp
+*/
+
+#include "testhistogrammedian.h"
+#include "auxiliary/histogrammedian.h"
+
+#include <QtGlobal>
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+#include <QtTest/QTest>
+#else
+#include <QTest>
+#endif
+#include <QRandomGenerator>
+
+#include <algorithm>
+
+using Mathematics::HistogramMedian;
+
+namespace
+{
+// Median and MAD by sorting, the median of an even count being the mean of the middle two
+void reference(std::vector<double> values, double &median, double &mad)
+{
+    auto middle = [](std::vector<double> &v)
+    {
+        std::sort(v.begin(), v.end());
+        const size_t n = v.size();
+        return n % 2 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+    };
+    median = middle(values);
+    for (auto &value : values)
+        value = std::fabs(value - median);
+    mad = middle(values);
+}
+
+// Sky background with gaussian noise and a few saturated pixels
+template <typename T>
+std::vector<T> makeData(const int count, const double background, const double noise, const double saturation)
+{
+    QRandomGenerator rng(count);
+    std::vector<T> data(count);
+    for (auto &value : data)
+    {
+        // Box-Muller
+        const double u1 = std::max(1e-12, rng.generateDouble()), u2 = rng.generateDouble();
+        double sample = background + noise * std::sqrt(-2 * std::log(u1)) * std::cos(2 * M_PI * u2);
+        if (rng.bounded(500) == 0)
+            sample = saturation;
+        value = static_cast<T>(std::max(0.0, std::min(sample, saturation)));
+    }
+    return data;
+}
+
+template <typename T>
+void checkExact(const int count)
+{
+    const std::vector<T> data = makeData<T>(count, 1000, 25, std::min(65535.0, double(std::numeric_limits<T>::max())));
+    double median, mad;
+    reference(std::vector<double>(data.begin(), data.end()), median, mad);
+
+    const auto result = HistogramMedian::compute(data.data(), data.size());
+    QCOMPARE(result.count, data.size());
+    QCOMPARE(result.median, median);
+    QCOMPARE(result.mad, mad);
+}
+}
+
+TestHistogramMedian::TestHistogramMedian(QObject * parent): QObject(parent)
+{
+}
+
+void TestHistogramMedian::testExact_data()
+{
+    QTest::addColumn<QString>("type");
+    QTest::addColumn<int>("count");
+
+    for (const QString type : { "uint16", "int16", "int32", "int64" })
+        for (const int count : { 1, 2, 101, 1000000 })
+            QTest::newRow(qPrintable(QString("%1 %2").arg(type).arg(count))) << type << count;
+}
+
+// Integer data spanning fewer than BINS values gives exactly the same result as sorting
+void TestHistogramMedian::testExact()
+{
+    QFETCH(QString, type);
+    QFETCH(int, count);
+
+    if (type == "uint16")
+        checkExact<uint16_t>(count);
+    else if (type == "int16")
+        checkExact<int16_t>(count);
+    else if (type == "int32")
+        checkExact<int32_t>(count);
+    else
+        checkExact<int64_t>(count);
+}
+
+void TestHistogramMedian::testFloat_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("small") << 1001;
+    QTest::newRow("large") << 2000000;
+}
+
+// Float data is exact for small counts and within the bin width otherwise
+void TestHistogramMedian::testFloat()
+{
+    QFETCH(int, count);
+
+    std::vector<float> data = makeData<float>(count, 0.02, 0.001, 1.0);
+    data[count / 2] = std::numeric_limits<float>::quiet_NaN();
+
+    std::vector<double> values;
+    for (const auto value : data)
+        if (!std::isnan(value))
+            values.push_back(value);
+    double median, mad;
+    reference(values, median, mad);
+
+    const auto result = HistogramMedian::compute(data.data(), data.size());
+    QCOMPARE(result.count, values.size());
+
+    const double tolerance = static_cast<size_t>(count) <= HistogramMedian::SMALL_COUNT ? 1e-9 :
+                             (*std::max_element(values.begin(), values.end()) - *std::min_element(values.begin(), values.end())) /
+                             HistogramMedian::BINS;
+    QVERIFY2(std::fabs(result.median - median) <= tolerance,
+             qPrintable(QString("median %1 expected %2").arg(result.median).arg(median)));
+    QVERIFY2(std::fabs(result.mad - mad) <= tolerance,
+             qPrintable(QString("MAD %1 expected %2").arg(result.mad).arg(mad)));
+}
+
+void TestHistogramMedian::testMaskAndStride()
+{
+    // Interleaved RGB, the green channel is 100 + index
+    std::vector<uint16_t> rgb(3 * 9);
+    for (int i = 0; i < 9; i++)
+    {
+        rgb[3 * i] = 0;
+        rgb[3 * i + 1] = 100 + i;
+        rgb[3 * i + 2] = 60000;
+    }
+    auto result = HistogramMedian::compute(rgb.data() + 1, 9, 3);
+    QCOMPARE(result.median, 104.0);
+    QCOMPARE(result.mad, 2.0);
+
+    // Mask out the first 5 samples, leaving 105 to 108
+    const uint8_t mask[9] = { 0, 0, 0, 0, 0, 1, 1, 1, 1 };
+    result = HistogramMedian::compute(rgb.data() + 1, 9, 3, mask);
+    QCOMPARE(result.count, size_t(4));
+    QCOMPARE(result.median, 106.5);
+    QCOMPARE(result.mad, 1.0);
+
+    // Median only
+    result = HistogramMedian::compute(rgb.data() + 1, 9, 3, mask, false);
+    QCOMPARE(result.median, 106.5);
+    QCOMPARE(result.mad, 0.0);
+}
+
+void TestHistogramMedian::testEmpty()
+{
+    const std::vector<float> nans(10, std::numeric_limits<float>::quiet_NaN());
+    auto result = HistogramMedian::compute(nans.data(), nans.size());
+    QCOMPARE(result.count, size_t(0));
+
+    const std::vector<double> constant(100000, 0.5);
+    result = HistogramMedian::compute(constant.data(), constant.size());
+    QCOMPARE(result.count, constant.size());
+    QCOMPARE(result.median, 0.5);
+    QCOMPARE(result.mad, 0.0);
+}
+
+QTEST_GUILESS_MAIN(TestHistogramMedian)
@@ -0,0 +1,26 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+
+    Test for histogrammedian.cpp
+*/
+
+#pragma once
+
+#include <QObject>
+
+class TestHistogramMedian: public QObject
+{
+        Q_OBJECT
+    public:
+        explicit TestHistogramMedian(QObject * parent = nullptr);
+
+    private Q_SLOTS:
+        void testExact_data();
+        void testExact();
+        void testFloat_data();
+        void testFloat();
+        void testMaskAndStride();
+        void testEmpty();
+};
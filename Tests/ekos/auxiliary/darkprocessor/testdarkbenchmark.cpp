@@ -0,0 +1,290 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QtGlobal>
+#include <QTest>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+
+#include "ekos/auxiliary/darkkernels.h"
+#include "fitsviewer/stretchkernels.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+// Times the calibration of a 61 Mpix frame, the size of a full frame IMX455 sensor, for the 8, 16
+// and 32 bit data types: dark subtraction, master dark averaging and defect map correction. Each is
+// run with the pixel by pixel loops DarkProcessor and DarkLibrary used to have, then with the scalar
+// and the vectorised kernels on all the cores, which must give the same result.
+class TestDarkBenchmark : public QObject
+{
+        Q_OBJECT
+
+    private:
+        template <typename T> static std::vector<T> makeFrame(double background, double noise, quint32 seed);
+        template <typename T> static quint64 checksum(const std::vector<T> &frame);
+        template <typename T> static void subtraction();
+        template <typename T> static void masterFrame();
+        template <typename T> static void defects();
+        static void runForType(const QString &type, void (*byteFn)(), void (*shortFn)(), void (*ushortFn)(),
+                               void (*longFn)(), void (*ulongFn)(), void (*floatFn)());
+
+        static QList<StretchKernels::Isa> isas();
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void benchmarkSubtraction_data();
+        void benchmarkSubtraction();
+        void benchmarkMasterFrame_data();
+        void benchmarkMasterFrame();
+        void benchmarkDefects_data();
+        void benchmarkDefects();
+};
+
+static constexpr uint32_t WIDTH = 9576;
+static constexpr uint32_t HEIGHT = 6388;
+static constexpr size_t SAMPLES = static_cast<size_t>(WIDTH) * HEIGHT;
+static constexpr uint32_t FRAMES = 5;
+
+template <typename T>
+std::vector<T> TestDarkBenchmark::makeFrame(double background, double noise, quint32 seed)
+{
+    // Background with noise and a few hot pixels, brighter than the light frame where they are
+    QRandomGenerator rng(seed);
+    const double scale = std::is_floating_point<T>::value ? 1.0 : std::min<double>(std::numeric_limits<T>::max(),
+                         65535.0);
+    std::vector<T> frame(SAMPLES);
+    for (size_t i = 0; i < SAMPLES; i++)
+    {
+        double value = background + noise * rng.generateDouble();
+        if (rng.bounded(2000) == 0)
+            value = 0.9 + 0.1 * rng.generateDouble();
+        frame[i] = static_cast<T>(value * scale);
+    }
+    return frame;
+}
+
+template <typename T>
+quint64 TestDarkBenchmark::checksum(const std::vector<T> &frame)
+{
+    // FNV-1a over the bytes of the frame
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(frame.data());
+    quint64 hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < frame.size() * sizeof(T); i++)
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    return hash;
+}
+
+template <typename T>
+void TestDarkBenchmark::subtraction()
+{
+    const std::vector<T> light = makeFrame<T>(0.2, 0.1, 1);
+    const std::vector<T> dark = makeFrame<T>(0.05, 0.02, 2);
+
+    // Pixel by pixel on one core
+    std::vector<T> output = light;
+    QElapsedTimer timer;
+    timer.start();
+    for (size_t i = 0; i < SAMPLES; i++)
+        output[i] = (output[i] > dark[i]) ? (output[i] - dark[i]) : 0;
+    const qint64 legacy = timer.elapsed();
+    const quint64 reference = checksum(output);
+
+    qInfo() << QString("  subtract %1 %2: %3 ms").arg(QTest::currentDataTag()).arg("Legacy", -7).arg(legacy);
+
+    for (const auto isa : isas())
+    {
+        StretchKernels::setIsa(isa);
+        output = light;
+        timer.restart();
+        Ekos::DarkKernels::subtract(output.data(), WIDTH, HEIGHT, dark.data(), WIDTH);
+        const qint64 elapsed = timer.elapsed();
+
+        qInfo() << QString("  subtract %1 %2: %3 ms").arg(QTest::currentDataTag())
+                .arg(StretchKernels::isaName(isa), -7).arg(elapsed);
+        QCOMPARE(checksum(output), reference);
+    }
+}
+
+template <typename T>
+void TestDarkBenchmark::masterFrame()
+{
+    const std::vector<T> dark = makeFrame<T>(0.05, 0.02, 3);
+
+    // Pixel by pixel on one core, the same dark taken FRAMES times
+    std::vector<uint32_t> sum(SAMPLES, 0);
+    std::vector<T> master(SAMPLES);
+    QElapsedTimer timer;
+    timer.start();
+    for (uint32_t frame = 0; frame < FRAMES; frame++)
+        for (size_t i = 0; i < SAMPLES; i++)
+            sum[i] += dark[i];
+    for (size_t i = 0; i < SAMPLES; i++)
+        master[i] = sum[i] / FRAMES;
+    const qint64 legacy = timer.elapsed();
+    const quint64 reference = checksum(master);
+
+    qInfo() << QString("  master %1 %2: %3 ms").arg(QTest::currentDataTag()).arg("Legacy", -7).arg(legacy);
+
+    for (const auto isa : isas())
+    {
+        StretchKernels::setIsa(isa);
+        std::fill(sum.begin(), sum.end(), 0);
+        timer.restart();
+        for (uint32_t frame = 0; frame < FRAMES; frame++)
+            Ekos::DarkKernels::accumulate(dark.data(), sum.data(), SAMPLES);
+        Ekos::DarkKernels::average(sum.data(), master.data(), SAMPLES, FRAMES);
+        const qint64 elapsed = timer.elapsed();
+
+        qInfo() << QString("  master %1 %2: %3 ms").arg(QTest::currentDataTag())
+                .arg(StretchKernels::isaName(isa), -7).arg(elapsed);
+        QCOMPARE(checksum(master), reference);
+    }
+}
+
+template <typename T>
+void TestDarkBenchmark::defects()
+{
+    const std::vector<T> light = makeFrame<T>(0.2, 0.1, 4);
+
+    // About 0.1% of the pixels, none next to another so that correcting them in place one at a time
+    // gives the same result as the kernel
+    QRandomGenerator rng(5);
+    std::vector<bool> taken(SAMPLES, false);
+    std::vector<uint32_t> offsets;
+    while (offsets.size() < SAMPLES / 1000)
+    {
+        const uint32_t x = 2 + rng.bounded(WIDTH - 4);
+        const uint32_t y = 2 + rng.bounded(HEIGHT - 4);
+        bool isolated = true;
+        for (int dy = -1; dy <= 1; dy++)
+            for (int dx = -1; dx <= 1; dx++)
+                isolated = isolated && !taken[(y + dy) * WIDTH + x + dx];
+        if (!isolated)
+            continue;
+        taken[y * WIDTH + x] = true;
+        offsets.push_back(y * WIDTH + x);
+    }
+
+    // One pixel at a time sorting its neighbours, as DarkProcessor::median3x3Filter() did
+    std::vector<T> output = light;
+    QElapsedTimer timer;
+    timer.start();
+    for (const uint32_t offset : offsets)
+    {
+        const T *top = output.data() + offset - WIDTH - 1;
+        const T *mid = output.data() + offset - 1;
+        const T *bot = output.data() + offset + WIDTH - 1;
+        std::array<T, 8> elements = { top[0], top[1], top[2], mid[0], mid[2], bot[0], bot[1], bot[2] };
+        std::sort(elements.begin(), elements.end());
+        output[offset] = (elements[3] + elements[4]) / 2;
+    }
+    const qint64 legacy = timer.nsecsElapsed();
+    const quint64 reference = checksum(output);
+
+    qInfo() << QString("  defects %1 %2: %3 ms for %4 pixels").arg(QTest::currentDataTag()).arg("Legacy", -7)
+            .arg(legacy / 1e6, 0, 'f', 2).arg(offsets.size());
+
+    output = light;
+    timer.restart();
+    Ekos::DarkKernels::correctDefects(output.data(), WIDTH, offsets);
+    const qint64 elapsed = timer.nsecsElapsed();
+
+    qInfo() << QString("  defects %1 %2: %3 ms for %4 pixels").arg(QTest::currentDataTag()).arg("Batched", -7)
+            .arg(elapsed / 1e6, 0, 'f', 2).arg(offsets.size());
+    QCOMPARE(checksum(output), reference);
+}
+
+void TestDarkBenchmark::runForType(const QString &type, void (*byteFn)(), void (*shortFn)(), void (*ushortFn)(),
+                                   void (*longFn)(), void (*ulongFn)(), void (*floatFn)())
+{
+    if (type == "byte")
+        byteFn();
+    else if (type == "short")
+        shortFn();
+    else if (type == "ushort")
+        ushortFn();
+    else if (type == "long")
+        longFn();
+    else if (type == "ulong")
+        ulongFn();
+    else if (type == "float")
+        floatFn();
+    else
+        QFAIL("Unknown data type");
+}
+
+QList<StretchKernels::Isa> TestDarkBenchmark::isas()
+{
+    QList<StretchKernels::Isa> list { StretchKernels::Isa::SCALAR };
+    if (StretchKernels::bestIsa() == StretchKernels::Isa::AVX2)
+        list << StretchKernels::Isa::SSE41;
+    if (StretchKernels::bestIsa() != StretchKernels::Isa::SCALAR)
+        list << StretchKernels::bestIsa();
+    return list;
+}
+
+void TestDarkBenchmark::initTestCase()
+{
+    qInfo() << QString("Best instruction set: %1, %2x%3 frames").arg(StretchKernels::isaName(StretchKernels::bestIsa()))
+            .arg(WIDTH).arg(HEIGHT);
+}
+
+void TestDarkBenchmark::cleanupTestCase()
+{
+    StretchKernels::setIsa(StretchKernels::bestIsa());
+}
+
+static void addTypeRows()
+{
+    QTest::addColumn<QString>("type");
+    for (const QString type : { "byte", "short", "ushort", "long", "ulong", "float" })
+        QTest::newRow(qPrintable(type)) << type;
+}
+
+void TestDarkBenchmark::benchmarkSubtraction_data()
+{
+    addTypeRows();
+}
+
+void TestDarkBenchmark::benchmarkSubtraction()
+{
+    QFETCH(QString, type);
+    runForType(type, &subtraction<uint8_t>, &subtraction<int16_t>, &subtraction<uint16_t>, &subtraction<int32_t>,
+               &subtraction<uint32_t>, &subtraction<float>);
+}
+
+void TestDarkBenchmark::benchmarkMasterFrame_data()
+{
+    addTypeRows();
+}
+
+void TestDarkBenchmark::benchmarkMasterFrame()
+{
+    QFETCH(QString, type);
+    runForType(type, &masterFrame<uint8_t>, &masterFrame<int16_t>, &masterFrame<uint16_t>, &masterFrame<int32_t>,
+               &masterFrame<uint32_t>, &masterFrame<float>);
+}
+
+void TestDarkBenchmark::benchmarkDefects_data()
+{
+    addTypeRows();
+}
+
+void TestDarkBenchmark::benchmarkDefects()
+{
+    QFETCH(QString, type);
+    runForType(type, &defects<uint8_t>, &defects<int16_t>, &defects<uint16_t>, &defects<int32_t>, &defects<uint32_t>,
+               &defects<float>);
+}
+
+QTEST_GUILESS_MAIN(TestDarkBenchmark)
+
+#include "testdarkbenchmark.moc"
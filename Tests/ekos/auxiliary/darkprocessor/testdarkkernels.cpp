@@ -0,0 +1,93 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QtGlobal>
+#include <QTest>
+
+#include "ekos/auxiliary/darkkernels.h"
+#include "fitsviewer/stretchkernels.h"
+
+#include <cstring>
+#include <limits>
+#include <vector>
+
+// Checks that the dark subtraction kernels give the same result as light > dark ? light - dark : 0
+// for float frames with NaN, infinite, signed zero and denormal pixels, with each instruction set
+class TestDarkKernels : public QObject
+{
+        Q_OBJECT
+
+    private:
+        static QList<StretchKernels::Isa> isas();
+
+    private Q_SLOTS:
+        void cleanupTestCase();
+        void testSubtractNonFinite_data();
+        void testSubtractNonFinite();
+};
+
+QList<StretchKernels::Isa> TestDarkKernels::isas()
+{
+    QList<StretchKernels::Isa> list { StretchKernels::Isa::SCALAR };
+    if (StretchKernels::bestIsa() == StretchKernels::Isa::AVX2)
+        list << StretchKernels::Isa::SSE41;
+    if (StretchKernels::bestIsa() != StretchKernels::Isa::SCALAR)
+        list << StretchKernels::bestIsa();
+    return list;
+}
+
+void TestDarkKernels::cleanupTestCase()
+{
+    StretchKernels::setIsa(StretchKernels::bestIsa());
+}
+
+void TestDarkKernels::testSubtractNonFinite_data()
+{
+    QTest::addColumn<int>("isa");
+    for (const auto isa : isas())
+        QTest::newRow(qPrintable(StretchKernels::isaName(isa))) << static_cast<int>(isa);
+}
+
+void TestDarkKernels::testSubtractNonFinite()
+{
+    QFETCH(int, isa);
+    StretchKernels::setIsa(static_cast<StretchKernels::Isa>(isa));
+
+    const float values[] =
+    {
+        std::numeric_limits<float>::quiet_NaN(), -std::numeric_limits<float>::quiet_NaN(),
+        std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(),
+        0.0f, -0.0f, std::numeric_limits<float>::denorm_min(), std::numeric_limits<float>::max(),
+        -1.0f, 1.5f, 1000.0f
+    };
+    const uint32_t count = sizeof(values) / sizeof(values[0]);
+
+    // Every pair of values, in rows which aren't a multiple of the vector width so that the scalar
+    // tail is used too
+    const uint32_t width = count * count + 3;
+    const uint32_t height = 4;
+    std::vector<float> light(width * height), dark(width * height), expected(width * height);
+    for (uint32_t i = 0; i < light.size(); i++)
+    {
+        const uint32_t pair = (i + i / width) % (count * count);
+        light[i] = values[pair / count];
+        dark[i] = values[pair % count];
+        expected[i] = (light[i] > dark[i]) ? (light[i] - dark[i]) : 0;
+    }
+
+    const std::vector<float> input = light;
+    Ekos::DarkKernels::subtract(light.data(), width, height, dark.data(), width);
+
+    // Bit for bit, as a -0 would compare equal to the expected 0
+    for (uint32_t i = 0; i < light.size(); i++)
+        QVERIFY2(std::memcmp(&light[i], &expected[i], sizeof(float)) == 0,
+                 qPrintable(QString("%1 - %2 gave %3 instead of %4").arg(input[i]).arg(dark[i]).arg(light[i])
+                            .arg(expected[i])));
+}
+
+QTEST_GUILESS_MAIN(TestDarkKernels)
+
+#include "testdarkkernels.moc"
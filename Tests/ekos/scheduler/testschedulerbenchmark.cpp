@@ -0,0 +1,215 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+/*
+ * Times the greedy scheduler planning 200 synthetic jobs, spread over the sky with altitude,
+ * twilight and Moon separation constraints, evaluating the jobs one at a time and then on all the
+ * threads of the pool, and checks that both give the same schedule. Also checks that evaluating
+ * the running job on all the threads doesn't search the start times of more jobs than one at a time.
+ */
+
+#include "../../testhelpers.h"
+
+#include "ekos/scheduler/greedyscheduler.h"
+#include "ekos/scheduler/schedulerjob.h"
+#include "ekos/scheduler/schedulermodulestate.h"
+#include "ekos/scheduler/schedulerutils.h"
+#include "geolocation.h"
+#include "kstarsdata.h"
+#include "Options.h"
+
+#include <QtGlobal>
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+#include <QtTest/QTest>
+#else
+#include <QTest>
+#endif
+#include <QElapsedTimer>
+#include <QThreadPool>
+
+#include <cmath>
+
+class TestSchedulerBenchmark : public QObject
+{
+        Q_OBJECT
+
+    public:
+        TestSchedulerBenchmark();
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void benchmarkSchedule();
+        void testRunningJobEvaluations();
+
+    private:
+        // Creates the jobs, all running the test's 9filters.esq
+        QList<Ekos::SchedulerJob *> makeJobs() const;
+        // Schedules the jobs with the given number of threads, returns the time it took in ms
+        qint64 schedule(const QList<Ekos::SchedulerJob *> &jobs, int threads, QStringList &plan);
+        // Evaluates the running job with the given number of threads, returns how many start time
+        // searches the jobs did, i.e. weren't answered from their caches
+        int countRunningJobSearches(Ekos::GreedyScheduler &scheduler, const QList<Ekos::SchedulerJob *> &jobs,
+                                    const Ekos::SchedulerJob *runningJob, const QDateTime &now, int threads,
+                                    const Ekos::SchedulerJob **next);
+
+        QString m_SequenceFile;
+};
+
+#include "testschedulerbenchmark.moc"
+
+static constexpr int JOBS = 200;
+
+// The same place as testschedulerunit, at the start of a spring night
+GeoLocation siliconValley(dms(-122, 10), dms(37, 26, 30), "Silicon Valley", "CA", "USA", -7);
+KStarsDateTime evening(QDateTime(QDate(2021, 4, 16), QTime(20, 0, 0), QTimeZone(-7 * 3600)));
+
+TestSchedulerBenchmark::TestSchedulerBenchmark() : QObject()
+{
+    m_SequenceFile = QFINDTESTDATA("9filters.esq");
+
+    Options::setDitherEnabled(false);
+    Options::setGreedyScheduling(true);
+}
+
+void TestSchedulerBenchmark::initTestCase()
+{
+    KTEST_BEGIN();
+
+    // The jobs take their Moon from KStarsData, without which the Moon constraints are ignored
+    KStarsData *data = KStarsData::Create();
+    QVERIFY(data != nullptr);
+    QVERIFY(data->initialize());
+}
+
+void TestSchedulerBenchmark::cleanupTestCase()
+{
+    KTEST_END();
+}
+
+QList<Ekos::SchedulerJob *> TestSchedulerBenchmark::makeJobs() const
+{
+    const KStarsDateTime ut = siliconValley.LTtoUT(evening);
+    QList<Ekos::SchedulerJob *> jobs;
+    for (int i = 0; i < JOBS; i++)
+    {
+        // Golden ratio steps in RA and declination, with minimum altitudes of 20, 30 and 40 degrees,
+        // and Moon separations of 0, 20, 40 and 60 degrees
+        const dms ra(15.0 * std::fmod(i * 0.618034 * 24.0, 24.0));
+        const dms dec(-25.0 + std::fmod(i * 0.618034 * 85.0, 85.0));
+        const double minAltitude = 20.0 + 10.0 * (i % 3);
+        const double minMoonSeparation = 20.0 * (i % 4);
+
+        auto *job = new Ekos::SchedulerJob();
+        Ekos::SchedulerUtils::setupJob(*job, QString("Target%1").arg(i + 1, 3, 10, QChar('0')), true, "", "", ra, dec,
+                                       ut.djd(), 0.0, QUrl::fromLocalFile(m_SequenceFile), QUrl(""),
+                                       Ekos::START_ASAP, QDateTime(), Ekos::FINISH_SEQUENCE, QDateTime(), 1,
+                                       minAltitude, minMoonSeparation, 90.0, true, false, true, false, false, false);
+        jobs.append(job);
+    }
+    return jobs;
+}
+
+qint64 TestSchedulerBenchmark::schedule(const QList<Ekos::SchedulerJob *> &jobs, int threads, QStringList &plan)
+{
+    const int maxThreads = QThreadPool::globalInstance()->maxThreadCount();
+    QThreadPool::globalInstance()->setMaxThreadCount(threads);
+
+    Ekos::GreedyScheduler scheduler;
+    scheduler.setParams(true, true, true, 3600, 3600);
+    const Ekos::CapturedFramesMap capturedFrames;
+
+    QElapsedTimer timer;
+    timer.start();
+    scheduler.scheduleJobs(jobs, evening, capturedFrames, nullptr);
+    const qint64 elapsed = timer.elapsed();
+
+    QThreadPool::globalInstance()->setMaxThreadCount(maxThreads);
+
+    for (const auto &entry : scheduler.getSchedule())
+        plan.append(Ekos::GreedyScheduler::jobScheduleString(entry));
+    return elapsed;
+}
+
+void TestSchedulerBenchmark::benchmarkSchedule()
+{
+    Ekos::SchedulerModuleState::setGeo(&siliconValley);
+    Ekos::SchedulerModuleState::setLocalTime(&evening);
+
+    // Separate jobs for each run, so that neither reuses what the other computed
+    const QList<Ekos::SchedulerJob *> serialJobs = makeJobs(), parallelJobs = makeJobs();
+    QCOMPARE(serialJobs.size(), JOBS);
+
+    // The positions of the Moon and the twilight are shared by all the jobs. The run on all the threads
+    // goes first, so that it is the one computing them, before and while the jobs are evaluated.
+    const int threads = QThreadPool::globalInstance()->maxThreadCount();
+    QStringList serialPlan, parallelPlan;
+    const qint64 parallelMsecs = schedule(parallelJobs, threads, parallelPlan);
+    const qint64 serialMsecs = schedule(serialJobs, 1, serialPlan);
+
+    qInfo() << QString("  %1 jobs, %2 scheduled: one thread %3 ms, %4 threads %5 ms, speed-up %6x")
+            .arg(serialJobs.size()).arg(serialPlan.size()).arg(serialMsecs).arg(threads).arg(parallelMsecs)
+            .arg(parallelMsecs > 0 ? static_cast<double>(serialMsecs) / parallelMsecs : 0.0, 0, 'f', 2);
+
+    QVERIFY(!serialPlan.isEmpty());
+    QCOMPARE(parallelPlan, serialPlan);
+
+    qDeleteAll(serialJobs);
+    qDeleteAll(parallelJobs);
+}
+
+int TestSchedulerBenchmark::countRunningJobSearches(Ekos::GreedyScheduler &scheduler,
+        const QList<Ekos::SchedulerJob *> &jobs, const Ekos::SchedulerJob *runningJob, const QDateTime &now,
+        int threads, const Ekos::SchedulerJob **next)
+{
+    const int maxThreads = QThreadPool::globalInstance()->maxThreadCount();
+    QThreadPool::globalInstance()->setMaxThreadCount(threads);
+
+    for (auto *job : jobs)
+        job->clearCache();
+    QDateTime when;
+    *next = scheduler.selectNextJob(jobs, now, runningJob, Ekos::GreedyScheduler::DONT_SIMULATE, &when);
+
+    QThreadPool::globalInstance()->setMaxThreadCount(maxThreads);
+
+    int searches = 0;
+    for (const auto *job : jobs)
+        searches += job->startTimeCache.size();
+    return searches;
+}
+
+void TestSchedulerBenchmark::testRunningJobEvaluations()
+{
+    Ekos::SchedulerModuleState::setGeo(&siliconValley);
+    Ekos::SchedulerModuleState::setLocalTime(&evening);
+
+    const QList<Ekos::SchedulerJob *> jobs = makeJobs();
+    Ekos::GreedyScheduler scheduler;
+    scheduler.setParams(true, true, true, 3600, 3600);
+    const Ekos::CapturedFramesMap capturedFrames;
+    scheduler.scheduleJobs(jobs, evening, capturedFrames, nullptr);
+    const Ekos::SchedulerJob *runningJob = scheduler.getScheduledJob();
+    QVERIFY(runningJob != nullptr);
+    QVERIFY(runningJob->getStartupTime().isValid());
+
+    // As the scheduler checks the job a while after it started
+    const QDateTime now = runningJob->getStartupTime().addSecs(10 * 60);
+    const Ekos::SchedulerJob *serialNext = nullptr, *parallelNext = nullptr;
+    const int serialSearches = countRunningJobSearches(scheduler, jobs, runningJob, now, 1, &serialNext);
+    const int parallelSearches = countRunningJobSearches(scheduler, jobs, runningJob, now,
+                                 QThreadPool::globalInstance()->maxThreadCount(), &parallelNext);
+
+    qInfo() << QString("  running job %1: %2 start time searches on one thread, %3 on all the threads")
+            .arg(runningJob->getName()).arg(serialSearches).arg(parallelSearches);
+
+    QVERIFY(serialSearches > 0);
+    QCOMPARE(parallelNext, serialNext);
+    QCOMPARE(parallelSearches, serialSearches);
+
+    qDeleteAll(jobs);
+}
+
+QTEST_MAIN(TestSchedulerBenchmark)
@@ -14,10 +14,13 @@
 #include "ekos/scheduler/greedyscheduler.h"
 #include "ekos/scheduler/schedulerjob.h"
 #include "ekos/scheduler/schedulermodulestate.h"
+#include "ekos/scheduler/visibilitytimeline.h"
 #include "indi/indiproperty.h"
 #include "ekos/capture/sequencejob.h"
 #include "ekos/capture/placeholderpath.h"
 #include "geolocation.h"
+#include "ksnumbers.h"
+#include "skyobject.h"
 #include "Options.h"
 
 #include <QtGlobal>
@@ -26,6 +29,7 @@
 #else
 #include <QTest>
 #endif
+#include <cmath>
 #include <memory>
 
 #include <QObject>
@@ -51,6 +55,7 @@ class TestSchedulerUnit : public QObject
         void loadSequenceQueueTest();
         void estimateJobTimeTest();
         void evaluateJobsTest();
+        void visibilityTimelineTest();
 
     private:
         void runSetupJob(Ekos::SchedulerJob &job,
@@ -625,4 +630,53 @@ void TestSchedulerUnit::evaluateJobsTest()
     jobs.clear();
 }
 
+// Test VisibilityTimeline::sample(). The interpolated positions should be those the scheduler computed
+// minute by minute before, to well within the resolution of the altitude constraints.
+void TestSchedulerUnit::visibilityTimelineTest()
+{
+    Ekos::VisibilityTimeline timeline;
+    const SkyPoint target(midnightRA, testDEC);
+
+    // One altitude per hour from noon to noon, as precomputed above
+    for (int hour = 0; hour < svAltitudes.size(); hour++)
+    {
+        const KStarsDateTime lt = midNight.addSecs((hour - 12) * 3600);
+        const auto sample = timeline.sample(target, &siliconValley, nullptr, siliconValley.LTtoUT(lt));
+        QVERIFY2(compareFloat(sample.altitude, svAltitudes[hour], 0.02),
+                 qPrintable(QString("hour %1: %2 vs %3").arg(hour).arg(sample.altitude).arg(svAltitudes[hour])));
+        QVERIFY(compareFloat(sample.moonAltitude, -90) && compareFloat(sample.moonSeparation, 180));
+    }
+
+    // Between the samples of the timeline, over several days, against precessing the target each time
+    SkyObject o;
+    o.setRA0(target.ra0());
+    o.setDec0(target.dec0());
+    for (int minutes = 0; minutes < 3 * 24 * 60; minutes += 97)
+    {
+        const KStarsDateTime ut = siliconValley.LTtoUT(midNight.addSecs(minutes * 60 + 17));
+        KSNumbers numbers(ut.djd());
+        o.updateCoordsNow(&numbers);
+        const CachingDms LST = siliconValley.GSTtoLST(ut.gst());
+        o.EquatorialToHorizontal(&LST, siliconValley.lat());
+
+        // The target passes a few arcseconds from the zenith at midnight, where the altitude turns within
+        // a minute, elsewhere the difference is a fraction of an arcsecond
+        const auto sample = timeline.sample(target, &siliconValley, nullptr, ut);
+        QVERIFY2(compareFloat(sample.altitude, o.alt().Degrees(), 0.02),
+                 qPrintable(QString("minute %1: altitude %2 vs %3").arg(minutes).arg(sample.altitude).arg(o.alt().Degrees())));
+        if (o.alt().Degrees() > 85)
+            continue;
+        QVERIFY(compareFloat(sample.altitude, o.alt().Degrees(), 0.001));
+        const double dAz = std::remainder(sample.azimuth - o.az().Degrees(), 360.0) * std::cos(o.alt().radians());
+        QVERIFY2(std::abs(dAz) < 0.001, qPrintable(QString("minute %1: azimuth %2 vs %3").arg(minutes)
+                 .arg(sample.azimuth).arg(o.az().Degrees())));
+    }
+
+    // Another target doesn't get the positions of the first one
+    const SkyPoint other(dms(10.0), dms(-20.0));
+    const KStarsDateTime ut = siliconValley.LTtoUT(midNight);
+    QVERIFY(!compareFloat(timeline.sample(other, &siliconValley, nullptr, ut).altitude,
+                          timeline.sample(target, &siliconValley, nullptr, ut).altitude, 1.0));
+}
+
 QTEST_GUILESS_MAIN(TestSchedulerUnit)
@@ -0,0 +1,219 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QtGlobal>
+#include <QTest>
+
+#include "fitsviewer/fitsdrizzle.h"
+
+#include "opencv2/imgproc.hpp"
+
+#include <cmath>
+
+// Checks the drizzle kernel conserves flux and geometry, including across the parallel row bands
+class TestDrizzle : public QObject
+{
+        Q_OBJECT
+
+    private:
+        static cv::Mat makeWarp(const double dx, const double dy, const double angleDeg);
+
+    private Q_SLOTS:
+        void testFlat_data();
+        void testFlat();
+        void testPointSource_data();
+        void testPointSource();
+        void testWeightTotal_data();
+        void testWeightTotal();
+        void testInvalid();
+};
+
+static constexpr int WIDTH = 64;
+static constexpr int HEIGHT = 48;
+
+// Rotation about the centre of the sub followed by a shift, as the 3x3 warps of FITSStack
+cv::Mat TestDrizzle::makeWarp(const double dx, const double dy, const double angleDeg)
+{
+    const double a = angleDeg * M_PI / 180.0;
+    const double cx = WIDTH / 2.0, cy = HEIGHT / 2.0;
+    cv::Mat warp = cv::Mat::eye(3, 3, CV_64F);
+    warp.at<double>(0, 0) = std::cos(a);
+    warp.at<double>(0, 1) = -std::sin(a);
+    warp.at<double>(1, 0) = std::sin(a);
+    warp.at<double>(1, 1) = std::cos(a);
+    warp.at<double>(0, 2) = cx - std::cos(a) * cx + std::sin(a) * cy + dx;
+    warp.at<double>(1, 2) = cy - std::sin(a) * cx - std::cos(a) * cy + dy;
+    return warp;
+}
+
+void TestDrizzle::testFlat_data()
+{
+    QTest::addColumn<int>("channels");
+    QTest::addColumn<double>("scale");
+    QTest::addColumn<double>("pixFrac");
+
+    QTest::newRow("mono 2x 0.7") << 1 << 2.0 << 0.7;
+    QTest::newRow("mono 1.5x 1.0") << 1 << 1.5 << 1.0;
+    QTest::newRow("rgb 3x 0.9") << 3 << 3.0 << 0.9;
+}
+
+void TestDrizzle::testFlat()
+{
+    QFETCH(int, channels);
+    QFETCH(double, scale);
+    QFETCH(double, pixFrac);
+
+    // A flat field stays flat wherever there is data, whatever the dither
+    const cv::Scalar value(0.25, 0.5, 0.75);
+    const cv::Mat sub(HEIGHT, WIDTH, CV_32FC(channels), value);
+
+    FITSDrizzle drizzle;
+    QVERIFY(drizzle.init(WIDTH, HEIGHT, channels, scale, pixFrac));
+    QCOMPARE(drizzle.outputSize(), cv::Size(std::lround(WIDTH * scale), std::lround(HEIGHT * scale)));
+
+    const double shifts[][3] = { { 0.0, 0.0, 0.0 }, { 0.5, -0.25, 0.3 }, { -1.3, 0.7, -0.5 }, { 2.1, 1.9, 0.1 } };
+    for (const auto &shift : shifts)
+        QVERIFY(drizzle.add(sub, makeWarp(shift[0], shift[1], shift[2]), 1.0f));
+    QCOMPARE(drizzle.count(), 4);
+
+    const cv::Mat result = drizzle.result();
+    const cv::Mat &weight = drizzle.weightMap();
+    int covered = 0;
+    for (int y = 0; y < result.rows; y++)
+    {
+        for (int x = 0; x < result.cols; x++)
+        {
+            if (weight.at<float>(y, x) <= 0.0f)
+                continue;
+            covered++;
+            for (int c = 0; c < channels; c++)
+                QVERIFY2(std::fabs(result.ptr<float>(y)[x * channels + c] - value[c]) < 1e-5,
+                         qPrintable(QString("pixel %1,%2 = %3").arg(x).arg(y).arg(result.ptr<float>(y)[x * channels + c])));
+        }
+    }
+    // Dithered subs with these drop sizes leave no holes in the middle of the stack
+    QVERIFY(covered > 0.8 * result.total());
+    for (int y = result.rows / 4; y < 3 * result.rows / 4; y++)
+        for (int x = result.cols / 4; x < 3 * result.cols / 4; x++)
+            QVERIFY(weight.at<float>(y, x) > 0.0f);
+}
+
+void TestDrizzle::testPointSource_data()
+{
+    QTest::addColumn<double>("scale");
+    QTest::addColumn<double>("dx");
+    QTest::addColumn<double>("dy");
+
+    QTest::newRow("2x aligned") << 2.0 << 0.0 << 0.0;
+    QTest::newRow("2x shifted") << 2.0 << 3.25 << -1.5;
+    QTest::newRow("3x shifted") << 3.0 << -2.4 << 4.6;
+}
+
+void TestDrizzle::testPointSource()
+{
+    QFETCH(double, scale);
+    QFETCH(double, dx);
+    QFETCH(double, dy);
+
+    // A single hot pixel lands centred on its warped position on the finer grid
+    const int px = 20, py = 17;
+    cv::Mat sub = cv::Mat::zeros(HEIGHT, WIDTH, CV_32F);
+    sub.at<float>(py, px) = 100.0f;
+
+    FITSDrizzle drizzle;
+    QVERIFY(drizzle.init(WIDTH, HEIGHT, 1, scale, 0.6));
+    QVERIFY(drizzle.add(sub, makeWarp(dx, dy, 0.0), 1.0f));
+
+    // The weighted sum is the flux dropped on each output pixel
+    cv::Mat flux;
+    cv::multiply(drizzle.result(), drizzle.weightMap(), flux);
+    const cv::Moments m = cv::moments(flux);
+    QVERIFY(m.m00 > 0.0);
+
+    const double expectedX = scale * (px + dx + 0.5) - 0.5;
+    const double expectedY = scale * (py + dy + 0.5) - 0.5;
+    QVERIFY2(std::fabs(m.m10 / m.m00 - expectedX) < 1e-3, qPrintable(QString::number(m.m10 / m.m00)));
+    QVERIFY2(std::fabs(m.m01 / m.m00 - expectedY) < 1e-3, qPrintable(QString::number(m.m01 / m.m00)));
+
+    // Total flux is the pixel value times the drop area
+    const double side = 0.6 * scale;
+    QVERIFY(std::fabs(m.m00 - 100.0 * side * side) < 1e-3 * m.m00);
+}
+
+void TestDrizzle::testWeightTotal_data()
+{
+    QTest::addColumn<double>("angle");
+    QTest::addColumn<float>("weight");
+
+    QTest::newRow("shift") << 0.0 << 1.0f;
+    QTest::newRow("rotated") << 2.0 << 1.0f;
+    QTest::newRow("rotated weighted") << -7.5 << 0.5f;
+}
+
+void TestDrizzle::testWeightTotal()
+{
+    QFETCH(double, angle);
+    QFETCH(float, weight);
+
+    // The weight map must hold every drop exactly once, clipped to the output grid. This catches drops
+    // lost or counted twice where they straddle the row bands processed in parallel.
+    const double scale = 2.0, pixFrac = 0.8;
+    const cv::Mat warp = makeWarp(1.7, -0.6, angle);
+    const cv::Mat sub(HEIGHT, WIDTH, CV_32F, cv::Scalar(1.0));
+
+    FITSDrizzle drizzle;
+    QVERIFY(drizzle.init(WIDTH, HEIGHT, 1, scale, pixFrac));
+    QVERIFY(drizzle.add(sub, warp, weight));
+    QCOMPARE(drizzle.totalWeight(), weight);
+
+    const cv::Size size = drizzle.outputSize();
+    const double h = 0.5 * pixFrac * scale;
+    double expected = 0.0;
+    for (int y = 0; y < HEIGHT; y++)
+    {
+        for (int x = 0; x < WIDTH; x++)
+        {
+            const double mx = warp.at<double>(0, 0) * x + warp.at<double>(0, 1) * y + warp.at<double>(0, 2);
+            const double my = warp.at<double>(1, 0) * x + warp.at<double>(1, 1) * y + warp.at<double>(1, 2);
+            const double ox = scale * (mx + 0.5) - 0.5, oy = scale * (my + 0.5) - 0.5;
+            const double wx = std::min(ox + h, size.width - 0.5) - std::max(ox - h, -0.5);
+            const double wy = std::min(oy + h, size.height - 0.5) - std::max(oy - h, -0.5);
+            if (wx > 0.0 && wy > 0.0)
+                expected += weight * wx * wy;
+        }
+    }
+    const double total = cv::sum(drizzle.weightMap())[0];
+    QVERIFY2(std::fabs(total - expected) < 1e-4 * expected, qPrintable(QString("%1 != %2").arg(total).arg(expected)));
+}
+
+void TestDrizzle::testInvalid()
+{
+    FITSDrizzle drizzle;
+    QVERIFY(!drizzle.init(WIDTH, HEIGHT, 2, 2.0, 0.7));
+    QVERIFY(!drizzle.init(WIDTH, HEIGHT, 1, 0.5, 0.7));
+    QVERIFY(!drizzle.init(WIDTH, HEIGHT, 1, 2.0, 0.0));
+    QVERIFY(!drizzle.isInitialised());
+    QVERIFY(!drizzle.add(cv::Mat::ones(HEIGHT, WIDTH, CV_32F), cv::Mat(), 1.0f));
+
+    QVERIFY(drizzle.init(WIDTH, HEIGHT, 1, 2.0, 0.7));
+    // Wrong geometry, type or weight
+    QVERIFY(!drizzle.add(cv::Mat::ones(HEIGHT / 2, WIDTH, CV_32F), cv::Mat(), 1.0f));
+    QVERIFY(!drizzle.add(cv::Mat::ones(HEIGHT, WIDTH, CV_32FC3), cv::Mat(), 1.0f));
+    QVERIFY(!drizzle.add(cv::Mat::ones(HEIGHT, WIDTH, CV_32F), cv::Mat(), 0.0f));
+    QCOMPARE(drizzle.count(), 0);
+
+    // Empty warp is the identity
+    QVERIFY(drizzle.add(cv::Mat::ones(HEIGHT, WIDTH, CV_32F), cv::Mat(), 1.0f));
+    QCOMPARE(drizzle.count(), 1);
+
+    drizzle.reset();
+    QVERIFY(!drizzle.isInitialised());
+    QVERIFY(drizzle.result().empty());
+}
+
+QTEST_GUILESS_MAIN(TestDrizzle)
+
+#include "testdrizzle.moc"
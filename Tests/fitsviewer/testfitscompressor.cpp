@@ -0,0 +1,207 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QtGlobal>
+#include <QTest>
+#include <QFile>
+#include <QFileInfo>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+
+#include "fitsviewer/fitscompressor.h"
+
+#include <vector>
+
+// Compresses FITS frames of each data type with FITSCompressor and reads them back with CFITSIO,
+// which must give the same pixels and header keys
+class TestFITSCompressor : public QObject
+{
+        Q_OBJECT
+
+    private:
+        static std::vector<double> makePixels(int bitpix, size_t count, quint32 seed);
+        static bool writeFITS(const QString &filename, int bitpix, int planes, const std::vector<double> &pixels);
+
+    private Q_SLOTS:
+        void testRoundTrip_data();
+        void testRoundTrip();
+        void testInvalidInput();
+};
+
+// Odd sizes, so that the last HCOMPRESS tile has fewer rows than the others
+static constexpr long WIDTH = 101;
+static constexpr long HEIGHT = 67;
+
+static const QString OBJECT = "M 42";
+static constexpr double EXPTIME = 120.5;
+static constexpr int GAIN = 139;
+
+// Random values over the whole range of the data type
+std::vector<double> TestFITSCompressor::makePixels(int bitpix, size_t count, quint32 seed)
+{
+    QRandomGenerator rng(seed);
+    std::vector<double> pixels(count);
+    for (double &pixel : pixels)
+    {
+        switch (bitpix)
+        {
+            case BYTE_IMG:
+                pixel = rng.bounded(256);
+                break;
+            case SHORT_IMG:
+                pixel = static_cast<int>(rng.bounded(65536)) - 32768;
+                break;
+            case USHORT_IMG:
+                pixel = rng.bounded(65536);
+                break;
+            case LONG_IMG:
+                pixel = static_cast<qint32>(rng.generate());
+                break;
+            default:
+                pixel = static_cast<float>(1000.0 * rng.generateDouble() - 100.0);
+                break;
+        }
+    }
+    return pixels;
+}
+
+bool TestFITSCompressor::writeFITS(const QString &filename, int bitpix, int planes, const std::vector<double> &pixels)
+{
+    fitsfile *fptr = nullptr;
+    int status = 0;
+    long naxes[3] = { WIDTH, HEIGHT, planes };
+    QByteArray object = OBJECT.toLatin1();
+    double exptime = EXPTIME;
+    int gain = GAIN;
+
+    fits_create_diskfile(&fptr, QFile::encodeName(filename).constData(), &status);
+    fits_create_img(fptr, bitpix, planes > 1 ? 3 : 2, naxes, &status);
+    fits_write_key(fptr, TSTRING, "OBJECT", object.data(), "Object name", &status);
+    fits_write_key(fptr, TDOUBLE, "EXPTIME", &exptime, "Total Exposure Time (s)", &status);
+    fits_write_key(fptr, TINT, "GAIN", &gain, "Gain", &status);
+    fits_write_img(fptr, TDOUBLE, 1, static_cast<LONGLONG>(pixels.size()), const_cast<double *>(pixels.data()),
+                   &status);
+    fits_close_file(fptr, &status);
+    return status == 0;
+}
+
+void TestFITSCompressor::testRoundTrip_data()
+{
+    QTest::addColumn<int>("bitpix");
+    QTest::addColumn<int>("planes");
+    QTest::addColumn<int>("method");
+
+    QTest::newRow("byte rice") << static_cast<int>(BYTE_IMG) << 1 << static_cast<int>(FITSCompressor::RICE);
+    QTest::newRow("short rice") << static_cast<int>(SHORT_IMG) << 1 << static_cast<int>(FITSCompressor::RICE);
+    QTest::newRow("ushort rice") << static_cast<int>(USHORT_IMG) << 1 << static_cast<int>(FITSCompressor::RICE);
+    QTest::newRow("long rice") << static_cast<int>(LONG_IMG) << 1 << static_cast<int>(FITSCompressor::RICE);
+    QTest::newRow("byte hcompress") << static_cast<int>(BYTE_IMG) << 1 << static_cast<int>(FITSCompressor::HCOMPRESS);
+    QTest::newRow("ushort hcompress") << static_cast<int>(USHORT_IMG) << 1
+                                      << static_cast<int>(FITSCompressor::HCOMPRESS);
+    // HCOMPRESS isn't used for 32-bit data, which falls back to Rice
+    QTest::newRow("long hcompress") << static_cast<int>(LONG_IMG) << 1 << static_cast<int>(FITSCompressor::HCOMPRESS);
+    QTest::newRow("ushort rgb") << static_cast<int>(USHORT_IMG) << 3 << static_cast<int>(FITSCompressor::RICE);
+    // Floating point data is compressed by CFITSIO with GZIP_2, unquantised
+    QTest::newRow("float") << static_cast<int>(FLOAT_IMG) << 1 << static_cast<int>(FITSCompressor::RICE);
+}
+
+void TestFITSCompressor::testRoundTrip()
+{
+    QFETCH(int, bitpix);
+    QFETCH(int, planes);
+    QFETCH(int, method);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString input = dir.filePath("frame.fits");
+    const QString output = dir.filePath("frame.fits.fz");
+
+    const std::vector<double> pixels = makePixels(bitpix, WIDTH * HEIGHT * planes, 1);
+    QVERIFY(writeFITS(input, bitpix, planes, pixels));
+
+    QFile file(input);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray buffer = file.readAll();
+    file.close();
+
+    QVERIFY(FITSCompressor::canCompress(buffer.constData(), buffer.size()));
+    const FITSCompressor::Result result = FITSCompressor::compress(buffer.constData(), buffer.size(), output,
+                                          static_cast<FITSCompressor::Method>(method));
+    QVERIFY2(result.success, qPrintable(result.error));
+    QCOMPARE(result.inputSize, static_cast<qint64>(buffer.size()));
+    QCOMPARE(result.outputSize, QFileInfo(output).size());
+
+    // The compressed image is in the first extension, which CFITSIO reads as a plain image
+    fitsfile *fptr = nullptr;
+    int status = 0;
+    QVERIFY(!fits_open_image(&fptr, QFile::encodeName(output).constData(), READONLY, &status));
+    QVERIFY(fits_is_compressed_image(fptr, &status));
+
+    int equivalentBitpix = 0, naxis = 0;
+    long naxes[3] = { 0, 0, 0 };
+    fits_get_img_equivtype(fptr, &equivalentBitpix, &status);
+    fits_get_img_dim(fptr, &naxis, &status);
+    fits_get_img_size(fptr, 3, naxes, &status);
+    QCOMPARE(status, 0);
+    QCOMPARE(equivalentBitpix, bitpix);
+    QCOMPARE(naxis, planes > 1 ? 3 : 2);
+    QCOMPARE(naxes[0], WIDTH);
+    QCOMPARE(naxes[1], HEIGHT);
+    if (planes > 1)
+        QCOMPARE(naxes[2], static_cast<long>(planes));
+
+    std::vector<double> decompressed(pixels.size(), -1);
+    int anyNull = 0;
+    fits_read_img(fptr, TDOUBLE, 1, static_cast<LONGLONG>(decompressed.size()), nullptr, decompressed.data(), &anyNull,
+                  &status);
+    QCOMPARE(status, 0);
+    for (size_t i = 0; i < pixels.size(); i++)
+        QVERIFY2(decompressed[i] == pixels[i], qPrintable(QString("pixel %1: %2 instead of %3").arg(i)
+                 .arg(decompressed[i]).arg(pixels[i])));
+
+    char object[FLEN_VALUE] = {0};
+    double exptime = 0;
+    int gain = 0;
+    fits_read_key(fptr, TSTRING, "OBJECT", object, nullptr, &status);
+    fits_read_key(fptr, TDOUBLE, "EXPTIME", &exptime, nullptr, &status);
+    fits_read_key(fptr, TINT, "GAIN", &gain, nullptr, &status);
+    QCOMPARE(status, 0);
+    QCOMPARE(QString(object), OBJECT);
+    QCOMPARE(exptime, EXPTIME);
+    QCOMPARE(gain, GAIN);
+
+    fits_close_file(fptr, &status);
+}
+
+void TestFITSCompressor::testInvalidInput()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString output = dir.filePath("frame.fits.fz");
+
+    // Not a FITS file: the compression fails, and leaves no file behind
+    const QByteArray buffer(2880, 'x');
+    QVERIFY(!FITSCompressor::canCompress(buffer.constData(), buffer.size()));
+    const FITSCompressor::Result result = FITSCompressor::compress(buffer.constData(), buffer.size(), output,
+                                          FITSCompressor::RICE);
+    QVERIFY(!result.success);
+    QVERIFY(!result.error.isEmpty());
+    QVERIFY(!QFile::exists(output));
+
+    // A FITS file missing some of its pixels is not compressed either
+    const QString input = dir.filePath("frame.fits");
+    QVERIFY(writeFITS(input, USHORT_IMG, 1, makePixels(USHORT_IMG, WIDTH * HEIGHT, 2)));
+    QFile file(input);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray complete = file.read(file.size());
+    file.close();
+    QVERIFY(FITSCompressor::canCompress(complete.constData(), complete.size()));
+    QVERIFY(!FITSCompressor::canCompress(complete.constData(), complete.size() - 2880));
+}
+
+QTEST_GUILESS_MAIN(TestFITSCompressor)
+
+#include "testfitscompressor.moc"
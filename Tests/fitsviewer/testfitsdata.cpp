@@ -14,6 +14,7 @@
 #include <QDir>
 #include <QFileInfo>
 #include <QTemporaryDir>
+#include <QTimeZone>
 #include "testfitsdata.h"
 #include "Options.h"
 #include "ekos/auxiliary/solverutils.h"
@@ -366,6 +367,230 @@ void TestFitsData::testLoadCompressedFits()
 #endif
 }
 
+void TestFitsData::testLoadMappedFits_data()
+{
+#if QT_VERSION < 0x050900
+    QSKIP("Skipping fixture-based test on old QT version.");
+#else
+    // Either a fixture, or a BITPIX to generate an image with
+    QTest::addColumn<QString>("NAME");
+    QTest::addColumn<int>("BITPIX");
+    QTest::newRow("M47-USHORT") << "m47_sim_stars.fits" << 0;
+    QTest::newRow("BAHTINOV-BYTE") << "bahtinov-focus.fits" << 0;
+    QTest::newRow("FLOAT") << QString() << FLOAT_IMG;
+    QTest::newRow("DOUBLE") << QString() << DOUBLE_IMG;
+    QTest::newRow("LONGLONG") << QString() << LONGLONG_IMG;
+    // Signed without BZERO, read by CFITSIO
+    QTest::newRow("SHORT") << QString() << SHORT_IMG;
+#endif
+}
+
+// Files on disk are memory mapped where possible, buffers are always read with CFITSIO. Both must give the same image.
+void TestFitsData::testLoadMappedFits()
+{
+#if QT_VERSION < 0x050900
+    QSKIP("Skipping fixture-based test on old QT version.");
+#else
+    QFETCH(QString, NAME);
+    QFETCH(int, BITPIX);
+
+    // Not in the temporary location, files there are never mapped
+    QTemporaryDir dir(QDir::current().filePath("mappedXXXXXX"));
+    QVERIFY(dir.isValid());
+    if (NAME.isEmpty())
+    {
+        NAME = dir.filePath("generated.fits");
+        fitsfile *fptr = nullptr;
+        int status = 0;
+        long naxes[2] = { 301, 200 };
+        std::vector<double> pixels(naxes[0] * naxes[1]);
+        for (size_t i = 0; i < pixels.size(); i++)
+            pixels[i] = (i * 7919) % 60000 / (BITPIX < 0 ? 3.0 : 1.0);
+        fits_create_diskfile(&fptr, QFile::encodeName(NAME).constData(), &status);
+        fits_create_img(fptr, BITPIX, 2, naxes, &status);
+        fits_write_img(fptr, TDOUBLE, 1, pixels.size(), pixels.data(), &status);
+        fits_close_file(fptr, &status);
+        QCOMPARE(status, 0);
+    }
+    else if (!QFile::exists(NAME))
+        QSKIP("Skipping mapped load test because of missing fixture");
+
+    std::unique_ptr<FITSData> mapped(new FITSData(FITS_NORMAL));
+    QFuture<bool> worker = mapped->loadFromFile(NAME);
+    QTRY_VERIFY_WITH_TIMEOUT(worker.isFinished(), 10000);
+    QVERIFY2(worker.result(), qPrintable(mapped->getLastError()));
+
+    QFile file(NAME);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    std::unique_ptr<FITSData> read(new FITSData(FITS_NORMAL));
+    read->setExtension("fits");
+    QVERIFY2(read->loadFromBuffer(file.readAll()), qPrintable(read->getLastError()));
+
+    QCOMPARE(mapped->width(), read->width());
+    QCOMPARE(mapped->height(), read->height());
+    QCOMPARE(mapped->channels(), read->channels());
+    QCOMPARE(mapped->dataType(), read->dataType());
+    const size_t size = static_cast<size_t>(read->samplesPerChannel()) * read->channels() * read->getBytesPerPixel();
+    QVERIFY(memcmp(mapped->getImageBuffer(), read->getImageBuffer(), size) == 0);
+    QCOMPARE(mapped->getMean(), read->getMean());
+
+    // Changes to the image, e.g. by filters, must never reach the file
+    QVERIFY(file.seek(0));
+    const QByteArray before = file.readAll();
+    memset(mapped->getWritableImageBuffer(), 0xA5, size);
+    QVERIFY(file.seek(0));
+    QCOMPARE(file.readAll(), before);
+#endif
+}
+
+void TestFitsData::testMappedFileTruncated_data()
+{
+    QTest::addColumn<int>("BITPIX");
+    QTest::newRow("BYTE") << static_cast<int>(BYTE_IMG);
+    QTest::newRow("USHORT") << static_cast<int>(USHORT_IMG);
+    QTest::newRow("FLOAT") << static_cast<int>(FLOAT_IMG);
+}
+
+// A loaded image must not depend on its file, which a capture may rewrite or the user delete while it is displayed
+void TestFitsData::testMappedFileTruncated()
+{
+    QFETCH(int, BITPIX);
+
+    // Not in the temporary location, files there are never mapped
+    QTemporaryDir dir(QDir::current().filePath("mappedXXXXXX"));
+    QVERIFY(dir.isValid());
+    const QString name = dir.filePath("truncated.fits");
+    fitsfile *fptr = nullptr;
+    int status = 0;
+    long naxes[2] = { 1201, 800 };
+    std::vector<double> pixels(naxes[0] * naxes[1]);
+    for (size_t i = 0; i < pixels.size(); i++)
+        pixels[i] = (i * 7919) % 250;
+    fits_create_diskfile(&fptr, QFile::encodeName(name).constData(), &status);
+    fits_create_img(fptr, BITPIX, 2, naxes, &status);
+    fits_write_img(fptr, TDOUBLE, 1, pixels.size(), pixels.data(), &status);
+    fits_close_file(fptr, &status);
+    QCOMPARE(status, 0);
+
+    std::unique_ptr<FITSData> data(new FITSData(FITS_NORMAL));
+    QFuture<bool> worker = data->loadFromFile(name);
+    QTRY_VERIFY_WITH_TIMEOUT(worker.isFinished(), 10000);
+    QVERIFY2(worker.result(), qPrintable(data->getLastError()));
+    const size_t size = static_cast<size_t>(data->samplesPerChannel()) * data->channels() * data->getBytesPerPixel();
+    const QByteArray loaded(reinterpret_cast<const char *>(data->getImageBuffer()), size);
+    const double mean = data->getMean();
+
+    // Reading the buffer would fault if it were still backed by the truncated file
+    QVERIFY(QFile::resize(name, 0));
+    QCOMPARE(QByteArray(reinterpret_cast<const char *>(data->getImageBuffer()), size), loaded);
+    QVERIFY(QFile::remove(name));
+    QCOMPARE(QByteArray(reinterpret_cast<const char *>(data->getImageBuffer()), size), loaded);
+
+    // And the statistics are still those of the image written
+    data->calculateStats(true);
+    QCOMPARE(data->getMean(), mean);
+}
+
+void TestFitsData::testLoadRawBuffer_data()
+{
+    QTest::addColumn<int>("BITS");
+    QTest::newRow("BYTE") << 8;
+    QTest::newRow("USHORT") << 16;
+}
+
+// Streamed frames are adopted as they are, they must give the same image as the FITS file CFITSIO would write for them.
+void TestFitsData::testLoadRawBuffer()
+{
+    QFETCH(int, BITS);
+
+    const int width = 641, height = 480;
+    const int bytes = BITS / 8;
+    const int samples = width * height;
+    std::vector<uint16_t> values(samples);
+    for (int i = 0; i < samples; i++)
+        values[i] = ((i * 7919) % 60000) >> (16 - BITS);
+
+    std::unique_ptr<uint8_t[]> pixels(new uint8_t[samples * bytes]);
+    for (int i = 0; i < samples; i++)
+    {
+        if (BITS == 16)
+            reinterpret_cast<uint16_t *>(pixels.get())[i] = values[i];
+        else
+            pixels[i] = static_cast<uint8_t>(values[i]);
+    }
+
+    // The same frame as a FITS file in memory, the way streamed frames used to be loaded
+    fitsfile *fptr = nullptr;
+    void *fitsBuffer = nullptr;
+    size_t fitsSize = 0;
+    int status = 0;
+    long naxes[2] = { width, height };
+    double exposure = 0.5;
+    int binning = 2;
+    fits_create_memfile(&fptr, &fitsBuffer, &fitsSize, 4096, realloc, &status);
+    fits_create_img(fptr, BITS == 16 ? USHORT_IMG : BYTE_IMG, 2, naxes, &status);
+    fits_update_key(fptr, TDOUBLE, "EXPTIME", &exposure, "Total Exposure Time (s)", &status);
+    fits_update_key(fptr, TINT, "XBINNING", &binning, "Binning factor in width", &status);
+    fits_update_key(fptr, TINT, "YBINNING", &binning, "Binning factor in height", &status);
+    fits_write_img(fptr, BITS == 16 ? TUSHORT : TBYTE, 1, samples, pixels.get(), &status);
+    fits_close_file(fptr, &status);
+    QCOMPARE(status, 0);
+    const QByteArray fitsData(static_cast<const char *>(fitsBuffer), static_cast<int>(fitsSize));
+    free(fitsBuffer);
+
+    QElapsedTimer timer;
+    timer.start();
+    std::unique_ptr<FITSData> read(new FITSData(FITS_GUIDE));
+    read->setExtension("fits");
+    QVERIFY2(read->loadFromBuffer(fitsData), qPrintable(read->getLastError()));
+    const qint64 readNsecs = timer.nsecsElapsed();
+
+    FITSData::RawFrameInfo info;
+    info.width = width;
+    info.height = height;
+    info.bitsPerPixel = BITS;
+    info.xBinning = binning;
+    info.yBinning = binning;
+    info.exposure = exposure;
+    info.timestamp = QDateTime(QDate(2026, 3, 1), QTime(22, 15, 30, 250), QTimeZone::utc());
+    const uint8_t *adopted = pixels.get();
+    timer.restart();
+    QSharedPointer<FITSData> raw = FITSData::fromRawBuffer(FITS_GUIDE, std::move(pixels), info);
+    const qint64 rawNsecs = timer.nsecsElapsed();
+    QVERIFY(raw);
+    qInfo() << QString("  %1x%2 %3-bit frame: loaded from FITS %4 ms, adopted raw %5 ms")
+            .arg(width).arg(height).arg(BITS).arg(readNsecs / 1e6, 0, 'f', 2).arg(rawNsecs / 1e6, 0, 'f', 2);
+
+    // No copy is made
+    QCOMPARE(raw->getImageBuffer(), adopted);
+
+    QCOMPARE(raw->width(), read->width());
+    QCOMPARE(raw->height(), read->height());
+    QCOMPARE(raw->channels(), read->channels());
+    QCOMPARE(raw->dataType(), read->dataType());
+    QCOMPARE(raw->getBytesPerPixel(), read->getBytesPerPixel());
+    QVERIFY(memcmp(raw->getImageBuffer(), read->getImageBuffer(), samples * bytes) == 0);
+    QCOMPARE(raw->getMin(), read->getMin());
+    QCOMPARE(raw->getMax(), read->getMax());
+    QCOMPARE(raw->getMean(), read->getMean());
+    QCOMPARE(raw->getStdDev(), read->getStdDev());
+    QCOMPARE(raw->getMedian(), read->getMedian());
+
+    for (const QString &key : QStringList{ "BITPIX", "NAXIS", "NAXIS1", "NAXIS2", "EXPTIME", "XBINNING", "YBINNING" })
+    {
+        QVariant rawValue, readValue;
+        QVERIFY2(raw->getRecordValue(key, rawValue), qPrintable(key));
+        QVERIFY2(read->getRecordValue(key, readValue), qPrintable(key));
+        QCOMPARE(rawValue.toDouble(), readValue.toDouble());
+    }
+    QCOMPARE(raw->getDateTime(), KStarsDateTime(info.timestamp.date(), info.timestamp.time()));
+
+    // Nothing to adopt
+    QVERIFY(!FITSData::fromRawBuffer(FITS_GUIDE, nullptr, info));
+    info.bitsPerPixel = 12;
+    QVERIFY(!FITSData::fromRawBuffer(FITS_GUIDE, std::unique_ptr<uint8_t[]>(new uint8_t[samples * 2]), info));
+}
+
 void TestFitsData::testCentroidAlgorithmBenchmark_data()
 {
 #if QT_VERSION < 0x050900
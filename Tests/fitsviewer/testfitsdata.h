@@ -35,6 +35,12 @@ class TestFitsData : public QObject
         void testLoadFits();
         void testLoadCompressedFits_data();
         void testLoadCompressedFits();
+        void testLoadMappedFits_data();
+        void testLoadMappedFits();
+        void testMappedFileTruncated_data();
+        void testMappedFileTruncated();
+        void testLoadRawBuffer_data();
+        void testLoadRawBuffer();
 
         void testCentroidAlgorithmBenchmark_data();
         void testCentroidAlgorithmBenchmark();
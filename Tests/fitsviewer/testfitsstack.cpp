@@ -0,0 +1,212 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QtGlobal>
+#include <QTest>
+#include <QRandomGenerator>
+
+#include "fitsviewer/fitsstack.h"
+#include "fitsviewer/fitsstackspill.h"
+
+#include <cmath>
+#include <vector>
+
+// Checks that sigma clipping the subs band by band from the spill file gives the same stack as
+// sigma clipping them in memory, and that the spill file rejects subs it can't hold
+class TestFITSStack : public QObject
+{
+        Q_OBJECT
+
+    private:
+        static LiveStackData makeParams(const LiveStackStackingMethod method, const bool tiled, const int budgetMB);
+        static std::vector<cv::Mat> makeSubs(const int count, const int channels, const quint32 seed);
+        static void addSubs(FITSStack &stack, const std::vector<cv::Mat> &subs, const bool spill);
+
+    private Q_SLOTS:
+        void testTiledMatchesInMemory_data();
+        void testTiledMatchesInMemory();
+        void testInconsistentSub();
+        void testTiledFailure();
+};
+
+static constexpr int WIDTH = 256;
+static constexpr int HEIGHT = 192;
+static constexpr int SUBS = 10;
+
+LiveStackData TestFITSStack::makeParams(const LiveStackStackingMethod method, const bool tiled, const int budgetMB)
+{
+    LiveStackData params;
+    params.calcSNR = false;
+    params.hotPixels = false;
+    params.coldPixels = false;
+    params.alignMethod = LiveStackAlignMethod::NONE;
+    params.numInMem = SUBS;
+    params.downscale = LiveStackDownscale::NONE;
+    params.weighting = LiveStackFrameWeighting::EQUAL;
+    params.normalization = LiveStackNormalization::NONE;
+    params.stackingMethod = method;
+    params.lowSigma = 2.0;
+    params.highSigma = 2.0;
+    params.windsorCutoff = 1.5;
+    params.iterations = 3;
+    params.kappa = 0.0;
+    params.alpha = 0.0;
+    params.sigma = 0.0;
+    params.PSFUpdate = 0;
+    params.tiledClipping = tiled;
+    params.tiledBudgetMB = budgetMB;
+    params.postProcessing.postProcess = false;
+    return params;
+}
+
+// Noisy background with hot pixels and, in some subs, a bright trail for the clipping to reject
+std::vector<cv::Mat> TestFITSStack::makeSubs(const int count, const int channels, const quint32 seed)
+{
+    QRandomGenerator rng(seed);
+    std::vector<cv::Mat> subs;
+    for (int i = 0; i < count; i++)
+    {
+        cv::Mat sub(HEIGHT, WIDTH, CV_32FC(channels));
+        for (int y = 0; y < HEIGHT; y++)
+        {
+            float *row = sub.ptr<float>(y);
+            for (int x = 0; x < WIDTH * channels; x++)
+            {
+                double value = 0.1 + 0.02 * rng.generateDouble();
+                if (rng.bounded(500) == 0)
+                    value = 0.9;
+                if (i % 3 == 0 && std::abs(x / channels - y - i) < 2)
+                    value = 0.8;
+                row[x] = static_cast<float>(value);
+            }
+        }
+        subs.push_back(sub);
+    }
+    return subs;
+}
+
+// Add the subs as calibrated and aligned, spilling them as FITSStack does for tiled clipping
+void TestFITSStack::addSubs(FITSStack &stack, const std::vector<cv::Mat> &subs, const bool spill)
+{
+    stack.m_Width = subs[0].cols;
+    stack.m_Height = subs[0].rows;
+    stack.m_Channels = subs[0].channels();
+    if (spill)
+    {
+        stack.m_Spill.reset(new FITSStackSpill());
+        QVERIFY(stack.m_Spill->init(subs[0].cols, subs[0].rows, subs[0].channels()));
+    }
+
+    for (const cv::Mat &sub : subs)
+    {
+        FITSStack::StackImageData data;
+        data.wcsprm = nullptr;
+        data.image = sub.clone();
+        data.isCalibrated = data.isCorrected = data.isAligned = true;
+        if (spill)
+        {
+            data.spillIndex = stack.m_Spill->append(data.image);
+            QVERIFY(data.spillIndex >= 0);
+        }
+        stack.m_StackImageData.push_back(data);
+        if (spill)
+            QVERIFY(stack.spillSub(stack.m_StackImageData.size() - 1, true));
+    }
+}
+
+void TestFITSStack::testTiledMatchesInMemory_data()
+{
+    QTest::addColumn<int>("channels");
+    QTest::addColumn<int>("method");
+    QTest::addColumn<int>("budgetMB");
+
+    // Each sub is 192 KB per channel, so a budget of 1 MB needs several bands for 10 subs
+    QTest::newRow("mono sigma one band") << 1 << static_cast<int>(LiveStackStackingMethod::SIGMA) << 512;
+    QTest::newRow("mono sigma bands") << 1 << static_cast<int>(LiveStackStackingMethod::SIGMA) << 1;
+    QTest::newRow("rgb sigma bands") << 3 << static_cast<int>(LiveStackStackingMethod::SIGMA) << 1;
+    QTest::newRow("mono windsor bands") << 1 << static_cast<int>(LiveStackStackingMethod::WINDSOR) << 1;
+    QTest::newRow("rgb windsor bands") << 3 << static_cast<int>(LiveStackStackingMethod::WINDSOR) << 1;
+}
+
+void TestFITSStack::testTiledMatchesInMemory()
+{
+    QFETCH(int, channels);
+    QFETCH(int, method);
+    QFETCH(int, budgetMB);
+
+    const std::vector<cv::Mat> subs = makeSubs(SUBS, channels, 3);
+    const auto stackingMethod = static_cast<LiveStackStackingMethod>(method);
+
+    FITSStack inMemory(nullptr, LiveStackChannel::SINGLE, makeParams(stackingMethod, false, budgetMB));
+    addSubs(inMemory, subs, false);
+    const cv::Mat expected = inMemory.stackSubsSigmaClipping(inMemory.getWeights());
+    QVERIFY(!expected.empty());
+
+    FITSStack tiled(nullptr, LiveStackChannel::SINGLE, makeParams(stackingMethod, true, budgetMB));
+    addSubs(tiled, subs, true);
+    for (const auto &data : tiled.m_StackImageData)
+        QVERIFY(data.isSpilled && data.image.empty());
+    const cv::Mat actual = tiled.stackSubsSigmaClippingTiled(true, tiled.getWeights());
+    QVERIFY(!actual.empty());
+
+    QCOMPARE(actual.size(), expected.size());
+    QCOMPARE(actual.type(), expected.type());
+    QCOMPARE(cv::norm(actual, expected, cv::NORM_INF), 0.0);
+
+    // The clipping state is carried over to incremental stacks so must match too
+    QCOMPARE(tiled.m_SigmaClip32FC4.size(), inMemory.m_SigmaClip32FC4.size());
+    for (int ch = 0; ch < channels; ch++)
+        QCOMPARE(cv::norm(tiled.m_SigmaClip32FC4[ch], inMemory.m_SigmaClip32FC4[ch], cv::NORM_INF), 0.0);
+}
+
+void TestFITSStack::testInconsistentSub()
+{
+    FITSStack stack(nullptr, LiveStackChannel::SINGLE, makeParams(LiveStackStackingMethod::SIGMA, true, 512));
+    addSubs(stack, makeSubs(2, 1, 5), true);
+
+    // A sub of another size, or with another number of channels, can't go in the spill file
+    for (const cv::Mat &sub : { cv::Mat(HEIGHT, WIDTH / 2, CV_32FC1, cv::Scalar(0.1)),
+                                cv::Mat(HEIGHT, WIDTH, CV_32FC3, cv::Scalar(0.1, 0.1, 0.1))
+                              })
+    {
+        QVERIFY(!stack.m_Spill->matches(sub));
+        QCOMPARE(stack.m_Spill->append(sub), -1);
+
+        FITSStack::StackImageData data;
+        data.wcsprm = nullptr;
+        data.image = sub;
+        data.spillIndex = 0;
+        stack.m_StackImageData.push_back(data);
+        QVERIFY(!stack.spillSub(stack.m_StackImageData.size() - 1, true));
+        QVERIFY(!stack.m_StackImageData.last().isSpilled);
+        stack.m_StackImageData.removeLast();
+    }
+    QCOMPARE(stack.m_Spill->size(), 2);
+}
+
+void TestFITSStack::testTiledFailure()
+{
+    FITSStack stack(nullptr, LiveStackChannel::SINGLE, makeParams(LiveStackStackingMethod::SIGMA, true, 512));
+    addSubs(stack, makeSubs(3, 1, 7), true);
+
+    // A sub missing from the spill file makes tiled clipping fail, which stackSubs must report
+    stack.m_StackImageData[1].isSpilled = false;
+    float totalWeight = 0.0f;
+    cv::Mat hitMap, initialStack;
+    QVERIFY(!stack.stackSubs(true, totalWeight, hitMap, initialStack));
+    QVERIFY(initialStack.empty());
+
+    // An incremental stack fails without losing the existing stack
+    const cv::Mat existing(HEIGHT, WIDTH, CV_32FC1, cv::Scalar(0.25));
+    cv::Mat runningStack = existing.clone();
+    QVERIFY(!stack.stackSubs(false, totalWeight, hitMap, runningStack));
+    QCOMPARE(runningStack.size(), existing.size());
+    QCOMPARE(cv::norm(runningStack, existing, cv::NORM_INF), 0.0);
+}
+
+QTEST_GUILESS_MAIN(TestFITSStack)
+
+#include "testfitsstack.moc"
@@ -0,0 +1,181 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QtGlobal>
+#include <QTest>
+#include <QElapsedTimer>
+#include <QFile>
+
+#include "Options.h"
+#include "ekos/auxiliary/stellarsolverprofile.h"
+#include "fitsviewer/fitsdata.h"
+#include "fitsviewer/fitssepdetector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+// Compares the full frame SEP extraction with the tiled extraction on the m47 fixture: the time
+// taken, and that both find the same stars with the same HFRs, including the stars on tile seams.
+class TestSEPBenchmark : public QObject
+{
+        Q_OBJECT
+
+    private:
+        struct Result
+        {
+            QList<QPointF> centres;
+            QList<double> hfrs;
+            int detected { 0 };
+            double hfr { 0 };
+            qint64 msecs { 0 };
+        };
+        Result extract(const bool tiled, const int tileSize);
+
+    private Q_SLOTS:
+        void initTestCase();
+        void testMakeTiles_data();
+        void testMakeTiles();
+        void benchmarkTiled_data();
+        void benchmarkTiled();
+
+    private:
+        std::unique_ptr<FITSData> m_Data;
+};
+
+static const QString NAME = "m47_sim_stars.fits";
+static constexpr int ITERATIONS = 3;
+
+void TestSEPBenchmark::initTestCase()
+{
+    if (!QFile::exists(NAME))
+        QSKIP("Skipping benchmark because of missing fixture");
+
+    m_Data.reset(new FITSData());
+    QFuture<bool> worker = m_Data->loadFromFile(NAME);
+    QTRY_VERIFY_WITH_TIMEOUT(worker.isFinished(), 10000);
+    QVERIFY(worker.result());
+
+    Options::setStellarSolverPartition(false);
+}
+
+TestSEPBenchmark::Result TestSEPBenchmark::extract(const bool tiled, const int tileSize)
+{
+    // All the stars of the frame, with HFRs, as the HFR measurement of Capture does
+    QVariantMap settings;
+    settings["optionsProfileIndex"] = 0;
+    settings["optionsProfileGroup"] = static_cast<int>(Ekos::HFRProfiles);
+    settings["tiledExtraction"] = tiled;
+    settings["tileSize"] = tileSize;
+    m_Data->setSourceExtractorSettings(settings);
+
+    Result result;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < ITERATIONS; i++)
+        m_Data->findStars(ALGORITHM_SEP).waitForFinished();
+    result.msecs = timer.elapsed() / ITERATIONS;
+
+    for (const auto &star : m_Data->getStarCenters())
+    {
+        result.centres.append(QPointF(star->x, star->y));
+        result.hfrs.append(star->HFR);
+    }
+    result.detected = m_Data->getDetectedStars();
+    result.hfr = m_Data->getHFR();
+    return result;
+}
+
+void TestSEPBenchmark::testMakeTiles_data()
+{
+    QTest::addColumn<QRect>("frame");
+    QTest::addColumn<int>("tileSize");
+    QTest::addColumn<int>("tiles");
+
+    QTest::newRow("m47") << QRect(0, 0, 1280, 1024) << 512 << 6;
+    QTest::newRow("small") << QRect(0, 0, 300, 200) << 1024 << 1;
+    QTest::newRow("subframe") << QRect(100, 50, 3000, 2000) << 1024 << 6;
+    QTest::newRow("full frame") << QRect(0, 0, 9576, 6388) << 1024 << 54;
+}
+
+void TestSEPBenchmark::testMakeTiles()
+{
+    QFETCH(QRect, frame);
+    QFETCH(int, tileSize);
+    QFETCH(int, tiles);
+
+    const int overlap = 64;
+    const auto result = FITSSEPDetector::makeTiles(frame, tileSize, overlap);
+    QCOMPARE(static_cast<int>(result.size()), tiles);
+
+    // The cores cover the frame exactly once and the frames overlap their cores within the frame
+    qint64 area = 0;
+    for (int i = 0; i < result.size(); i++)
+    {
+        const auto &tile = result[i];
+        QVERIFY(frame.contains(tile.frame));
+        QVERIFY(tile.frame.contains(tile.core));
+        QCOMPARE(tile.frame, tile.core.adjusted(-overlap, -overlap, overlap, overlap).intersected(frame));
+        area += static_cast<qint64>(tile.core.width()) * tile.core.height();
+        for (int j = i + 1; j < result.size(); j++)
+            QVERIFY(!tile.core.intersects(result[j].core));
+    }
+    QCOMPARE(area, static_cast<qint64>(frame.width()) * frame.height());
+}
+
+void TestSEPBenchmark::benchmarkTiled_data()
+{
+    QTest::addColumn<int>("tileSize");
+
+    // m47 is 1280x1024 so these are 3x2 and 2x2 tiles
+    QTest::newRow("512") << 512;
+    QTest::newRow("640") << 640;
+}
+
+void TestSEPBenchmark::benchmarkTiled()
+{
+    QFETCH(int, tileSize);
+
+    const Result full = extract(false, tileSize);
+    const Result tiled = extract(true, tileSize);
+    const int fullCount = full.centres.size();
+    const int tiledCount = tiled.centres.size();
+    QVERIFY(fullCount > 50);
+
+    qInfo() << QString("  %1 tiles: full frame %2 stars in %3 ms, tiled %4 stars in %5 ms, speed-up %6x")
+            .arg(FITSSEPDetector::makeTiles(QRect(0, 0, m_Data->width(), m_Data->height()), tileSize, 64).size())
+            .arg(fullCount).arg(full.msecs).arg(tiledCount).arg(tiled.msecs)
+            .arg(tiled.msecs > 0 ? static_cast<double>(full.msecs) / tiled.msecs : 0.0, 0, 'f', 2);
+
+    // SEP's background mesh differs slightly between the frame and the tiles so faint stars at the
+    // detection threshold may come and go, but the stars and their HFRs must otherwise agree.
+    QVERIFY2(std::abs(tiledCount - fullCount) <= std::max(2, fullCount / 50),
+             qPrintable(QString("%1 != %2").arg(tiledCount).arg(fullCount)));
+    QVERIFY(std::abs(tiled.detected - full.detected) <= std::max(2, full.detected / 50));
+
+    int matched = 0, duplicates = 0;
+    for (int i = 0; i < fullCount; i++)
+    {
+        int found = 0;
+        for (int j = 0; j < tiledCount; j++)
+        {
+            const QPointF d = tiled.centres[j] - full.centres[i];
+            if (d.x() * d.x() + d.y() * d.y() > 1.0)
+                continue;
+            if (found++ == 0 && std::fabs(tiled.hfrs[j] - full.hfrs[i]) < 0.05 * full.hfrs[i] + 0.05)
+                matched++;
+        }
+        if (found > 1)
+            duplicates++;
+    }
+    QCOMPARE(duplicates, 0);
+    QVERIFY2(matched >= 0.97 * fullCount, qPrintable(QString("matched %1 of %2").arg(matched).arg(fullCount)));
+    QVERIFY(std::fabs(tiled.hfr - full.hfr) < 0.05 * full.hfr);
+}
+
+QTEST_GUILESS_MAIN(TestSEPBenchmark)
+
+#include "testsepbenchmark.moc"
@@ -0,0 +1,187 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QtGlobal>
+#include <QTest>
+#include <QRandomGenerator>
+
+#include "fitsviewer/fitsstackstatistics.h"
+
+#include <cmath>
+#include <vector>
+
+// Checks the running statistics against a direct two pass calculation over all the subs
+class TestStackStatistics : public QObject
+{
+        Q_OBJECT
+
+    private:
+        static std::vector<cv::Mat> makeSubs(const int count, const int channels, const double sigma, const quint32 seed);
+
+    private Q_SLOTS:
+        void testAgainstDirect_data();
+        void testAgainstDirect();
+        void testCoverage();
+        void testNoiseFallsWithSubs();
+};
+
+static constexpr int WIDTH = 64;
+static constexpr int HEIGHT = 48;
+
+// Flat background of 0.1 plus a brighter centre, with gaussian noise of sigma
+std::vector<cv::Mat> TestStackStatistics::makeSubs(const int count, const int channels, const double sigma,
+        const quint32 seed)
+{
+    QRandomGenerator rng(seed);
+    std::vector<cv::Mat> subs;
+    for (int i = 0; i < count; i++)
+    {
+        cv::Mat sub(HEIGHT, WIDTH, CV_32FC(channels));
+        for (int y = 0; y < HEIGHT; y++)
+        {
+            float *row = sub.ptr<float>(y);
+            for (int x = 0; x < WIDTH * channels; x++)
+            {
+                const bool centre = std::abs(y - HEIGHT / 2) < HEIGHT / 8 && std::abs(x / channels - WIDTH / 2) < WIDTH / 8;
+                // Box-Muller
+                const double u1 = std::max(1e-12, rng.generateDouble());
+                const double u2 = rng.generateDouble();
+                const double gaussian = std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * M_PI * u2);
+                row[x] = static_cast<float>((centre ? 0.5 : 0.1) + sigma * gaussian);
+            }
+        }
+        subs.push_back(sub);
+    }
+    return subs;
+}
+
+void TestStackStatistics::testAgainstDirect_data()
+{
+    QTest::addColumn<int>("channels");
+    QTest::addColumn<bool>("weighted");
+
+    QTest::newRow("mono equal") << 1 << false;
+    QTest::newRow("mono weighted") << 1 << true;
+    QTest::newRow("rgb equal") << 3 << false;
+    QTest::newRow("rgb weighted") << 3 << true;
+}
+
+void TestStackStatistics::testAgainstDirect()
+{
+    QFETCH(int, channels);
+    QFETCH(bool, weighted);
+
+    const int count = 25;
+    const std::vector<cv::Mat> subs = makeSubs(count, channels, 0.01, 7);
+    std::vector<float> weights(count, 1.0f);
+    if (weighted)
+    {
+        for (int i = 0; i < count; i++)
+            weights[i] = 0.5f + (i % 5) * 0.25f;
+    }
+
+    FITSStackStatistics statistics;
+    for (int i = 0; i < count; i++)
+        QVERIFY(statistics.add(subs[i], weights[i]));
+    QCOMPARE(statistics.count(), count);
+
+    double w = 0.0, w2 = 0.0;
+    for (const auto weight : weights)
+    {
+        w += weight;
+        w2 += weight * weight;
+    }
+
+    const cv::Mat variance = statistics.variance();
+    const cv::Mat noise = statistics.noiseMap();
+    for (int y = 0; y < HEIGHT; y += 7)
+    {
+        for (int x = 0; x < WIDTH; x += 5)
+        {
+            double noiseSq = 0.0;
+            for (int c = 0; c < channels; c++)
+            {
+                double mean = 0.0;
+                for (int i = 0; i < count; i++)
+                    mean += weights[i] * subs[i].ptr<float>(y)[x * channels + c];
+                mean /= w;
+                double m2 = 0.0;
+                for (int i = 0; i < count; i++)
+                {
+                    const double d = subs[i].ptr<float>(y)[x * channels + c] - mean;
+                    m2 += weights[i] * d * d;
+                }
+                const double expected = m2 / (w - w2 / w);
+                noiseSq += expected * w2 / (w * w);
+
+                QVERIFY(std::fabs(statistics.mean().ptr<float>(y)[x * channels + c] - mean) < 1e-5);
+                QVERIFY2(std::fabs(variance.ptr<float>(y)[x * channels + c] - expected) < 1e-3 * expected,
+                         qPrintable(QString("variance %1 expected %2").arg(variance.ptr<float>(y)[x * channels + c])
+                                    .arg(expected)));
+            }
+            const double expectedNoise = std::sqrt(noiseSq / channels);
+            QVERIFY(std::fabs(noise.at<float>(y, x) - expectedNoise) < 1e-3 * expectedNoise);
+        }
+    }
+}
+
+void TestStackStatistics::testCoverage()
+{
+    // Pixels outside a sub's aligned area are zero and are not counted
+    std::vector<cv::Mat> subs = makeSubs(3, 1, 0.01, 11);
+    subs[1].colRange(0, WIDTH / 2).setTo(cv::Scalar(0));
+    subs[2].colRange(0, WIDTH / 2).setTo(cv::Scalar(0));
+
+    FITSStackStatistics statistics;
+    for (const auto &sub : subs)
+        QVERIFY(statistics.add(sub, 1.0f));
+
+    const cv::Mat noise = statistics.noiseMap();
+    // Only one sub covers the left half so there is no noise estimate there
+    QCOMPARE(noise.at<float>(HEIGHT / 4, WIDTH / 4), 0.0f);
+    QCOMPARE(statistics.mean().at<float>(HEIGHT / 4, WIDTH / 4), subs[0].at<float>(HEIGHT / 4, WIDTH / 4));
+    QVERIFY(noise.at<float>(HEIGHT / 4, 3 * WIDTH / 4) > 0.0f);
+
+    // A sub of a different size restarts the statistics
+    QVERIFY(statistics.add(cv::Mat::ones(HEIGHT / 2, WIDTH / 2, CV_32F), 1.0f));
+    QCOMPARE(statistics.count(), 1);
+
+    statistics.reset();
+    QVERIFY(statistics.isEmpty());
+    QVERIFY(statistics.noiseMap().empty());
+    QCOMPARE(statistics.summarise().subs, 0);
+}
+
+void TestStackStatistics::testNoiseFallsWithSubs()
+{
+    // The noise of the stack should fall as 1/sqrt(subs) and the SNR rise accordingly
+    const double sigma = 0.02;
+    const std::vector<cv::Mat> subs = makeSubs(64, 1, sigma, 3);
+
+    FITSStackStatistics statistics;
+    FITSStackStatistics::Summary summary16, summary64;
+    for (int i = 0; i < 64; i++)
+    {
+        statistics.add(subs[i], 1.0f);
+        if (i == 15)
+            summary16 = statistics.summarise();
+    }
+    summary64 = statistics.summarise();
+
+    QCOMPARE(summary64.subs, 64);
+    QVERIFY2(std::fabs(summary16.noise - sigma / 4) < 0.2 * sigma / 4, qPrintable(QString::number(summary16.noise)));
+    QVERIFY2(std::fabs(summary64.noise - sigma / 8) < 0.2 * sigma / 8, qPrintable(QString::number(summary64.noise)));
+    QVERIFY(std::fabs(summary64.background - 0.1) < 0.01);
+    QVERIFY(summary64.snr > 1.5 * summary16.snr);
+
+    const QImage image = FITSStackStatistics::noiseImage(statistics.noiseMap(), summary64.noise, 32);
+    QCOMPARE(image.width(), 32);
+    QCOMPARE(image.height(), 24);
+}
+
+QTEST_GUILESS_MAIN(TestStackStatistics)
+
+#include "teststackstatistics.moc"
@@ -0,0 +1,178 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QtGlobal>
+#include <QTest>
+#include <QRandomGenerator>
+
+#include "fitsviewer/fitsstarmatcher.h"
+
+#include <algorithm>
+#include <cmath>
+
+class TestStarMatcher : public QObject
+{
+        Q_OBJECT
+
+    private:
+        struct SimStar
+        {
+            cv::Point2d pos;
+            double flux;
+        };
+
+        static std::vector<SimStar> makeField(const quint32 seed, const int numStars);
+        static std::vector<cv::Point2d> observe(const std::vector<SimStar> &field, const double angleDeg,
+                                                const double dx, const double dy, const double noise,
+                                                const double dropFraction, const int numSpurious,
+                                                const quint32 seed);
+
+    private Q_SLOTS:
+        void testMatch_data();
+        void testMatch();
+        void testTooFewStars();
+        void testUnrelatedField();
+};
+
+static constexpr int WIDTH = 2000;
+static constexpr int HEIGHT = 1500;
+
+std::vector<TestStarMatcher::SimStar> TestStarMatcher::makeField(const quint32 seed, const int numStars)
+{
+    QRandomGenerator rng(seed);
+    std::vector<SimStar> field;
+    for (int i = 0; i < numStars; i++)
+        field.push_back({ cv::Point2d(rng.bounded(double(WIDTH)), rng.bounded(double(HEIGHT))),
+                          std::pow(10.0, rng.bounded(3.0)) });
+    return field;
+}
+
+// Observe the field through a rotation about the image centre plus a translation, with centroid noise,
+// missing stars and spurious detections. Stars are returned brightest first as the detector would.
+std::vector<cv::Point2d> TestStarMatcher::observe(const std::vector<SimStar> &field, const double angleDeg,
+        const double dx, const double dy, const double noise, const double dropFraction,
+        const int numSpurious, const quint32 seed)
+{
+    QRandomGenerator rng(seed);
+    const double angle = angleDeg * M_PI / 180.0;
+    const cv::Point2d centre(WIDTH / 2.0, HEIGHT / 2.0);
+
+    std::vector<SimStar> seen;
+    for (const auto &star : field)
+    {
+        if (rng.bounded(1.0) < dropFraction)
+            continue;
+        const cv::Point2d p = star.pos - centre;
+        const cv::Point2d q(std::cos(angle) * p.x - std::sin(angle) * p.y + centre.x + dx + (rng.bounded(2.0) - 1.0) * noise,
+                            std::sin(angle) * p.x + std::cos(angle) * p.y + centre.y + dy + (rng.bounded(2.0) - 1.0) * noise);
+        if (q.x < 0 || q.y < 0 || q.x >= WIDTH || q.y >= HEIGHT)
+            continue;
+        // Photometric noise so the brightness order is not identical
+        seen.push_back({ q, star.flux * (0.9 + rng.bounded(0.2)) });
+    }
+    for (int i = 0; i < numSpurious; i++)
+        seen.push_back({ cv::Point2d(rng.bounded(double(WIDTH)), rng.bounded(double(HEIGHT))), rng.bounded(100.0) });
+
+    std::sort(seen.begin(), seen.end(), [](const SimStar & a, const SimStar & b)
+    {
+        return a.flux > b.flux;
+    });
+
+    std::vector<cv::Point2d> stars;
+    for (const auto &star : seen)
+        stars.push_back(star.pos);
+    return stars;
+}
+
+void TestStarMatcher::testMatch_data()
+{
+    QTest::addColumn<double>("angle");
+    QTest::addColumn<double>("dx");
+    QTest::addColumn<double>("dy");
+    QTest::addColumn<double>("noise");
+    QTest::addColumn<double>("drop");
+    QTest::addColumn<int>("spurious");
+
+    QTest::newRow("identity") << 0.0 << 0.0 << 0.0 << 0.0 << 0.0 << 0;
+    QTest::newRow("shift") << 0.0 << 37.5 << -12.25 << 0.2 << 0.0 << 0;
+    QTest::newRow("field rotation") << 3.0 << 5.0 << 8.0 << 0.2 << 0.1 << 5;
+    QTest::newRow("meridian flip") << 180.0 << -20.0 << 15.0 << 0.2 << 0.1 << 5;
+    QTest::newRow("large offset") << -25.0 << 300.0 << -200.0 << 0.3 << 0.2 << 10;
+}
+
+void TestStarMatcher::testMatch()
+{
+    QFETCH(double, angle);
+    QFETCH(double, dx);
+    QFETCH(double, dy);
+    QFETCH(double, noise);
+    QFETCH(double, drop);
+    QFETCH(int, spurious);
+
+    const std::vector<SimStar> field = makeField(1234, 150);
+    std::vector<cv::Point2d> reference = observe(field, 0.0, 0.0, 0.0, 0.0, 0.0, 0, 1);
+
+    FITSStarMatcher matcher;
+    matcher.setReference(reference);
+    QVERIFY(matcher.hasReference());
+
+    const std::vector<cv::Point2d> stars = observe(field, angle, dx, dy, noise, drop, spurious, 2);
+    cv::Mat affine;
+    int numMatched = 0;
+    QVERIFY(matcher.match(stars, affine, numMatched));
+    QVERIFY(numMatched >= FITSStarMatcher::MIN_MATCHES);
+
+    // The fitted transform maps the sub back onto the reference, i.e. the inverse rotation
+    const double fittedAngle = std::atan2(affine.at<double>(1, 0), affine.at<double>(0, 0)) * 180.0 / M_PI;
+    double angleError = std::fmod(std::fabs(fittedAngle + angle), 360.0);
+    angleError = std::min(angleError, 360.0 - angleError);
+    QVERIFY2(angleError < 0.05, qPrintable(QString("angle error %1").arg(angleError)));
+
+    const double scale = std::hypot(affine.at<double>(0, 0), affine.at<double>(1, 0));
+    QVERIFY(std::fabs(scale - 1.0) < 0.001);
+
+    // Every reference star that was observed should map back to within a fraction of a pixel
+    const cv::Point2d centre(WIDTH / 2.0, HEIGHT / 2.0);
+    const double rad = angle * M_PI / 180.0;
+    for (const auto &star : field)
+    {
+        const cv::Point2d p = star.pos - centre;
+        const cv::Point2d q(std::cos(rad) * p.x - std::sin(rad) * p.y + centre.x + dx,
+                            std::sin(rad) * p.x + std::cos(rad) * p.y + centre.y + dy);
+        const cv::Point2d back(affine.at<double>(0, 0) * q.x + affine.at<double>(0, 1) * q.y + affine.at<double>(0, 2),
+                               affine.at<double>(1, 0) * q.x + affine.at<double>(1, 1) * q.y + affine.at<double>(1, 2));
+        QVERIFY2(cv::norm(back - star.pos) < 0.5 + noise,
+                 qPrintable(QString("star at %1,%2 misplaced by %3").arg(star.pos.x).arg(star.pos.y).arg(cv::norm(back - star.pos))));
+    }
+}
+
+void TestStarMatcher::testTooFewStars()
+{
+    const std::vector<SimStar> field = makeField(99, FITSStarMatcher::MIN_STARS - 1);
+    FITSStarMatcher matcher;
+    matcher.setReference(observe(field, 0.0, 0.0, 0.0, 0.0, 0.0, 0, 1));
+    QVERIFY(!matcher.hasReference());
+
+    cv::Mat affine;
+    int numMatched = 0;
+    QVERIFY(!matcher.match(observe(field, 0.0, 0.0, 0.0, 0.0, 0.0, 0, 2), affine, numMatched));
+    QCOMPARE(numMatched, 0);
+}
+
+void TestStarMatcher::testUnrelatedField()
+{
+    FITSStarMatcher matcher;
+    matcher.setReference(observe(makeField(1, 150), 0.0, 0.0, 0.0, 0.0, 0.0, 0, 1));
+    QVERIFY(matcher.hasReference());
+
+    cv::Mat affine;
+    int numMatched = 0;
+    QVERIFY(!matcher.match(observe(makeField(2, 150), 0.0, 0.0, 0.0, 0.0, 0.0, 0, 2), affine, numMatched));
+}
+
+QTEST_GUILESS_MAIN(TestStarMatcher)
+
+#include "teststarmatcher.moc"
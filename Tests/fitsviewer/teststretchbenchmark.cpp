@@ -0,0 +1,287 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QtGlobal>
+#include <QTest>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QRandomGenerator>
+
+#include "fitsviewer/stretch.h"
+#include "fitsviewer/stretchkernels.h"
+
+#include <fitsio.h>
+
+#include <algorithm>
+#include <cmath>
+
+// Measures the display pipeline throughput in Mpix/s for each FITS data type, using the scalar
+// kernels and the best vectorised kernels the CPU supports, and checks that both give the same result.
+class TestStretchBenchmark : public QObject
+{
+        Q_OBJECT
+
+    private:
+        static QByteArray makeImage(const int dataType, const int width, const int height, const int channels);
+        template <typename T> static QByteArray makeImage(const int width, const int height, const int channels,
+                const double scale);
+        template <typename T> static void histogram(const QByteArray &image, const int samples,
+                const QList<StretchKernels::Isa> &isas);
+        static double mpixPerSecond(const qint64 pixels, const int iterations, const qint64 nsecs);
+
+        static QList<StretchKernels::Isa> isas();
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void benchmarkStretch_data();
+        void benchmarkStretch();
+        void benchmarkHistogram_data();
+        void benchmarkHistogram();
+};
+
+// About 24 Mpix, similar to an APS-C sensor
+static constexpr int MONO_WIDTH = 6000;
+static constexpr int MONO_HEIGHT = 4000;
+// Colour images are 3 planes so are kept smaller
+static constexpr int RGB_WIDTH = 3000;
+static constexpr int RGB_HEIGHT = 2000;
+static constexpr int ITERATIONS = 5;
+
+template <typename T>
+QByteArray TestStretchBenchmark::makeImage(const int width, const int height, const int channels, const double scale)
+{
+    // Sky background with noise plus some saturated stars, so every branch of the stretch is used
+    QRandomGenerator rng(42);
+    const qint64 samples = static_cast<qint64>(width) * height * channels;
+    QByteArray image(samples * sizeof(T), Qt::Uninitialized);
+    T *buffer = reinterpret_cast<T *>(image.data());
+    for (qint64 i = 0; i < samples; i++)
+    {
+        double value = 0.05 + 0.01 * (rng.bounded(2.0) - 1.0);
+        if (rng.bounded(1000) == 0)
+            value = rng.bounded(1.0);
+        buffer[i] = static_cast<T>(value * scale);
+    }
+    return image;
+}
+
+QByteArray TestStretchBenchmark::makeImage(const int dataType, const int width, const int height, const int channels)
+{
+    switch (dataType)
+    {
+        case TBYTE:
+            return makeImage<uint8_t>(width, height, channels, 255);
+        case TSHORT:
+            return makeImage<int16_t>(width, height, channels, 32767);
+        case TUSHORT:
+            return makeImage<uint16_t>(width, height, channels, 65535);
+        case TLONG:
+            return makeImage<int32_t>(width, height, channels, 65535);
+        case TFLOAT:
+            return makeImage<float>(width, height, channels, 1.0);
+        case TLONGLONG:
+            return makeImage<int64_t>(width, height, channels, 65535);
+        case TDOUBLE:
+            return makeImage<double>(width, height, channels, 1.0);
+        default:
+            return QByteArray();
+    }
+}
+
+template <typename T>
+void TestStretchBenchmark::histogram(const QByteArray &image, const int samples, const QList<StretchKernels::Isa> &isas)
+{
+    const T *buffer = reinterpret_cast<const T *>(image.constData());
+    double min = buffer[0], max = buffer[0];
+    for (int i = 1; i < samples; i++)
+    {
+        min = std::min(min, static_cast<double>(buffer[i]));
+        max = std::max(max, static_cast<double>(buffer[i]));
+    }
+
+    // Same bins as FITSData::constructHistogram()
+    int binCount = std::max(0.0, std::min(max - min, 256.0));
+    if (binCount <= 0)
+        binCount = 256;
+    const double binWidth = std::max(max > 1.1 ? 1.0 : .0001, (max - min) / binCount);
+
+    QVector<uint32_t> reference;
+    for (const auto isa : isas)
+    {
+        StretchKernels::setIsa(isa);
+        QVector<uint32_t> frequency;
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < ITERATIONS; i++)
+        {
+            frequency.fill(0, binCount + 1);
+            StretchKernels::histogram(buffer, samples, 1, min, binWidth, binCount, frequency.data());
+        }
+        const qint64 elapsed = timer.nsecsElapsed();
+
+        qInfo() << QString("  histogram %1 %2: %3 Mpix/s").arg(QTest::currentDataTag())
+                .arg(StretchKernels::isaName(isa), -7)
+                .arg(mpixPerSecond(samples, ITERATIONS, elapsed), 0, 'f', 1);
+
+        uint32_t total = 0;
+        for (const auto count : frequency)
+            total += count;
+        QCOMPARE(total, static_cast<uint32_t>(samples));
+
+        if (reference.isEmpty())
+            reference = frequency;
+        else
+            QCOMPARE(frequency, reference);
+    }
+}
+
+double TestStretchBenchmark::mpixPerSecond(const qint64 pixels, const int iterations, const qint64 nsecs)
+{
+    return nsecs > 0 ? pixels * iterations * 1000.0 / nsecs : 0.0;
+}
+
+QList<StretchKernels::Isa> TestStretchBenchmark::isas()
+{
+    QList<StretchKernels::Isa> list { StretchKernels::Isa::SCALAR };
+    if (StretchKernels::bestIsa() == StretchKernels::Isa::AVX2)
+        list << StretchKernels::Isa::SSE41;
+    if (StretchKernels::bestIsa() != StretchKernels::Isa::SCALAR)
+        list << StretchKernels::bestIsa();
+    return list;
+}
+
+void TestStretchBenchmark::initTestCase()
+{
+    qInfo() << QString("Best instruction set: %1").arg(StretchKernels::isaName(StretchKernels::bestIsa()));
+}
+
+void TestStretchBenchmark::cleanupTestCase()
+{
+    StretchKernels::setIsa(StretchKernels::bestIsa());
+}
+
+static void addTypeRows(const bool withChannels)
+{
+    const QList<QPair<QString, int>> types =
+    {
+        { "byte", TBYTE }, { "short", TSHORT }, { "ushort", TUSHORT }, { "long", TLONG },
+        { "float", TFLOAT }, { "longlong", TLONGLONG }, { "double", TDOUBLE }
+    };
+    for (const auto &type : types)
+    {
+        QTest::newRow(qPrintable(type.first + (withChannels ? " mono" : ""))) << type.second << 1;
+        if (withChannels)
+            QTest::newRow(qPrintable(type.first + " rgb")) << type.second << 3;
+    }
+}
+
+void TestStretchBenchmark::benchmarkStretch_data()
+{
+    QTest::addColumn<int>("dataType");
+    QTest::addColumn<int>("channels");
+    addTypeRows(true);
+}
+
+void TestStretchBenchmark::benchmarkStretch()
+{
+    QFETCH(int, dataType);
+    QFETCH(int, channels);
+
+    const int width = channels == 1 ? MONO_WIDTH : RGB_WIDTH;
+    const int height = channels == 1 ? MONO_HEIGHT : RGB_HEIGHT;
+    const QByteArray image = makeImage(dataType, width, height, channels);
+    const uint8_t *buffer = reinterpret_cast<const uint8_t *>(image.constData());
+
+    Stretch stretch(width, height, channels, dataType);
+    stretch.setParams(stretch.computeParams(buffer));
+
+    QImage reference;
+    for (const auto isa : isas())
+    {
+        StretchKernels::setIsa(isa);
+        QImage output(width, height, channels == 1 ? QImage::Format_Indexed8 : QImage::Format_RGB32);
+
+        // Warm up the thread pool and caches
+        stretch.run(buffer, &output);
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < ITERATIONS; i++)
+            stretch.run(buffer, &output);
+        const qint64 elapsed = timer.nsecsElapsed();
+
+        qInfo() << QString("  stretch %1 %2: %3 Mpix/s").arg(QTest::currentDataTag())
+                .arg(StretchKernels::isaName(isa), -7)
+                .arg(mpixPerSecond(static_cast<qint64>(width) * height, ITERATIONS, elapsed), 0, 'f', 1);
+
+        if (reference.isNull())
+        {
+            reference = output;
+            continue;
+        }
+
+        // The kernels do the same float arithmetic, allow for a different rounding of the last bit
+        int maxDifference = 0;
+        const int bytesPerLine = width * (channels == 1 ? 1 : 4);
+        for (int y = 0; y < height; y++)
+        {
+            const uchar *a = reference.constScanLine(y);
+            const uchar *b = output.constScanLine(y);
+            for (int x = 0; x < bytesPerLine; x++)
+                maxDifference = std::max(maxDifference, std::abs(a[x] - b[x]));
+        }
+        QVERIFY2(maxDifference <= 1, qPrintable(QString("%1 differs from scalar by %2")
+                                                .arg(StretchKernels::isaName(isa)).arg(maxDifference)));
+    }
+}
+
+void TestStretchBenchmark::benchmarkHistogram_data()
+{
+    QTest::addColumn<int>("dataType");
+    QTest::addColumn<int>("channels");
+    addTypeRows(false);
+}
+
+void TestStretchBenchmark::benchmarkHistogram()
+{
+    QFETCH(int, dataType);
+
+    const int samples = MONO_WIDTH * MONO_HEIGHT;
+    const QByteArray image = makeImage(dataType, MONO_WIDTH, MONO_HEIGHT, 1);
+
+    switch (dataType)
+    {
+        case TBYTE:
+            histogram<uint8_t>(image, samples, isas());
+            break;
+        case TSHORT:
+            histogram<int16_t>(image, samples, isas());
+            break;
+        case TUSHORT:
+            histogram<uint16_t>(image, samples, isas());
+            break;
+        case TLONG:
+            histogram<int32_t>(image, samples, isas());
+            break;
+        case TFLOAT:
+            histogram<float>(image, samples, isas());
+            break;
+        case TLONGLONG:
+            histogram<int64_t>(image, samples, isas());
+            break;
+        case TDOUBLE:
+            histogram<double>(image, samples, isas());
+            break;
+        default:
+            QFAIL("Unknown data type");
+    }
+}
+
+QTEST_GUILESS_MAIN(TestStretchBenchmark)
+
+#include "teststretchbenchmark.moc"
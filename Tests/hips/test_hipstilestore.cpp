@@ -0,0 +1,212 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QtGlobal>
+#include <QTest>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+#include "hips/hipstilestore.h"
+
+#include <algorithm>
+
+// Fills HIPSTileStore from a local directory laid out like a HiPS server, as the offline source is,
+// and checks what comes back: the same tiles after reopening, the least recently used dropped
+// first when over budget, the lowest orders kept, and decoded tiles equal to the encoded ones.
+class TestHIPSTileStore : public QObject
+{
+        Q_OBJECT
+
+    private:
+        // Writes the tile of a HiPS server at order/pix in the stand-in directory, returns its path
+        QString makeTile(int order, int pix) const;
+        QByteArray readTile(int order, int pix) const;
+
+        QTemporaryDir m_Server;
+        QTemporaryDir m_Cache;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void init();
+        void persistence();
+        void eviction();
+        void decodedTiles();
+        void otherSurvey();
+};
+
+static constexpr int TILE_WIDTH = 64;
+static constexpr qint64 UID = 1234;
+
+QString TestHIPSTileStore::makeTile(int order, int pix) const
+{
+    // Same layout as the URLs HIPSManager builds
+    const int dir = (pix / 10000) * 10000;
+    const QString path = m_Server.filePath(QString("Norder%1/Dir%2/Npix%3.png").arg(order).arg(dir).arg(pix));
+    QDir().mkpath(QFileInfo(path).path());
+
+    QImage image(TILE_WIDTH, TILE_WIDTH, QImage::Format_RGB32);
+    image.fill(QColor::fromHsv((pix * 37) % 360, 200, 50 + order * 20));
+    // Something for the tiles to differ in besides their color
+    for (int x = 0; x < TILE_WIDTH; x++)
+        image.setPixel(x, (x + pix) % TILE_WIDTH, qRgb(255, 255, 255));
+    image.save(path);
+    return path;
+}
+
+QByteArray TestHIPSTileStore::readTile(int order, int pix) const
+{
+    const int dir = (pix / 10000) * 10000;
+    QFile file(m_Server.filePath(QString("Norder%1/Dir%2/Npix%3.png").arg(order).arg(dir).arg(pix)));
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+void TestHIPSTileStore::initTestCase()
+{
+    QVERIFY(m_Server.isValid());
+    QVERIFY(m_Cache.isValid());
+    for (int pix = 0; pix < 12; pix++)
+        makeTile(3, pix);
+    for (int pix = 0; pix < 64; pix++)
+        makeTile(5, 1000 + pix);
+}
+
+void TestHIPSTileStore::init()
+{
+    // Each test starts with an empty store
+    HIPSTileStore store;
+    QVERIFY(store.open(m_Cache.path(), UID));
+    store.clear();
+}
+
+void TestHIPSTileStore::persistence()
+{
+    {
+        HIPSTileStore store;
+        QVERIFY(store.open(m_Cache.path(), UID));
+        for (int pix = 1000; pix < 1032; pix++)
+        {
+            const QByteArray data = readTile(5, pix);
+            QVERIFY(store.write({ 5, pix, UID }, data, store.decode(data)));
+        }
+        QCOMPARE(store.count(), 32);
+        // The index is written when the store is closed
+    }
+
+    HIPSTileStore store;
+    QVERIFY(store.open(m_Cache.path(), UID));
+    QCOMPARE(store.count(), 32);
+    for (int pix = 1000; pix < 1032; pix++)
+    {
+        QVERIFY(store.contains({ 5, pix, UID }));
+        QImage expected;
+        QVERIFY(expected.loadFromData(readTile(5, pix)));
+        QCOMPARE(store.read({ 5, pix, UID }), expected);
+    }
+    QVERIFY(!store.contains({ 5, 1032, UID }));
+    QVERIFY(store.read({ 5, 1032, UID }).isNull());
+
+    const HIPSTileStore::Statistics statistics = store.statistics();
+    QCOMPARE(statistics.hits, 32);
+    QCOMPARE(statistics.misses, 2);
+    QCOMPARE(statistics.decodes, 32);
+}
+
+void TestHIPSTileStore::eviction()
+{
+    HIPSTileStore store;
+    QVERIFY(store.open(m_Cache.path(), UID));
+
+    // The low order tiles first, they are kept whatever their age
+    for (int pix = 0; pix < 12; pix++)
+        QVERIFY(store.write({ 3, pix, UID }, readTile(3, pix), QImage()));
+    const qint64 lowOrderSize = store.size();
+
+    qint64 tileSize = 0;
+    for (int pix = 1000; pix < 1016; pix++)
+    {
+        const qint64 before = store.size();
+        QVERIFY(store.write({ 5, pix, UID }, readTile(5, pix), QImage()));
+        tileSize = std::max(tileSize, store.size() - before);
+    }
+
+    // Use the first half again, so that the second half is the least recently used
+    for (int pix = 1000; pix < 1008; pix++)
+        QVERIFY(!store.read({ 5, pix, UID }).isNull());
+
+    // Eviction goes down to 90% of the budget, which leaves room for the low orders and the first half
+    const qint64 budget = (lowOrderSize + 9 * tileSize) * 10 / 9;
+    store.setMaxSize(budget);
+    QVERIFY(store.size() <= budget);
+    QVERIFY(store.statistics().evictions > 0);
+
+    for (int pix = 0; pix < 12; pix++)
+        QVERIFY2(store.contains({ 3, pix, UID }), qPrintable(QString("order 3 tile %1 was dropped").arg(pix)));
+    for (int pix = 1000; pix < 1008; pix++)
+        QVERIFY2(store.contains({ 5, pix, UID }), qPrintable(QString("recent tile %1 was dropped").arg(pix)));
+    QVERIFY(!store.contains({ 5, 1008, UID }));
+
+    // The most recently used come first
+    const QVector<pixCacheKey_t> recent = store.recentTiles(8);
+    QCOMPARE(recent.size(), 8);
+    QCOMPARE(recent.first().level, 5);
+    QCOMPARE(recent.first().pix, 1007);
+    QCOMPARE(recent.first().uid, UID);
+}
+
+void TestHIPSTileStore::decodedTiles()
+{
+    HIPSTileStore store;
+    QVERIFY(store.open(m_Cache.path(), UID));
+    store.setKeepDecoded(true);
+
+    constexpr int COUNT = 64;
+    QVector<QImage> expected;
+    for (int pix = 1000; pix < 1000 + COUNT; pix++)
+    {
+        const QByteArray data = readTile(5, pix);
+        expected.append(store.decode(data));
+        QVERIFY(store.write({ 5, pix, UID }, data, expected.last()));
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int pix = 1000; pix < 1000 + COUNT; pix++)
+    {
+        const QImage image = store.read({ 5, pix, UID });
+        QCOMPARE(image.convertToFormat(QImage::Format_RGB32), expected[pix - 1000].convertToFormat(QImage::Format_RGB32));
+    }
+    const qint64 decodedMsecs = timer.elapsed();
+
+    timer.restart();
+    for (int pix = 1000; pix < 1000 + COUNT; pix++)
+        QVERIFY(!store.decode(readTile(5, pix)).isNull());
+    qInfo() << QString("  %1 tiles: read decoded %2 ms, decoded from PNG %3 ms")
+            .arg(COUNT).arg(decodedMsecs).arg(timer.elapsed());
+}
+
+void TestHIPSTileStore::otherSurvey()
+{
+    HIPSTileStore store;
+    QVERIFY(store.open(m_Cache.path(), UID));
+    QVERIFY(store.write({ 3, 0, UID }, readTile(3, 0), QImage()));
+
+    // Keys of another survey are neither read nor written
+    QVERIFY(!store.contains({ 3, 0, UID + 1 }));
+    QVERIFY(!store.write({ 3, 1, UID + 1 }, readTile(3, 1), QImage()));
+
+    // Which has its own files
+    QVERIFY(store.open(m_Cache.path(), UID + 1));
+    QCOMPARE(store.count(), 0);
+    QVERIFY(store.open(m_Cache.path(), UID));
+    QCOMPARE(store.count(), 1);
+}
+
+QTEST_GUILESS_MAIN(TestHIPSTileStore)
+
+#include "test_hipstilestore.moc"
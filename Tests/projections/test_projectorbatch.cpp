@@ -0,0 +1,147 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QtGlobal>
+#include <QTest>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+
+#include "kstarsdata.h"
+#include "projections/azimuthalequidistantprojector.h"
+#include "projections/equirectangularprojector.h"
+#include "projections/gnomonicprojector.h"
+#include "projections/lambertprojector.h"
+#include "projections/orthographicprojector.h"
+#include "projections/stereographicprojector.h"
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+// Compares projecting many points one by one with toScreenVec(), as the sky map did for every
+// star, to projecting them at once with toScreenBatch(): the time taken, and that both give the
+// same screen positions and visibility. The view is zoomed out to the whole sky.
+class TestProjectorBatch : public QObject
+{
+        Q_OBJECT
+
+    private:
+        static std::unique_ptr<Projector> makeProjector(Projector::Projection type, const ViewParams &vp);
+
+    private Q_SLOTS:
+        void benchmarkBatch_data();
+        void benchmarkBatch();
+};
+
+static constexpr int POINTS = 200000;
+
+std::unique_ptr<Projector> TestProjectorBatch::makeProjector(Projector::Projection type, const ViewParams &vp)
+{
+    switch (type)
+    {
+        case Projector::Lambert:
+            return std::make_unique<LambertProjector>(vp);
+        case Projector::AzimuthalEquidistant:
+            return std::make_unique<AzimuthalEquidistantProjector>(vp);
+        case Projector::Orthographic:
+            return std::make_unique<OrthographicProjector>(vp);
+        case Projector::Equirectangular:
+            return std::make_unique<EquirectangularProjector>(vp);
+        case Projector::Stereographic:
+            return std::make_unique<StereographicProjector>(vp);
+        case Projector::Gnomonic:
+        default:
+            return std::make_unique<GnomonicProjector>(vp);
+    }
+}
+
+void TestProjectorBatch::benchmarkBatch_data()
+{
+    QTest::addColumn<int>("type");
+    QTest::addColumn<bool>("altAz");
+
+    QTest::newRow("Gnomonic horizontal") << int(Projector::Gnomonic) << true;
+    QTest::newRow("Gnomonic equatorial") << int(Projector::Gnomonic) << false;
+    QTest::newRow("Stereographic horizontal") << int(Projector::Stereographic) << true;
+    QTest::newRow("Lambert horizontal") << int(Projector::Lambert) << true;
+    QTest::newRow("Orthographic equatorial") << int(Projector::Orthographic) << false;
+    QTest::newRow("Azimuthal equidistant horizontal") << int(Projector::AzimuthalEquidistant) << true;
+    QTest::newRow("Equirectangular horizontal") << int(Projector::Equirectangular) << true;
+    QTest::newRow("Equirectangular equatorial") << int(Projector::Equirectangular) << false;
+}
+
+void TestProjectorBatch::benchmarkBatch()
+{
+    QFETCH(int, type);
+    QFETCH(bool, altAz);
+
+    SkyPoint focus(dms(83.6), dms(22.0));
+    focus.setAlt(dms(35.0));
+    focus.setAz(dms(141.0));
+
+    ViewParams vp;
+    vp.width         = 1920;
+    vp.height        = 1080;
+    vp.zoomFactor    = MINZOOM;
+    vp.rotationAngle = CachingDms(12.5);
+    vp.useRefraction = true;
+    vp.useAltAz      = altAz;
+    vp.fillGround    = false;
+    vp.focus         = &focus;
+    const std::unique_ptr<Projector> proj = makeProjector(static_cast<Projector::Projection>(type), vp);
+
+    // Uniform over the sphere in both frames, always the same
+    QRandomGenerator random(42);
+    std::vector<SkyPoint> points(POINTS);
+    std::vector<double> ra(POINTS), dec(POINTS), alt(POINTS), az(POINTS);
+    for (int i = 0; i < POINTS; i++)
+    {
+        ra[i]  = random.bounded(360.0);
+        dec[i] = std::asin(2.0 * random.generateDouble() - 1.0) * 180.0 / M_PI;
+        az[i]  = random.bounded(360.0);
+        alt[i] = std::asin(2.0 * random.generateDouble() - 1.0) * 180.0 / M_PI;
+        points[i].setRA(CachingDms(ra[i]));
+        points[i].setDec(CachingDms(dec[i]));
+        points[i].setAlt(alt[i]);
+        points[i].setAz(az[i]);
+    }
+
+    std::vector<Eigen::Vector2f> single(POINTS), batch(POINTS);
+    std::unique_ptr<bool[]> singleVisible(new bool[POINTS]), batchVisible(new bool[POINTS]);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < POINTS; i++)
+        single[i] = proj->toScreenVec(&points[i], true, &singleVisible[i]);
+    const qint64 singleMsecs = timer.elapsed();
+
+    timer.restart();
+    proj->toScreenBatch(ra.data(), dec.data(), alt.data(), az.data(), POINTS, batch.data(), batchVisible.get());
+    const qint64 batchMsecs = timer.elapsed();
+
+    qInfo() << QString("  %1 points: one by one %2 ms, batched %3 ms, speed-up %4x")
+            .arg(POINTS).arg(singleMsecs).arg(batchMsecs)
+            .arg(batchMsecs > 0 ? static_cast<double>(singleMsecs) / batchMsecs : 0.0, 0, 'f', 2);
+
+    int visible = 0;
+    double worst = 0;
+    for (int i = 0; i < POINTS; i++)
+    {
+        QCOMPARE(batchVisible[i], singleVisible[i]);
+        if (!singleVisible[i])
+            continue;
+        visible++;
+        // Single precision of positions up to a few thousand pixels off the center
+        const double error = (batch[i] - single[i]).norm();
+        worst = std::max(worst, error);
+        QVERIFY2(error < 0.01 + 1e-6 * single[i].norm(), qPrintable(QString("point %1 is %2 px off").arg(i).arg(error)));
+    }
+    qInfo() << QString("  %1 visible, largest difference %2 px").arg(visible).arg(worst, 0, 'g', 3);
+}
+
+QTEST_GUILESS_MAIN(TestProjectorBatch)
+
+#include "test_projectorbatch.moc"
@@ -0,0 +1,183 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QtGlobal>
+#include <QTest>
+
+#include "ksnumbers.h"
+#include "Options.h"
+#include "skycomponents/stararrays.h"
+#include "skyobjects/apparenttransform.h"
+#include "skyobjects/starobject.h"
+
+#include <cmath>
+
+// Checks that the packed stars are ordered as the draw loop expects and end up where the
+// StarObjects they were made of would be
+class TestStarArrays : public QObject
+{
+        Q_OBJECT
+
+    private:
+        static StarObject makeStar(double raDeg, double decDeg, float mag, double pmRA = 0, double pmDec = 0);
+
+    private Q_SLOTS:
+        void initTestCase();
+        void testOrder();
+        void testWithin_data();
+        void testWithin();
+        void testUpdate();
+        void testLazyUpdate();
+};
+
+StarObject TestStarArrays::makeStar(double raDeg, double decDeg, float mag, double pmRA, double pmDec)
+{
+    StarObject star(dms(raDeg), dms(decDeg), mag, QString(), QString(), "K0", pmRA, pmDec, 0.0, false, false, 0);
+    return star;
+}
+
+void TestStarArrays::initTestCase()
+{
+    Options::setUseRelativistic(false);
+    Options::setAlwaysRecomputeCoordinates(false);
+}
+
+void TestStarArrays::testOrder()
+{
+    StarArrays arrays;
+    arrays.reset(4);
+    arrays.append(2, makeStar(10, 10, 5.0), 0);
+    arrays.append(0, makeStar(20, 20, 3.0), 1);
+    arrays.append(2, makeStar(30, 30, 1.5), 2);
+    arrays.append(3, makeStar(40, 40, 4.0), 3);
+    arrays.append(2, makeStar(50, 50, 1.5), 4);
+    // Outside the mesh, dropped
+    arrays.append(4, makeStar(60, 60, 1.0), 5);
+
+    // Nothing is found before it is finished
+    QCOMPARE(arrays.size(), 0);
+    arrays.finish();
+    QCOMPARE(arrays.size(), 5);
+
+    QCOMPARE(arrays.begin(0), 0);
+    QCOMPARE(arrays.end(0), 1);
+    QCOMPARE(arrays.begin(1), arrays.end(1));
+    QCOMPARE(arrays.begin(2), 1);
+    QCOMPARE(arrays.end(2), 4);
+    QCOMPARE(arrays.end(3), 5);
+
+    // By magnitude within the trixel, in the order they came when equally bright
+    QCOMPARE(arrays.id(1), 2U);
+    QCOMPARE(arrays.id(2), 4U);
+    QCOMPARE(arrays.id(3), 0U);
+    QCOMPARE(arrays.mag(3), 5.0f);
+    QCOMPARE(arrays.spchar(3), 'K');
+
+    arrays.reset(4);
+    QCOMPARE(arrays.size(), 0);
+    QCOMPARE(arrays.begin(3), arrays.end(3));
+}
+
+void TestStarArrays::testWithin_data()
+{
+    QTest::addColumn<double>("distance");
+    QTest::addColumn<double>("radius");
+    QTest::addColumn<bool>("within");
+
+    QTest::newRow("degrees in") << 0.5 << 1.0 << true;
+    QTest::newRow("degrees out") << 1.5 << 1.0 << false;
+    QTest::newRow("arcseconds in") << 0.9 / 3600 << 1.0 / 3600 << true;
+    QTest::newRow("arcseconds out") << 1.1 / 3600 << 1.0 / 3600 << false;
+    QTest::newRow("whole sky") << 179.0 << 180.0 << true;
+}
+
+void TestStarArrays::testWithin()
+{
+    QFETCH(double, distance);
+    QFETCH(double, radius);
+    QFETCH(bool, within);
+
+    // Along the declination circle, where the distance is the difference of declinations
+    const SkyPoint center(dms(123.4), dms(-20.0));
+    StarArrays arrays;
+    arrays.reset(1);
+    arrays.append(0, makeStar(123.4, -20.0 + distance, 6.0), 0);
+    arrays.finish();
+
+    double v[3];
+    StarArrays::unitVector(center, v);
+    QCOMPARE(arrays.within(0, v, StarArrays::chord2(radius)), within);
+}
+
+void TestStarArrays::testUpdate()
+{
+    // A fast mover and a star near the pole, which have the largest corrections
+    StarObject stars[] = { makeStar(269.45, 4.69, 9.5, -798.6, 10328.1), makeStar(37.95, 89.26, 2.0, 44.2, -11.7),
+                           makeStar(201.3, -11.16, 1.0)
+                         };
+    StarArrays arrays;
+    arrays.reset(1);
+    for (quint32 i = 0; i < 3; i++)
+        arrays.append(0, stars[i], i);
+    arrays.finish();
+
+    KSNumbers num(J2000 + 25.3 * 365.25);
+    const CachingDms LST(211.5), lat(48.1);
+    arrays.update(0, ApparentTransform(&num, LST, lat), 1, 1, 99.0);
+
+    SkyPoint point;
+    for (int i = 0; i < arrays.size(); i++)
+    {
+        StarObject &star = stars[arrays.id(i)];
+        star.updateCoords(&num, true, nullptr, nullptr, true);
+        star.EquatorialToHorizontal(&LST, &lat);
+        arrays.position(i, point);
+        const double error = point.angularDistanceTo(&star).Degrees() * 3600.0;
+        QVERIFY2(error < 0.05, qPrintable(QString("star %1 is %2\" off").arg(arrays.id(i)).arg(error)));
+        QVERIFY(std::abs(point.alt().Degrees() - star.alt().Degrees()) * 3600.0 < 0.05);
+        QVERIFY(std::abs(point.az().Degrees() - star.az().Degrees()) * 3600.0 * std::cos(star.alt().radians()) < 0.05);
+    }
+}
+
+void TestStarArrays::testLazyUpdate()
+{
+    StarArrays arrays;
+    arrays.reset(1);
+    arrays.append(0, makeStar(100, 20, 2.0), 0);
+    arrays.append(0, makeStar(101, 21, 7.0), 1);
+    arrays.finish();
+
+    SkyPoint bright, faint;
+    const dms LST(0.0), lat(0.0);
+    KSNumbers num(J2000 + 3650);
+    arrays.update(0, ApparentTransform(&num, LST, lat), 1, 1, 5.0);
+    arrays.position(0, bright);
+    arrays.position(1, faint);
+    QVERIFY(bright.ra().Degrees() > 90.0);
+    // Not updated until it is needed
+    QCOMPARE(faint.ra().Degrees(), 0.0);
+
+    arrays.update(0, ApparentTransform(&num, LST, lat), 1, 1, 8.0);
+    arrays.position(1, faint);
+    QVERIFY(faint.ra().Degrees() > 90.0);
+
+    // Within the same solar minute nothing moves, later it does
+    SkyPoint before;
+    arrays.position(0, before);
+    KSNumbers soon(J2000 + 3650 + 0.0001);
+    arrays.update(0, ApparentTransform(&soon, LST, lat), 2, 2, 8.0);
+    arrays.position(0, bright);
+    QCOMPARE(bright.ra().Degrees(), before.ra().Degrees());
+
+    KSNumbers later(J2000 + 3650 + 100);
+    arrays.update(0, ApparentTransform(&later, LST, lat), 3, 3, 8.0);
+    arrays.position(0, bright);
+    QVERIFY(bright.angularDistanceTo(&before).Degrees() > 1.0 / 3600);
+}
+
+QTEST_GUILESS_MAIN(TestStarArrays)
+
+#include "teststararrays.moc"
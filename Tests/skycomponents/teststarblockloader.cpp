@@ -0,0 +1,209 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QtGlobal>
+#include <QTest>
+#include <QDir>
+#include <QFile>
+#include <QSignalSpy>
+#include <QStandardPaths>
+
+#include "auxiliary/binfilehelper.h"
+#include "skycomponents/starblockloader.h"
+#include "skyobjects/deepstardata.h"
+
+#include <cstring>
+
+// Checks that the background loader stages the records StarBlockList::fillToMag() would read, on a
+// small generated catalog
+class TestStarBlockLoader : public QObject
+{
+        Q_OBJECT
+
+    private:
+        static bool writeCatalog(const QString &name);
+
+    private Q_SLOTS:
+        void initTestCase();
+        void testRecordMagnitude();
+        void testStageToMagnitude();
+        void testStaleRecords();
+        void testQueueOrder();
+
+    private:
+        BinFileHelper m_Reader;
+};
+
+static const QString NAME = "teststarblockloader.dat";
+static constexpr quint32 TRIXELS = 8;
+static constexpr quint32 RECORDS = 40;
+
+// Each trixel holds RECORDS stars from magnitude 5.0 in steps of 0.1, the first star of trixel 1 has no V
+bool TestStarBlockLoader::writeCatalog(const QString &name)
+{
+    QByteArray file(124, ' ');
+    const qint16 endian = 0x4B53;
+    file.append(reinterpret_cast<const char *>(&endian), 2);
+    file.append(char(2));
+
+    const char *names[] = { "RA", "Dec", "dRA", "dDec", "B", "V" };
+    const qint8 sizes[] = { 4, 4, 2, 2, 2, 2 };
+    const qint16 nfields = 6;
+    file.append(reinterpret_cast<const char *>(&nfields), 2);
+    for (int i = 0; i < nfields; i++)
+    {
+        dataElement de;
+        strncpy(de.name, names[i], sizeof(de.name) - 1);
+        de.size = sizes[i];
+        file.append(reinterpret_cast<const char *>(&de), sizeof(dataElement));
+    }
+
+    const quint32 indexSize = TRIXELS;
+    file.append(reinterpret_cast<const char *>(&indexSize), 4);
+    quint32 offset = file.size() + indexSize * 12;
+    for (quint32 id = 0; id < indexSize; id++)
+    {
+        file.append(reinterpret_cast<const char *>(&id), 4);
+        file.append(reinterpret_cast<const char *>(&offset), 4);
+        file.append(reinterpret_cast<const char *>(&RECORDS), 4);
+        offset += RECORDS * sizeof(DeepStarData);
+    }
+
+    for (quint32 id = 0; id < indexSize; id++)
+    {
+        for (quint32 j = 0; j < RECORDS; j++)
+        {
+            DeepStarData data;
+            data.RA = id;
+            data.Dec = j;
+            data.V = 5000 + j * 100;
+            data.B = data.V + 600;
+            if (id == 1 && j == 0)
+                data.V = 30000;
+            file.append(reinterpret_cast<const char *>(&data), sizeof(DeepStarData));
+        }
+    }
+
+    QFile out(QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)).filePath(name));
+    return out.open(QIODevice::WriteOnly) && out.write(file) == file.size();
+}
+
+void TestStarBlockLoader::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    QDir().mkpath(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation));
+    QVERIFY(writeCatalog(NAME));
+
+    QVERIFY(m_Reader.openFile(NAME) != nullptr);
+    QVERIFY(m_Reader.readHeader());
+    QVERIFY(m_Reader.mapFile());
+}
+
+void TestStarBlockLoader::testRecordMagnitude()
+{
+    const uchar *records = m_Reader.getRecords(0);
+    QVERIFY(records != nullptr);
+    QCOMPARE(StarBlockLoader::recordMagnitude(records, 16, false), 5.0f);
+    QCOMPARE(StarBlockLoader::recordMagnitude(records + 10 * sizeof(DeepStarData), 16, false), 6.0f);
+
+    // Without V the magnitude is made up from B, as StarObject does
+    records = m_Reader.getRecords(1);
+    QCOMPARE(StarBlockLoader::recordMagnitude(records, 16, false), (5600 - 1600) / 1000.0f);
+}
+
+void TestStarBlockLoader::testStageToMagnitude()
+{
+    StarBlockLoader loader(&m_Reader);
+    QSignalSpy ready(&loader, &StarBlockLoader::recordsReady);
+
+    // Nothing is staged until it is asked for
+    QVERIFY(loader.take(2, 0).isEmpty());
+
+    loader.request(2, 0, 5.25, true);
+    QTRY_VERIFY(ready.count() > 0);
+
+    // Up to and including the first star fainter than the limit, 5.0 to 5.3
+    const QByteArray records = loader.take(2, 0);
+    QCOMPARE(static_cast<int>(records.size()), static_cast<int>(4 * sizeof(DeepStarData)));
+    QCOMPARE(memcmp(records.constData(), m_Reader.getRecords(2), records.size()), 0);
+
+    // Taken, so no longer staged
+    QVERIFY(loader.take(2, 0).isEmpty());
+
+    // Continuing from where the stars loaded so far end
+    loader.request(2, 4, 5.55, true);
+    QTRY_VERIFY(ready.count() > 1);
+    const QByteArray more = loader.take(2, 4);
+    QCOMPARE(static_cast<int>(more.size()), static_cast<int>(3 * sizeof(DeepStarData)));
+    QCOMPARE(memcmp(more.constData(), m_Reader.getRecords(2) + 4 * sizeof(DeepStarData), more.size()), 0);
+
+    // All the remaining records when the limit is beyond the catalog
+    loader.request(3, 30, 99.0, true);
+    QTRY_VERIFY(ready.count() > 2);
+    QCOMPARE(static_cast<int>(loader.take(3, 30).size()), static_cast<int>(10 * sizeof(DeepStarData)));
+
+    const StarBlockLoader::Statistics statistics = loader.statistics();
+    QCOMPARE(statistics.loaded, 3ULL);
+    QCOMPARE(statistics.queueDepth, 0);
+    QCOMPARE(statistics.staged, 0);
+}
+
+void TestStarBlockLoader::testStaleRecords()
+{
+    StarBlockLoader loader(&m_Reader);
+    QSignalSpy ready(&loader, &StarBlockLoader::recordsReady);
+
+    loader.request(4, 0, 6.0, true);
+    QTRY_VERIFY(ready.count() > 0);
+    QCOMPARE(loader.statistics().staged, 1);
+
+    // Stars were loaded some other way meanwhile, the records staged from the start are dropped
+    QVERIFY(loader.take(4, 5).isEmpty());
+    QCOMPARE(loader.statistics().staged, 0);
+
+    // Beyond the end of the trixel there is nothing to stage
+    loader.request(4, RECORDS, 99.0, true);
+    QTRY_COMPARE(loader.statistics().loaded, 2ULL);
+    QVERIFY(loader.take(4, RECORDS).isEmpty());
+}
+
+void TestStarBlockLoader::testQueueOrder()
+{
+    StarBlockLoader loader(&m_Reader);
+    QSignalSpy ready(&loader, &StarBlockLoader::recordsReady);
+
+    // Predictions alone are staged without asking for a redraw
+    loader.request(5, 0, 6.0, false);
+    QTRY_COMPARE(loader.statistics().loaded, 1ULL);
+    QCOMPARE(loader.statistics().staged, 1);
+    QCOMPARE(ready.count(), 0);
+
+    // Asking again for what is staged doesn't read it again
+    loader.request(5, 0, 6.0, true);
+    QCOMPARE(loader.statistics().queueDepth, 0);
+    QVERIFY(!loader.take(5, 0).isEmpty());
+
+    loader.request(6, 0, 6.0, false);
+    loader.request(7, 0, 6.0, true);
+    QTRY_COMPARE(loader.statistics().loaded, 3ULL);
+    QVERIFY(ready.count() > 0);
+    QVERIFY(!loader.take(6, 0).isEmpty());
+    QVERIFY(!loader.take(7, 0).isEmpty());
+
+    loader.countHit();
+    loader.countMiss();
+    loader.countMiss();
+    QCOMPARE(loader.statistics().hits, 1ULL);
+    QCOMPARE(loader.statistics().misses, 2ULL);
+
+    loader.request(0, 0, 6.0, false);
+    loader.clear();
+    QTRY_COMPARE(loader.statistics().queueDepth, 0);
+}
+
+QTEST_GUILESS_MAIN(TestStarBlockLoader)
+
+#include "teststarblockloader.moc"
@@ -0,0 +1,138 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QtGlobal>
+#include <QTest>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+
+#include "ksnumbers.h"
+#include "Options.h"
+#include "skyobjects/apparenttransform.h"
+#include "skyobjects/skypoint.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Compares updating many points one by one with SkyPoint::updateCoords() and EquatorialToHorizontal()
+// to updating them at once with ApparentTransform: the time taken, and that both end up at the same
+// positions.
+class TestApparentTransform : public QObject
+{
+        Q_OBJECT
+
+    private:
+        static std::vector<SkyPoint> makePoints(int count);
+
+    private Q_SLOTS:
+        void initTestCase();
+        void benchmarkTransform_data();
+        void benchmarkTransform();
+};
+
+static constexpr int POINTS = 100000;
+
+// Uniform over the sphere, always the same
+std::vector<SkyPoint> TestApparentTransform::makePoints(int count)
+{
+    QRandomGenerator random(42);
+    std::vector<SkyPoint> points;
+    points.reserve(count);
+    for (int i = 0; i < count; i++)
+    {
+        const double ra = random.bounded(360.0);
+        const double dec = std::asin(2.0 * random.generateDouble() - 1.0) * 180.0 / M_PI;
+        points.emplace_back(dms(ra), dms(dec));
+    }
+    return points;
+}
+
+void TestApparentTransform::initTestCase()
+{
+    Options::setUseRelativistic(false);
+    Options::setAlwaysRecomputeCoordinates(false);
+}
+
+void TestApparentTransform::benchmarkTransform_data()
+{
+    QTest::addColumn<double>("years");
+    QTest::addColumn<double>("LST");
+    QTest::addColumn<double>("latitude");
+
+    QTest::newRow("2026 mid-northern") << 26.8 << 211.5 << 48.1;
+    QTest::newRow("2050 southern") << 50.2 << 17.3 << -33.9;
+    QTest::newRow("1990 equator") << -10.4 << 301.0 << 0.3;
+}
+
+void TestApparentTransform::benchmarkTransform()
+{
+    QFETCH(double, years);
+    QFETCH(double, LST);
+    QFETCH(double, latitude);
+
+    KSNumbers num(J2000 + years * 365.25);
+    const CachingDms lst(LST), lat(latitude);
+
+    std::vector<SkyPoint> single = makePoints(POINTS);
+    std::vector<SkyPoint> batch = single;
+
+    QElapsedTimer timer;
+    timer.start();
+    for (SkyPoint &point : single)
+    {
+        point.updateCoords(&num, false, nullptr, nullptr, true);
+        point.EquatorialToHorizontal(&lst, &lat);
+    }
+    const qint64 singleMsecs = timer.elapsed();
+
+    // As the catalogs do it: from the J2000 positions to the SkyPoints
+    timer.restart();
+    const ApparentTransform transform(&num, lst, lat);
+    std::vector<double> x(POINTS), y(POINTS), z(POINTS), ax(POINTS), ay(POINTS), az(POINTS);
+    for (int i = 0; i < POINTS; i++)
+    {
+        double sinRa, cosRa, sinDec, cosDec;
+        batch[i].ra0().SinCos(sinRa, cosRa);
+        batch[i].dec0().SinCos(sinDec, cosDec);
+        x[i] = cosDec * cosRa;
+        y[i] = cosDec * sinRa;
+        z[i] = sinDec;
+    }
+    transform.toApparent(x.data(), y.data(), z.data(), POINTS, ax.data(), ay.data(), az.data());
+    transform.toHorizontal(ax.data(), ay.data(), az.data(), POINTS, x.data(), y.data());
+    for (int i = 0; i < POINTS; i++)
+    {
+        ApparentTransform::setEquatorial(batch[i], ax[i], ay[i], az[i]);
+        batch[i].setAlt(x[i]);
+        batch[i].setAz(y[i]);
+    }
+    const qint64 batchMsecs = timer.elapsed();
+
+    qInfo() << QString("  %1 points: one by one %2 ms, batched %3 ms, speed-up %4x")
+            .arg(POINTS).arg(singleMsecs).arg(batchMsecs)
+            .arg(batchMsecs > 0 ? static_cast<double>(singleMsecs) / batchMsecs : 0.0, 0, 'f', 2);
+
+    // Meeus' corrections are first order, the largest difference is near the poles
+    double worstEquatorial = 0, worstHorizontal = 0;
+    for (int i = 0; i < POINTS; i++)
+    {
+        worstEquatorial = std::max(worstEquatorial, batch[i].angularDistanceTo(&single[i]).Degrees() * 3600.0);
+
+        const double dAlt = batch[i].alt().Degrees() - single[i].alt().Degrees();
+        double dAz = std::remainder(batch[i].az().Degrees() - single[i].az().Degrees(), 360.0);
+        dAz *= std::cos(single[i].alt().radians());
+        worstHorizontal = std::max(worstHorizontal, std::hypot(dAlt, dAz) * 3600.0);
+    }
+    qInfo() << QString("  largest difference %1\" in RA/Dec, %2\" in Alt/Az").arg(worstEquatorial, 0, 'f', 4)
+            .arg(worstHorizontal, 0, 'f', 4);
+    QVERIFY2(worstEquatorial < 0.1, qPrintable(QString("%1\"").arg(worstEquatorial)));
+    QVERIFY2(worstHorizontal < 0.1, qPrintable(QString("%1\"").arg(worstHorizontal)));
+}
+
+QTEST_GUILESS_MAIN(TestApparentTransform)
+
+#include "test_apparenttransform.moc"
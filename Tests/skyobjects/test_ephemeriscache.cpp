@@ -0,0 +1,227 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QtGlobal>
+#include <QTest>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+
+#include "../testhelpers.h"
+
+#include "geolocation.h"
+#include "ksnumbers.h"
+#include "kstarsdata.h"
+#include "kstarsdatetime.h"
+#include "skyobjects/ephemeriscache.h"
+#include "skyobjects/ksmoon.h"
+#include "skyobjects/ksplanet.h"
+#include "tools/eclipsetool/lunareclipsehandler.h"
+#include "tools/ksconjunct.h"
+
+#include <cmath>
+
+// Checks the positions of EphemerisCache against the full series, and times a year of conjunction and
+// eclipse searches with and without it.
+class TestEphemerisCache : public QObject
+{
+        Q_OBJECT
+
+    private:
+        // Turns the cache off by giving the bodies no span, or back on with the spans they had
+        void setCached(bool cached);
+
+        QHash<QString, double> m_Spans;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void planets_data();
+        void planets();
+        void moon();
+        void benchmarkConjunctions();
+        void benchmarkLunarEclipses();
+};
+
+static const QStringList BODIES { "Mercury", "Venus", "Earth", "Mars", "Jupiter", "Saturn", "Uranus", "Neptune", "Moon" };
+
+// Angles differing by less than the tolerance, whatever their turn
+static double angleError(const dms &a, const dms &b)
+{
+    const double d = a.radians() - b.radians();
+    return std::abs(d - 2 * dms::PI * std::round(d / (2 * dms::PI)));
+}
+
+void TestEphemerisCache::setCached(bool cached)
+{
+    for (const QString &body : BODIES)
+        EphemerisCache::Instance()->setSpan(body, cached ? m_Spans[body] : 0);
+}
+
+void TestEphemerisCache::initTestCase()
+{
+    KTEST_BEGIN();
+
+    // The tools find the geographic location through KStarsData
+    KStarsData *data = KStarsData::Create();
+    QVERIFY(data != nullptr);
+    QVERIFY(data->initialize());
+
+    for (const QString &body : BODIES)
+        m_Spans[body] = EphemerisCache::Instance()->span(body);
+}
+
+void TestEphemerisCache::cleanupTestCase()
+{
+    KTEST_END();
+}
+
+void TestEphemerisCache::planets_data()
+{
+    QTest::addColumn<int>("planet");
+
+    QTest::newRow("Mercury") << static_cast<int>(KSPlanetBase::MERCURY);
+    QTest::newRow("Venus") << static_cast<int>(KSPlanetBase::VENUS);
+    QTest::newRow("Mars") << static_cast<int>(KSPlanetBase::MARS);
+    QTest::newRow("Jupiter") << static_cast<int>(KSPlanetBase::JUPITER);
+    QTest::newRow("Saturn") << static_cast<int>(KSPlanetBase::SATURN);
+    QTest::newRow("Uranus") << static_cast<int>(KSPlanetBase::URANUS);
+    QTest::newRow("Neptune") << static_cast<int>(KSPlanetBase::NEPTUNE);
+    QTest::newRow("Earth") << -1;
+}
+
+void TestEphemerisCache::planets()
+{
+    QFETCH(int, planet);
+
+    KSPlanet body = planet < 0 ? KSPlanet(i18n("Earth")) : KSPlanet(planet);
+    QVERIFY(body.loadData());
+
+    // Anywhere within two centuries, in millennia since J2000
+    QRandomGenerator random(planet + 1);
+    double worst[3] = { 0, 0, 0 };
+    EphemerisCache::Scope ephemerides;
+    for (int i = 0; i < 2000; i++)
+    {
+        const double jm = random.bounded(0.2) - 0.1;
+        EclipticPosition cached, series;
+        body.calcEcliptic(jm, cached);
+        body.calcEclipticSeries(jm, series);
+
+        worst[0] = std::max(worst[0], angleError(cached.longitude, series.longitude));
+        worst[1] = std::max(worst[1], angleError(cached.latitude, series.latitude));
+        worst[2] = std::max(worst[2], std::abs(cached.radius - series.radius) / series.radius);
+    }
+
+    qInfo() << QString("  %1: largest error %2 rad in longitude, %3 rad in latitude, %4 in distance")
+            .arg(body.untranslatedName()).arg(worst[0], 0, 'g', 3).arg(worst[1], 0, 'g', 3).arg(worst[2], 0, 'g', 3);
+    QVERIFY(worst[0] <= EphemerisCache::ANGLE_TOLERANCE);
+    QVERIFY(worst[1] <= EphemerisCache::ANGLE_TOLERANCE);
+    QVERIFY(worst[2] <= EphemerisCache::ANGLE_TOLERANCE);
+}
+
+void TestEphemerisCache::moon()
+{
+    KSMoon cachedMoon, seriesMoon;
+    QRandomGenerator random(7);
+    double worst[3] = { 0, 0, 0 };
+    for (int i = 0; i < 2000; i++)
+    {
+        KSNumbers num(J2000 + random.bounded(20 * 365.25));
+        {
+            EphemerisCache::Scope ephemerides;
+            cachedMoon.findPosition(&num);
+        }
+        seriesMoon.findPosition(&num);
+
+        worst[0] = std::max(worst[0], angleError(cachedMoon.ecLong(), seriesMoon.ecLong()));
+        worst[1] = std::max(worst[1], angleError(cachedMoon.ecLat(), seriesMoon.ecLat()));
+        worst[2] = std::max(worst[2], std::abs(cachedMoon.rearth() - seriesMoon.rearth()) / seriesMoon.rearth());
+    }
+
+    qInfo() << QString("  Moon: largest error %1 rad in longitude, %2 rad in latitude, %3 in distance")
+            .arg(worst[0], 0, 'g', 3).arg(worst[1], 0, 'g', 3).arg(worst[2], 0, 'g', 3);
+    QVERIFY(worst[0] <= EphemerisCache::ANGLE_TOLERANCE);
+    QVERIFY(worst[1] <= EphemerisCache::ANGLE_TOLERANCE);
+    QVERIFY(worst[2] <= EphemerisCache::ANGLE_TOLERANCE);
+}
+
+void TestEphemerisCache::benchmarkConjunctions()
+{
+    // The conjunctions of the Moon and Jupiter during a year, a dozen of them
+    const long double startJD = KStarsDateTime(QDate(2024, 1, 1), QTime(0, 0, 0)).djd();
+    const long double stopJD = KStarsDateTime(QDate(2025, 1, 1), QTime(0, 0, 0)).djd();
+
+    const auto search = [&](QMap<long double, dms> &conjunctions)
+    {
+        SkyObject_s moon(new KSMoon());
+        KSPlanetBase_s jupiter(new KSPlanet(KSPlanetBase::JUPITER));
+        KSConjunct conjunct;
+        conjunct.setGeoLocation(KStarsData::Instance()->geo());
+        conjunct.setMaxSeparation(10.0 * dms::DegToRad);
+        conjunct.setObject1(moon);
+        conjunct.setObject2(jupiter);
+
+        QElapsedTimer timer;
+        timer.start();
+        conjunctions = conjunct.findClosestApproach(startJD, stopJD);
+        return timer.elapsed();
+    };
+
+    QMap<long double, dms> series, cached;
+    setCached(false);
+    const qint64 seriesMsecs = search(series);
+    setCached(true);
+    const qint64 cachedMsecs = search(cached);
+
+    qInfo() << QString("  %1 Moon-Jupiter conjunctions in a year: series %2 ms, cached %3 ms")
+            .arg(cached.size()).arg(seriesMsecs).arg(cachedMsecs);
+
+    QVERIFY(series.size() >= 12);
+    QCOMPARE(cached.size(), series.size());
+    for (auto s = series.cbegin(), c = cached.cbegin(); s != series.cend(); ++s, ++c)
+    {
+        // Within the precision of the search, a minute
+        QVERIFY(std::abs(static_cast<double>(c.key() - s.key())) < 1.0 / (24 * 60));
+        QVERIFY(std::abs(c.value().Degrees() - s.value().Degrees()) < 0.01);
+    }
+}
+
+void TestEphemerisCache::benchmarkLunarEclipses()
+{
+    // The 2025 eclipses, in March and September
+    const long double startJD = KStarsDateTime(QDate(2025, 1, 1), QTime(0, 0, 0)).djd();
+    const long double stopJD = KStarsDateTime(QDate(2026, 1, 1), QTime(0, 0, 0)).djd();
+
+    const auto search = [&](QVector<long double> &eclipses)
+    {
+        LunarEclipseHandler handler;
+        handler.setGeoLocation(KStarsData::Instance()->geo());
+
+        QElapsedTimer timer;
+        timer.start();
+        for (const auto &eclipse : handler.computeEclipses(startJD, stopJD))
+            eclipses.append(eclipse->getJD());
+        return timer.elapsed();
+    };
+
+    QVector<long double> series, cached;
+    setCached(false);
+    const qint64 seriesMsecs = search(series);
+    setCached(true);
+    const qint64 cachedMsecs = search(cached);
+
+    qInfo() << QString("  %1 lunar eclipses in a year: series %2 ms, cached %3 ms")
+            .arg(cached.size()).arg(seriesMsecs).arg(cachedMsecs);
+
+    QCOMPARE(series.size(), 2);
+    QCOMPARE(cached.size(), series.size());
+    for (int i = 0; i < series.size(); i++)
+        QVERIFY(std::abs(static_cast<double>(cached[i] - series[i])) < 1.0 / (24 * 60));
+}
+
+QTEST_MAIN(TestEphemerisCache)
+
+#include "test_ephemeriscache.moc"
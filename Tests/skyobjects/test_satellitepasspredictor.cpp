@@ -0,0 +1,250 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QtGlobal>
+#include <QTest>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+
+#include "../testhelpers.h"
+
+#include "kstarsdata.h"
+#include "kstarsdatetime.h"
+#include "skyobjects/satellite.h"
+#include "skyobjects/satellitepasspredictor.h"
+
+#include <cmath>
+
+// Predicts the passes of synthetic TLE sets with SatellitePassPredictor, checks them against the
+// elevation sampled every second and times a week of passes of 1000 satellites against sampling
+// them every minute.
+class TestSatellitePassPredictor : public QObject
+{
+        Q_OBJECT
+
+    private:
+        // A mix of low orbits, and of GPS, geostationary and Molniya orbits for the deep space terms
+        QVector<Satellite *> makeSatellites(int count, quint32 seed) const;
+
+        // A pass found by sampling the elevation every second
+        struct SampledPass
+        {
+            double aos { 0 }, los { 0 }, maxElevation { -90 };
+            bool visible { false };
+        };
+        QVector<SampledPass> samplePasses(Satellite *sat, double days, double minElevation) const;
+
+        double m_StartJD { 0 };
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void accuracy_data();
+        void accuracy();
+        void benchmark();
+};
+
+QVector<Satellite *> TestSatellitePassPredictor::makeSatellites(int count, quint32 seed) const
+{
+    QRandomGenerator random(seed);
+    QVector<Satellite *> satellites;
+    for (int i = 0; i < count; i++)
+    {
+        double meanMotion, eccentricity, inclination, bstar = 0;
+        const double orbit = random.generateDouble();
+        if (orbit < 0.9)
+        {
+            meanMotion = 14.0 + 2.2 * random.generateDouble();
+            eccentricity = 0.02 * std::pow(random.generateDouble(), 2);
+            inclination = 100.0 * random.generateDouble();
+            bstar = 1e-5 + 5e-4 * random.generateDouble();
+        }
+        else if (orbit < 0.94)
+        {
+            meanMotion = 2.0056;
+            eccentricity = 0.01 * random.generateDouble();
+            inclination = 55.0 + random.generateDouble();
+        }
+        else if (orbit < 0.98)
+        {
+            meanMotion = 1.0027;
+            eccentricity = 0.0005 * random.generateDouble();
+            inclination = 5.0 * random.generateDouble();
+        }
+        else
+        {
+            meanMotion = 2.006;
+            eccentricity = 0.7 + 0.02 * random.generateDouble();
+            inclination = 63.4;
+        }
+
+        // BSTAR as the TLE writes it, a mantissa and a negative power of ten
+        int exponent = 0;
+        double mantissa = bstar;
+        while (mantissa > 0 && mantissa < 0.1)
+        {
+            mantissa *= 10;
+            exponent++;
+        }
+
+        const QString line1 = QString::asprintf("1 %05dU 26001A   26290.50000000  .00001000  00000-0  %05d-%1d 0  9990",
+                                                i % 100000, static_cast<int>(mantissa * 1e5), exponent);
+        const QString line2 = QString::asprintf("2 %05d %8.4f %8.4f %07d %8.4f %8.4f %11.8f 10000", i % 100000,
+                                                inclination, 360 * random.generateDouble(),
+                                                static_cast<int>(eccentricity * 1e7), 360 * random.generateDouble(),
+                                                360 * random.generateDouble(), meanMotion);
+        satellites.append(new Satellite(QString("SAT %1").arg(i), line1, line2));
+    }
+    return satellites;
+}
+
+QVector<TestSatellitePassPredictor::SampledPass> TestSatellitePassPredictor::samplePasses(Satellite *sat,
+        double days, double minElevation) const
+{
+    QVector<SampledPass> passes;
+    SampledPass pass;
+    bool inPass = false;
+    const int seconds = static_cast<int>(days * 86400);
+    for (int s = 0; s <= seconds; s++)
+    {
+        const double jd = m_StartJD + s / 86400.0;
+        if (sat->updatePos(Satellite::observer(jd)) != 0)
+            break;
+
+        const double elevation = sat->alt().Degrees();
+        if (elevation >= minElevation)
+        {
+            if (!inPass)
+            {
+                pass = SampledPass();
+                pass.aos = jd;
+                inPass = true;
+            }
+            pass.maxElevation = std::max(pass.maxElevation, elevation);
+            pass.visible = pass.visible || sat->isVisible();
+        }
+        else if (inPass)
+        {
+            pass.los = jd;
+            passes.append(pass);
+            inPass = false;
+        }
+    }
+    if (inPass)
+    {
+        pass.los = m_StartJD + seconds / 86400.0;
+        passes.append(pass);
+    }
+    return passes;
+}
+
+void TestSatellitePassPredictor::initTestCase()
+{
+    KTEST_BEGIN();
+
+    // Satellite needs the geographic location of KStarsData
+    KStarsData *data = KStarsData::Create();
+    QVERIFY(data != nullptr);
+    QVERIFY(data->initialize());
+
+    // A day after the epoch of the TLEs
+    m_StartJD = KStarsDateTime(QDate(2026, 10, 18), QTime(12, 0, 0)).djd();
+}
+
+void TestSatellitePassPredictor::cleanupTestCase()
+{
+    KTEST_END();
+}
+
+void TestSatellitePassPredictor::accuracy_data()
+{
+    QTest::addColumn<double>("minElevation");
+
+    QTest::newRow("horizon") << 0.0;
+    QTest::newRow("10 degrees") << 10.0;
+}
+
+void TestSatellitePassPredictor::accuracy()
+{
+    QFETCH(double, minElevation);
+
+    constexpr double DAYS = 1;
+    constexpr double SECOND = 1.0 / 86400.0;
+    const QVector<Satellite *> satellites = makeSatellites(30, 4);
+
+    SatellitePassPredictor predictor(satellites, KStarsData::Instance()->geo());
+    predictor.setMinElevation(minElevation);
+    const QVector<SatellitePass> passes = predictor.predict(m_StartJD, DAYS);
+
+    int count = 0, visibleMismatches = 0;
+    for (Satellite *sat : satellites)
+    {
+        const QVector<SampledPass> sampled = samplePasses(sat, DAYS, minElevation);
+        for (const SampledPass &expected : sampled)
+        {
+            // The sampled times are up to a second late
+            auto pass = std::find_if(passes.cbegin(), passes.cend(), [&](const SatellitePass & p)
+            {
+                return p.name == sat->name() && std::abs(p.aos - expected.aos) <= 2 * SECOND &&
+                       std::abs(p.los - expected.los) <= 2 * SECOND;
+            });
+            QVERIFY2(pass != passes.cend(), qPrintable(QString("%1 pass at %2 missed").arg(sat->name())
+                     .arg(expected.aos, 0, 'f', 6)));
+
+            QVERIFY(pass->tca >= pass->aos && pass->tca <= pass->los);
+            QVERIFY(pass->maxElevation >= expected.maxElevation - 0.01);
+            QVERIFY(pass->maxElevation >= minElevation);
+            QVERIFY(pass->illuminated >= 0 && pass->illuminated <= 1);
+            if (pass->visible != expected.visible)
+                visibleMismatches++;
+        }
+        count += sampled.size();
+    }
+    QCOMPARE(passes.size(), count);
+    QVERIFY(count > 0);
+
+    // The predictor looks at the sunlight once a minute, a few seconds of visibility may differ
+    QVERIFY(visibleMismatches <= std::max(1, count / 20));
+
+    qDeleteAll(satellites);
+}
+
+void TestSatellitePassPredictor::benchmark()
+{
+    constexpr int COUNT = 1000;
+    constexpr int DAYS = 7;
+    const QVector<Satellite *> satellites = makeSatellites(COUNT, 5);
+
+    // Sampling the elevation every minute, which only brackets the passes
+    QElapsedTimer timer;
+    timer.start();
+    for (int step = 0; step <= DAYS * 1440; step++)
+    {
+        const Satellite::Observer observer = Satellite::observer(m_StartJD + step / 1440.0);
+        for (Satellite *sat : satellites)
+            sat->updatePos(observer);
+    }
+    const qint64 sampledMsecs = timer.elapsed();
+
+    timer.restart();
+    SatellitePassPredictor predictor(satellites, KStarsData::Instance()->geo());
+    const QVector<SatellitePass> passes = predictor.predict(m_StartJD, DAYS);
+    const qint64 predictedMsecs = timer.elapsed();
+
+    int visible = 0;
+    for (const SatellitePass &pass : passes)
+        visible += pass.visible ? 1 : 0;
+
+    qInfo() << QString("  %1 satellites, %2 days: %3 passes (%4 visible) predicted in %5 ms, sampling every minute %6 ms, %7x")
+            .arg(COUNT).arg(DAYS).arg(passes.size()).arg(visible).arg(predictedMsecs).arg(sampledMsecs)
+            .arg(static_cast<double>(sampledMsecs) / std::max<qint64>(predictedMsecs, 1), 0, 'f', 1);
+
+    qDeleteAll(satellites);
+}
+
+QTEST_MAIN(TestSatellitePassPredictor)
+
+#include "test_satellitepasspredictor.moc"
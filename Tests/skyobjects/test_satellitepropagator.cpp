@@ -0,0 +1,224 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QtGlobal>
+#include <QTest>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+
+#include "../testhelpers.h"
+
+#include "kstarsdata.h"
+#include "kstarsdatetime.h"
+#include "skyobjects/satellite.h"
+#include "skyobjects/satellitepropagator.h"
+
+#include <cmath>
+
+// Propagates synthetic TLE sets with SatellitePropagator and with Satellite::updatePos() one satellite
+// at a time, checks that they agree and times a simulated hour of 20 000 satellites.
+class TestSatellitePropagator : public QObject
+{
+        Q_OBJECT
+
+    private:
+        // A mix of low orbits, and of GPS, geostationary and Molniya orbits for the deep space terms
+        QVector<Satellite *> makeSatellites(int count, quint32 seed) const;
+
+        double m_StartJD { 0 };
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void accuracy();
+        void belowHorizon();
+        void benchmark();
+};
+
+QVector<Satellite *> TestSatellitePropagator::makeSatellites(int count, quint32 seed) const
+{
+    QRandomGenerator random(seed);
+    QVector<Satellite *> satellites;
+    for (int i = 0; i < count; i++)
+    {
+        double meanMotion, eccentricity, inclination, bstar = 0;
+        const double orbit = random.generateDouble();
+        if (orbit < 0.9)
+        {
+            meanMotion = 14.0 + 2.2 * random.generateDouble();
+            eccentricity = 0.02 * std::pow(random.generateDouble(), 2);
+            inclination = 100.0 * random.generateDouble();
+            bstar = 1e-5 + 5e-4 * random.generateDouble();
+        }
+        else if (orbit < 0.94)
+        {
+            meanMotion = 2.0056;
+            eccentricity = 0.01 * random.generateDouble();
+            inclination = 55.0 + random.generateDouble();
+        }
+        else if (orbit < 0.98)
+        {
+            meanMotion = 1.0027;
+            eccentricity = 0.0005 * random.generateDouble();
+            inclination = 5.0 * random.generateDouble();
+        }
+        else
+        {
+            meanMotion = 2.006;
+            eccentricity = 0.7 + 0.02 * random.generateDouble();
+            inclination = 63.4;
+        }
+
+        // BSTAR as the TLE writes it, a mantissa and a negative power of ten
+        int exponent = 0;
+        double mantissa = bstar;
+        while (mantissa > 0 && mantissa < 0.1)
+        {
+            mantissa *= 10;
+            exponent++;
+        }
+
+        const QString line1 = QString::asprintf("1 %05dU 26001A   26290.50000000  .00001000  00000-0  %05d-%1d 0  9990",
+                                                i % 100000, static_cast<int>(mantissa * 1e5), exponent);
+        const QString line2 = QString::asprintf("2 %05d %8.4f %8.4f %07d %8.4f %8.4f %11.8f 10000", i % 100000,
+                                                inclination, 360 * random.generateDouble(),
+                                                static_cast<int>(eccentricity * 1e7), 360 * random.generateDouble(),
+                                                360 * random.generateDouble(), meanMotion);
+        satellites.append(new Satellite(QString("SAT %1").arg(i), line1, line2));
+    }
+    return satellites;
+}
+
+void TestSatellitePropagator::initTestCase()
+{
+    KTEST_BEGIN();
+
+    // Satellite needs the geographic location and the Sun of KStarsData
+    KStarsData *data = KStarsData::Create();
+    QVERIFY(data != nullptr);
+    QVERIFY(data->initialize());
+
+    // A day after the epoch of the TLEs
+    m_StartJD = KStarsDateTime(QDate(2026, 10, 18), QTime(12, 0, 0)).djd();
+}
+
+void TestSatellitePropagator::cleanupTestCase()
+{
+    KTEST_END();
+}
+
+void TestSatellitePropagator::accuracy()
+{
+    const QVector<Satellite *> scalar = makeSatellites(2000, 1);
+    const QVector<Satellite *> batch = makeSatellites(2000, 1);
+
+    SatellitePropagator propagator;
+    propagator.setSatellites(batch);
+
+    // A day, forth then back, which restarts the resonance integration of the deep space orbits
+    for (int step = -24; step <= 24; step++)
+    {
+        const Satellite::Observer observer = Satellite::observer(m_StartJD + std::abs(step) / 24.0);
+        propagator.updatePositions(observer, false);
+        for (int i = 0; i < scalar.size(); i++)
+        {
+            QCOMPARE(propagator.error(i), scalar[i]->updatePos(observer));
+            if (propagator.error(i) != 0)
+                continue;
+
+            QVERIFY(std::abs(batch[i]->range() - scalar[i]->range()) < 1e-6);
+            QVERIFY(std::abs(batch[i]->velocity() - scalar[i]->velocity()) < 1e-9);
+            QVERIFY(std::abs(batch[i]->alt().Degrees() - scalar[i]->alt().Degrees()) < 1e-7);
+            QVERIFY(std::abs(batch[i]->az().Degrees() - scalar[i]->az().Degrees()) < 1e-7);
+            QVERIFY(std::abs(batch[i]->ra().Degrees() - scalar[i]->ra().Degrees()) < 1e-7);
+            QVERIFY(std::abs(batch[i]->dec().Degrees() - scalar[i]->dec().Degrees()) < 1e-7);
+            QCOMPARE(batch[i]->isVisible(), scalar[i]->isVisible());
+        }
+    }
+
+    qDeleteAll(scalar);
+    qDeleteAll(batch);
+}
+
+void TestSatellitePropagator::belowHorizon()
+{
+    const QVector<Satellite *> scalar = makeSatellites(2000, 2);
+    const QVector<Satellite *> batch = makeSatellites(2000, 2);
+
+    SatellitePropagator propagator;
+    propagator.setSatellites(batch);
+
+    const Satellite::Observer observer = Satellite::observer(m_StartJD);
+    propagator.updatePositions(observer, true);
+    int below = 0;
+    for (int i = 0; i < scalar.size(); i++)
+    {
+        QCOMPARE(propagator.error(i), scalar[i]->updatePos(observer));
+        if (propagator.error(i) != 0)
+            continue;
+
+        // The coordinates are always set, the visibility is only tested above the horizon
+        QVERIFY(std::abs(batch[i]->alt().Degrees() - scalar[i]->alt().Degrees()) < 1e-7);
+        QVERIFY(std::abs(batch[i]->az().Degrees() - scalar[i]->az().Degrees()) < 1e-7);
+        QVERIFY(std::abs(batch[i]->ra().Degrees() - scalar[i]->ra().Degrees()) < 1e-7);
+        QVERIFY(std::abs(batch[i]->dec().Degrees() - scalar[i]->dec().Degrees()) < 1e-7);
+        if (batch[i]->alt().Degrees() <= SkyPoint::altCrit)
+        {
+            below++;
+            QVERIFY(!batch[i]->isVisible());
+        }
+        else
+            QCOMPARE(batch[i]->isVisible(), scalar[i]->isVisible());
+    }
+    QVERIFY(below > scalar.size() / 2);
+
+    qDeleteAll(scalar);
+    qDeleteAll(batch);
+}
+
+void TestSatellitePropagator::benchmark()
+{
+    constexpr int COUNT = 20000;
+    constexpr int STEPS = 60;
+    const QVector<Satellite *> satellites = makeSatellites(COUNT, 3);
+
+    // One satellite at a time, as the satellite groups used to update
+    QElapsedTimer timer;
+    timer.start();
+    for (int step = 0; step < STEPS; step++)
+    {
+        const double jd = m_StartJD + step / 1440.0;
+        for (Satellite *sat : satellites)
+            sat->updatePos(Satellite::observer(jd));
+    }
+    const qint64 scalarMsecs = timer.elapsed();
+
+    timer.restart();
+    SatellitePropagator propagator;
+    propagator.setSatellites(satellites);
+    const qint64 setupMsecs = timer.elapsed();
+
+    // Once a simulated minute over an hour, hiding the satellites under the ground as the sky map does
+    timer.restart();
+    for (int step = 0; step < STEPS; step++)
+        propagator.updatePositions(Satellite::observer(m_StartJD + step / 1440.0), true);
+    const qint64 batchMsecs = timer.elapsed();
+
+    timer.restart();
+    for (int step = 0; step < STEPS; step++)
+        propagator.propagate(m_StartJD + step / 1440.0);
+    const qint64 propagateMsecs = timer.elapsed();
+
+    qInfo() << QString("  %1 satellites, %2 steps: one at a time %3 ms, batched %4 ms (propagation only %5 ms, setup %6 ms), %7x")
+            .arg(COUNT).arg(STEPS).arg(scalarMsecs).arg(batchMsecs).arg(propagateMsecs).arg(setupMsecs)
+            .arg(static_cast<double>(scalarMsecs) / std::max<qint64>(batchMsecs, 1), 0, 'f', 1);
+
+    qDeleteAll(satellites);
+}
+
+QTEST_MAIN(TestSatellitePropagator)
+
+#include "test_satellitepropagator.moc"
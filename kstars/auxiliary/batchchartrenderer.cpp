@@ -0,0 +1,313 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "batchchartrenderer.h"
+
+#include "kstarsdata.h"
+#include "ksutils.h"
+#include "Options.h"
+#include "simclock.h"
+#include "skymap.h"
+#include "projections/projector.h"
+
+#include <kstars_debug.h>
+
+#include <KLocalizedString>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMetaEnum>
+#include <QTimeZone>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <numeric>
+
+BatchChartRenderer::BatchChartRenderer(KStarsData *data, SkyMap *map, int workers) : m_Data(data), m_Map(map)
+{
+    m_Workers.setMaxThreadCount(std::max(1, workers));
+}
+
+bool BatchChartRenderer::readJobs(const QString &fileName, QVector<Job> &jobs, QString &error)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        error = i18n("Unable to open %1: %2", fileName, file.errorString());
+        return false;
+    }
+    const QByteArray content = file.readAll();
+
+    const QString suffix = QFileInfo(fileName).suffix().toLower();
+    if (suffix == "json")
+        return readJson(content, jobs, error);
+    if (suffix == "csv")
+        return readCsv(content, jobs, error);
+
+    error = i18n("Jobs are read from JSON or CSV files, not %1", fileName);
+    return false;
+}
+
+bool BatchChartRenderer::readJson(const QByteArray &content, QVector<Job> &jobs, QString &error)
+{
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(content, &parseError);
+    if (document.isNull())
+    {
+        error = parseError.errorString();
+        return false;
+    }
+
+    const QJsonArray array = document.isArray() ? document.array() : document.object().value("jobs").toArray();
+    for (const auto &value : array)
+    {
+        const QJsonObject object = value.toObject();
+        Job job;
+        for (auto it = object.constBegin(); it != object.constEnd(); ++it)
+        {
+            if (!setField(job, it.key().toLower(), it.value().toVariant(), error))
+            {
+                error = i18n("Job %1: %2", jobs.size() + 1, error);
+                return false;
+            }
+        }
+        if (!checkJob(job, error))
+        {
+            error = i18n("Job %1: %2", jobs.size() + 1, error);
+            return false;
+        }
+        jobs.append(job);
+    }
+    return true;
+}
+
+bool BatchChartRenderer::readCsv(const QByteArray &content, QVector<Job> &jobs, QString &error)
+{
+    QStringList columns;
+    int lineNumber = 0;
+    for (const QByteArray &rawLine : content.split('\n'))
+    {
+        lineNumber++;
+        const QString line = QString::fromUtf8(rawLine).trimmed();
+        if (line.isEmpty() || line.startsWith('#'))
+            continue;
+
+        QStringList fields = line.split(',');
+        for (auto &field : fields)
+        {
+            field = field.trimmed();
+            if (field.size() >= 2 && field.startsWith('"') && field.endsWith('"'))
+                field = field.mid(1, field.size() - 2);
+        }
+
+        // The first line names the columns
+        if (columns.isEmpty())
+        {
+            for (const auto &field : fields)
+                columns.append(field.toLower());
+            continue;
+        }
+
+        if (fields.size() != columns.size())
+        {
+            error = i18n("Line %1: %2 fields for %3 columns", lineNumber, fields.size(), columns.size());
+            return false;
+        }
+
+        Job job;
+        for (int i = 0; i < fields.size(); i++)
+        {
+            if (!setField(job, columns[i], fields[i], error))
+            {
+                error = i18n("Line %1: %2", lineNumber, error);
+                return false;
+            }
+        }
+        if (!checkJob(job, error))
+        {
+            error = i18n("Line %1: %2", lineNumber, error);
+            return false;
+        }
+        jobs.append(job);
+    }
+    return true;
+}
+
+bool BatchChartRenderer::setField(Job &job, const QString &key, const QVariant &value, QString &error)
+{
+    const QString text = value.toString().trimmed();
+    bool ok = true;
+
+    if (key == "ra" || key == "dec")
+    {
+        // Plain numbers are degrees, sexagesimal RA is in hours
+        const bool isDec = key == "dec";
+        dms &angle = isDec ? job.dec : job.ra;
+        const double degrees = text.toDouble(&ok);
+        if (ok)
+            angle.setD(degrees);
+        else
+            ok = angle.setFromString(text, isDec);
+    }
+    else if (key == "fov")
+        job.fov = text.toDouble(&ok);
+    else if (key == "width")
+        job.width = text.toInt(&ok);
+    else if (key == "height")
+        job.height = text.toInt(&ok);
+    else if (key == "output")
+        job.output = text;
+    else if (key == "time")
+    {
+        if (!text.isEmpty())
+        {
+            QDateTime time = QDateTime::fromString(text, Qt::ISODate);
+            // Without an offset the time is UTC
+            if (time.timeSpec() == Qt::LocalTime)
+                time.setTimeZone(QTimeZone::utc());
+            job.time = KStarsDateTime(time.toUTC());
+            ok = time.isValid();
+        }
+    }
+    else if (key == "projection")
+    {
+        if (!text.isEmpty())
+        {
+            job.projection = text.toInt(&ok);
+            if (!ok)
+                job.projection = QMetaEnum::fromType<Projector::Projection>().keyToValue(text.toLatin1().constData(), &ok);
+            ok = ok && job.projection >= 0 && job.projection < Projector::UnknownProjection;
+        }
+    }
+    else
+    {
+        error = i18n("Unknown field %1", key);
+        return false;
+    }
+
+    if (!ok)
+        error = i18n("Invalid %1: %2", key, text);
+    return ok;
+}
+
+bool BatchChartRenderer::checkJob(const Job &job, QString &error)
+{
+    if (job.output.isEmpty())
+        error = i18n("No output file");
+    else if (job.fov <= 0)
+        error = i18n("No field of view");
+    else if (job.width <= 0 || job.height <= 0)
+        error = i18n("No image size");
+    else
+        return true;
+    return false;
+}
+
+int BatchChartRenderer::render(const QVector<Job> &jobs)
+{
+    const bool asyncStarLoading = Options::asyncStarLoading();
+    const uint projection       = Options::projection();
+    const double zoomFactor     = Options::zoomFactor();
+    // The charts are drawn once, the deep stars can't be left loading in the background
+    Options::setAsyncStarLoading(false);
+
+    // Jobs of the same time share the positions of the sky, draw them in order of time
+    const KStarsDateTime now = KStarsDateTime::currentDateTimeUtc();
+    auto timeOf = [&](int i)
+    {
+        return jobs[i].time.isValid() ? jobs[i].time : now;
+    };
+    QVector<int> order(jobs.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b)
+    {
+        return timeOf(a).djd() < timeOf(b).djd();
+    });
+
+    QElapsedTimer total;
+    total.start();
+    int failed = 0;
+    for (int index : order)
+    {
+        const Job &job = jobs[index];
+        QElapsedTimer timer;
+        timer.start();
+
+        Options::setProjection(job.projection >= 0 ? job.projection : projection);
+        Options::setZoomFactor(KSUtils::clamp(job.width / (job.fov * dms::DegToRad), MINZOOM, MAXZOOM));
+        setTime(timeOf(index));
+
+        m_Map->resize(job.width, job.height);
+        m_Map->setDestination(job.ra, job.dec);
+        m_Map->setFocus(job.ra, job.dec);
+        qApp->processEvents();
+        m_Map->setupProjector();
+
+        QImage image(job.width, job.height, QImage::Format_ARGB32_Premultiplied);
+        m_Map->exportSkyImage(&image);
+        const qint64 drawn = timer.elapsed();
+
+        // The image is shared with the worker, which holds the only reference once this loop goes on
+        const QString output = job.output;
+        const int number = index + 1, count = jobs.size();
+        m_Writes.append(QtConcurrent::run(&m_Workers, [image, output, number, count, drawn]()
+        {
+            QElapsedTimer timer;
+            timer.start();
+            if (!image.save(output))
+            {
+                qCWarning(KSTARS) << "Unable to save image:" << output;
+                return false;
+            }
+            qCInfo(KSTARS) << QString("Chart %1/%2 %3: drawn in %4 ms, written in %5 ms")
+                           .arg(number).arg(count).arg(output).arg(drawn).arg(timer.elapsed());
+            return true;
+        }));
+
+        // Don't let the drawn images pile up if writing is slower than drawing
+        failed += waitForWrites(2 * m_Workers.maxThreadCount());
+    }
+    failed += waitForWrites(0);
+
+    Options::setAsyncStarLoading(asyncStarLoading);
+    Options::setProjection(projection);
+    Options::setZoomFactor(zoomFactor);
+
+    qCInfo(KSTARS) << QString("%1 charts in %2 ms, %3 failed").arg(jobs.size()).arg(total.elapsed()).arg(failed);
+    return failed;
+}
+
+void BatchChartRenderer::setTime(const KStarsDateTime &time)
+{
+    if (m_LastTime.isValid() && m_LastTime == time)
+        return;
+
+    // The first time everything is computed, later only what moved enough since the previous job
+    if (!m_LastTime.isValid())
+        m_Data->setFullTimeUpdate();
+    m_LastTime = time;
+    m_Data->clock()->setUTC(time);
+    m_Data->updateTime(m_Data->geo(), true);
+}
+
+int BatchChartRenderer::waitForWrites(int pending)
+{
+    int failed = 0;
+    while (m_Writes.size() > pending)
+    {
+        QFuture<bool> write = m_Writes.takeFirst();
+        write.waitForFinished();
+        if (!write.result())
+            failed++;
+    }
+    return failed;
+}
@@ -0,0 +1,103 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "dms.h"
+#include "kstarsdatetime.h"
+
+#include <QFuture>
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+
+class KStarsData;
+class QVariant;
+class SkyMap;
+
+/**
+ * @class BatchChartRenderer
+ * Renders many sky charts with a single start of KStarsData.
+ *
+ * Each job gives the center, field of view, time, projection, size and output file of a chart.
+ * Jobs are read from a JSON file, either an array of job objects or an object with such an array
+ * as "jobs", or from a CSV file whose first line names the columns:
+ *
+ * - ra: right ascension, in degrees as a number or in hours as a sexagesimal string
+ * - dec: declination in degrees, as a number or a sexagesimal string
+ * - fov: width of the chart in degrees
+ * - time: UTC as ISO 8601, the current time if empty
+ * - projection: Lambert, AzimuthalEquidistant, Orthographic, Equirectangular, Stereographic or
+ *   Gnomonic, the current projection if empty
+ * - width, height: size of the image in pixels
+ * - output: image file, whose format is given by its extension
+ *
+ * The catalogs, the sky mesh and the positions updated for one time are shared by all the jobs,
+ * so the jobs are rendered by time and the sky is only updated when the time changes. The
+ * composite is drawn on this thread, with the stars and HiPS tiles of each chart split over the
+ * global thread pool by SkyQPainter. Encoding and writing the images, which takes about as long
+ * as drawing them, runs on a pool of workers while the next charts are drawn.
+ *
+ * @short Headless renderer of a list of sky charts
+ */
+class BatchChartRenderer
+{
+    public:
+        struct Job
+        {
+            dms ra;
+            dms dec;
+            double fov { 0 };
+            /// Invalid for the current time
+            KStarsDateTime time;
+            /// -1 for the current projection
+            int projection { -1 };
+            int width { 0 };
+            int height { 0 };
+            QString output;
+        };
+
+        /**
+         * @short Constructor
+         * @param data initialized data, with the location and color scheme set
+         * @param map sky map to project and draw with
+         * @param workers number of threads encoding and writing the images
+         */
+        BatchChartRenderer(KStarsData *data, SkyMap *map, int workers);
+
+        /**
+         * @short Read the jobs of a JSON or CSV file, which is told by its extension
+         * @param fileName of the job file
+         * @param jobs filled with the jobs of the file
+         * @param error set to the reason when the file can't be read
+         * @return true if every job of the file could be read
+         */
+        static bool readJobs(const QString &fileName, QVector<Job> &jobs, QString &error);
+
+        /**
+         * @short Render the charts and wait for all of them to be written
+         * @return the number of charts that could not be written
+         */
+        int render(const QVector<Job> &jobs);
+
+    private:
+        static bool readJson(const QByteArray &content, QVector<Job> &jobs, QString &error);
+        static bool readCsv(const QByteArray &content, QVector<Job> &jobs, QString &error);
+        /** Set a field of a job from its value in the file */
+        static bool setField(Job &job, const QString &key, const QVariant &value, QString &error);
+        static bool checkJob(const Job &job, QString &error);
+
+        /** Bring the sky to the time of a job, only when it differs from the last one */
+        void setTime(const KStarsDateTime &time);
+        /** Wait until at most the given number of images are still being written */
+        int waitForWrites(int pending);
+
+        KStarsData *m_Data { nullptr };
+        SkyMap *m_Map { nullptr };
+        QThreadPool m_Workers;
+        QVector<QFuture<bool>> m_Writes;
+        KStarsDateTime m_LastTime;
+};
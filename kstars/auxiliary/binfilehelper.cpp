@@ -9,8 +9,16 @@
 #include "byteorder.h"
 #include "auxiliary/kspaths.h"
 
+#include <QFile>
 #include <QStandardPaths>
 
+#include <algorithm>
+
+#ifdef Q_OS_UNIX
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 class BinFileHelper;
 
 BinFileHelper::BinFileHelper()
@@ -24,10 +32,12 @@ BinFileHelper::~BinFileHelper()
     fields.clear();
     if (fileHandle)
         closeFile();
+    unmapFile();
 }
 
 void BinFileHelper::init()
 {
+    unmapFile();
     if (fileHandle)
         fclose(fileHandle);
 
@@ -83,6 +93,7 @@ FILE *BinFileHelper::openFile(const QString &fileName)
         errnum = ERR_FILEOPEN;
         return nullptr;
     }
+    filePath = FilePath;
     return fileHandle;
 }
 
@@ -275,10 +286,74 @@ bool BinFileHelper::readHeader()
 
 void BinFileHelper::closeFile()
 {
+    unmapFile();
     fclose(fileHandle);
     fileHandle = nullptr;
 }
 
+bool BinFileHelper::mapFile()
+{
+    unmapFile();
+    if (!fileHandle || !indexUpdated)
+        return false;
+
+    mappedFile.reset(new QFile(filePath));
+    if (mappedFile->open(QIODevice::ReadOnly))
+    {
+        mappedSize = mappedFile->size();
+        mappedData = mappedFile->map(0, mappedSize);
+    }
+
+    // Mapping can fail, e.g. for the largest catalogs on 32-bit systems, in which case the file is read as before
+    if (!mappedData)
+    {
+        mappedFile.reset();
+        mappedSize = 0;
+        return false;
+    }
+    return true;
+}
+
+void BinFileHelper::unmapFile()
+{
+    if (mappedFile && mappedData)
+        mappedFile->unmap(mappedData);
+    mappedFile.reset();
+    mappedData = nullptr;
+    mappedSize = 0;
+}
+
+const uchar *BinFileHelper::getRecords(int id) const
+{
+    if (!mappedData || !indexUpdated || id < 0 || id >= indexOffset.size())
+        return nullptr;
+
+    const qint64 start = indexOffset.at(id);
+    const qint64 end   = start + static_cast<qint64>(indexCount.at(id)) * recordSize;
+    if (start <= 0 || end > mappedSize)
+        return nullptr;
+    return mappedData + start;
+}
+
+void BinFileHelper::prefetchRecords(int id, quint32 firstRecord, quint32 maxBytes) const
+{
+#ifdef Q_OS_UNIX
+    const uchar *records = getRecords(id);
+    if (!records || firstRecord >= indexCount.at(id))
+        return;
+
+    static const long pageSize = sysconf(_SC_PAGESIZE);
+    const qint64 length = std::min<qint64>(static_cast<qint64>(indexCount.at(id) - firstRecord) * recordSize, maxBytes);
+    const qint64 start  = (records - mappedData) + static_cast<qint64>(firstRecord) * recordSize;
+    const qint64 page   = start - start % pageSize;
+    posix_madvise(mappedData + page, start + length - page, POSIX_MADV_WILLNEED);
+#else
+    Q_UNUSED(id)
+    Q_UNUSED(firstRecord)
+    Q_UNUSED(maxBytes)
+#endif
+}
+
 int BinFileHelper::getErrorNumber()
 {
     int err = errnum;
@@ -10,7 +10,9 @@
 #include <QVector>
 
 #include <cstdio>
+#include <memory>
 
+class QFile;
 class QString;
 
 /**
@@ -31,6 +33,10 @@ typedef struct dataElement
  * by KStars. The file format is designed specifically to support data that has the form of an
  * array of structures. See data/README.fileformat for details.
  * The methods use primitive C file I/O routines defined in stdio.h to obtain efficiency
+ *
+ * Once the header is read the file may also be memory mapped with mapFile(). The records of each
+ * index entry can then be decoded straight from the mapping, without a seek and a read per record,
+ * and the pages of entries that will be needed soon can be prefetched by the kernel.
  * @short Implements an interface to handle binary data files used by KStars
  * @author Akarsh Simha
  * @version 1.0
@@ -69,6 +75,52 @@ class BinFileHelper
          */
         void closeFile();
 
+        /**
+         * @short  Memory map the open file, read only
+         * @note   To be called after readHeader(). The FILE handle stays open and valid.
+         * @return True if the file was mapped. If not, the records must be read with the FILE handle.
+         */
+        bool mapFile();
+
+        /**
+         * @short  Unmap the file, if it was mapped
+         */
+        void unmapFile();
+
+        /**
+         * @return True if the file is memory mapped
+         */
+        inline bool isMapped() const
+        {
+            return mappedData != nullptr;
+        }
+
+        /**
+         * @short  Returns the mapped contents of the file
+         * @return Pointer to the start of the file, or nullptr if the file is not mapped
+         */
+        inline const uchar *getMappedData() const
+        {
+            return mappedData;
+        }
+
+        /**
+         * @short  Returns the records under the given index ID, in the mapping
+         * @param  id  ID of the index entry
+         * @return Pointer to the first of getRecordCount(id) records of guessRecordSize() bytes each,
+         *         without byte swapping, or nullptr if the file is not mapped or the entry lies outside it
+         * @note   Records are not aligned, copy them out with memcpy.
+         */
+        const uchar *getRecords(int id) const;
+
+        /**
+         * @short  Ask the kernel to read ahead the records under the given index ID, if the file is mapped
+         * @param  id  ID of the index entry
+         * @param  firstRecord  First record to read ahead
+         * @param  maxBytes  Read ahead no more than this many bytes
+         */
+        void prefetchRecords(int id, quint32 firstRecord = 0, quint32 maxBytes = 256 * 1024) const;
+
         /**
          * @short   Get error number
          * @return  A number corresponding to the error
@@ -262,6 +314,14 @@ class BinFileHelper
 
         /// Handle to the file.
         FILE *fileHandle { nullptr};
+        /// Path of the open file
+        QString filePath;
+        /// The file, while it is memory mapped
+        std::unique_ptr<QFile> mappedFile;
+        /// Start of the mapping of the whole file
+        uchar *mappedData { nullptr };
+        /// Size of the mapping
+        qint64 mappedSize { 0 };
         /// Stores offsets corresponding to each index table entry
         QVector < unsigned long > indexOffset;
         /// Stores number of records under each index table entry
@@ -0,0 +1,228 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "histogrammedian.h"
+
+#include <QFuture>
+#include <QThread>
+#include <QtConcurrent>
+
+#include <algorithm>
+
+namespace Mathematics
+{
+
+namespace
+{
+// Smallest number of samples worth giving to a thread
+constexpr size_t MIN_CHUNK = 1 << 18;
+
+size_t numChunks(size_t count)
+{
+    return std::max<size_t>(1, std::min<size_t>(QThread::idealThreadCount(), count / MIN_CHUNK));
+}
+}
+
+std::vector<uint32_t> HistogramMedian::accumulate(size_t count, int bins,
+        const std::function<void(size_t, size_t, uint32_t *)> &fill)
+{
+    const size_t chunks = numChunks(count);
+    std::vector<uint32_t> histogram(bins, 0);
+    if (chunks == 1)
+    {
+        fill(0, count, histogram.data());
+        return histogram;
+    }
+
+    std::vector<std::vector<uint32_t>> partials(chunks);
+    QVector<QFuture<void>> futures;
+    const size_t chunkSize = (count + chunks - 1) / chunks;
+    for (size_t c = 0; c < chunks; c++)
+    {
+        const size_t begin = c * chunkSize;
+        const size_t end = std::min(count, begin + chunkSize);
+        futures.append(QtConcurrent::run([&partials, &fill, c, begin, end, bins]()
+        {
+            partials[c].assign(bins, 0);
+            fill(begin, end, partials[c].data());
+        }));
+    }
+    for (auto &future : futures)
+        future.waitForFinished();
+
+    for (const auto &partial : partials)
+        for (int bin = 0; bin < bins; bin++)
+            histogram[bin] += partial[bin];
+    return histogram;
+}
+
+bool HistogramMedian::accumulateRange(size_t count,
+                                      const std::function<void(size_t, size_t, double &, double &)> &fill,
+                                      double &min, double &max)
+{
+    const size_t chunks = numChunks(count);
+    std::vector<double> lows(chunks, std::numeric_limits<double>::infinity());
+    std::vector<double> highs(chunks, -std::numeric_limits<double>::infinity());
+
+    QVector<QFuture<void>> futures;
+    const size_t chunkSize = (count + chunks - 1) / chunks;
+    for (size_t c = 0; c < chunks; c++)
+    {
+        const size_t begin = c * chunkSize;
+        const size_t end = std::min(count, begin + chunkSize);
+        futures.append(QtConcurrent::run([&lows, &highs, &fill, c, begin, end]()
+        {
+            fill(begin, end, lows[c], highs[c]);
+        }));
+    }
+    for (auto &future : futures)
+        future.waitForFinished();
+
+    min = *std::min_element(lows.begin(), lows.end());
+    max = *std::max_element(highs.begin(), highs.end());
+    return min <= max;
+}
+
+double HistogramMedian::exactValue(const std::vector<uint32_t> &histogram, const Binning &binning, uint64_t rank)
+{
+    uint64_t seen = 0;
+    for (int bin = 0; bin < binning.bins; bin++)
+    {
+        seen += histogram[bin];
+        if (seen > rank)
+            return binning.origin + bin;
+    }
+    return binning.origin + binning.bins - 1;
+}
+
+double HistogramMedian::exactDeviation(const std::vector<uint32_t> &histogram, const Binning &binning,
+                                       double median, uint64_t rank)
+{
+    // Walk outwards from the median, taking whichever of the next lower or higher
+    // populated bin is closer, until rank samples have been passed.
+    int low = std::min(static_cast<int>(std::floor(median - binning.origin)), binning.bins - 1);
+    int high = low + 1;
+    uint64_t seen = 0;
+    while (true)
+    {
+        while (low >= 0 && histogram[low] == 0)
+            low--;
+        while (high < binning.bins && histogram[high] == 0)
+            high++;
+        if (low < 0 && high >= binning.bins)
+            return 0;
+
+        const double lowDeviation = low >= 0 ? median - (binning.origin + low) : std::numeric_limits<double>::infinity();
+        const double highDeviation = high < binning.bins ? binning.origin + high - median :
+                                     std::numeric_limits<double>::infinity();
+        if (lowDeviation <= highDeviation)
+        {
+            seen += histogram[low--];
+            if (seen > rank)
+                return lowDeviation;
+        }
+        else
+        {
+            seen += histogram[high++];
+            if (seen > rank)
+                return highDeviation;
+        }
+    }
+}
+
+HistogramMedian::Result HistogramMedian::select(std::vector<double> &values, bool withMAD)
+{
+    Result result;
+    const size_t n = values.size();
+    result.count = n;
+    if (n == 0)
+        return result;
+
+    // Mean of the two middle values when n is even
+    auto middle = [n](std::vector<double> &v)
+    {
+        std::nth_element(v.begin(), v.begin() + n / 2, v.end());
+        const double upper = v[n / 2];
+        if (n % 2)
+            return upper;
+        return (*std::max_element(v.begin(), v.begin() + n / 2) + upper) / 2;
+    };
+
+    result.median = middle(values);
+    if (withMAD)
+    {
+        for (auto &value : values)
+            value = std::fabs(value - result.median);
+        result.mad = middle(values);
+    }
+    return result;
+}
+
+HistogramMedian::Result HistogramMedian::resolve(const std::vector<uint32_t> &histogram, const Binning &binning,
+        bool withMAD)
+{
+    Result result;
+    uint64_t n = 0;
+    for (const auto count : histogram)
+        n += count;
+    result.count = n;
+    if (n == 0)
+        return result;
+
+    if (binning.exact)
+    {
+        const bool odd = n % 2;
+        result.median = odd ? exactValue(histogram, binning, n / 2) :
+                        (exactValue(histogram, binning, n / 2 - 1) + exactValue(histogram, binning, n / 2)) / 2;
+        if (withMAD)
+            result.mad = odd ? exactDeviation(histogram, binning, result.median, n / 2) :
+                         (exactDeviation(histogram, binning, result.median, n / 2 - 1) +
+                          exactDeviation(histogram, binning, result.median, n / 2)) / 2;
+        return result;
+    }
+
+    // Interpolate assuming the samples in a bin are spread evenly across it
+    std::vector<uint64_t> cumulative(binning.bins + 1, 0);
+    for (int bin = 0; bin < binning.bins; bin++)
+        cumulative[bin + 1] = cumulative[bin] + histogram[bin];
+
+    const double half = n / 2.0;
+    const auto upper = std::upper_bound(cumulative.cbegin(), cumulative.cend(), half);
+    const int medianBin = std::clamp(static_cast<int>(upper - cumulative.cbegin()) - 1, 0, binning.bins - 1);
+    result.median = binning.origin + binning.width * (medianBin + (half - cumulative[medianBin]) /
+                    std::max<uint32_t>(1, histogram[medianBin]));
+
+    if (withMAD)
+    {
+        // Number of samples below value
+        auto below = [&](double value)
+        {
+            const double position = (value - binning.origin) / binning.width;
+            if (position <= 0)
+                return 0.0;
+            if (position >= binning.bins)
+                return static_cast<double>(n);
+            const int bin = static_cast<int>(position);
+            return cumulative[bin] + histogram[bin] * (position - bin);
+        };
+
+        // The MAD is the deviation within which half the samples lie. Bisect to well under a bin width.
+        double low = 0;
+        double high = std::max(result.median - binning.origin, binning.origin + binning.bins * binning.width - result.median);
+        for (int i = 0; i < 64 && high - low > binning.width * 1e-3; i++)
+        {
+            const double deviation = (low + high) / 2;
+            if (below(result.median + deviation) - below(result.median - deviation) < half)
+                low = deviation;
+            else
+                high = deviation;
+        }
+        result.mad = (low + high) / 2;
+    }
+    return result;
+}
+
+} // namespace Mathematics
@@ -0,0 +1,182 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Median and median absolute deviation (MAD) of image data computed from a histogram,
+// so the data is neither copied nor sorted and memory use does not depend on the image size.
+//
+// 8 and 16-bit integer data, and any other integer data spanning fewer than BINS values, is binned
+// with one value per bin so the median and MAD are exact. All other data is binned into BINS bins
+// between its minimum and maximum and the results are interpolated within a bin, so the error is
+// bounded by (max - min) / BINS. Such data with at most SMALL_COUNT samples is copied and the
+// median and MAD selected exactly instead.
+//
+// The median of an even number of samples is the mean of the two middle samples. NaNs are ignored.
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace Mathematics
+{
+
+class HistogramMedian
+{
+    public:
+        struct Result
+        {
+            double median { 0 };
+            double mad { 0 };
+            // Number of samples used, i.e. excluding masked samples and NaNs
+            size_t count { 0 };
+        };
+
+        static constexpr int BINS = 65536;
+        // Data that can't be binned exactly is selected directly up to this number of samples
+        static constexpr size_t SMALL_COUNT = BINS;
+
+        /**
+         * @brief compute Median and MAD of count samples
+         * @param data first sample
+         * @param count number of samples
+         * @param stride distance between samples, e.g. 3 for one channel of interleaved RGB
+         * @param mask optional, one byte per sample (not strided), samples with a 0 mask are ignored
+         * @param withMAD whether to compute the MAD as well as the median
+         */
+        template <typename T>
+        static Result compute(const T *data, size_t count, size_t stride = 1, const uint8_t *mask = nullptr,
+                              bool withMAD = true)
+        {
+            if constexpr (std::is_integral<T>::value && sizeof(T) <= 2)
+                return compute(data, count, stride, mask, std::numeric_limits<T>::min(), std::numeric_limits<T>::max(),
+                               withMAD);
+            else
+            {
+                double min = 0, max = 0;
+                if (!range(data, count, stride, mask, min, max))
+                    return Result();
+                return compute(data, count, stride, mask, min, max, withMAD);
+            }
+        }
+
+        /**
+         * @brief compute As above, when the range of the data is already known.
+         * Samples outside min to max are counted in the first or last bin.
+         */
+        template <typename T>
+        static Result compute(const T *data, size_t count, size_t stride, const uint8_t *mask, double min, double max,
+                              bool withMAD = true)
+        {
+            Binning binning;
+            if (std::is_integral<T>::value && max - min < BINS)
+            {
+                binning.exact = true;
+                binning.origin = std::floor(min);
+                binning.bins = static_cast<int>(std::floor(max) - binning.origin) + 1;
+            }
+            else if (!(max > min))
+            {
+                // Constant data
+                binning.exact = true;
+                binning.origin = min;
+                binning.bins = 1;
+            }
+            else if (count <= SMALL_COUNT)
+            {
+                // Too few samples for the interpolation to be accurate, but few enough to select directly
+                std::vector<double> values;
+                values.reserve(count);
+                for (size_t i = 0; i < count; i++)
+                {
+                    const double value = static_cast<double>(data[i * stride]);
+                    if ((!mask || mask[i]) && !std::isnan(value))
+                        values.push_back(value);
+                }
+                return select(values, withMAD);
+            }
+            else
+            {
+                binning.origin = min;
+                binning.width = (max - min) / BINS;
+                binning.bins = BINS;
+            }
+
+            const int top = binning.bins - 1;
+            const double origin = binning.origin;
+            const double scale = 1.0 / binning.width;
+            const bool exact = binning.exact;
+            const std::vector<uint32_t> histogram = accumulate(count, binning.bins,
+                                                    [ = ](size_t begin, size_t end, uint32_t *bins)
+            {
+                for (size_t i = begin; i < end; i++)
+                {
+                    if (mask && !mask[i])
+                        continue;
+                    const T value = data[i * stride];
+                    if constexpr (std::is_floating_point<T>::value)
+                    {
+                        if (std::isnan(value))
+                            continue;
+                    }
+                    const double offset = exact ? static_cast<double>(value) - origin : (value - origin) * scale;
+                    const int bin = offset <= 0 ? 0 : (offset >= top ? top : static_cast<int>(offset));
+                    bins[bin]++;
+                }
+            });
+            return resolve(histogram, binning, withMAD);
+        }
+
+    private:
+        struct Binning
+        {
+            bool exact { false };
+            double origin { 0 };
+            double width { 1 };
+            int bins { 1 };
+        };
+
+        // Minimum and maximum of the samples, returns false if there are none
+        template <typename T>
+        static bool range(const T *data, size_t count, size_t stride, const uint8_t *mask, double &min, double &max)
+        {
+            return accumulateRange(count, [ = ](size_t begin, size_t end, double & low, double & high)
+            {
+                for (size_t i = begin; i < end; i++)
+                {
+                    if (mask && !mask[i])
+                        continue;
+                    const double value = static_cast<double>(data[i * stride]);
+                    // NaN fails both comparisons
+                    if (value < low)
+                        low = value;
+                    if (value > high)
+                        high = value;
+                }
+            }, min, max);
+        }
+
+        // Run fill over chunks of the samples in parallel, each chunk into its own histogram, and sum them
+        static std::vector<uint32_t> accumulate(size_t count, int bins,
+                                                const std::function<void(size_t, size_t, uint32_t *)> &fill);
+        static bool accumulateRange(size_t count, const std::function<void(size_t, size_t, double &, double &)> &fill,
+                                    double &min, double &max);
+
+        static Result resolve(const std::vector<uint32_t> &histogram, const Binning &binning, bool withMAD);
+        // Median and MAD by selection, values is modified
+        static Result select(std::vector<double> &values, bool withMAD);
+        // Value of the sample at rank (0 based) in an exact histogram
+        static double exactValue(const std::vector<uint32_t> &histogram, const Binning &binning, uint64_t rank);
+        // Deviation from median of the sample at rank (0 based) when sorted by deviation, in an exact histogram
+        static double exactDeviation(const std::vector<uint32_t> &histogram, const Binning &binning, double median,
+                                     uint64_t rank);
+};
+
+} // namespace Mathematics
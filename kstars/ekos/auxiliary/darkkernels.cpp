@@ -0,0 +1,694 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "darkkernels.h"
+
+#include "fitsviewer/stretchkernels.h"
+
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define DARK_KERNELS_X86
+#include <immintrin.h>
+#elif defined(__aarch64__) && !defined(__AARCH64EB__)
+#define DARK_KERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+// GCC and Clang need to be told which functions may use instructions beyond the build target.
+#if defined(__GNUC__) || defined(__clang__)
+#define DARK_TARGET(x) __attribute__((target(x)))
+#else
+#define DARK_TARGET(x)
+#endif
+
+namespace Ekos
+{
+
+namespace DarkKernels
+{
+
+namespace
+{
+
+using StretchKernels::Isa;
+
+// Samples handled by each task, enough to amortise the scheduling and small enough to balance the cores
+constexpr size_t BAND = 1 << 18;
+// Defects gathered at once for the median network
+constexpr int CHUNK = 256;
+
+// Run fn(first, last) over [0, count) in bands on all the cores
+template <typename Fn>
+void forBands(size_t count, size_t band, Fn fn)
+{
+    if (count <= band)
+    {
+        fn(size_t(0), count);
+        return;
+    }
+
+    QVector<size_t> bands;
+    for (size_t first = 0; first < count; first += band)
+        bands.append(first);
+
+    QtConcurrent::blockingMap(bands, [&](size_t first)
+    {
+        fn(first, std::min(first + band, count));
+    });
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// Scalar
+////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+void subtractScalar(T *light, const T *dark, int n)
+{
+    for (int i = 0; i < n; i++)
+        light[i] = (light[i] > dark[i]) ? (light[i] - dark[i]) : 0;
+}
+
+template <typename T>
+void accumulateScalar(const T *input, uint32_t *sum, int n)
+{
+    for (int i = 0; i < n; i++)
+        sum[i] += input[i];
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// x86 SSE4.1 and AVX2
+//
+// The unsigned 8 and 16 bit types have a saturating subtraction. The other integer types subtract
+// min(light, dark) from light, which is 0 when the dark is brighter, as the scalar code. Floats keep
+// the difference only where light > dark, which is false for NaN as in the scalar code.
+////////////////////////////////////////////////////////////////////////////////////////////
+
+#if defined(DARK_KERNELS_X86)
+
+template <typename T> struct Sse41;
+
+struct Sse41Integer
+{
+    using V = __m128i;
+    DARK_TARGET("sse4.1") static V load(const void *p)
+    {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    }
+    DARK_TARGET("sse4.1") static void store(void *p, V v)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v);
+    }
+};
+
+template <> struct Sse41<uint8_t> : Sse41Integer
+{
+    DARK_TARGET("sse4.1") static V subtract(V l, V d)
+    {
+        return _mm_subs_epu8(l, d);
+    }
+};
+
+template <> struct Sse41<int16_t> : Sse41Integer
+{
+    DARK_TARGET("sse4.1") static V subtract(V l, V d)
+    {
+        return _mm_sub_epi16(l, _mm_min_epi16(l, d));
+    }
+};
+
+template <> struct Sse41<uint16_t> : Sse41Integer
+{
+    DARK_TARGET("sse4.1") static V subtract(V l, V d)
+    {
+        return _mm_subs_epu16(l, d);
+    }
+};
+
+template <> struct Sse41<int32_t> : Sse41Integer
+{
+    DARK_TARGET("sse4.1") static V subtract(V l, V d)
+    {
+        return _mm_sub_epi32(l, _mm_min_epi32(l, d));
+    }
+};
+
+template <> struct Sse41<uint32_t> : Sse41Integer
+{
+    DARK_TARGET("sse4.1") static V subtract(V l, V d)
+    {
+        return _mm_sub_epi32(l, _mm_min_epu32(l, d));
+    }
+};
+
+template <> struct Sse41<float>
+{
+    using V = __m128;
+    DARK_TARGET("sse4.1") static V load(const float *p)
+    {
+        return _mm_loadu_ps(p);
+    }
+    DARK_TARGET("sse4.1") static void store(float *p, V v)
+    {
+        _mm_storeu_ps(p, v);
+    }
+    DARK_TARGET("sse4.1") static V subtract(V l, V d)
+    {
+        return _mm_and_ps(_mm_cmpgt_ps(l, d), _mm_sub_ps(l, d));
+    }
+};
+
+template <typename T> struct Avx2;
+
+struct Avx2Integer
+{
+    using V = __m256i;
+    DARK_TARGET("avx2") static V load(const void *p)
+    {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+    }
+    DARK_TARGET("avx2") static void store(void *p, V v)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v);
+    }
+};
+
+template <> struct Avx2<uint8_t> : Avx2Integer
+{
+    DARK_TARGET("avx2") static V subtract(V l, V d)
+    {
+        return _mm256_subs_epu8(l, d);
+    }
+};
+
+template <> struct Avx2<int16_t> : Avx2Integer
+{
+    DARK_TARGET("avx2") static V subtract(V l, V d)
+    {
+        return _mm256_sub_epi16(l, _mm256_min_epi16(l, d));
+    }
+};
+
+template <> struct Avx2<uint16_t> : Avx2Integer
+{
+    DARK_TARGET("avx2") static V subtract(V l, V d)
+    {
+        return _mm256_subs_epu16(l, d);
+    }
+};
+
+template <> struct Avx2<int32_t> : Avx2Integer
+{
+    DARK_TARGET("avx2") static V subtract(V l, V d)
+    {
+        return _mm256_sub_epi32(l, _mm256_min_epi32(l, d));
+    }
+};
+
+template <> struct Avx2<uint32_t> : Avx2Integer
+{
+    DARK_TARGET("avx2") static V subtract(V l, V d)
+    {
+        return _mm256_sub_epi32(l, _mm256_min_epu32(l, d));
+    }
+};
+
+template <> struct Avx2<float>
+{
+    using V = __m256;
+    DARK_TARGET("avx2") static V load(const float *p)
+    {
+        return _mm256_loadu_ps(p);
+    }
+    DARK_TARGET("avx2") static void store(float *p, V v)
+    {
+        _mm256_storeu_ps(p, v);
+    }
+    DARK_TARGET("avx2") static V subtract(V l, V d)
+    {
+        return _mm256_and_ps(_mm256_cmp_ps(l, d, _CMP_GT_OQ), _mm256_sub_ps(l, d));
+    }
+};
+
+template <typename T>
+DARK_TARGET("sse4.1") void subtractSSE41(T *light, const T *dark, int n)
+{
+    constexpr int LANES = 16 / sizeof(T);
+    int i = 0;
+    for (; i + LANES <= n; i += LANES)
+        Sse41<T>::store(light + i, Sse41<T>::subtract(Sse41<T>::load(light + i), Sse41<T>::load(dark + i)));
+    subtractScalar(light + i, dark + i, n - i);
+}
+
+template <typename T>
+DARK_TARGET("avx2") void subtractAVX2(T *light, const T *dark, int n)
+{
+    constexpr int LANES = 32 / sizeof(T);
+    int i = 0;
+    for (; i + LANES <= n; i += LANES)
+        Avx2<T>::store(light + i, Avx2<T>::subtract(Avx2<T>::load(light + i), Avx2<T>::load(dark + i)));
+    subtractScalar(light + i, dark + i, n - i);
+}
+
+// Widen 4 samples to 32 bits and add them to the sums
+DARK_TARGET("sse4.1") inline void add4(uint32_t *sum, __m128i wide)
+{
+    __m128i *p = reinterpret_cast<__m128i *>(sum);
+    _mm_storeu_si128(p, _mm_add_epi32(_mm_loadu_si128(p), wide));
+}
+
+DARK_TARGET("sse4.1") void accumulateSSE41(const uint8_t *input, uint32_t *sum, int n)
+{
+    int i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+        add4(sum + i, _mm_cvtepu8_epi32(v));
+        add4(sum + i + 4, _mm_cvtepu8_epi32(_mm_srli_si128(v, 4)));
+        add4(sum + i + 8, _mm_cvtepu8_epi32(_mm_srli_si128(v, 8)));
+        add4(sum + i + 12, _mm_cvtepu8_epi32(_mm_srli_si128(v, 12)));
+    }
+    accumulateScalar(input + i, sum + i, n - i);
+}
+
+DARK_TARGET("sse4.1") void accumulateSSE41(const int16_t *input, uint32_t *sum, int n)
+{
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+        add4(sum + i, _mm_cvtepi16_epi32(v));
+        add4(sum + i + 4, _mm_cvtepi16_epi32(_mm_srli_si128(v, 8)));
+    }
+    accumulateScalar(input + i, sum + i, n - i);
+}
+
+DARK_TARGET("sse4.1") void accumulateSSE41(const uint16_t *input, uint32_t *sum, int n)
+{
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+        add4(sum + i, _mm_cvtepu16_epi32(v));
+        add4(sum + i + 4, _mm_cvtepu16_epi32(_mm_srli_si128(v, 8)));
+    }
+    accumulateScalar(input + i, sum + i, n - i);
+}
+
+// The 32 bit integers wrap around as the scalar code
+template <typename T>
+DARK_TARGET("sse4.1") void accumulateSSE41(const T *input, uint32_t *sum, int n)
+{
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+        add4(sum + i, _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i)));
+    accumulateScalar(input + i, sum + i, n - i);
+}
+
+DARK_TARGET("avx2") inline void add8(uint32_t *sum, __m256i wide)
+{
+    __m256i *p = reinterpret_cast<__m256i *>(sum);
+    _mm256_storeu_si256(p, _mm256_add_epi32(_mm256_loadu_si256(p), wide));
+}
+
+DARK_TARGET("avx2") void accumulateAVX2(const uint8_t *input, uint32_t *sum, int n)
+{
+    int i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+        add8(sum + i, _mm256_cvtepu8_epi32(v));
+        add8(sum + i + 8, _mm256_cvtepu8_epi32(_mm_srli_si128(v, 8)));
+    }
+    accumulateScalar(input + i, sum + i, n - i);
+}
+
+DARK_TARGET("avx2") void accumulateAVX2(const int16_t *input, uint32_t *sum, int n)
+{
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+        add8(sum + i, _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i))));
+    accumulateScalar(input + i, sum + i, n - i);
+}
+
+DARK_TARGET("avx2") void accumulateAVX2(const uint16_t *input, uint32_t *sum, int n)
+{
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+        add8(sum + i, _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i))));
+    accumulateScalar(input + i, sum + i, n - i);
+}
+
+template <typename T>
+DARK_TARGET("avx2") void accumulateAVX2(const T *input, uint32_t *sum, int n)
+{
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+        add8(sum + i, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input + i)));
+    accumulateScalar(input + i, sum + i, n - i);
+}
+
+#endif // DARK_KERNELS_X86
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// NEON
+////////////////////////////////////////////////////////////////////////////////////////////
+
+#if defined(DARK_KERNELS_NEON)
+
+template <typename T> struct Neon;
+
+template <> struct Neon<uint8_t>
+{
+    static uint8x16_t load(const uint8_t *p)
+    {
+        return vld1q_u8(p);
+    }
+    static void store(uint8_t *p, uint8x16_t v)
+    {
+        vst1q_u8(p, v);
+    }
+    static uint8x16_t subtract(uint8x16_t l, uint8x16_t d)
+    {
+        return vqsubq_u8(l, d);
+    }
+};
+
+template <> struct Neon<int16_t>
+{
+    static int16x8_t load(const int16_t *p)
+    {
+        return vld1q_s16(p);
+    }
+    static void store(int16_t *p, int16x8_t v)
+    {
+        vst1q_s16(p, v);
+    }
+    static int16x8_t subtract(int16x8_t l, int16x8_t d)
+    {
+        return vsubq_s16(l, vminq_s16(l, d));
+    }
+};
+
+template <> struct Neon<uint16_t>
+{
+    static uint16x8_t load(const uint16_t *p)
+    {
+        return vld1q_u16(p);
+    }
+    static void store(uint16_t *p, uint16x8_t v)
+    {
+        vst1q_u16(p, v);
+    }
+    static uint16x8_t subtract(uint16x8_t l, uint16x8_t d)
+    {
+        return vqsubq_u16(l, d);
+    }
+};
+
+template <> struct Neon<int32_t>
+{
+    static int32x4_t load(const int32_t *p)
+    {
+        return vld1q_s32(p);
+    }
+    static void store(int32_t *p, int32x4_t v)
+    {
+        vst1q_s32(p, v);
+    }
+    static int32x4_t subtract(int32x4_t l, int32x4_t d)
+    {
+        return vsubq_s32(l, vminq_s32(l, d));
+    }
+};
+
+template <> struct Neon<uint32_t>
+{
+    static uint32x4_t load(const uint32_t *p)
+    {
+        return vld1q_u32(p);
+    }
+    static void store(uint32_t *p, uint32x4_t v)
+    {
+        vst1q_u32(p, v);
+    }
+    static uint32x4_t subtract(uint32x4_t l, uint32x4_t d)
+    {
+        return vqsubq_u32(l, d);
+    }
+};
+
+template <> struct Neon<float>
+{
+    static float32x4_t load(const float *p)
+    {
+        return vld1q_f32(p);
+    }
+    static void store(float *p, float32x4_t v)
+    {
+        vst1q_f32(p, v);
+    }
+    static float32x4_t subtract(float32x4_t l, float32x4_t d)
+    {
+        return vreinterpretq_f32_u32(vandq_u32(vcgtq_f32(l, d), vreinterpretq_u32_f32(vsubq_f32(l, d))));
+    }
+};
+
+template <typename T>
+void subtractNEON(T *light, const T *dark, int n)
+{
+    constexpr int LANES = 16 / sizeof(T);
+    int i = 0;
+    for (; i + LANES <= n; i += LANES)
+        Neon<T>::store(light + i, Neon<T>::subtract(Neon<T>::load(light + i), Neon<T>::load(dark + i)));
+    subtractScalar(light + i, dark + i, n - i);
+}
+
+void accumulateNEON(const uint8_t *input, uint32_t *sum, int n)
+{
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        const uint16x8_t v = vmovl_u8(vld1_u8(input + i));
+        vst1q_u32(sum + i, vaddw_u16(vld1q_u32(sum + i), vget_low_u16(v)));
+        vst1q_u32(sum + i + 4, vaddw_u16(vld1q_u32(sum + i + 4), vget_high_u16(v)));
+    }
+    accumulateScalar(input + i, sum + i, n - i);
+}
+
+void accumulateNEON(const int16_t *input, uint32_t *sum, int n)
+{
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+        vst1q_u32(sum + i, vaddq_u32(vld1q_u32(sum + i), vreinterpretq_u32_s32(vmovl_s16(vld1_s16(input + i)))));
+    accumulateScalar(input + i, sum + i, n - i);
+}
+
+void accumulateNEON(const uint16_t *input, uint32_t *sum, int n)
+{
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+        vst1q_u32(sum + i, vaddw_u16(vld1q_u32(sum + i), vld1_u16(input + i)));
+    accumulateScalar(input + i, sum + i, n - i);
+}
+
+void accumulateNEON(const int32_t *input, uint32_t *sum, int n)
+{
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+        vst1q_u32(sum + i, vaddq_u32(vld1q_u32(sum + i), vreinterpretq_u32_s32(vld1q_s32(input + i))));
+    accumulateScalar(input + i, sum + i, n - i);
+}
+
+void accumulateNEON(const uint32_t *input, uint32_t *sum, int n)
+{
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+        vst1q_u32(sum + i, vaddq_u32(vld1q_u32(sum + i), vld1q_u32(input + i)));
+    accumulateScalar(input + i, sum + i, n - i);
+}
+
+#endif // DARK_KERNELS_NEON
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// Dispatch
+////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+constexpr bool isVectorised()
+{
+    return std::is_same<T, uint8_t>::value || std::is_same<T, int16_t>::value || std::is_same<T, uint16_t>::value
+           || std::is_same<T, int32_t>::value || std::is_same<T, uint32_t>::value || std::is_same<T, float>::value;
+}
+
+template <typename T>
+void subtractRow(T *light, const T *dark, int n)
+{
+    if constexpr (isVectorised<T>())
+    {
+        switch (StretchKernels::isa())
+        {
+#if defined(DARK_KERNELS_X86)
+            case Isa::AVX2:
+                subtractAVX2(light, dark, n);
+                return;
+            case Isa::SSE41:
+                subtractSSE41(light, dark, n);
+                return;
+#elif defined(DARK_KERNELS_NEON)
+            case Isa::NEON:
+                subtractNEON(light, dark, n);
+                return;
+#endif
+            default:
+                break;
+        }
+    }
+    subtractScalar(light, dark, n);
+}
+
+template <typename T>
+void accumulateRun(const T *input, uint32_t *sum, int n)
+{
+    // Floats are added as the scalar code does, converting the sum to float and back
+    if constexpr (isVectorised<T>() && !std::is_same<T, float>::value)
+    {
+        switch (StretchKernels::isa())
+        {
+#if defined(DARK_KERNELS_X86)
+            case Isa::AVX2:
+                accumulateAVX2(input, sum, n);
+                return;
+            case Isa::SSE41:
+                accumulateSSE41(input, sum, n);
+                return;
+#elif defined(DARK_KERNELS_NEON)
+            case Isa::NEON:
+                accumulateNEON(input, sum, n);
+                return;
+#endif
+            default:
+                break;
+        }
+    }
+    accumulateScalar(input, sum, n);
+}
+
+// Sorting network of 8 values, applied to CHUNK sets of values at once so that the compiler can
+// vectorise each comparator
+template <typename T>
+void sort8(T values[8][CHUNK], int n)
+{
+    static constexpr int PAIRS[19][2] =
+    {
+        {0, 2}, {1, 3}, {4, 6}, {5, 7},
+        {0, 4}, {1, 5}, {2, 6}, {3, 7},
+        {0, 1}, {2, 3}, {4, 5}, {6, 7},
+        {2, 4}, {3, 5},
+        {1, 4}, {3, 6},
+        {1, 2}, {3, 4}, {5, 6}
+    };
+
+    for (const auto &pair : PAIRS)
+    {
+        T *a = values[pair[0]];
+        T *b = values[pair[1]];
+        for (int i = 0; i < n; i++)
+        {
+            const T low = std::min(a[i], b[i]);
+            const T high = std::max(a[i], b[i]);
+            a[i] = low;
+            b[i] = high;
+        }
+    }
+}
+
+} // namespace
+
+template <typename T>
+void subtract(T *light, uint32_t width, uint32_t height, const T *dark, uint32_t darkStride)
+{
+    const size_t rowsPerBand = std::max<size_t>(1, BAND / std::max<uint32_t>(width, 1));
+    forBands(height, rowsPerBand, [ = ](size_t first, size_t last)
+    {
+        for (size_t y = first; y < last; y++)
+            subtractRow(light + y * width, dark + y * darkStride, static_cast<int>(width));
+    });
+}
+
+template <typename T>
+void accumulate(const T *input, uint32_t *sum, size_t count)
+{
+    forBands(count, BAND, [ = ](size_t first, size_t last)
+    {
+        accumulateRun(input + first, sum + first, static_cast<int>(last - first));
+    });
+}
+
+template <typename T>
+void average(const uint32_t *sum, T *output, size_t count, uint32_t frames)
+{
+    forBands(count, BAND, [ = ](size_t first, size_t last)
+    {
+        for (size_t i = first; i < last; i++)
+            output[i] = sum[i] / frames;
+    });
+}
+
+template <typename T>
+void correctDefects(T *buffer, uint32_t width, const std::vector<uint32_t> &offsets)
+{
+    std::vector<T> medians(offsets.size());
+
+    // Neighbours of a sample, the sample itself left out
+    const int64_t neighbours[8] =
+    {
+        -int64_t(width) - 1, -int64_t(width), -int64_t(width) + 1, -1, 1, int64_t(width) - 1, int64_t(width), int64_t(width) + 1
+    };
+
+    forBands(offsets.size(), 16 * CHUNK, [&](size_t first, size_t last)
+    {
+        T values[8][CHUNK];
+        for (size_t start = first; start < last; start += CHUNK)
+        {
+            const int n = static_cast<int>(std::min<size_t>(CHUNK, last - start));
+            for (int k = 0; k < 8; k++)
+                for (int i = 0; i < n; i++)
+                    values[k][i] = buffer[offsets[start + i] + neighbours[k]];
+
+            sort8(values, n);
+
+            // Same rounding as the average of the two middle values in the scalar code
+            for (int i = 0; i < n; i++)
+                medians[start + i] = (values[3][i] + values[4][i]) / 2;
+        }
+    });
+
+    for (size_t i = 0; i < offsets.size(); i++)
+        buffer[offsets[i]] = medians[i];
+}
+
+#define DARK_KERNELS_INSTANTIATE(T) \
+    template void subtract<T>(T *, uint32_t, uint32_t, const T *, uint32_t); \
+    template void accumulate<T>(const T *, uint32_t *, size_t); \
+    template void average<T>(const uint32_t *, T *, size_t, uint32_t); \
+    template void correctDefects<T>(T *, uint32_t, const std::vector<uint32_t> &);
+
+DARK_KERNELS_INSTANTIATE(uint8_t)
+DARK_KERNELS_INSTANTIATE(int16_t)
+DARK_KERNELS_INSTANTIATE(uint16_t)
+DARK_KERNELS_INSTANTIATE(int32_t)
+DARK_KERNELS_INSTANTIATE(uint32_t)
+DARK_KERNELS_INSTANTIATE(float)
+DARK_KERNELS_INSTANTIATE(int64_t)
+DARK_KERNELS_INSTANTIATE(double)
+
+} // namespace DarkKernels
+
+} // namespace Ekos
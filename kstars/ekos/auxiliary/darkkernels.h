@@ -0,0 +1,64 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Ekos
+{
+
+/**
+ * Pixel kernels used to calibrate frames with the dark library.
+ *
+ * The frames are split in bands of rows which are processed on all the cores. The 8, 16 and 32 bit
+ * and float kernels are vectorised with SSE4.1, AVX2 (x86) or NEON (aarch64), using the instruction
+ * set selected by StretchKernels at runtime. The 64 bit types use the scalar code.
+ *
+ * All the kernels are instantiated for the FITS data types: uint8_t, int16_t, uint16_t, int32_t,
+ * uint32_t, float, int64_t and double.
+ */
+namespace DarkKernels
+{
+
+/**
+ * @brief subtract Subtracts a dark frame from a light frame, clamping at 0. As with light > dark ?
+ * light - dark : 0, a float pixel is set to 0 where the light or the dark is NaN.
+ * @param light light frame of width x height samples, modified in place.
+ * @param dark first dark sample matching the first light sample.
+ * @param darkStride number of samples between two rows of the dark frame.
+ */
+template <typename T>
+void subtract(T *light, uint32_t width, uint32_t height, const T *dark, uint32_t darkStride);
+
+/**
+ * @brief accumulate Adds count samples of a dark frame to the sums of the master frame.
+ */
+template <typename T>
+void accumulate(const T *input, uint32_t *sum, size_t count);
+
+/**
+ * @brief average Sets the master frame to the average of the frames accumulated in sum.
+ * @param frames number of frames accumulated.
+ */
+template <typename T>
+void average(const uint32_t *sum, T *output, size_t count, uint32_t frames);
+
+/**
+ * @brief correctDefects Replaces each defective sample by the median of its 8 neighbours.
+ * The medians are all taken from the frame before any correction, so that neighbouring defects
+ * give the same result whatever the order they are processed in.
+ * @param buffer frame of width samples per row, modified in place.
+ * @param offsets offsets of the defective samples, none of which may be on the border of the frame.
+ */
+template <typename T>
+void correctDefects(T *buffer, uint32_t width, const std::vector<uint32_t> &offsets);
+
+} // namespace DarkKernels
+
+} // namespace Ekos
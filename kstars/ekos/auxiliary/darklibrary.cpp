@@ -5,6 +5,7 @@
 */
 
 #include "darklibrary.h"
+#include "darkkernels.h"
 #include "Options.h"
 
 #include "ekos_debug.h"
@@ -1339,8 +1340,7 @@ template <typename T>
 void DarkLibrary::aggregateInternal(const QSharedPointer<FITSData> &data)
 {
     T const *darkBuffer  = reinterpret_cast<T const*>(data->getImageBuffer());
-    for (uint32_t i = 0; i < m_DarkMasterBuffer.size(); i++)
-        m_DarkMasterBuffer[i] += darkBuffer[i];
+    DarkKernels::accumulate(darkBuffer, m_DarkMasterBuffer.data(), m_DarkMasterBuffer.size());
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
@@ -1401,8 +1401,7 @@ template <typename T>  void DarkLibrary::generateMasterFrameInternal(const QShar
     T *writableBuffer = reinterpret_cast<T *>(data->getWritableImageBuffer());
     const uint32_t count = metadata["count"].toInt();
     // Average the values
-    for (uint32_t i = 0; i < m_DarkMasterBuffer.size(); i++)
-        writableBuffer[i] = m_DarkMasterBuffer[i] / count;
+    DarkKernels::average(m_DarkMasterBuffer.data(), writableBuffer, m_DarkMasterBuffer.size(), count);
 
     QString ts = QDateTime::currentDateTime().toString("yyyy-MM-ddThh-mm-ss");
     QString path = QDir(KSPaths::writableLocation(QStandardPaths::AppLocalDataLocation)).filePath("darks/darkframe_" + ts +
@@ -5,10 +5,11 @@
 */
 
 #include "darkprocessor.h"
+#include "darkkernels.h"
 #include "darklibrary.h"
 #include "ekos/auxiliary/opticaltrainsettings.h"
 
-#include <array>
+#include <algorithm>
 
 #include "ekos_debug.h"
 
@@ -79,73 +80,34 @@ void DarkProcessor::normalizeDefectsInternal(const QSharedPointer<DefectMap> &de
 
     T *lightBuffer = reinterpret_cast<T *>(lightData->getWritableImageBuffer());
     const uint32_t width = lightData->width();
+    const uint32_t height = lightData->height();
 
     // Account for offset X and Y
     // e.g. if we send a subframed light frame 100x100 pixels wide
     // but the source defect map covers 1000x1000 pixels array, then we need to only compensate
-    // for the 100x100 region.
-    for (BadPixelSet::const_iterator onePixel = defectMap->hotThreshold();
-            onePixel != defectMap->hotPixels().cend(); ++onePixel)
+    // for the 100x100 region. Pixels on the border of the light frame have no 3x3 neighbourhood
+    // and are left as they are.
+    std::vector<uint32_t> offsets;
+    const auto addPixel = [&](const BadPixel & onePixel)
     {
-        const uint16_t x = (*onePixel).x;
-        const uint16_t y = (*onePixel).y;
-
-        if (x <= offsetX || y <= offsetY)
-            continue;
+        const uint16_t x = onePixel.x;
+        const uint16_t y = onePixel.y;
 
-        uint32_t offset = (x - offsetX) + (y - offsetY) * width;
+        if (x <= offsetX || y <= offsetY || x - offsetX + 1u >= width || y - offsetY + 1u >= height)
+            return;
 
-        lightBuffer[offset] = median3x3Filter(x - offsetX, y - offsetY, width, lightBuffer);
-    }
-
-    for (BadPixelSet::const_iterator onePixel = defectMap->coldPixels().cbegin();
-            onePixel != defectMap->coldThreshold(); ++onePixel)
-    {
-        const uint16_t x = (*onePixel).x;
-        const uint16_t y = (*onePixel).y;
+        offsets.push_back((x - offsetX) + (y - offsetY) * width);
+    };
 
-        if (x <= offsetX || y <= offsetY)
-            continue;
+    std::for_each(defectMap->hotThreshold(), defectMap->hotPixels().cend(), addPixel);
+    std::for_each(defectMap->coldPixels().cbegin(), defectMap->coldThreshold(), addPixel);
 
-        uint32_t offset = (x - offsetX) + (y - offsetY) * width;
-
-        lightBuffer[offset] = median3x3Filter(x - offsetX, y - offsetY, width, lightBuffer);
-    }
+    DarkKernels::correctDefects(lightBuffer, width, offsets);
 
     lightData->calculateStats(true);
 
 }
 
-///////////////////////////////////////////////////////////////////////////////////////
-///
-///////////////////////////////////////////////////////////////////////////////////////
-template <typename T>
-T DarkProcessor::median3x3Filter(uint16_t x, uint16_t y, uint32_t width, T *buffer)
-{
-    T *top = buffer + (y - 1) * width + (x - 1);
-    T *mid = buffer + (y - 0) * width + (x - 1);
-    T *bot = buffer + (y + 1) * width + (x - 1);
-
-    std::array<T, 8> elements;
-
-    // Top
-    elements[0] = *(top + 0);
-    elements[1] = *(top + 1);
-    elements[2] = *(top + 2);
-    // Mid
-    elements[3] = *(mid + 0);
-    // Mid+1 is the defective value, so we skip and go for + 2
-    elements[4] = *(mid + 2);
-    // Bottom
-    elements[5] = *(bot + 0);
-    elements[6] = *(bot + 1);
-    elements[7] = *(bot + 2);
-
-    std::sort(elements.begin(), elements.end());
-    auto median = (elements[3] + elements[4]) / 2;
-    return median;
-}
-
 ///////////////////////////////////////////////////////////////////////////////////////
 ///
 ///////////////////////////////////////////////////////////////////////////////////////
@@ -206,14 +168,7 @@ void DarkProcessor::subtractInternal(const QSharedPointer<FITSData> &darkData, c
     const uint32_t darkoffset = offsetX + offsetY * darkStride;
     T const *darkBuffer  = reinterpret_cast<T const*>(darkData->getImageBuffer()) + darkoffset;
 
-    for (uint32_t y = 0; y < height; y++)
-    {
-        for (uint32_t x = 0; x < width; x++)
-            lightBuffer[x] = (lightBuffer[x] > darkBuffer[x]) ? (lightBuffer[x] - darkBuffer[x]) : 0;
-
-        lightBuffer += width;
-        darkBuffer += darkStride;
-    }
+    DarkKernels::subtract(lightBuffer, width, height, darkBuffer, darkStride);
 
     lightData->calculateStats(true);
 }
@@ -101,9 +101,6 @@ class DarkProcessor : public QObject
         void normalizeDefectsInternal(const QSharedPointer<DefectMap> &defectMap, const QSharedPointer<FITSData> &lightData,
                                       uint16_t offsetX, uint16_t offsetY);
 
-        template <typename T>
-        T median3x3Filter(uint16_t x, uint16_t y, uint32_t width, T *buffer);
-
     Q_SIGNALS:
         void darkFrameCompleted(bool);
         void newLog(const QString &message);
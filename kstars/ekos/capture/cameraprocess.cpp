@@ -23,6 +23,8 @@
 #include "ksmessagebox.h"
 #include "kstars.h"
 
+#include <KFormat>
+
 #ifdef HAVE_CFITSIO
 #include "fitsviewer/fitsdata.h"
 #include "fitsviewer/fitstab.h"
@@ -1079,7 +1081,18 @@ bool Ekos::CameraProcess::checkSavingReceivedImage(const QSharedPointer<FITSData
         if (activeJob()->jobType() != SequenceJob::JOBTYPE_PREVIEW
                 && activeJob()->getCalibrationStage() != SequenceJobState::CAL_CALIBRATION)
         {
-            if (state()->generateFilename(extension, &filename) && activeCamera()->saveCurrentImage(filename))
+            // Tile compressed FITS are saved as .fits.fz, if the camera's image can be compressed at all,
+            // so that the name is checked for collisions as the one that will be written
+            QString fileExtension = extension;
+            if (fileExtension == ".fits" && Options::captureFITSCompression() > 0)
+            {
+                if (activeCamera()->canCompressCurrentImage())
+                    fileExtension += ".fz";
+                else
+                    qCWarning(KSTARS_EKOS_CAPTURE) << "Image can't be tile compressed, saving it uncompressed.";
+            }
+
+            if (state()->generateFilename(fileExtension, &filename) && activeCamera()->saveCurrentImage(filename))
             {
                 data->setFilename(filename);
                 KStars::Instance()->statusBar()->showMessage(i18n("file saved to %1", filename), 0);
@@ -2683,6 +2696,9 @@ void CameraProcess::setCamera(bool connection)
         connect(activeCamera(), &ISD::Camera::ready, this, &CameraProcess::cameraReady, Qt::UniqueConnection);
         connect(activeCamera(), &ISD::Camera::videoRecordToggled, this, &CameraProcess::updateVideoRecordStatus,
                 Qt::UniqueConnection);
+        connect(activeCamera(), &ISD::Camera::imageCompressed, this, &CameraProcess::imageCompressed, Qt::UniqueConnection);
+        connect(activeCamera(), &ISD::Camera::imageSavedUncompressed, this, &CameraProcess::imageSavedUncompressed,
+                Qt::UniqueConnection);
         // disable passing through new frames to the FITS viewer
         disconnect(activeCamera(), &ISD::Camera::newImage, this, &CameraProcess::showFITSPreview);
     }
@@ -2696,6 +2712,8 @@ void CameraProcess::setCamera(bool connection)
         disconnect(activeCamera(), &ISD::Camera::newRemoteFile, this, &CameraProcess::processNewRemoteFile);
         //    disconnect(m_Camera, &ISD::Camera::previewFITSGenerated, this, &Capture::setGeneratedPreviewFITS);
         disconnect(activeCamera(), &ISD::Camera::ready, this, &CameraProcess::cameraReady);
+        disconnect(activeCamera(), &ISD::Camera::imageCompressed, this, &CameraProcess::imageCompressed);
+        disconnect(activeCamera(), &ISD::Camera::imageSavedUncompressed, this, &CameraProcess::imageSavedUncompressed);
     }
 
 }
@@ -2830,6 +2848,27 @@ void CameraProcess::updateVideoRecordStatus(bool enabled)
     }
 }
 
+void CameraProcess::imageCompressed(const QString &filename, qint64 inputSize, qint64 outputSize, qint64 elapsedMS)
+{
+    if (outputSize <= 0)
+        return;
+
+    Q_EMIT newLog(i18n("%1 compressed %2:1 (%3 to %4) in %5 ms.", QFileInfo(filename).fileName(),
+                       QString::number(static_cast<double>(inputSize) / outputSize, 'f', 2),
+                       KFormat().formatByteSize(inputSize), KFormat().formatByteSize(outputSize), elapsedMS));
+}
+
+void CameraProcess::imageSavedUncompressed(const QString &requestedFilename, const QString &filename)
+{
+    // The image was named and logged as compressed before it was written, point to the file that exists
+    if (state()->imageData() && state()->imageData()->filename() == requestedFilename)
+        state()->imageData()->setFilename(filename);
+
+    KStars::Instance()->statusBar()->showMessage(i18n("file saved to %1", filename), 0);
+    Q_EMIT newLog(i18n("%1 could not be compressed, saved uncompressed as %2.", QFileInfo(requestedFilename).fileName(),
+                       filename));
+}
+
 void CameraProcess::llsq(QVector<double> x, QVector<double> y, double &a, double &b)
 {
     double bot;
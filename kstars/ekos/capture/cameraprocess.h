@@ -808,6 +808,15 @@ class CameraProcess : public QObject
          * @param enabled true if recording is on
          */
         void updateVideoRecordStatus(bool enabled);
+        /**
+         * @brief Report the result of tile compressing a saved image in the capture log.
+         */
+        void imageCompressed(const QString &filename, qint64 inputSize, qint64 outputSize, qint64 elapsedMS);
+        /**
+         * @brief Point the image data and the capture log to the uncompressed file written when
+         * compressing a saved image failed.
+         */
+        void imageSavedUncompressed(const QString &requestedFilename, const QString &filename);
         /**
          * @brief captureImageWithDelay Helper function that starts the sequence delay timer
          * for starting to capture after the configured delay.
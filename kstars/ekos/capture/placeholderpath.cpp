@@ -733,7 +733,8 @@ PlaceholderPath::PathPropertyType PlaceholderPath::propertyType(PathProperty pro
 // that number, checking to make sure the new filename with the incremented number doesn't exist.
 QString PlaceholderPath::repairFilename(const QString &filename)
 {
-    QRegularExpression re("^(.*[^\\d])(\\d+)\\.(\\w+)$");
+    // The extension may be compound, e.g. fits.fz
+    QRegularExpression re("^(.*[^\\d])(\\d+)\\.(\\w+(?:\\.\\w+)?)$");
 
     auto match = re.match(filename);
     if (match.hasMatch())
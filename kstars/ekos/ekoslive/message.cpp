@@ -3335,6 +3335,12 @@ void Message::processLiveStackerCommands(const QString &command, const QJsonObje
         params.weighting = static_cast<LiveStackFrameWeighting>(m_LiveStackerSettings.value("weighting", 0).toInt());
         params.lowSigma = m_LiveStackerSettings.value("lowSigma", 2.0).toDouble();
         params.highSigma = m_LiveStackerSettings.value("highSigma", 3.0).toDouble();
+        params.drizzleScale = static_cast<LiveStackDrizzleScale>(m_LiveStackerSettings.value("drizzleScale", 1).toInt());
+        params.drizzlePixFrac = m_LiveStackerSettings.value("drizzlePixFrac", 0.7).toDouble();
+        // Not set by every client, so keep the values the user chose in KStars
+        params.tiledClipping = m_LiveStackerSettings.value("tiledClipping", Options::fitsLSTiledClipping()).toBool();
+        params.tiledBudgetMB = m_LiveStackerSettings.value("tiledBudgetMB", Options::fitsLSTiledBudget()).toInt();
+        params.pipelineWorkers = m_LiveStackerSettings.value("pipelineWorkers", Options::fitsLSPipelineWorkers()).toInt();
 
         // Post-processing settings
         params.postProcessing.postProcess = m_LiveStackerSettings.value("postProcess", false).toBool();
@@ -3727,6 +3733,11 @@ void Message::onLiveStackerJobChanged(const QSharedPointer<Ekos::SequenceJob> &j
     params.weighting         = static_cast<LiveStackFrameWeighting>(m_LiveStackerSettings.value("weighting", 0).toInt());
     params.lowSigma          = m_LiveStackerSettings.value("lowSigma", 2.0).toDouble();
     params.highSigma         = m_LiveStackerSettings.value("highSigma", 3.0).toDouble();
+    params.drizzleScale      = static_cast<LiveStackDrizzleScale>(m_LiveStackerSettings.value("drizzleScale", 1).toInt());
+    params.drizzlePixFrac    = m_LiveStackerSettings.value("drizzlePixFrac", 0.7).toDouble();
+    params.tiledClipping     = m_LiveStackerSettings.value("tiledClipping", Options::fitsLSTiledClipping()).toBool();
+    params.tiledBudgetMB     = m_LiveStackerSettings.value("tiledBudgetMB", Options::fitsLSTiledBudget()).toInt();
+    params.pipelineWorkers   = m_LiveStackerSettings.value("pipelineWorkers", Options::fitsLSPipelineWorkers()).toInt();
     params.postProcessing.postProcess = m_LiveStackerSettings.value("postProcess", false).toBool();
     params.postProcessing.sharpenAmt  = m_LiveStackerSettings.value("sharpenAmt", 0.0).toDouble();
     params.postProcessing.denoiseAmt  = m_LiveStackerSettings.value("denoiseAmt", 0.0).toDouble();
@@ -16,7 +16,6 @@
 #include "fitsviewer/fitsview.h"
 
 #include <cassert>
-#include <fitsio.h>
 #include <KMessageBox>
 #include <QImage>
 
@@ -1114,77 +1113,33 @@ void PHD2::processStarImage(const QJsonObject &jsonStarFrame)
     int width =  jsonStarFrame["width"].toInt();
     int height = jsonStarFrame["height"].toInt();
 
-    //This section sets up the FITS File
-    fitsfile *fptr = nullptr;
-    int status = 0;
-    long fpixel = 1, naxis = 2, nelements, exposure;
-    long naxes[2] = { width, height };
-    char error_status[512] = {0};
-
-    void* fits_buffer = nullptr;
-    size_t fits_buffer_size = 0;
-    if (fits_create_memfile(&fptr, &fits_buffer, &fits_buffer_size, 4096, realloc, &status))
-    {
-        qCWarning(KSTARS_EKOS_GUIDE) << "fits_create_file failed:" << error_status;
-        return;
-    }
-
-    if (fits_create_img(fptr, USHORT_IMG, naxis, naxes, &status))
-    {
-        qCWarning(KSTARS_EKOS_GUIDE) << "fits_create_img failed:" << error_status;
-        status = 0;
-        fits_close_file(fptr, &status);
-        free(fits_buffer);
-        return;
-    }
-
-    //Note, this is made up.  If you want the actual exposure time, you have to request it from PHD2
-    exposure = 1;
-    fits_update_key(fptr, TLONG, "EXPOSURE", &exposure, "Total Exposure Time", &status);
-
     //This section takes the Pixels from the JSON Document
-    //Then it converts from base64 to a QByteArray
-    //Then it creates a datastream from the QByteArray to the pixel array for the FITS File
+    //Then it converts from base64 to a QByteArray of 16 bit pixels
+    //Then the pixels are handed over to FITSData as they are
     QByteArray converted = QByteArray::fromBase64(jsonStarFrame["pixels"].toString().toLocal8Bit());
-
-    //This finishes up and closes the FITS file
-    nelements = naxes[0] * naxes[1];
-    if (fits_write_img(fptr, TUSHORT, fpixel, nelements, converted.data(), &status))
+    if (width <= 0 || height <= 0 || converted.size() != width * height * static_cast<int>(sizeof(uint16_t)))
     {
-        fits_get_errstatus(status, error_status);
-        qCWarning(KSTARS_EKOS_GUIDE) << "fits_write_img failed:" << error_status;
-        status = 0;
-        fits_close_file(fptr, &status);
-        free(fits_buffer);
+        qCWarning(KSTARS_EKOS_GUIDE) << "Invalid star image of" << width << "x" << height << "with"
+                                     << converted.size() << "bytes";
         return;
     }
 
-    if (fits_flush_file(fptr, &status))
-    {
-        fits_get_errstatus(status, error_status);
-        qCWarning(KSTARS_EKOS_GUIDE) << "fits_flush_file failed:" << error_status;
-        status = 0;
-        fits_close_file(fptr, &status);
-        free(fits_buffer);
-        return;
-    }
+    std::unique_ptr<uint8_t[]> pixels(new uint8_t[converted.size()]);
+    memcpy(pixels.get(), converted.constData(), converted.size());
 
-    if (fits_close_file(fptr, &status))
-    {
-        fits_get_errstatus(status, error_status);
-        qCWarning(KSTARS_EKOS_GUIDE) << "fits_close_file failed:" << error_status;
-        free(fits_buffer);
-        return;
-    }
+    FITSData::RawFrameInfo info;
+    info.width = static_cast<uint16_t>(width);
+    info.height = static_cast<uint16_t>(height);
+    info.bitsPerPixel = 16;
+    //Note, this is made up.  If you want the actual exposure time, you have to request it from PHD2
+    info.exposure = 1;
 
-    //This loads the FITS file in the Guide FITSView
+    //This loads the star image in the Guide FITSView
     //Then it updates the Summary Screen
-    QSharedPointer<FITSData> fdata;
-    QByteArray buffer = QByteArray::fromRawData(reinterpret_cast<char *>(fits_buffer), fits_buffer_size);
-    fdata.reset(new FITSData(), &QObject::deleteLater);
-    fdata->setExtension(QString("fits"));
-    fdata->loadFromBuffer(buffer);
-    free(fits_buffer);
+    QSharedPointer<FITSData> fdata = FITSData::fromRawBuffer(FITS_NORMAL, std::move(pixels), info);
+    if (!fdata)
+        return;
+
     m_GuideFrame->loadData(fdata);
 
     m_GuideFrame->updateFrame();
@@ -15,6 +15,9 @@
 #include "schedulerjob.h"
 #include "schedulerutils.h"
 
+#include <QThreadPool>
+#include <QtConcurrent>
+
 #define TEST_PRINT if (false) fprintf
 
 // Can make the scheduling a bit faster by sampling every other minute instead of every minute.
@@ -327,6 +330,58 @@ QDateTime firstPossibleStart(const SchedulerJob *job, const QDateTime &now,
 }
 }  // namespace
 
+// Each job of the batch is evaluated by a single thread of the global pool, so its start time cache
+// isn't shared. The positions of the Moon and the twilight are shared by all the jobs, and computing
+// them moves the Earth of the sky map and uses the static data of KSMoon, so they are computed here
+// first, on the calling thread. The location and options are only read.
+int GreedyScheduler::computeStartTimes(const QList<SchedulerJob *> &jobs, int first, const QDateTime &now,
+                                       const SchedulerJob * const currentJob, int maxJobs,
+                                       QVector<QDateTime> *startTimes) const
+{
+    // As many as the pool has threads, but not past the current job, since the search stops there.
+    const int batchSize = std::max(1, std::min(maxJobs, QThreadPool::globalInstance()->maxThreadCount()));
+    QVector<int> batch;
+    int last = first;
+    for (; last < jobs.size() && batch.size() < batchSize; ++last)
+    {
+        if (!allowJob(jobs[last], rescheduleAbortsImmediate, rescheduleAbortsQueue, rescheduleErrors))
+            continue;
+        batch.append(last);
+        if (currentJob && jobs[last] == currentJob)
+        {
+            ++last;
+            break;
+        }
+    }
+
+    // If the job state is abort or error, might have to delay the first possible start time.
+    QVector<QDateTime> startSearchingAt(jobs.size());
+    for (const int i : batch)
+        startSearchingAt[i] = firstPossibleStart(jobs[i], now, rescheduleAbortsQueue, abortDelaySeconds,
+                              rescheduleErrors, errorDelaySeconds);
+
+    auto compute = [&](int i)
+    {
+        SchedulerJob * const job = jobs[i];
+        // I found that passing in an "until" 4th argument actually hurt performance, as it reduces
+        // the effectiveness of the cache that getNextPossibleStartTime uses.
+        (*startTimes)[i] = job->getNextPossibleStartTime(startSearchingAt[i], SCHEDULE_RESOLUTION_MINUTES,
+                           currentJob && (job == currentJob));
+    };
+
+    // No need for the pool for a single job, which is the common case when the current job is evaluated.
+    if (batch.size() == 1)
+        compute(batch.first());
+    else if (batch.size() > 1)
+    {
+        // A job searching past what was prepared computes the rest under VisibilityTimeline::ephemerisMutex().
+        for (const int i : batch)
+            jobs[i]->prepareNextPossibleStartTime(startSearchingAt[i]);
+        QtConcurrent::blockingMap(batch, compute);
+    }
+    return last;
+}
+
 // Consider all jobs marked as JOB_EVALUATION/ABORT/ERROR. Assume ordered by highest priority first.
 // - Find the job with the earliest start time (given constraints like altitude, twilight, ...)
 //   that can run for at least 10 minutes before a higher priority job.
@@ -364,6 +419,12 @@ SchedulerJob *GreedyScheduler::selectNextJob(const QList<SchedulerJob *> &jobs,
     SchedulerJob * nextJob = nullptr;
     QString interruptStr;
 
+    // The start times of the jobs don't depend on each other, so they are computed several at a time,
+    // see computeStartTimes(). They are still gone through one by one in priority order below, which
+    // keeps the choice, and how ties are broken, the same as computing them one by one.
+    QVector<QDateTime> startTimes(jobs.size());
+    int computedUpTo = 0;
+
     for (int i = 0; i < jobs.size(); ++i)
     {
         SchedulerJob * const job = jobs[i];
@@ -377,16 +438,16 @@ SchedulerJob *GreedyScheduler::selectNextJob(const QList<SchedulerJob *> &jobs,
             continue;
         }
 
-        // If the job state is abort or error, might have to delay the first possible start time.
-        QDateTime startSearchingtAt = firstPossibleStart(
-                                          job, now, rescheduleAbortsQueue, abortDelaySeconds, rescheduleErrors, errorDelaySeconds);
-
-        TEST_PRINT(stderr, "  start searching at %s\n", startSearchingtAt.toString().toLatin1().data());
-        // Find the first time this job can meet all its constraints.
-        // I found that passing in an "until" 4th argument actually hurt performance, as it reduces
-        // the effectiveness of the cache that getNextPossibleStartTime uses.
-        const QDateTime startTime = job->getNextPossibleStartTime(startSearchingtAt, SCHEDULE_RESOLUTION_MINUTES,
-                                    evaluatingCurrentJob);
+        // Find the first time this job can meet all its constraints, computed along with the next few jobs.
+        // Looking for a job to start, the search usually ends with the first allowed job, which can start
+        // now, so that one is computed on its own and the rest only if it can't. Evaluating the current job,
+        // all the jobs up to it are needed anyway.
+        if (i >= computedUpTo)
+        {
+            const int maxJobs = (currentJob || computedUpTo > 0) ? jobs.size() : 1;
+            computedUpTo = computeStartTimes(jobs, i, now, currentJob, maxJobs, &startTimes);
+        }
+        const QDateTime &startTime = startTimes[i];
         TEST_PRINT(stderr, "  startTime %s\n", startTime.toString().toLatin1().data());
 
         if (startTime.isValid())
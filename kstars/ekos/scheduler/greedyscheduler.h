@@ -13,6 +13,8 @@
 #include <QString>
 #include <QVector>
 
+class TestSchedulerBenchmark;
+
 namespace Ekos
 {
 
@@ -168,6 +170,13 @@ class GreedyScheduler : public QObject
                                     QString *interruptReason = nullptr,
                                     const QMap<QString, uint16_t> *capturedFramesCount = nullptr);
 
+        // Computes the next possible start times of a batch of at most maxJobs of the allowed jobs,
+        // starting at jobs[first], in parallel. The times are stored at the jobs' indices in startTimes.
+        // Returns the index following the last job of the batch.
+        int computeStartTimes(const QList<SchedulerJob *> &jobs, int first, const QDateTime &now,
+                              const SchedulerJob * const currentJob, int maxJobs,
+                              QVector<QDateTime> *startTimes) const;
+
         // Simulate the running of the scheduler from time to endTime by appending
         // JobSchedule entries to the schedule.
         // Used to find which jobs will be run in the future.
@@ -199,6 +208,8 @@ class GreedyScheduler : public QObject
 
         // How long the simulations run.
         int SIM_HOURS = 72;
+
+        friend TestSchedulerBenchmark;
 };
 
 }  // namespace Ekos
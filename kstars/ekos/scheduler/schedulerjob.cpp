@@ -655,10 +655,19 @@ bool SchedulerJob::moonConstraintsOK(QDateTime const &when, QString *reason, dou
     moon->updateCoords(&numbers, true, SchedulerModuleState::getGeo()->lat(), &LST, true);
     moon->EquatorialToHorizontal(&LST, SchedulerModuleState::getGeo()->lat());
 
+    return checkMoonConstraints(moon->alt().Degrees(), moon->angularDistanceTo(&o).Degrees(), reason, margin);
+}
+
+bool SchedulerJob::checkMoonConstraints(double moonAltitude, double moonSeparation, QString *reason,
+                                        double *margin) const
+{
+    if (margin)
+        *margin = 90;
+
     bool separationOK = true;
     if (getMinMoonSeparation() > 0)
     {
-        const double val = moon->angularDistanceTo(&o).Degrees() - getMinMoonSeparation();
+        const double val = moonSeparation - getMinMoonSeparation();
         separationOK = val >= 0;
         if (margin)
             *margin = std::abs(val);
@@ -667,7 +676,7 @@ bool SchedulerJob::moonConstraintsOK(QDateTime const &when, QString *reason, dou
     bool altitudeOK = true;
     if (getMaxMoonAltitude() < 90)
     {
-        const double val = moon->alt().Degrees() - getMaxMoonAltitude();
+        const double val = moonAltitude - getMaxMoonAltitude();
         altitudeOK = val <= 0;
         if (margin)
             *margin = std::min(*margin, std::abs(val));
@@ -697,15 +706,6 @@ QDateTime SchedulerJob::calculateNextTime(QDateTime const &when, bool checkIfCon
                           Qt::UTC == when.timeSpec() ? SchedulerModuleState::getGeo()->UTtoLT(KStarsDateTime(when)) : when :
                           getLocalTime());
 
-    // Create a sky object with the target catalog coordinates
-    SkyPoint const target = getTargetCoords();
-    SkyObject o;
-    o.setRA0(target.ra0());
-    o.setDec0(target.dec0());
-
-    // Calculate the UT at the argument time
-    KStarsDateTime const ut = SchedulerModuleState::getGeo()->LTtoUT(ltWhen);
-
     unsigned int maxMinute = 1e8;
     if (!runningJob && until.isValid())
         maxMinute = when.secsTo(until) / 60;
@@ -750,7 +750,7 @@ QDateTime SchedulerJob::calculateNextTime(QDateTime const &when, bool checkIfCon
         if (minute >= nextAltCheck)
         {
             double margin;
-            const bool altAndMoonOK = checkAltitudeAndMoon(o, ltOffset, reason, &margin);
+            const bool altAndMoonOK = checkAltitudeAndMoon(ltOffset, reason, &margin);
             bool done = ((checkIfConstraintsAreMet && altAndMoonOK) || (!checkIfConstraintsAreMet && !altAndMoonOK));
 
             if (done && inSkip)
@@ -766,7 +766,7 @@ QDateTime SchedulerJob::calculateNextTime(QDateTime const &when, bool checkIfCon
                     {
                         KStarsDateTime const lt(ltWhen.addSecs(min * 60));
                         // don't need to test twilight--that was not skipped.
-                        const bool checkOK = checkAltitudeAndMoon(o, lt, reason, nullptr);
+                        const bool checkOK = checkAltitudeAndMoon(lt, reason, nullptr);
                         if ((checkIfConstraintsAreMet && checkOK) || (!checkIfConstraintsAreMet && !checkOK))
                         {
                             // Found an earlier return.
@@ -802,24 +802,22 @@ QDateTime SchedulerJob::calculateNextTime(QDateTime const &when, bool checkIfCon
     return QDateTime();
 }
 
-bool SchedulerJob::checkAltitudeAndMoon(SkyObject o, const KStarsDateTime &ltOffset, QString *reason, double *margin) const
+bool SchedulerJob::checkAltitudeAndMoon(const KStarsDateTime &ltOffset, QString *reason, double *margin) const
 {
-    // Update RA/DEC of the target for the current fraction of the day
-    KSNumbers numbers(ltOffset.djd());
-    o.updateCoordsNow(&numbers);
+    // The positions of the target and the Moon at this time, computed once per day of the timeline
+    const GeoLocation *geo = SchedulerModuleState::getGeo();
+    const bool checkMoon = moon != nullptr && (getMinMoonSeparation() > 0 || getMaxMoonAltitude() < 90);
+    const VisibilityTimeline::Sample sample = visibilityTimeline.sample(getTargetCoords(), geo,
+            checkMoon ? moon : nullptr, geo->LTtoUT(ltOffset));
 
-    // Compute local sidereal time for the current fraction of the day, calculate altitude
-    CachingDms const LST = SchedulerModuleState::getGeo()->GSTtoLST(SchedulerModuleState::getGeo()->LTtoUT(ltOffset).gst());
-    o.EquatorialToHorizontal(&LST, SchedulerModuleState::getGeo()->lat());
-    double const altitude = o.alt().Degrees();
-    double const azimuth = o.az().Degrees();
-
-    bool const altitudeOK = satisfiesAltitudeConstraint(azimuth, altitude, reason, margin);
+    bool const altitudeOK = satisfiesAltitudeConstraint(sample.azimuth, sample.altitude, reason, margin);
     if (altitudeOK)
     {
         // Check moon constraints (moon altitude and distance between target and moon)
+        if (!checkMoon)
+            return true;
         double moonMargin;
-        bool moonConstraint = moonConstraintsOK(ltOffset, reason, &moonMargin);
+        bool moonConstraint = checkMoonConstraints(sample.moonAltitude, sample.moonSeparation, reason, &moonMargin);
         if (margin)
             *margin = std::min(*margin, moonMargin);
         return moonConstraint;
@@ -1065,6 +1063,29 @@ QDateTime SchedulerJob::getNextPossibleStartTime(const QDateTime &when, int incr
     }
 }
 
+void SchedulerJob::prepareNextPossibleStartTime(const QDateTime &when) const
+{
+    const GeoLocation *geo = SchedulerModuleState::getGeo();
+    QDateTime ltWhen(when.isValid() ? (Qt::UTC == when.timeSpec() ? geo->UTtoLT(KStarsDateTime(when)) : when)
+                     : getLocalTime());
+    if (START_AT == getFileStartupCondition() && getStartAtTime() > ltWhen)
+        ltWhen = getStartAtTime();
+
+    // The search covers the 24 hours following when, or following where a cached search stopped,
+    // which is at most 24 hours after when.
+    const QDateTime ltEnd = ltWhen.addDays(2);
+
+    if (moon != nullptr && (getMinMoonSeparation() > 0 || getMaxMoonAltitude() < 90))
+        VisibilityTimeline::prepareMoon(geo->LTtoUT(KStarsDateTime(ltWhen)), geo->LTtoUT(KStarsDateTime(ltEnd)), geo, moon);
+
+    if (getEnforceTwilight())
+    {
+        QDateTime dawn, dusk;
+        for (QDateTime t = ltWhen; t <= ltEnd; t = t.addDays(1))
+            SchedulerModuleState::calculateDawnDusk(t, dawn, dusk);
+    }
+}
+
 // When will this job end (not looking at capture plan)?
 QDateTime SchedulerJob::getNextEndTime(const QDateTime &start, int increment, QString *reason, const QDateTime &until) const
 {
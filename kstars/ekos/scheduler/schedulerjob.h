@@ -10,6 +10,7 @@
 #include "schedulertypes.h"
 #include "ekos/capture/sequencejob.h"
 #include "greedyscheduler.h"
+#include "visibilitytimeline.h"
 
 #include <QUrl>
 #include <QMap>
@@ -20,6 +21,7 @@ class ArtificialHorizon;
 class KSMoon;
 class TestSchedulerUnit;
 class TestEkosSchedulerOps;
+class TestSchedulerBenchmark;
 class dms;
 
 namespace Ekos
@@ -547,7 +549,22 @@ class SchedulerJob
                                            const QDateTime &until = QDateTime()) const;
         QDateTime getNextEndTime(const QDateTime &start, int increment = 1, QString *reason = nullptr,
                                  const QDateTime &until = QDateTime()) const;
-        bool checkAltitudeAndMoon(SkyObject o, const KStarsDateTime &ltOffset, QString *reason, double *margin) const;
+
+        /**
+         * @brief prepareNextPossibleStartTime Compute the twilight and the Moon positions that
+         * getNextPossibleStartTime() may need when searching from when, so that it can then be called on
+         * a worker thread without computing them there.
+         */
+        void prepareNextPossibleStartTime(const QDateTime &when) const;
+
+        /**
+             * @brief checkAltitudeAndMoon checks the altitude, artificial horizon and Moon constraints at a given time.
+             * @param ltOffset local time to check.
+             * @param reason pointer to the reason text in case that the check failed
+             * @param margin set to how far, in degrees, the closest constraint is from changing
+             * @note The positions come from the visibility timeline of the job, computed once per day.
+             */
+        bool checkAltitudeAndMoon(const KStarsDateTime &ltOffset, QString *reason, double *margin) const;
 
 
         /**
@@ -696,11 +713,13 @@ class SchedulerJob
     private:
         bool runsDuringAstronomicalNightTimeInternal(const QDateTime &time, QDateTime *minDawnDusk,
                 QDateTime *nextPossibleSuccess = nullptr) const;
+        bool checkMoonConstraints(double moonAltitude, double moonSeparation, QString *reason, double *margin) const;
 
         // Private constructor for unit testing.
         SchedulerJob(KSMoon *moonPtr);
         friend TestSchedulerUnit;
         friend TestEkosSchedulerOps;
+        friend TestSchedulerBenchmark;
 
         /** @brief Setter used in the unit test to fix the local time. Otherwise getter gets from KStars instance. */
         /** @{ */
@@ -833,6 +852,11 @@ class SchedulerJob
                 void add(const QDateTime &from, const QDateTime &until, const QDateTime &result) const;
                 // Clear the cache.
                 void clear() const;
+                // The number of computations kept, i.e. the calls that weren't answered from the cache.
+                int size() const
+                {
+                    return startComputations.size();
+                }
             private:
                 // Made this mutable and all methods const so that the cache could be
                 // used in SchedulerJob const methods.
@@ -840,6 +864,11 @@ class SchedulerJob
         };
         StartTimeCache startTimeCache;
 
+        // Positions of the target and the Moon over the days the scheduler looks at. Unlike the cache
+        // above it is kept across schedule calculations, it only holds positions and not constraints.
+        // The copies made by GreedyScheduler::simulate() share it.
+        VisibilityTimeline visibilityTimeline;
+
         // These are used in testing, instead of KStars::Instance() resources
         static KStarsDateTime *storedLocalTime;
         static GeoLocation *storedGeo;
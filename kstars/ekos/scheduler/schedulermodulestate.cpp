@@ -10,6 +10,7 @@
 #include "schedulerjob.h"
 #include "kstarsdata.h"
 #include "ksalmanac.h"
+#include "visibilitytimeline.h"
 #include "Options.h"
 
 #define MAX_FAILURE_ATTEMPTS 5
@@ -509,6 +510,8 @@ void SchedulerModuleState::calculateDawnDusk(const QDateTime &when, QDateTime &n
                                     3600.0));
 #else
         // Creating these almanac instances seems expensive.
+        // The jobs may be evaluated on several threads, see GreedyScheduler::computeStartTimes().
+        const std::lock_guard<std::mutex> lock(VisibilityTimeline::ephemerisMutex());
         static QMap<QString, KSAlmanac const * > almanacMap;
         const QString key = QString("%1 %2 %3").arg(midnight.toString()).arg(getGeo()->lat()->Degrees()).arg(
                                 getGeo()->lng()->Degrees());
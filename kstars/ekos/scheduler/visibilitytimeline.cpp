@@ -0,0 +1,236 @@
+/*  Ekos Scheduler Visibility Timeline
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "visibilitytimeline.h"
+
+#include "geolocation.h"
+#include "ksmoon.h"
+#include "ksnumbers.h"
+#include "kstarsdatetime.h"
+#include "skyobject.h"
+
+#include <QList>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace Ekos
+{
+
+namespace
+{
+constexpr int MINUTES = 24 * 60;
+// Minutes between two updates of the apparent coordinates of the target and of the Moon
+constexpr int TARGET_STEP = 60;
+constexpr int MOON_STEP = 10;
+
+// Topocentric RA (hours) and Dec (degrees) of the Moon every MOON_STEP minutes of a UT day
+struct MoonDay
+{
+    int dayNumber;
+    double longitude, latitude, elevation;
+    QVector<double> ra, dec;
+};
+
+// The Moon is the same for all the jobs, the most recent days come first
+QList<MoonDay> moonDays;
+
+MoonDay moonDay(int dayNumber, const GeoLocation *geo, KSMoon *moon)
+{
+    const std::lock_guard<std::mutex> lock(VisibilityTimeline::ephemerisMutex());
+    for (int i = 0; i < moonDays.size(); i++)
+    {
+        const MoonDay &day = moonDays[i];
+        if (day.dayNumber == dayNumber && day.longitude == geo->lng()->Degrees() &&
+                day.latitude == geo->lat()->Degrees() && day.elevation == geo->elevation())
+        {
+            moonDays.move(i, 0);
+            return moonDays.first();
+        }
+    }
+
+    // Computing the positions moves the Moon, so they are computed on a copy rather than on the Moon
+    // the sky map draws
+    const std::unique_ptr<KSMoon> ownMoon(moon->clone());
+    MoonDay day { dayNumber, geo->lng()->Degrees(), geo->lat()->Degrees(), geo->elevation(), {}, {} };
+    const int steps = MINUTES / MOON_STEP + 1;
+    day.ra.resize(steps);
+    day.dec.resize(steps);
+    for (int i = 0; i < steps; i++)
+    {
+        const KStarsDateTime ut(dayNumber - 0.5 + static_cast<double>(i * MOON_STEP) / MINUTES);
+        KSNumbers numbers(ut.djd());
+        const CachingDms LST = geo->GSTtoLST(ut.gst());
+        ownMoon->updateCoords(&numbers, true, geo->lat(), &LST, true);
+        day.ra[i] = ownMoon->ra().Hours();
+        day.dec[i] = ownMoon->dec().Degrees();
+    }
+
+    moonDays.prepend(day);
+    if (moonDays.size() > VisibilityTimeline::MAX_DAYS)
+        moonDays.removeLast();
+    return day;
+}
+
+// Interpolate between two angles, taking the shorter way around the circle
+double interpolateAngle(double a0, double a1, double f, double full)
+{
+    if (a1 - a0 > full / 2)
+        a1 -= full;
+    else if (a0 - a1 > full / 2)
+        a1 += full;
+    const double a = a0 + f * (a1 - a0);
+    return a < 0 ? a + full : (a >= full ? a - full : a);
+}
+} // namespace
+
+VisibilityTimeline::VisibilityTimeline() : m_Data(std::make_shared<Data>())
+{
+}
+
+std::mutex &VisibilityTimeline::ephemerisMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+void VisibilityTimeline::prepareMoon(const KStarsDateTime &start, const KStarsDateTime &end, const GeoLocation *geo,
+                                     KSMoon *moon)
+{
+    // No more days than are kept, the last ones would push the first ones out
+    const int first = static_cast<int>(std::floor(start.djd() + 0.5));
+    const int last = std::min(static_cast<int>(std::floor(end.djd() + 0.5)), first + MAX_DAYS - 1);
+    for (int dayNumber = first; dayNumber <= last; dayNumber++)
+        moonDay(dayNumber, geo, moon);
+}
+
+void VisibilityTimeline::clear() const
+{
+    const std::lock_guard<std::mutex> lock(m_Data->mutex);
+    m_Data->days.clear();
+}
+
+VisibilityTimeline::Sample VisibilityTimeline::sample(const SkyPoint &target, const GeoLocation *geo, KSMoon *moon,
+        const KStarsDateTime &ut) const
+{
+    // Positions computed for another target or place are of no use. If they are shared with a copy
+    // that still needs them, start anew instead of clearing them.
+    const auto matches = [&](const Data & data)
+    {
+        return target.ra0().Degrees() == data.ra0 && target.dec0().Degrees() == data.dec0 &&
+               geo->lng()->Degrees() == data.longitude && geo->lat()->Degrees() == data.latitude &&
+               geo->elevation() == data.elevation && (moon != nullptr) == data.hasMoon;
+    };
+    std::shared_ptr<Data> data = m_Data;
+    std::unique_lock<std::mutex> lock(data->mutex);
+    if (!matches(*data))
+    {
+        if (data.use_count() > 2)
+        {
+            lock.unlock();
+            m_Data = data = std::make_shared<Data>();
+            lock = std::unique_lock<std::mutex>(data->mutex);
+        }
+        data->days.clear();
+        data->ra0 = target.ra0().Degrees();
+        data->dec0 = target.dec0().Degrees();
+        data->longitude = geo->lng()->Degrees();
+        data->latitude = geo->lat()->Degrees();
+        data->elevation = geo->elevation();
+        data->hasMoon = moon != nullptr;
+    }
+
+    const long double jd = ut.djd();
+    const int dayNumber = static_cast<int>(std::floor(jd + 0.5));
+    const double minutes = static_cast<double>(jd - (dayNumber - 0.5L)) * MINUTES;
+    const int i = std::min(std::max(static_cast<int>(minutes), 0), MINUTES - 1);
+    const double f = minutes - i;
+
+    const Day &d = day(*data, dayNumber, target, geo, moon);
+    Sample result;
+    result.altitude = d.altitude[i] + f * (d.altitude[i + 1] - d.altitude[i]);
+    result.azimuth = interpolateAngle(d.azimuth[i], d.azimuth[i + 1], f, 360.0);
+    if (data->hasMoon)
+    {
+        result.moonAltitude = d.moonAltitude[i] + f * (d.moonAltitude[i + 1] - d.moonAltitude[i]);
+        result.moonSeparation = d.moonSeparation[i] + f * (d.moonSeparation[i + 1] - d.moonSeparation[i]);
+    }
+    return result;
+}
+
+const VisibilityTimeline::Day &VisibilityTimeline::day(Data &data, int dayNumber, const SkyPoint &target,
+        const GeoLocation *geo, KSMoon *moon)
+{
+    QMap<int, Day> &days = data.days;
+    auto found = days.constFind(dayNumber);
+    if (found != days.constEnd())
+        return found.value();
+
+    // Keep the days nearest to the new one
+    if (days.size() >= MAX_DAYS)
+    {
+        if (dayNumber - days.firstKey() > days.lastKey() - dayNumber)
+            days.erase(days.begin());
+        else
+            days.erase(std::prev(days.end()));
+    }
+
+    // Apparent coordinates of the target at each TARGET_STEP
+    SkyObject o;
+    o.setRA0(target.ra0());
+    o.setDec0(target.dec0());
+    QVector<double> ra(MINUTES / TARGET_STEP + 1), dec(MINUTES / TARGET_STEP + 1);
+    for (int i = 0; i < ra.size(); i++)
+    {
+        KSNumbers numbers(dayNumber - 0.5 + static_cast<double>(i * TARGET_STEP) / MINUTES);
+        o.updateCoordsNow(&numbers);
+        ra[i] = o.ra().Hours();
+        dec[i] = o.dec().Degrees();
+    }
+
+    MoonDay moonPositions;
+    if (moon != nullptr)
+        moonPositions = moonDay(dayNumber, geo, moon);
+
+    Day day;
+    day.altitude.resize(MINUTES + 1);
+    day.azimuth.resize(MINUTES + 1);
+    if (moon != nullptr)
+    {
+        day.moonAltitude.resize(MINUTES + 1);
+        day.moonSeparation.resize(MINUTES + 1);
+    }
+
+    SkyPoint point, moonPoint;
+    for (int minute = 0; minute <= MINUTES; minute++)
+    {
+        const KStarsDateTime ut(dayNumber - 0.5 + static_cast<double>(minute) / MINUTES);
+        const CachingDms LST = geo->GSTtoLST(ut.gst());
+
+        const int step = (minute + TARGET_STEP / 2) / TARGET_STEP;
+        point.setRA(ra[step]);
+        point.setDec(dec[step]);
+        point.EquatorialToHorizontal(&LST, geo->lat());
+        day.altitude[minute] = point.alt().Degrees();
+        day.azimuth[minute] = point.az().Degrees();
+
+        if (moon != nullptr)
+        {
+            const int j = std::min(minute / MOON_STEP, MINUTES / MOON_STEP - 1);
+            const double f = static_cast<double>(minute - j * MOON_STEP) / MOON_STEP;
+            moonPoint.setRA(interpolateAngle(moonPositions.ra[j], moonPositions.ra[j + 1], f, 24.0));
+            moonPoint.setDec(moonPositions.dec[j] + f * (moonPositions.dec[j + 1] - moonPositions.dec[j]));
+            moonPoint.EquatorialToHorizontal(&LST, geo->lat());
+            day.moonAltitude[minute] = moonPoint.alt().Degrees();
+            day.moonSeparation[minute] = moonPoint.angularDistanceTo(&point).Degrees();
+        }
+    }
+
+    return days.insert(dayNumber, day).value();
+}
+
+} // Ekos namespace
@@ -0,0 +1,115 @@
+/*  Ekos Scheduler Visibility Timeline
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QMap>
+#include <QVector>
+
+#include <memory>
+#include <mutex>
+
+class GeoLocation;
+class KSMoon;
+class KStarsDateTime;
+class SkyPoint;
+
+namespace Ekos
+{
+
+/**
+ * @brief The VisibilityTimeline class keeps the altitude and azimuth of a scheduler target, and the
+ * altitude and separation of the Moon, sampled every minute of whole UT days.
+ *
+ * The scheduler searches the next start and end times of every job minute by minute, over several
+ * days when it simulates the schedule, and used to precess the target and compute the Moon for each
+ * of these minutes. Here a day is computed once, the first time it is asked for, and each later
+ * query is interpolated between the two samples around it. The apparent coordinates of the target
+ * are updated every hour, and those of the Moon every ten minutes, which is well below the accuracy
+ * the constraints need.
+ *
+ * The timeline only holds positions: the altitude, Moon and horizon constraints of the job are
+ * checked against them on each query, so changing them doesn't invalidate anything. The days are
+ * dropped when the target or the location change. The Moon doesn't depend on the target, so its
+ * positions are shared by the timelines of all the jobs.
+ */
+class VisibilityTimeline
+{
+    public:
+        struct Sample
+        {
+            double altitude { 0 };
+            double azimuth { 0 };
+            /// -90 without a Moon
+            double moonAltitude { -90 };
+            /// 180 without a Moon
+            double moonSeparation { 180 };
+        };
+
+        /** Copies share their days until one of them is asked for another target or place */
+        VisibilityTimeline();
+
+        /**
+         * @brief sample Get the positions of the target and the Moon at a given time.
+         * @param target catalog coordinates of the target
+         * @param geo location of the observatory
+         * @param moon Moon to compute, or nullptr to ignore it
+         * @param ut universal time
+         * @return the interpolated positions
+         */
+        Sample sample(const SkyPoint &target, const GeoLocation *geo, KSMoon *moon, const KStarsDateTime &ut) const;
+
+        /** @brief clear Drop all the days computed so far. */
+        void clear() const;
+
+        /**
+         * @brief prepareMoon Compute the positions of the Moon for the UT days from start to end, both
+         * included, so that the timelines sampled later on worker threads find them ready.
+         * @param start first time, universal
+         * @param end last time, universal
+         * @param geo location of the observatory
+         * @param moon Moon to compute
+         */
+        static void prepareMoon(const KStarsDateTime &start, const KStarsDateTime &end, const GeoLocation *geo,
+                                KSMoon *moon);
+
+        /**
+         * @brief ephemerisMutex Held while the Moon or the twilight of the scheduler are computed. KSMoon
+         * keeps its series in static data, and moving the Sun or the Moon moves the Earth of the sky map,
+         * so two threads may not compute them at the same time.
+         */
+        static std::mutex &ephemerisMutex();
+
+        /** Number of days kept per target, the oldest are dropped first */
+        static constexpr int MAX_DAYS = 8;
+
+    private:
+        struct Day
+        {
+            // One entry per minute from 0h UT to 24h UT, both included
+            QVector<float> altitude;
+            QVector<float> azimuth;
+            QVector<float> moonAltitude;
+            QVector<float> moonSeparation;
+        };
+
+        struct Data
+        {
+            std::mutex mutex;
+            QMap<int, Day> days;
+            // What the days were computed for
+            double ra0 { -1 }, dec0 { -1 };
+            double longitude { 0 }, latitude { 0 }, elevation { 0 };
+            bool hasMoon { false };
+        };
+
+        static const Day &day(Data &data, int dayNumber, const SkyPoint &target, const GeoLocation *geo, KSMoon *moon);
+
+        // The scheduler simulates on copies of its jobs, which should reuse the days of the originals
+        mutable std::shared_ptr<Data> m_Data;
+};
+
+} // Ekos namespace
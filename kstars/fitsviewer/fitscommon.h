@@ -313,11 +313,12 @@ static CatObjType catObjTypes[MAX_CAT_OBJ_TYPES] =
 const QStringList STACK_FITS_FILTER { "*.fits", "*.fits.fz", "*.fit", "*.fts" };
 const QStringList STACK_XISF_FILTER { "*.xisf" };
 
-enum class LiveStackAlignMethod { PLATE_SOLVE, NONE };
+enum class LiveStackAlignMethod { PLATE_SOLVE, NONE, STAR_MATCH };
 static const QMap<LiveStackAlignMethod, QString> LiveStackAlignMethodNames
 {
     { LiveStackAlignMethod::PLATE_SOLVE, "Plate Solve" },
-    { LiveStackAlignMethod::NONE, "None" }
+    { LiveStackAlignMethod::NONE, "None" },
+    { LiveStackAlignMethod::STAR_MATCH, "Star Match" }
 };
 
 enum class LiveStackDownscale { NONE, X2, X3, X4 };
@@ -344,13 +345,22 @@ static const QMap<LiveStackNormalization, QString> LiveStackNormalizationNames
     { LiveStackNormalization::LINEAR, "Linear" }
 };
 
-enum class LiveStackStackingMethod { MEAN, SIGMA, WINDSOR, IMAGEMM };
+enum class LiveStackStackingMethod { MEAN, SIGMA, WINDSOR, IMAGEMM, DRIZZLE };
 static const QMap<LiveStackStackingMethod, QString> LiveStackStackingMethodNames
 {
     { LiveStackStackingMethod::MEAN, "Mean" },
     { LiveStackStackingMethod::SIGMA, "Sigma Clipping" },
     { LiveStackStackingMethod::WINDSOR, "Windsorization" },
-    { LiveStackStackingMethod::IMAGEMM, "ImageMM" }
+    { LiveStackStackingMethod::IMAGEMM, "ImageMM" },
+    { LiveStackStackingMethod::DRIZZLE, "Drizzle" }
+};
+
+enum class LiveStackDrizzleScale { X1_5, X2, X3 };
+static const QMap<LiveStackDrizzleScale, QString> LiveStackDrizzleScaleNames
+{
+    { LiveStackDrizzleScale::X1_5, "1.5×" },
+    { LiveStackDrizzleScale::X2, "2×" },
+    { LiveStackDrizzleScale::X3, "3×" }
 };
 
 enum class LiveStackChannel { SINGLE, RED, GREEN, BLUE, LUM, NONE };
@@ -414,6 +424,11 @@ struct LiveStackData
     double alpha;
     double sigma;
     int PSFUpdate;
+    bool tiledClipping = false;   // Spill subs to disk and sigma clip in bands (Sigma / Windsor only)
+    int tiledBudgetMB = 512;      // RAM budget for each band of spilled subs
+    int pipelineWorkers = 0;      // Subs loaded ahead in parallel (0 = load each sub when needed)
+    LiveStackDrizzleScale drizzleScale = LiveStackDrizzleScale::X2; // Output grid relative to the subs (Drizzle only)
+    double drizzlePixFrac = 0.7;  // Drop size relative to an input pixel (Drizzle only)
     LiveStackPPData postProcessing;
 
     // EkosLive integration: output directory for saved stacked images
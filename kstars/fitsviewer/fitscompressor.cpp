@@ -0,0 +1,323 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "fitscompressor.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QFuture>
+#include <QThread>
+#include <QtConcurrent>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <fits_debug.h>
+
+namespace
+{
+// HCOMPRESS tiles are blocks of about this many rows, Rice tiles are single rows like CFITSIO's default
+constexpr long HCOMPRESS_TILE_ROWS = 16;
+
+QString fitsError(int status)
+{
+    char message[FLEN_STATUS] = {0};
+    fits_get_errstatus(status, message);
+    return QString(message);
+}
+}
+
+FITSCompressor::Result FITSCompressor::compress(const char *buffer, size_t size, const QString &filename,
+        Method method)
+{
+    Result result;
+    result.inputSize = size;
+    QElapsedTimer timer;
+    timer.start();
+
+    fitsfile *in = nullptr, *out = nullptr;
+    int status = 0;
+    void *memory = const_cast<char *>(buffer);
+    size_t memorySize = size;
+    if (fits_open_memfile(&in, "capture", READONLY, &memory, &memorySize, 0, nullptr, &status))
+    {
+        result.error = fitsError(status);
+        return result;
+    }
+
+    Tiling tiling;
+    long naxes[3] = { 1, 1, 1 };
+    LONGLONG headStart = 0, dataStart = 0, dataEnd = 0;
+    fits_get_img_param(in, 3, &tiling.bitpix, &tiling.naxis, naxes, &status);
+    fits_get_hduaddrll(in, &headStart, &dataStart, &dataEnd, &status);
+
+    // generateFilename() leaves an empty file behind, and CFITSIO won't create over an existing file
+    QFile::remove(filename);
+    fits_create_diskfile(&out, QFile::encodeName(filename).constData(), &status);
+    if (status)
+    {
+        result.error = fitsError(status);
+        status = 0;
+        fits_close_file(in, &status);
+        return result;
+    }
+
+    tiling.width = naxes[0];
+    tiling.height = naxes[1];
+    tiling.planes = tiling.naxis == 3 ? naxes[2] : 1;
+    const int bytesPerSample = std::abs(tiling.bitpix) / 8;
+    const bool integer = tiling.bitpix == BYTE_IMG || tiling.bitpix == SHORT_IMG || tiling.bitpix == LONG_IMG;
+    const bool parallel = integer && (tiling.naxis == 2 || tiling.naxis == 3) &&
+                          dataStart + static_cast<LONGLONG>(tiling.width) * tiling.height * tiling.planes * bytesPerSample
+                          <= static_cast<LONGLONG>(size);
+
+    if (parallel && !status)
+    {
+        // HCOMPRESS needs tiles of at least 4x4 and is only used by CFITSIO for 8 and 16-bit data
+        tiling.method = method == HCOMPRESS ? HCOMPRESS : RICE;
+        if (tiling.method == HCOMPRESS && (tiling.bitpix == LONG_IMG || tiling.width < 4 || tiling.height < 4))
+            tiling.method = RICE;
+        if (tiling.method == HCOMPRESS)
+        {
+            // As CFITSIO, avoid a last tile of fewer than 4 rows
+            tiling.tileRows = HCOMPRESS_TILE_ROWS;
+            while (tiling.height % tiling.tileRows > 0 && tiling.height % tiling.tileRows < 4)
+                tiling.tileRows++;
+        }
+        tiling.tilesPerPlane = (tiling.height + tiling.tileRows - 1) / tiling.tileRows;
+        tiling.tiles = tiling.tilesPerPlane * tiling.planes;
+
+        writeTiles(in, out, tiling, reinterpret_cast<const uchar *>(buffer) + dataStart, &status);
+    }
+    else if (!status)
+    {
+        // Floating point data would be quantised, i.e. lossy, by Rice or HCOMPRESS
+        fits_set_compression_type(out, integer && method == HCOMPRESS ? HCOMPRESS_1 : (integer ? RICE_1 : GZIP_2), &status);
+        if (!integer)
+            fits_set_quantize_level(out, 0, &status);
+        fits_img_compress(in, out, &status);
+    }
+
+    if (status)
+        result.error = fitsError(status);
+
+    int closeStatus = 0;
+    fits_close_file(out, &closeStatus);
+    if (!status && closeStatus)
+        result.error = fitsError(closeStatus);
+    closeStatus = 0;
+    fits_close_file(in, &closeStatus);
+
+    result.success = result.error.isEmpty();
+    if (result.success)
+        result.outputSize = QFileInfo(filename).size();
+    else
+        QFile::remove(filename);
+    result.elapsedMS = timer.elapsed();
+    return result;
+}
+
+bool FITSCompressor::canCompress(const char *buffer, size_t size)
+{
+    if (buffer == nullptr || size == 0)
+        return false;
+
+    fitsfile *in = nullptr;
+    int status = 0;
+    void *memory = const_cast<char *>(buffer);
+    size_t memorySize = size;
+    if (fits_open_memfile(&in, "capture", READONLY, &memory, &memorySize, 0, nullptr, &status))
+        return false;
+
+    int bitpix = 0, naxis = 0;
+    long naxes[3] = { 1, 1, 1 };
+    LONGLONG headStart = 0, dataStart = 0, dataEnd = 0;
+    fits_get_img_param(in, 3, &bitpix, &naxis, naxes, &status);
+    fits_get_hduaddrll(in, &headStart, &dataStart, &dataEnd, &status);
+
+    // Camera blobs may leave out the padding of the last block, but not any pixels
+    const LONGLONG samples = static_cast<LONGLONG>(naxes[0]) * naxes[1] * (naxis == 3 ? naxes[2] : 1);
+    const bool ok = !status && naxis >= 1 && naxis <= 3 && samples > 0 &&
+                    dataStart + samples * (std::abs(bitpix) / 8) <= static_cast<LONGLONG>(size);
+
+    status = 0;
+    fits_close_file(in, &status);
+    return ok;
+}
+
+bool FITSCompressor::writeTiles(fitsfile *in, fitsfile *out, const Tiling &tiling, const uchar *data, int *status)
+{
+    const int bytesPerSample = std::abs(tiling.bitpix) / 8;
+
+    // Compress the tiles in parallel while the headers are written
+    std::vector<QByteArray> tiles(tiling.tiles);
+    QVector<QFuture<void>> futures;
+    const long chunks = std::max(1L, std::min<long>(QThread::idealThreadCount(), tiling.tiles));
+    const long tilesPerChunk = (tiling.tiles + chunks - 1) / chunks;
+    for (long first = 0; first < tiling.tiles; first += tilesPerChunk)
+    {
+        const long last = std::min(tiling.tiles, first + tilesPerChunk);
+        futures.append(QtConcurrent::run([&tiles, &tiling, data, bytesPerSample, first, last]()
+        {
+            for (long tile = first; tile < last; tile++)
+            {
+                const long plane = tile / tiling.tilesPerPlane;
+                const long row = (tile % tiling.tilesPerPlane) * tiling.tileRows;
+                const long rows = std::min(tiling.tileRows, tiling.height - row);
+                const uchar *samples = data + ((plane * tiling.height + row) * tiling.width) * bytesPerSample;
+                tiles[tile] = compressTile(samples, rows, tiling);
+            }
+        }));
+    }
+
+    // Empty primary array followed by the compressed image, as written by CFITSIO and fpack
+    char ttype[] = "COMPRESSED_DATA";
+    char tform[] = "1PB";
+    char *ttypes[] = { ttype };
+    char *tforms[] = { tform };
+    fits_create_img(out, BYTE_IMG, 0, nullptr, status);
+    fits_create_tbl(out, BINARY_TBL, tiling.tiles, 1, ttypes, tforms, nullptr, nullptr, status);
+
+    int yes = 1;
+    fits_write_key(out, TLOGICAL, "ZIMAGE", &yes, "extension contains compressed image", status);
+    fits_write_key(out, TLOGICAL, "ZSIMPLE", &yes, "file does conform to FITS standard", status);
+    int bitpix = tiling.bitpix;
+    fits_write_key(out, TINT, "ZBITPIX", &bitpix, "data type of original image", status);
+    int naxis = tiling.naxis;
+    fits_write_key(out, TINT, "ZNAXIS", &naxis, "dimension of original image", status);
+    long naxes[3] = { tiling.width, tiling.height, tiling.planes };
+    long tileSize[3] = { tiling.width, tiling.tileRows, 1 };
+    for (int i = 0; i < naxis; i++)
+    {
+        fits_write_key(out, TLONG, QString("ZNAXIS%1").arg(i + 1).toLatin1().constData(), &naxes[i],
+                       "length of original image axis", status);
+        fits_write_key(out, TLONG, QString("ZTILE%1").arg(i + 1).toLatin1().constData(), &tileSize[i],
+                       "size of tiles to be compressed", status);
+    }
+
+    char rice[] = "RICE_1", hcompress[] = "HCOMPRESS_1";
+    char blockSizeName[] = "BLOCKSIZE", bytePixName[] = "BYTEPIX", scaleName[] = "SCALE", smoothName[] = "SMOOTH";
+    int blockSize = 32, bytePix = bytesPerSample, zero = 0;
+    if (tiling.method == HCOMPRESS)
+    {
+        fits_write_key(out, TSTRING, "ZCMPTYPE", hcompress, "compression algorithm", status);
+        fits_write_key(out, TSTRING, "ZNAME1", scaleName, "HCOMPRESS scale factor", status);
+        fits_write_key(out, TINT, "ZVAL1", &zero, "HCOMPRESS scale factor", status);
+        fits_write_key(out, TSTRING, "ZNAME2", smoothName, "HCOMPRESS smoothing option", status);
+        fits_write_key(out, TINT, "ZVAL2", &zero, "HCOMPRESS smoothing option", status);
+    }
+    else
+    {
+        fits_write_key(out, TSTRING, "ZCMPTYPE", rice, "compression algorithm", status);
+        fits_write_key(out, TSTRING, "ZNAME1", blockSizeName, "compression block size", status);
+        fits_write_key(out, TINT, "ZVAL1", &blockSize, "pixels per block", status);
+        fits_write_key(out, TSTRING, "ZNAME2", bytePixName, "bytes per pixel (1, 2, 4, or 8)", status);
+        fits_write_key(out, TINT, "ZVAL2", &bytePix, "bytes per pixel (1, 2, 4, or 8)", status);
+    }
+
+    // Copy the image header apart from the structural keywords replaced above. BZERO and BSCALE keep their
+    // meaning in a compressed image, BLANK becomes ZBLANK.
+    int keys = 0;
+    fits_get_hdrspace(in, &keys, nullptr, status);
+    char card[FLEN_CARD];
+    for (int i = 1; i <= keys && !*status; i++)
+    {
+        fits_read_record(in, i, card, status);
+        const int keyClass = fits_get_keyclass(card);
+        if (keyClass == TYP_STRUC_KEY || keyClass == TYP_CMPRS_KEY || keyClass == TYP_CKSUM_KEY)
+            continue;
+        if (strncmp(card, "BLANK   ", 8) == 0)
+            memcpy(card, "ZBLANK  ", 8);
+        fits_write_record(out, card, status);
+    }
+
+    for (auto &future : futures)
+        future.waitForFinished();
+
+    for (long tile = 0; tile < tiling.tiles && !*status; tile++)
+    {
+        if (tiles[tile].isEmpty())
+        {
+            qCWarning(KSTARS_FITS) << "Failed to compress tile" << tile;
+            *status = DATA_COMPRESSION_ERR;
+            break;
+        }
+        fits_write_col(out, TBYTE, 1, tile + 1, 1, tiles[tile].size(),
+                       reinterpret_cast<uchar *>(tiles[tile].data()), status);
+        // Free each tile once written
+        tiles[tile] = QByteArray();
+    }
+
+    return *status == 0;
+}
+
+QByteArray FITSCompressor::compressTile(const uchar *data, long rows, const Tiling &tiling)
+{
+    // The FITS data is big endian, the coders want native integers
+    const long samples = rows * tiling.width;
+    const int bytesPerSample = std::abs(tiling.bitpix) / 8;
+    QByteArray output;
+
+    if (tiling.method == HCOMPRESS)
+    {
+        std::vector<int> values(samples);
+        if (bytesPerSample == 1)
+            std::copy(data, data + samples, values.begin());
+        else
+        {
+            for (long i = 0; i < samples; i++)
+                values[i] = qFromBigEndian<qint16>(data + 2 * i);
+        }
+
+        // Generous, HCOMPRESS can expand noisy data
+        long length = samples * sizeof(int) + 1024;
+        output.resize(length);
+        int status = 0;
+        // CFITSIO passes the tile width first
+        fits_hcompress(values.data(), tiling.width, rows, 0, output.data(), &length, &status);
+        if (status)
+            return QByteArray();
+        output.resize(length);
+        return output;
+    }
+
+    // Rice stores at most a little over the raw size
+    const int capacity = static_cast<int>(samples * bytesPerSample * 2 + 64);
+    output.resize(capacity);
+    auto *compressed = reinterpret_cast<unsigned char *>(output.data());
+    int length = -1;
+    switch (bytesPerSample)
+    {
+        case 1:
+        {
+            std::vector<signed char> values(data, data + samples);
+            length = fits_rcomp_byte(values.data(), samples, compressed, capacity, 32);
+            break;
+        }
+        case 2:
+        {
+            std::vector<short> values(samples);
+            qFromBigEndian<qint16>(data, samples, values.data());
+            length = fits_rcomp_short(values.data(), samples, compressed, capacity, 32);
+            break;
+        }
+        case 4:
+        {
+            std::vector<int> values(samples);
+            qFromBigEndian<qint32>(data, samples, values.data());
+            length = fits_rcomp(values.data(), samples, compressed, capacity, 32);
+            break;
+        }
+    }
+    if (length <= 0)
+        return QByteArray();
+    output.resize(length);
+    return output;
+}
@@ -0,0 +1,81 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+
+#include <fitsio.h>
+
+/**
+ * @class FITSCompressor
+ * @brief Writes FITS images as lossless tile compressed FITS (.fits.fz), as fpack would.
+ *
+ * 8, 16 and 32-bit integer images are split into tiles of whole rows which are compressed in
+ * parallel, each with CFITSIO's own Rice or HCOMPRESS coder, and then written in order as the
+ * binary table of the FITS tiled image compression convention. The result is identical in format
+ * to CFITSIO's output and is read by KStars, CFITSIO, funpack, astropy etc.
+ *
+ * Other images (floating point or 64-bit) are compressed losslessly with GZIP_2 by CFITSIO on the
+ * calling thread.
+ */
+class FITSCompressor
+{
+    public:
+        // Order matches the CaptureFITSCompression option
+        typedef enum
+        {
+            NONE,
+            RICE,
+            HCOMPRESS
+        } Method;
+
+        typedef struct
+        {
+            bool success { false };
+            QString error;
+            qint64 inputSize { 0 };
+            qint64 outputSize { 0 };
+            qint64 elapsedMS { 0 };
+        } Result;
+
+        /**
+         * @brief compress Write an in-memory FITS file as a tile compressed FITS file.
+         * Only the primary image HDU and its header are written.
+         * @param buffer complete FITS file as received from the camera
+         * @param size of buffer in bytes
+         * @param filename to write, replaced if it exists. Removed again on failure.
+         * @param method compression to use for integer images
+         */
+        static Result compress(const char *buffer, size_t size, const QString &filename, Method method);
+
+        /**
+         * @brief canCompress Check that an in-memory FITS file has a complete primary image that
+         * compress() can write, so that a caller can choose the .fits.fz name only when it will be used.
+         * compress() can still fail if the file can't be written.
+         * @param buffer complete FITS file as received from the camera
+         * @param size of buffer in bytes
+         */
+        static bool canCompress(const char *buffer, size_t size);
+
+    private:
+        struct Tiling
+        {
+            int bitpix { 0 };
+            int naxis { 0 };
+            long width { 0 };
+            long height { 0 };
+            long planes { 1 };
+            long tileRows { 1 };
+            long tilesPerPlane { 0 };
+            long tiles { 0 };
+            Method method { RICE };
+        };
+
+        static bool writeTiles(fitsfile *in, fitsfile *out, const Tiling &tiling, const uchar *data, int *status);
+        static QByteArray compressTile(const uchar *data, long rows, const Tiling &tiling);
+};
@@ -13,6 +13,7 @@
 #include "fitsgradientdetector.h"
 #include "fitscentroiddetector.h"
 #include "fitssepdetector.h"
+#include "stretchkernels.h"
 
 #include "fpack.h"
 
@@ -27,11 +28,14 @@
 #include "skycomponents/constellationboundarylines.h"
 #include "auxiliary/ksnotification.h"
 #include "auxiliary/robuststatistics.h"
+#include "auxiliary/histogrammedian.h"
 
 #include <KFormat>
 #include <QApplication>
 #include <QImage>
 #include <QtConcurrent>
+#include <QElapsedTimer>
+#include <QtEndian>
 #include <QImageReader>
 #include <QUrl>
 #include <QNetworkAccessManager>
@@ -49,6 +53,7 @@
 #include <libxisf.h>
 #endif
 
+#include <algorithm>
 #include <cfloat>
 #include <cmath>
 #include <zlib.h>
@@ -163,6 +168,7 @@ FITSData::~FITSData()
     releaseMemFileBuffer();
 
     // Live Stacking
+    clearStackPrefetch();
     if (m_StackImageBuffer != nullptr)
     {
         delete[] m_StackImageBuffer;
@@ -324,6 +330,87 @@ bool FITSData::loadFromBuffer(const QByteArray &buffer)
     return privateLoad(buffer);
 }
 
+QSharedPointer<FITSData> FITSData::fromRawBuffer(FITSMode mode, std::unique_ptr<uint8_t[]> buffer,
+        const RawFrameInfo &info)
+{
+    if (!buffer || info.width == 0 || info.height == 0 || (info.bitsPerPixel != 8 && info.bitsPerPixel != 16))
+    {
+        qCWarning(KSTARS_FITS) << "Invalid raw frame" << info.width << "x" << info.height << "with"
+                               << info.bitsPerPixel << "bits per pixel";
+        return {};
+    }
+
+    QSharedPointer<FITSData> data(new FITSData(mode), &QObject::deleteLater);
+    data->loadRawBuffer(std::move(buffer), info);
+    return data;
+}
+
+void FITSData::loadRawBuffer(std::unique_ptr<uint8_t[]> buffer, const RawFrameInfo &info)
+{
+    loadCommon("");
+    m_isTemporary = false;
+    m_isCompressed = false;
+    m_Extension = "fits";
+    cacheHFR = -1;
+    cacheEccentricity = -1;
+
+    if (info.bitsPerPixel == 16)
+    {
+        m_FITSBITPIX               = USHORT_IMG;
+        m_Statistics.dataType      = TUSHORT;
+        m_Statistics.bytesPerPixel = sizeof(uint16_t);
+    }
+    else
+    {
+        m_FITSBITPIX               = BYTE_IMG;
+        m_Statistics.dataType      = TBYTE;
+        m_Statistics.bytesPerPixel = sizeof(uint8_t);
+    }
+
+    m_Statistics.ndim                = 2;
+    m_Statistics.width               = info.width;
+    m_Statistics.height              = info.height;
+    m_Statistics.channels            = 1;
+    m_Statistics.samples_per_channel = m_Statistics.width * m_Statistics.height;
+    roiCenter.setX(m_Statistics.width / 2 + m_Statistics.width % 2);
+    roiCenter.setY(m_Statistics.height / 2 + m_Statistics.height % 2);
+
+    clearImageBuffers();
+    m_ImageBufferSize = m_Statistics.samples_per_channel * m_Statistics.bytesPerPixel;
+    m_ImageBuffer     = buffer.release();
+    m_Statistics.size = m_ImageBufferSize;
+
+    rotCounter   = 0;
+    flipHCounter = 0;
+    flipVCounter = 0;
+
+    const QDateTime timestamp = info.timestamp.isValid() ? info.timestamp.toUTC() : QDateTime::currentDateTimeUtc();
+    m_DateTime = KStarsDateTime(timestamp.date(), timestamp.time());
+
+    // The records CFITSIO would have written for such an image, typed as parseHeader() reads them back
+    m_HeaderRecords.clear();
+    const auto addRecord = [this](const QString & key, const QVariant & value, const QString & comment)
+    {
+        Record record;
+        record.key = key;
+        record.value = value;
+        record.comment = comment;
+        m_HeaderRecords.append(record);
+    };
+    addRecord("SIMPLE", "T", "file does conform to FITS standard");
+    addRecord("BITPIX", m_FITSBITPIX, "number of bits per data pixel");
+    addRecord("NAXIS", 2, "number of data axes");
+    addRecord("NAXIS1", static_cast<int>(info.width), "length of data axis 1");
+    addRecord("NAXIS2", static_cast<int>(info.height), "length of data axis 2");
+    addRecord("EXPTIME", info.exposure, "Total Exposure Time (s)");
+    addRecord("XBINNING", static_cast<int>(info.xBinning), "Binning factor in width");
+    addRecord("YBINNING", static_cast<int>(info.yBinning), "Binning factor in height");
+    addRecord("DATE-OBS", timestamp.toString("yyyy-MM-ddThh:mm:ss.zzz"), "UTC start date of observation");
+
+    calculateStats(false, false);
+    starsSearched = false;
+}
+
 QFuture<bool> FITSData::loadFromFile(const QString &inFilename)
 {
     loadCommon(inFilename);
@@ -409,6 +496,8 @@ bool FITSData::loadStack(const QStringList &inDir, const LiveStackData &params)
         QSharedPointer<FITSStack> stack = QSharedPointer<FITSStack>::create(this, base, params);
 
         connect(stack.get(), &FITSStack::updateStackMon, this, &FITSData::updateStackMon);
+        connect(stack.get(), &FITSStack::updateStackMemory, this, &FITSData::updateStackMemory);
+        connect(stack.get(), &FITSStack::updateStackNoise, this, &FITSData::updateStackNoise);
         m_Stacks.insert(base, stack);
     }
 
@@ -436,6 +525,8 @@ bool FITSData::loadStack(const QStringList &inDir, const LiveStackData &params)
     m_StackWatcher.waitForFinished();
     m_StackFITSWatcher.waitForFinished();
     m_StackPrepareFuture.waitForFinished();
+    m_StackActiveLoader.reset();
+    clearStackPrefetch();
     connect(&m_StackWatcher, &QFutureWatcher<bool>::finished, this, &FITSData::stackProcessDone);
     connect(&m_StackFITSWatcher, &QFutureWatcher<bool>::finished, this, &FITSData::stackFITSLoaded);
 
@@ -698,8 +789,9 @@ void FITSData::checkCancelStack()
     {
         qCDebug(KSTARS_FITS) << "Cancel stack request completed";
 
-        // Drain any subs in the work Q
+        // Drain any subs in the work Q and any loaded ahead
         m_StackQ.clear();
+        clearStackPrefetch();
 
         Q_EMIT stackReady(true);
     }
@@ -732,6 +824,7 @@ void FITSData::newStackSubs(QDateTime timestamp, const QVector<LiveStackFile> &n
 
     // Add the new files to the Stack Monitor
     Q_EMIT addStackMon(timestamp, lsfs);
+    stackPrefetch();
     incrementalStack();
 }
 
@@ -914,7 +1007,21 @@ bool FITSData::prepareStackBuffer()
             return false;
         }
 
-        m_StackSNR = m_LiveStackData.calcSNR ? calcStackSNR(finalImage) : 0.0;
+        m_StackSNR = 0.0;
+        if (m_LiveStackData.calcSNR)
+        {
+            // Use the stacks' running statistics, which are updated as subs are added, rather than measuring
+            // the whole stacked image again. Multi-channel stacks are averaged as calcStackSNR averages channels.
+            double snrSum = 0.0;
+            bool haveStatistics = !m_Stacks.isEmpty();
+            for (const auto &stack : m_Stacks)
+            {
+                const auto &summary = stack->getStatisticsSummary();
+                haveStatistics &= summary.noise > 0.0;
+                snrSum += summary.snr;
+            }
+            m_StackSNR = haveStatistics ? snrSum / m_Stacks.size() : calcStackSNR(finalImage);
+        }
 
         if (!convertMatToFITS(finalImage))
         {
@@ -1244,20 +1351,58 @@ void FITSData::redoPostProcessStack(const LiveStackPPData &ppParams)
 
 bool FITSData::processNextSub(LiveStackFile &sub)
 {
-    // Signal the Wait Load stage complete (i.e. we're now going to load the sub) to Stack Monitor
-    QVector<LiveStackFile> subs { sub };
-    QVector<LiveStackStageInfo> infos { LiveStackStageInfo::fromNow(-1, LSStage::WaitLoad, LSStatus::LSStatusOK) };
-    Q_EMIT updateStackMon(subs, infos);
+    // Pick up the sub from the load pipeline if its load has already been started
+    StackPrefetch prefetch;
+    auto it = std::find_if(m_StackPrefetch.begin(), m_StackPrefetch.end(), [&sub](const StackPrefetch & p)
+    {
+        return p.sub.ID == sub.ID && p.sub.file == sub.file;
+    });
+    const bool prefetched = (it != m_StackPrefetch.end());
+    if (prefetched)
+    {
+        prefetch = *it;
+        m_StackPrefetch.erase(it);
+        m_StackActiveLoader = prefetch.loader;
+    }
+    else
+    {
+        // Signal the Wait Load stage complete (i.e. we're now going to load the sub) to Stack Monitor
+        QVector<LiveStackFile> subs { sub };
+        QVector<LiveStackStageInfo> infos { LiveStackStageInfo::fromNow(-1, LSStage::WaitLoad, LSStatus::LSStatusOK) };
+        Q_EMIT updateStackMon(subs, infos);
+    }
 
     m_CurrentStack->setupNextSub(sub);
     m_StackFITSAsync = stackFITSSub;
-    qCDebug(KSTARS_FITS) << "Loading sub" << sub.file;
+    m_StackSubStarMatched = false;
+    qCDebug(KSTARS_FITS) << "Loading sub" << sub.file << (prefetched ? "(loaded ahead)" : "");
+
+    // Keep the pipeline full whilst this sub is processed
+    stackPrefetch();
 
     // Lambda to load the sub in the background
-    QFuture<bool> future = QtConcurrent::run([this, sub]() -> bool
+    QFuture<bool> future = QtConcurrent::run([this, sub, prefetch, prefetched]() -> bool
     {
         double snr = -1.0;
-        bool ok = stackLoadImage(sub.file);
+        bool ok;
+        qint64 readTime;
+        if (prefetched)
+        {
+            // Wait for the pipeline to finish loading the sub then take it over
+            const StackPrefetchResult result = prefetch.future.result();
+            ok = result.ok;
+            readTime = result.readTime;
+            if (ok)
+                stackAdoptLoad(*prefetch.loader);
+        }
+        else
+        {
+            QElapsedTimer timer;
+            timer.start();
+            ok = stackLoadImage(sub.file);
+            readTime = timer.elapsed();
+        }
+
         if (!ok)
             qCDebug(KSTARS_FITS) << QString("Unable to load sub %1").arg(sub.file);
         else
@@ -1302,11 +1447,32 @@ bool FITSData::processNextSub(LiveStackFile &sub)
         // Signal the Loaded stage complete to Stack Monitor
         QVariantMap extraData;
         extraData.insert("morc", m_StackStatistics.stats.channels);
+        extraData.insert("readTime", readTime / 1000.0);
         extraData.insert("snr", snr);
         QVector<LiveStackStageInfo> infos { LiveStackStageInfo::fromNow(-1, LSStage::Loaded,
                                             (ok) ? LSStatus::LSStatusOK : LSStatus::LSStatusError, extraData) };
         QVector<LiveStackFile> subs { sub };
         Q_EMIT updateStackMon(subs, infos);
+
+        // Star matching alignment. Subs that can't be matched will be plate solved instead
+        if (ok && m_LiveStackData.alignMethod == LiveStackAlignMethod::STAR_MATCH)
+        {
+            double hfr = -1.0;
+            int numStars = 0;
+            m_StackSubStarMatched = stackStarMatch(false, hfr, numStars);
+            if (m_StackSubStarMatched)
+            {
+                // Signal the Plate Solved stage complete to Stack Monitor
+                QVariantMap solvedData;
+                if (sub.file == m_LiveStackData.alignMaster)
+                    solvedData.insert("alignMaster", true);
+                solvedData.insert("numStars", numStars);
+                solvedData.insert("hfr", hfr);
+                QVector<LiveStackStageInfo> solvedInfos { LiveStackStageInfo::fromNow(-1, LSStage::PlateSolved,
+                                                          LSStatus::LSStatusOK, solvedData) };
+                Q_EMIT updateStackMon(subs, solvedInfos);
+            }
+        }
         return ok;
     });
 
@@ -1314,6 +1480,195 @@ bool FITSData::processNextSub(LiveStackFile &sub)
     return true;
 }
 
+// Keep the load pipeline full by starting to load the subs that will be processed next. Loads run on
+// their own pool, each with a private FITSData loader, so reading and debayering overlaps plate solving,
+// calibration and stacking of earlier subs. Subs are still committed to the stack in order by processNextSub.
+void FITSData::stackPrefetch()
+{
+    const int workers = m_LiveStackData.pipelineWorkers;
+    if (workers <= 0 || m_CancelRequest)
+        return;
+
+    if (m_StackPrefetchPool.maxThreadCount() != workers)
+        m_StackPrefetchPool.setMaxThreadCount(workers);
+
+    // Subs due to be processed next: the rest of the current batch followed by the work queue
+    QVector<LiveStackFile> upcoming;
+    for (int i = std::max(0, m_StackSubPos + 1); i < m_StackSubs.size() && upcoming.size() < workers; i++)
+        upcoming.push_back(m_StackSubs[i]);
+    for (int i = 0; i < m_StackQ.size() && upcoming.size() < workers; i++)
+        upcoming.push_back(m_StackQ[i]);
+
+    auto sameSub = [](const LiveStackFile & a, const LiveStackFile & b)
+    {
+        return a.ID == b.ID && a.file == b.file;
+    };
+
+    // Drop any loads that are no longer wanted, e.g. a sub discarded from the work queue
+    for (auto it = m_StackPrefetch.begin(); it != m_StackPrefetch.end();)
+    {
+        const bool wanted = std::any_of(upcoming.cbegin(), upcoming.cend(), [&](const LiveStackFile & sub)
+        {
+            return sameSub(sub, it->sub);
+        });
+        if (wanted)
+            ++it;
+        else
+        {
+            // Don't block the GUI thread on a load in progress, let it finish on its own
+            if (it->future.isFinished())
+                m_StackLoaders.push_back(it->loader);
+            else
+                retireStackPrefetch(*it);
+            it = m_StackPrefetch.erase(it);
+        }
+    }
+
+    for (const auto &sub : upcoming)
+    {
+        const bool started = std::any_of(m_StackPrefetch.cbegin(), m_StackPrefetch.cend(), [&](const StackPrefetch & p)
+        {
+            return sameSub(sub, p.sub);
+        });
+        if (started)
+            continue;
+
+        StackPrefetch prefetch;
+        prefetch.sub = sub;
+        if (m_StackLoaders.isEmpty())
+            prefetch.loader = QSharedPointer<FITSData>::create(FITS_LIVESTACKING);
+        else
+            prefetch.loader = m_StackLoaders.takeLast();
+        prefetch.loader->m_StackMultiC = m_StackMultiC;
+
+        QSharedPointer<FITSData> loader = prefetch.loader;
+        const QString file = sub.file;
+        prefetch.future = QtConcurrent::run(&m_StackPrefetchPool, [loader, file]() -> StackPrefetchResult
+        {
+            QElapsedTimer timer;
+            timer.start();
+            StackPrefetchResult result;
+            result.ok = loader->stackLoadImage(file);
+            if (!result.ok)
+                qCDebug(KSTARS_FITS) << QString("Unable to load ahead sub %1").arg(file);
+            result.readTime = timer.elapsed();
+            return result;
+        });
+        m_StackPrefetch.push_back(prefetch);
+
+        // Signal the Wait Load stage complete (i.e. the sub is now loading) to Stack Monitor
+        QVector<LiveStackFile> subs { sub };
+        QVector<LiveStackStageInfo> infos { LiveStackStageInfo::fromNow(-1, LSStage::WaitLoad, LSStatus::LSStatusOK) };
+        Q_EMIT updateStackMon(subs, infos);
+    }
+}
+
+void FITSData::retireStackPrefetch(const StackPrefetch &prefetch)
+{
+    m_StackRetiring.push_back(prefetch);
+
+    // Reclaim the loader for buffer reuse once its load is done. clearStackPrefetch() may have
+    // already dropped it, in which case there is nothing to do
+    auto *watcher = new QFutureWatcher<StackPrefetchResult>(this);
+    const QSharedPointer<FITSData> loader = prefetch.loader;
+    connect(watcher, &QFutureWatcher<StackPrefetchResult>::finished, this, [this, watcher, loader]()
+    {
+        for (auto it = m_StackRetiring.begin(); it != m_StackRetiring.end(); ++it)
+        {
+            if (it->loader == loader)
+            {
+                m_StackRetiring.erase(it);
+                m_StackLoaders.push_back(loader);
+                break;
+            }
+        }
+        watcher->deleteLater();
+    });
+    watcher->setFuture(prefetch.future);
+}
+
+void FITSData::clearStackPrefetch()
+{
+    for (auto &prefetch : m_StackPrefetch)
+        prefetch.future.waitForFinished();
+    for (auto &prefetch : m_StackRetiring)
+        prefetch.future.waitForFinished();
+    m_StackPrefetch.clear();
+    m_StackRetiring.clear();
+    m_StackLoaders.clear();
+}
+
+void FITSData::stackAdoptLoad(FITSData &loader)
+{
+    std::swap(m_Stackfptr, loader.m_Stackfptr);
+    std::swap(m_StackMemFileBuffer, loader.m_StackMemFileBuffer);
+    std::swap(m_StackMemFileBufferSize, loader.m_StackMemFileBufferSize);
+    std::swap(m_StackMemFileBufferOwned, loader.m_StackMemFileBufferOwned);
+    std::swap(m_StackImageBuffer, loader.m_StackImageBuffer);
+    std::swap(m_StackImageBufferSize, loader.m_StackImageBufferSize);
+    std::swap(m_StackStatistics, loader.m_StackStatistics);
+    m_StackHeaderRecords.swap(loader.m_StackHeaderRecords);
+}
+
+// Detect stars in the loaded stack image with SEP (via StellarSolver) for star matching alignment.
+// Called from the background load thread.
+bool FITSData::stackStarMatch(const bool alignMaster, double &hfr, int &numStars)
+{
+    hfr = -1.0;
+    numStars = 0;
+#ifdef HAVE_STELLARSOLVER
+    if (!m_CurrentStack || m_StackImageBuffer == nullptr)
+        return false;
+
+    const bool calcHFR = (m_LiveStackData.weighting == LiveStackFrameWeighting::HFR);
+    StellarSolver solver(m_StackStatistics.stats, m_StackImageBuffer);
+    auto params = SSolver::Parameters();
+    params.partition = Options::stellarSolverPartition();
+    solver.setParameters(params);
+    solver.setLogLevel(SSolver::LOG_NONE);
+    solver.setSSLogLevel(SSolver::LOG_OFF);
+    if (!solver.extract(calcHFR))
+    {
+        qCDebug(KSTARS_FITS) << "Star extraction for star matching failed";
+        return false;
+    }
+
+    // Brightest stars first
+    QList<FITSImage::Star> starList = solver.getStarList();
+    std::sort(starList.begin(), starList.end(), [](const FITSImage::Star & a, const FITSImage::Star & b)
+    {
+        return a.flux > b.flux;
+    });
+
+    std::vector<cv::Point2d> stars;
+    stars.reserve(starList.size());
+    for (const auto &star : starList)
+        stars.push_back(cv::Point2d(star.x, star.y));
+    numStars = starList.size();
+
+    if (calcHFR && !starList.isEmpty())
+    {
+        std::vector<float> hfrs;
+        hfrs.reserve(starList.size());
+        for (const auto &star : starList)
+            hfrs.push_back(star.HFR);
+        std::nth_element(hfrs.begin(), hfrs.begin() + hfrs.size() / 2, hfrs.end());
+        hfr = hfrs[hfrs.size() / 2];
+    }
+
+    if (alignMaster)
+    {
+        for (auto &stack : m_Stacks)
+            stack->addAlignMasterStars(stars);
+        return m_CurrentStack->hasAlignMasterStars();
+    }
+    return m_CurrentStack->starMatchSub(stars, hfr);
+#else
+    Q_UNUSED(alignMaster);
+    return false;
+#endif
+}
+
 void FITSData::processAlignMaster(const QString &alignMaster)
 {
     m_StackFITSAsync = stackFITSAlignMaster;
@@ -1325,6 +1680,13 @@ void FITSData::processAlignMaster(const QString &alignMaster)
         bool load = stackLoadImage(alignMaster);
         if (!load)
             qCDebug(KSTARS_FITS) << QString("Unable to load align master");
+        else if (m_LiveStackData.alignMethod == LiveStackAlignMethod::STAR_MATCH)
+        {
+            double hfr;
+            int numStars;
+            if (!stackStarMatch(true, hfr, numStars))
+                qCDebug(KSTARS_FITS) << "Unable to detect stars in align master, subs will be plate solved";
+        }
         return load;
     });
 
@@ -1414,6 +1776,13 @@ void FITSData::stackFITSLoaded()
     StackFITSAsyncType action = m_StackFITSAsync;
     m_StackFITSAsync = stackFITSNone;
 
+    // The loader that supplied the sub now holds our previous buffers, so it can be reused
+    if (m_StackActiveLoader)
+    {
+        m_StackLoaders.push_back(m_StackActiveLoader);
+        m_StackActiveLoader.reset();
+    }
+
     // Check for user cancel request
     if (m_CancelRequest || m_StackFITSWatcher.isCanceled())
     {
@@ -1433,6 +1802,7 @@ void FITSData::stackFITSLoaded()
     }
 
     bool plateSolving = (m_LiveStackData.alignMethod == LiveStackAlignMethod::PLATE_SOLVE);
+    bool starMatching = (m_LiveStackData.alignMethod == LiveStackAlignMethod::STAR_MATCH);
     auto currentChannel = channelForStack(m_CurrentStack);
     switch (action)
     {
@@ -1459,10 +1829,13 @@ void FITSData::stackFITSLoaded()
                     exposure = value.toDouble();
                 initLiveStackMetadata(target, exposure);
 
-                if (plateSolving)
+                // When star matching, the align master is still plate solved (once) if possible so the
+                // stack has a WCS and subs that fail to match can be aligned by plate solving
+                if (plateSolving || starMatching)
                 {
                     // Next step in the chain is to plate solve
                     qCDebug(KSTARS_FITS) << "Starting to plate solve align master...";
+                    m_StackAlignMasterSolving = true;
                     Q_EMIT plateSolveSub(m_StackSubRa, m_StackSubDec, m_StackSubPixscale, m_StackSubIndex,
                                          m_StackSubHealpix, m_CurrentStack->getStackData().weighting);
                     return;
@@ -1478,7 +1851,10 @@ void FITSData::stackFITSLoaded()
         case stackFITSSub:
             if (m_StackFITSWatcher.result())
             {
-                if (plateSolving)
+                if (starMatching && !m_StackSubStarMatched)
+                    qCDebug(KSTARS_FITS) << "Star matching failed, falling back to plate solving...";
+
+                if (plateSolving || (starMatching && !m_StackSubStarMatched))
                 {
                     // Next step in the chain is to plate solve
                     qCDebug(KSTARS_FITS) << "Starting to plate solve sub...";
@@ -1604,7 +1980,8 @@ void FITSData::solverDone(const bool timedOut, const bool success, const double
 
     // This plate solving result could be on a sub to be stacked, or the align master, or the sub could
     // be both a sub to be stacked and the align master
-    bool sub = (m_StackSubPos >= 0 && m_StackSubPos < m_StackSubs.size());
+    bool sub = !m_StackAlignMasterSolving && (m_StackSubPos >= 0 && m_StackSubPos < m_StackSubs.size());
+    m_StackAlignMasterSolving = false;
 
     bool alignMaster = !sub;
     if (sub)
@@ -1617,7 +1994,14 @@ void FITSData::solverDone(const bool timedOut, const bool success, const double
         qCDebug(KSTARS_FITS) << QString("Plate solve failed %1 Success: %2 TimedOut: %3").arg(alignMasterStr)
                              .arg(success).arg(timedOut);
 
-    if (!ok && alignMaster)
+    if (!ok && alignMaster && m_LiveStackData.alignMethod == LiveStackAlignMethod::STAR_MATCH &&
+            m_CurrentStack->hasAlignMasterStars())
+    {
+        // Star matching doesn't need the align master to be plate solved so carry on without a WCS
+        qCDebug(KSTARS_FITS) << "Align master not plate solved, continuing with star matching only";
+        m_AlignMasterProcessed = true;
+    }
+    else if (!ok && alignMaster)
     {
         // If we can't plate solve a regular sub we can just skip it but if we can't plate solve the align
         // master that's a problem so reset the align master selection and pick the next sub as align master
@@ -1730,6 +2114,14 @@ void FITSData::nextStackAction()
                 m_LiveStackData.alignMaster = m_StackSubs[m_StackSubPos].file;
                 Q_EMIT alignMasterChosen(m_StackSubs[m_StackSubPos].file);
             }
+
+            // Star matching needs the align master's stars before the first sub can be matched
+            if (m_LiveStackData.alignMethod == LiveStackAlignMethod::STAR_MATCH && !m_AlignMasterProcessed)
+            {
+                m_StackSubPos--;
+                processAlignMaster(m_LiveStackData.alignMaster);
+                return;
+            }
             done = processNextSub(m_StackSubs[m_StackSubPos]);
         }
         else
@@ -1749,6 +2141,9 @@ void FITSData::nextStackAction()
                 return;
             }
 
+            // Load any queued subs whilst stacking
+            stackPrefetch();
+
             // Stack... either an initial stack or add 1 or more subs to an existing stack
             QFuture<bool> future;
             if (m_CurrentStack->getInitialStackDone())
@@ -1916,6 +2311,188 @@ QString fitsErrorToString(int status)
     QString message = error_status;
     return message;
 }
+
+// Where the primary image data lies in an uncompressed FITS file, for images that can be used
+// straight from the file with no more conversion than a byte swap.
+struct MappableImage
+{
+    qint64 offset { 0 };
+    qint64 size { 0 };
+    int bytesPerSample { 0 };
+    // XORed with each sample after the byte swap. Converts 16-bit signed data with BZERO 32768 to
+    // unsigned, which is how cameras store 16-bit images and how CFITSIO would read them as TUSHORT.
+    quint64 flip { 0 };
+};
+
+bool findMappableImage(fitsfile *fptr, const QString &filename, int bitpix, qint64 samples, MappableImage &image)
+{
+    double bscale = 1, bzero = 0;
+    int status = 0;
+    if (fits_read_key(fptr, TDOUBLE, "BSCALE", &bscale, nullptr, &status) && status != KEY_NO_EXIST)
+        return false;
+    status = 0;
+    if (fits_read_key(fptr, TDOUBLE, "BZERO", &bzero, nullptr, &status) && status != KEY_NO_EXIST)
+        return false;
+    if (bscale != 1)
+        return false;
+
+    // Only the BITPIX / BZERO combinations whose samples CFITSIO would return unchanged apart from the byte order.
+    // Signed 16-bit data without BZERO is clipped to unsigned by CFITSIO and 32-bit data is read as unsigned long,
+    // so those are left to CFITSIO.
+    switch (bitpix)
+    {
+        case BYTE_IMG:
+        case LONGLONG_IMG:
+        case FLOAT_IMG:
+        case DOUBLE_IMG:
+            if (bzero != 0)
+                return false;
+            break;
+        case SHORT_IMG:
+            if (bzero != 32768)
+                return false;
+            image.flip = 0x8000;
+            break;
+        default:
+            return false;
+    }
+
+    LONGLONG headStart = 0, dataStart = 0, dataEnd = 0;
+    status = 0;
+    if (fits_get_hduaddrll(fptr, &headStart, &dataStart, &dataEnd, &status))
+        return false;
+
+    image.bytesPerSample = std::abs(bitpix) / 8;
+    image.offset = dataStart;
+    image.size = samples * image.bytesPerSample;
+    // A short file would fault when the mapping is read
+    return image.offset % image.bytesPerSample == 0 && image.offset + image.size <= dataEnd
+           && image.offset + image.size <= QFileInfo(filename).size();
+}
+
+template <typename T>
+void fromBigEndian(const uchar *source, uchar *destination, qint64 samples, T flip)
+{
+    // Qt byte swaps with SSSE3 or AVX2 where available and allows source == destination
+    qFromBigEndian<T>(source, samples, destination);
+    if (flip)
+    {
+        T *data = reinterpret_cast<T *>(destination);
+        for (qint64 i = 0; i < samples; i++)
+            data[i] ^= flip;
+    }
+}
+
+// Convert the big endian FITS samples to native order, in parallel chunks that stay in cache.
+// source and destination may be the same.
+void fromBigEndian(const uchar *source, uchar *destination, const MappableImage &image)
+{
+    const qint64 samples = image.size / image.bytesPerSample;
+    if (image.bytesPerSample == 1)
+    {
+        if (source != destination)
+            memcpy(destination, source, image.size);
+        return;
+    }
+
+    constexpr qint64 CHUNK = 1 << 20;
+    QVector<QFuture<void>> futures;
+    for (qint64 start = 0; start < samples; start += CHUNK)
+    {
+        const qint64 count = std::min(CHUNK, samples - start);
+        const qint64 offset = start * image.bytesPerSample;
+        futures.append(QtConcurrent::run([ = ]()
+        {
+            switch (image.bytesPerSample)
+            {
+                case 2:
+                    fromBigEndian<quint16>(source + offset, destination + offset, count, image.flip);
+                    break;
+                case 4:
+                    fromBigEndian<quint32>(source + offset, destination + offset, count, image.flip);
+                    break;
+                case 8:
+                    fromBigEndian<quint64>(source + offset, destination + offset, count, image.flip);
+                    break;
+            }
+        }));
+    }
+    for (auto &future : futures)
+        future.waitForFinished();
+}
+
+// Read the image by converting straight from a mapping of the file into destination, avoiding the copies
+// through CFITSIO's buffers. Returns false if the image must be read with CFITSIO.
+bool readMappedImage(fitsfile *fptr, const QString &filename, int bitpix, qint64 samples, uint8_t *destination)
+{
+    MappableImage image;
+    if (!findMappableImage(fptr, filename, bitpix, samples, image))
+        return false;
+
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    uchar *data = file.map(image.offset, image.size);
+    if (data == nullptr)
+        return false;
+
+    fromBigEndian(data, destination, image);
+    file.unmap(data);
+    return true;
+}
+}
+
+bool FITSData::mapImage(int bitpix, qint64 samples)
+{
+#ifdef Q_OS_WIN
+    // A mapped view stops the file being deleted or renamed for as long as the image is loaded
+    Q_UNUSED(bitpix);
+    Q_UNUSED(samples);
+    return false;
+#else
+    MappableImage image;
+    if (!findMappableImage(fptr, m_Filename, bitpix, samples, image))
+        return false;
+
+    // The byte swap writes, and so copies, every page of the mapping, after which the image no longer
+    // depends on the file. 8-bit pages would stay backed by the file and fault if it were truncated
+    // or rewritten, e.g. by a capture reusing its name, so they are read with readMappedImage().
+    if (image.bytesPerSample == 1)
+        return false;
+
+    QScopedPointer<QFile> file(new QFile(m_Filename));
+    if (!file->open(QIODevice::ReadOnly))
+        return false;
+
+    // A private mapping is copy-on-write: the byte swap and any later filtering, rotation etc. only
+    // copy the pages they modify, and nothing is written back to the file.
+    uchar *data = file->map(image.offset, image.size, QFileDevice::MapPrivateOption);
+    if (data == nullptr)
+        return false;
+    if (reinterpret_cast<quintptr>(data) % image.bytesPerSample != 0)
+    {
+        file->unmap(data);
+        return false;
+    }
+
+    fromBigEndian(data, data, image);
+
+    m_MappedFile.reset(file.take());
+    m_ImageBuffer = data;
+    return true;
+#endif
+}
+
+void FITSData::releaseImageBuffer()
+{
+    if (m_MappedFile)
+    {
+        m_MappedFile->unmap(m_ImageBuffer);
+        m_MappedFile.reset();
+    }
+    else
+        delete[] m_ImageBuffer;
+    m_ImageBuffer = nullptr;
 }
 
 bool FITSData::privateLoad(const QByteArray &buffer)
@@ -2085,6 +2662,8 @@ bool FITSData::loadFITSImage(const QByteArray &buffer, const bool isCompressed)
         return false;
     }
 
+    // m_FITSBITPIX is changed below to the type the image is read as
+    const int fileBITPIX = m_FITSBITPIX;
     switch (m_FITSBITPIX)
     {
         case BYTE_IMG:
@@ -2168,7 +2747,15 @@ bool FITSData::loadFITSImage(const QByteArray &buffer, const bool isCompressed)
     }
 
     m_ImageBufferSize = m_Statistics.samples_per_channel * m_Statistics.channels * m_Statistics.bytesPerPixel;
-    m_ImageBuffer = new uint8_t[m_ImageBufferSize];
+    long nelements = m_Statistics.samples_per_channel * m_Statistics.channels;
+
+    // Uncompressed files on disk can be mapped rather than read. Temporary files are excluded as they are
+    // removed or overwritten while still displayed. Images that can't stay mapped are still converted
+    // straight from a mapping of the file, which is released once they are read.
+    const bool onDisk = buffer.isEmpty() && !isCompressed && !m_Extension.contains(".fz");
+    const bool mapped = onDisk && !m_isTemporary && mapImage(fileBITPIX, nelements);
+    if (!mapped)
+        m_ImageBuffer = new uint8_t[m_ImageBufferSize];
     if (m_ImageBuffer == nullptr)
     {
         qCWarning(KSTARS_FITS) << "FITSData: Not enough memory for image_buffer channel. Requested: "
@@ -2184,9 +2771,9 @@ bool FITSData::loadFITSImage(const QByteArray &buffer, const bool isCompressed)
     rotCounter     = 0;
     flipHCounter   = 0;
     flipVCounter   = 0;
-    long nelements = m_Statistics.samples_per_channel * m_Statistics.channels;
 
-    if (fits_read_img(fptr, m_Statistics.dataType, 1, nelements, nullptr, m_ImageBuffer, &anynull, &status))
+    if (!mapped && !(onDisk && readMappedImage(fptr, m_Filename, fileBITPIX, nelements, m_ImageBuffer)) &&
+            fits_read_img(fptr, m_Statistics.dataType, 1, nelements, nullptr, m_ImageBuffer, &anynull, &status))
     {
         m_LastError = i18n("Error reading image: %1", fitsErrorToString(status));
         return false;
@@ -2224,7 +2811,8 @@ bool FITSData::loadFITSImage(const QByteArray &buffer, const bool isCompressed)
         loadWCS();
 #if !defined (KSTARS_LITE)
     else if (m_Mode == FITS_LIVESTACKING &&
-             m_LiveStackData.alignMethod == LiveStackAlignMethod::PLATE_SOLVE)
+             (m_LiveStackData.alignMethod == LiveStackAlignMethod::PLATE_SOLVE ||
+              m_LiveStackData.alignMethod == LiveStackAlignMethod::STAR_MATCH))
         stackSetupWCS();
 #endif // !KSTARS_LITE
 
@@ -2418,7 +3006,9 @@ bool FITSData::stackLoadFITSImage(QString filename, const bool isCompressed)
     }
 
     long nelements = m_StackStatistics.stats.samples_per_channel * m_StackStatistics.stats.channels;
-    if (fits_read_img(m_Stackfptr, m_StackStatistics.stats.dataType, 1, nelements, nullptr, m_StackImageBuffer, &anynull,
+    const bool mapped = !extension.contains(".fz") && !isCompressed &&
+                        readMappedImage(m_Stackfptr, filename, FITSBITPIX, nelements, m_StackImageBuffer);
+    if (!mapped && fits_read_img(m_Stackfptr, m_StackStatistics.stats.dataType, 1, nelements, nullptr, m_StackImageBuffer, &anynull,
                       &status))
     {
         qCDebug(KSTARS_FITS) << QString("Error %1 reading image: %2").arg(fitsErrorToString(status)).arg(filename);
@@ -3503,8 +4093,7 @@ bool FITSData::saveImage(const QString &newFilename)
 
 void FITSData::clearImageBuffers()
 {
-    delete[] m_ImageBuffer;
-    m_ImageBuffer = nullptr;
+    releaseImageBuffer();
     if(m_ImageRoiBuffer != nullptr )
     {
         delete[] m_ImageRoiBuffer;
@@ -3959,29 +4548,14 @@ template <typename T>
 void FITSData::calculateMedian(bool roi)
 {
     auto * buffer = reinterpret_cast<T *>(roi ? m_ImageRoiBuffer : m_ImageBuffer);
-    const uint32_t maxMedianSize = 500000;
-    uint32_t medianSize = roi ? m_ROIStatistics.samples_per_channel : m_Statistics.samples_per_channel;
-    uint8_t downsample = 1;
-    if (medianSize > maxMedianSize)
-    {
-        downsample = (static_cast<double>(medianSize) / maxMedianSize) + 0.999;
-        medianSize /= downsample;
-    }
-    // Ideally samples would be declared like this...
-    // std::vector<T> samples;
-    // Unfortunately this doesn't compile on Mac - see the comments in robuststatistics.cpp for more details
-    // So for now declare samples like this...
-    std::vector<int32_t> samples;
-    samples.reserve(medianSize);
+    const uint32_t samplesPerChannel = roi ? m_ROIStatistics.samples_per_channel : m_Statistics.samples_per_channel;
 
+    // Histogram based so every sample is used without copying the channel
     for (uint8_t n = 0; n < m_Statistics.channels; n++)
     {
-        auto *oneChannel = buffer + n * (roi ? m_ROIStatistics.samples_per_channel : m_Statistics.samples_per_channel);
-        for (uint32_t upto = 0; upto < (roi ? m_ROIStatistics.samples_per_channel : m_Statistics.samples_per_channel);
-                upto += downsample)
-            samples.push_back(oneChannel[upto]);
-        auto median = Mathematics::RobustStatistics::ComputeLocation(Mathematics::RobustStatistics::LOCATION_MEDIAN, samples);
-        roi ? m_ROIStatistics.median[n] = median : m_Statistics.median[n] = median;
+        const auto result = Mathematics::HistogramMedian::compute(buffer + n * samplesPerChannel, samplesPerChannel,
+                            1, nullptr, false);
+        roi ? m_ROIStatistics.median[n] = result.median : m_Statistics.median[n] = result.median;
     }
 }
 
@@ -6407,7 +6981,7 @@ bool FITSData::rotFITS(int rotate, int mirror)
         }
     }
 
-    delete[] m_ImageBuffer;
+    releaseImageBuffer();
     m_ImageBuffer = rotimage;
 
     return true;
@@ -6708,7 +7282,7 @@ uint8_t const * FITSData::getImageBuffer() const
 
 void FITSData::setImageBuffer(uint8_t * buffer)
 {
-    delete[] m_ImageBuffer;
+    releaseImageBuffer();
     m_ImageBuffer = buffer;
 }
 
@@ -7180,7 +7754,7 @@ bool FITSData::debayer_8bit()
 
     if (m_ImageBufferSize != rgb_size)
     {
-        delete[] m_ImageBuffer;
+        releaseImageBuffer();
         try
         {
             m_ImageBuffer = new uint8_t[rgb_size];
@@ -7284,7 +7858,7 @@ bool FITSData::debayer_16bit()
 
     if (m_ImageBufferSize != rgb_size)
     {
-        delete[] m_ImageBuffer;
+        releaseImageBuffer();
         try
         {
             m_ImageBuffer = new uint8_t[rgb_size];
@@ -7495,7 +8069,7 @@ bool FITSData::debayerCV(BayerParameters &bayerParams, bool stack)
             }
             else
             {
-                delete[] m_ImageBuffer;
+                releaseImageBuffer();
                 m_ImageBuffer = new uint8_t[rgb_size];
                 m_ImageBufferSize = rgb_size;
             }
@@ -8086,11 +8660,13 @@ template <typename T> void FITSData::constructHistogramInternal()
         {
             uint32_t offset = n * samples;
 
-            for (uint32_t i = 0; i < samples; i += sampleBy)
-            {
-                int32_t id = histogramBinInternal<T>(buffer[i + offset], n);
-                m_HistogramFrequency[n][id] += sampleBy;
-            }
+            // Same binning as histogramBinInternal(), vectorised.
+            QVector<uint32_t> frequency(m_HistogramBinCount + 1, 0);
+            StretchKernels::histogram(buffer + offset, (samples + sampleBy - 1) / sampleBy, sampleBy,
+                                      m_Statistics.min[n], m_HistogramBinWidth[n], m_HistogramBinCount,
+                                      frequency.data());
+            for (int i = 0; i <= m_HistogramBinCount; i++)
+                m_HistogramFrequency[n][i] += static_cast<double>(frequency[i]) * sampleBy;
         }));
     }
 
@@ -41,8 +41,11 @@
 #include <QNetworkReply>
 #include <QTimer>
 #include <QQueue>
+#include <QThreadPool>
 #include <QMutex>
 
+#include <memory>
+
 #ifndef KSTARS_LITE
 #include <kxmlguiwindow.h>
 #include <wcs.h>
@@ -109,6 +112,21 @@ class FITSData : public QObject
             QString comment;  /** FITS Header Comment, if any */
         };
 
+        /** Dimensions and metadata of a raw frame, as streamed by a camera */
+        struct RawFrameInfo
+        {
+            uint16_t width { 0 };
+            uint16_t height { 0 };
+            /** 8 or 16, samples in native byte order */
+            uint8_t bitsPerPixel { 8 };
+            uint8_t xBinning { 1 };
+            uint8_t yBinning { 1 };
+            /** Exposure in seconds */
+            double exposure { 0 };
+            /** UTC time of the frame, now if invalid */
+            QDateTime timestamp;
+        };
+
         typedef enum
         {
             Idle,
@@ -136,6 +154,18 @@ class FITSData : public QObject
          */
         bool loadFromBuffer(const QByteArray &buffer);
 
+        /**
+         * @brief fromRawBuffer Build data from a mono frame as it comes from a camera stream. The pixels are adopted
+         * as the image buffer, and the header only holds the dimensions and the metadata given, so no FITS file is
+         * written or parsed on the way.
+         * @param mode FITS mode of the data, e.g. FITS_GUIDE.
+         * @param buffer width * height samples of the given depth, owned by the data from now on.
+         * @param info dimensions, depth, binning, exposure and time of the frame.
+         * @return the data, or a null pointer if the frame is invalid.
+         */
+        static QSharedPointer<FITSData> fromRawBuffer(FITSMode mode, std::unique_ptr<uint8_t[]> buffer,
+                const RawFrameInfo &info);
+
         /**
          * @brief parseSolution Parse the WCS solution information from the header into the given struct.
          * @param solution Solution structure to fill out.
@@ -947,6 +977,23 @@ class FITSData : public QObject
          */
         void updateStackMon(const QVector<LiveStackFile> &subs, const QVector<LiveStackStageInfo> &infos);
 
+        /**
+         * @brief Update the Stack Monitor with memory used by the last stack
+         * @param peakProcess is the peak resident memory of the process
+         * @param peakMapped is the largest amount of spilled sub data mapped at once
+         * @param spilled is the amount of data in the spill file
+         */
+        void updateStackMemory(const qint64 peakProcess, const qint64 peakMapped, const qint64 spilled);
+
+        /**
+         * @brief Update the Stack Monitor with the noise of the stack
+         * @param noiseMap is a downscaled image of the per-pixel noise
+         * @param subs in the stack statistics
+         * @param noise is the median per-pixel noise of the stack
+         * @param snr of the stack
+         */
+        void updateStackNoise(const QImage &noiseMap, const int subs, const double noise, const double snr);
+
     public Q_SLOTS:
         void makeRoiBuffer(QRect roi);
 
@@ -962,12 +1009,26 @@ class FITSData : public QObject
         void loadCommon(const QString &inFilename);
         void releaseMemFileBuffer();
         void releaseStackMemFileBuffer();
+        // Free m_ImageBuffer, or unmap it if it points into a mapped file
+        void releaseImageBuffer();
+        /**
+         * @brief mapImage Point m_ImageBuffer directly at the image data in m_Filename rather than reading it
+         * through CFITSIO. Only possible for uncompressed primary images that need no scaling beyond a byte swap,
+         * which copies every page so that the image no longer depends on the file. 8-bit images, which need no
+         * swap, and all images on Windows, where the mapping would lock the file, are not mapped.
+         * @param bitpix BITPIX of the image as stored in the file
+         * @param samples number of samples to map
+         * @return true if the image was mapped, false if it must be read the usual way.
+         */
+        bool mapImage(int bitpix, qint64 samples);
         /**
          * @brief privateLoad Load an image (FITS, RAW, or images supported by Qt like jpeg, png).
          * @param Buffer pointer to image data. If buffer is emtpy, read from disk (m_Filename).
          * @return true if successfully loaded, false otherwise.
          */
         bool privateLoad(const QByteArray &buffer);
+        // Adopt a raw frame, see fromRawBuffer()
+        void loadRawBuffer(std::unique_ptr<uint8_t[]> buffer, const RawFrameInfo &info);
 
         // Load Qt-supported images.
         bool loadCanonicalImage(const QByteArray &buffer);
@@ -1235,6 +1296,54 @@ class FITSData : public QObject
          */
         bool processNextSub(LiveStackFile &sub);
 
+        // Load pipeline - subs loaded ahead of processing by private loaders, in sub order
+        typedef struct
+        {
+            bool ok;
+            qint64 readTime; // ms
+        } StackPrefetchResult;
+        struct StackPrefetch
+        {
+            LiveStackFile sub;
+            QSharedPointer < FITSData > loader;
+            QFuture < StackPrefetchResult > future;
+        };
+
+        /**
+         * @brief Start loading the subs that will be processed next in the background, up to the
+         *        number of load workers. Subs are still processed and stacked in order.
+         */
+        void stackPrefetch();
+
+        /**
+         * @brief Discard any subs loaded ahead, waiting for loads in progress to finish
+         */
+        void clearStackPrefetch();
+
+        /**
+         * @brief Drop a load that is no longer wanted but still in progress. It is left to finish in
+         *        the background and its loader is reused once it has
+         * @param prefetch load to drop
+         */
+        void retireStackPrefetch(const StackPrefetch &prefetch);
+
+        /**
+         * @brief Take over a sub loaded by a prefetch loader. The loader is given our previous
+         *        state in exchange so its buffers are reused for its next load
+         * @param loader that has loaded the sub
+         */
+        void stackAdoptLoad(FITSData &loader);
+
+        /**
+         * @brief Detect stars in the loaded stack image for star matching alignment. For the align master
+         *        the stars become the reference for all stacks, otherwise the current sub is matched to them
+         * @param alignMaster is true if the loaded image is the align master
+         * @param hfr is the median HFR of the stars (if HFR weighting), otherwise -1
+         * @param numStars is the number of stars detected
+         * @return success
+         */
+        bool stackStarMatch(const bool alignMaster, double &hfr, int &numStars);
+
         /**
          * @brief Callback to handle an asynchronous stacking operation completion
          */
@@ -1297,6 +1406,9 @@ class FITSData : public QObject
         uint8_t *m_ImageBuffer { nullptr };
         /// Above buffer size in bytes
         uint32_t m_ImageBufferSize { 0 };
+        /// File m_ImageBuffer is mapped from, if it was loaded by mapImage(). The mapping is private so
+        /// filters may modify the buffer in place without touching the file.
+        QScopedPointer<QFile> m_MappedFile;
         /// Image Buffer if Selection is to be done
         uint8_t *m_ImageRoiBuffer { nullptr };
         /// Above buffer size in bytes
@@ -1480,6 +1592,12 @@ class FITSData : public QObject
         QList < Record > m_StackHeaderRecords;
         QFutureWatcher < bool > m_StackWatcher;
         QFutureWatcher < bool > m_StackFITSWatcher;
+        // Load pipeline
+        QList < StackPrefetch > m_StackPrefetch;
+        QList < StackPrefetch > m_StackRetiring; // Unwanted loads left to finish before their loaders are reused
+        QVector < QSharedPointer < FITSData >> m_StackLoaders; // Idle loaders, kept for buffer reuse
+        QSharedPointer < FITSData > m_StackActiveLoader; // Loader whose sub is being processed
+        QThreadPool m_StackPrefetchPool;
         QFuture < void > m_StackPrepareFuture;
         typedef enum
         {
@@ -1493,6 +1611,8 @@ class FITSData : public QObject
         bool m_CancelRequest { false }; // Overall control variable for cancelling a stack operation
         bool m_StackWatcherCancel { false }; // Control variable to cancel background thread stack operation
         bool m_StackFITSWatcherCancel { false }; // Control variable to cancel background thread FITS Load operation
+        bool m_StackSubStarMatched { false }; // Current sub was aligned by star matching
+        bool m_StackAlignMasterSolving { false }; // Plate solve in progress is for the align master
         double m_StackSubRa { 0.0 };
         double m_StackSubDec { 0.0 };
         double m_StackSubPixscale { 0.0 };
@@ -0,0 +1,234 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "fitsdrizzle.h"
+#include <fits_debug.h>
+
+#include <QThread>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+// Apply fn(firstRow, lastRow) to bands of rows in parallel
+template <typename Fn>
+void forRowBands(const int rows, Fn fn)
+{
+    const int numChunks = std::max(1, QThread::idealThreadCount() * 2);
+    const int chunkRows = std::max(1, (rows + numChunks - 1) / numChunks);
+
+    QVector<int> rowBlocks;
+    for (int y = 0; y < rows; y += chunkRows)
+        rowBlocks.append(y);
+
+    QtConcurrent::blockingMap(rowBlocks, [&](int yStart)
+    {
+        fn(yStart, std::min(yStart + chunkRows, rows));
+    });
+}
+
+// Length of the overlap of [lo, hi] with output pixel i, which covers [i - 0.5, i + 0.5]
+inline double overlap(const double lo, const double hi, const int i)
+{
+    return std::min(hi, i + 0.5) - std::max(lo, i - 0.5);
+}
+}
+
+bool FITSDrizzle::init(const int width, const int height, const int channels, const double scale, const double pixFrac)
+{
+    reset();
+    if (width <= 0 || height <= 0 || (channels != 1 && channels != 3) || scale < 1.0 || scale > 4.0 ||
+            !(pixFrac > 0.0) || pixFrac > 1.0)
+    {
+        qCDebug(KSTARS_FITS) << QString("%1 invalid parameters %2x%3x%4 scale %5 pixfrac %6").arg(__FUNCTION__)
+                             .arg(width).arg(height).arg(channels).arg(scale).arg(pixFrac);
+        return false;
+    }
+
+    try
+    {
+        const int outWidth = static_cast<int>(std::lround(width * scale));
+        const int outHeight = static_cast<int>(std::lround(height * scale));
+        m_Sum = cv::Mat::zeros(outHeight, outWidth, CV_32FC(channels));
+        m_Weight = cv::Mat::zeros(outHeight, outWidth, CV_32F);
+    }
+    catch (const cv::Exception &ex)
+    {
+        qCDebug(KSTARS_FITS) << QString("openCV exception %1 called from %2").arg(ex.what()).arg(__FUNCTION__);
+        reset();
+        return false;
+    }
+
+    m_Width = width;
+    m_Height = height;
+    m_Channels = channels;
+    m_Scale = scale;
+    m_PixFrac = pixFrac;
+    return true;
+}
+
+void FITSDrizzle::reset()
+{
+    m_Subs = 0;
+    m_TotalWeight = 0.0f;
+    m_Sum.release();
+    m_Weight.release();
+}
+
+bool FITSDrizzle::add(const cv::Mat &sub, const cv::Mat &warp, const float weight)
+{
+    if (!isInitialised() || sub.type() != CV_32FC(m_Channels) || sub.cols != m_Width || sub.rows != m_Height
+            || !(weight > 0.0f))
+        return false;
+
+    try
+    {
+        // Sub -> master affine transform
+        cv::Matx23d m(1, 0, 0, 0, 1, 0);
+        if (!warp.empty())
+        {
+            if ((warp.rows != 2 && warp.rows != 3) || warp.cols != 3)
+                return false;
+            cv::Mat w;
+            warp.convertTo(w, CV_64F);
+            double norm = 1.0;
+            if (w.rows == 3)
+            {
+                if (std::fabs(w.at<double>(2, 0)) > 1e-9 || std::fabs(w.at<double>(2, 1)) > 1e-9)
+                    qCDebug(KSTARS_FITS) << QString("%1 ignoring perspective terms of warp").arg(__FUNCTION__);
+                norm = w.at<double>(2, 2);
+                if (std::fabs(norm) < 1e-12)
+                    return false;
+            }
+            for (int r = 0; r < 2; r++)
+                for (int c = 0; c < 3; c++)
+                    m(r, c) = w.at<double>(r, c) / norm;
+        }
+
+        // Sub -> output grid. Output pixel centres are at s * (master + 0.5) - 0.5
+        const double s = m_Scale;
+        const double offset = 0.5 * (s - 1.0);
+        const double ax = s * m(0, 0), bx = s * m(0, 1), cx = s * m(0, 2) + offset;
+        const double ay = s * m(1, 0), by = s * m(1, 1), cy = s * m(1, 2) + offset;
+
+        // Half side of the drop, which has the area of the shrunken input pixel
+        const double h = 0.5 * m_PixFrac * std::sqrt(std::fabs(ax * by - bx * ay));
+        if (!(h > 0.0))
+            return false;
+
+        const int channels = m_Channels;
+        const int outWidth = m_Sum.cols;
+        const int outHeight = m_Sum.rows;
+
+        forRowBands(outHeight, [&](const int firstRow, const int lastRow)
+        {
+            const double bandTop = firstRow - 0.5 - h;
+            const double bandBottom = lastRow - 0.5 + h;
+            for (int y = 0; y < m_Height; y++)
+            {
+                // oy is linear along an input row so only a run of it can drop into this band
+                const double rowX = bx * y + cx;
+                const double rowY = by * y + cy;
+                int xStart = 0, xEnd = m_Width;
+                if (std::fabs(ay) < 1e-12)
+                {
+                    if (rowY <= bandTop || rowY >= bandBottom)
+                        continue;
+                }
+                else
+                {
+                    double lo = (bandTop - rowY) / ay;
+                    double hi = (bandBottom - rowY) / ay;
+                    if (lo > hi)
+                        std::swap(lo, hi);
+                    if (hi < -1.0 || lo > m_Width)
+                        continue;
+                    xStart = std::max(0, static_cast<int>(std::floor(lo)) - 1);
+                    xEnd = std::min(m_Width, static_cast<int>(std::ceil(hi)) + 2);
+                }
+
+                const float *in = sub.ptr<float>(y) + xStart * channels;
+                for (int x = xStart; x < xEnd; x++, in += channels)
+                {
+                    const double ox = ax * x + rowX;
+                    const double oy = ay * x + rowY;
+
+                    const int y0 = std::max(firstRow, static_cast<int>(std::floor(oy - h + 0.5)));
+                    const int y1 = std::min(lastRow - 1, static_cast<int>(std::floor(oy + h + 0.5)));
+                    if (y0 > y1)
+                        continue;
+                    const int x0 = std::max(0, static_cast<int>(std::floor(ox - h + 0.5)));
+                    const int x1 = std::min(outWidth - 1, static_cast<int>(std::floor(ox + h + 0.5)));
+                    if (x0 > x1)
+                        continue;
+
+                    bool valid = true;
+                    for (int c = 0; c < channels; c++)
+                        valid &= std::isfinite(in[c]);
+                    if (!valid)
+                        continue;
+
+                    for (int j = y0; j <= y1; j++)
+                    {
+                        const double dy = overlap(oy - h, oy + h, j);
+                        if (dy <= 0.0)
+                            continue;
+                        float *sum = m_Sum.ptr<float>(j);
+                        float *wt = m_Weight.ptr<float>(j);
+                        for (int i = x0; i <= x1; i++)
+                        {
+                            const double dx = overlap(ox - h, ox + h, i);
+                            if (dx <= 0.0)
+                                continue;
+                            const float w = static_cast<float>(weight * dx * dy);
+                            wt[i] += w;
+                            for (int c = 0; c < channels; c++)
+                                sum[i * channels + c] += w * in[c];
+                        }
+                    }
+                }
+            }
+        });
+        m_Subs++;
+        m_TotalWeight += weight;
+        return true;
+    }
+    catch (const cv::Exception &ex)
+    {
+        qCDebug(KSTARS_FITS) << QString("openCV exception %1 called from %2").arg(ex.what()).arg(__FUNCTION__);
+        return false;
+    }
+}
+
+cv::Mat FITSDrizzle::result() const
+{
+    if (!isInitialised())
+        return cv::Mat();
+
+    cv::Mat out = cv::Mat::zeros(m_Sum.size(), m_Sum.type());
+    const int channels = m_Channels;
+    const int width = m_Sum.cols;
+    forRowBands(m_Sum.rows, [&](const int firstRow, const int lastRow)
+    {
+        for (int y = firstRow; y < lastRow; y++)
+        {
+            const float *sum = m_Sum.ptr<float>(y);
+            const float *wt = m_Weight.ptr<float>(y);
+            float *o = out.ptr<float>(y);
+            for (int x = 0; x < width; x++)
+            {
+                if (wt[x] <= 0.0f)
+                    continue;
+                const float inv = 1.0f / wt[x];
+                for (int c = 0; c < channels; c++)
+                    o[x * channels + c] = sum[x * channels + c] * inv;
+            }
+        }
+    });
+    return out;
+}
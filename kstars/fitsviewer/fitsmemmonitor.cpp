@@ -20,6 +20,7 @@
 #include <mach/host_info.h>
 #include <sys/sysctl.h>
 #include <mach/task.h>
+#include <sys/resource.h>
 #endif
 
 FITSMemoryMonitor::FITSMemoryMonitor(QWidget *parent) : QWidget(parent)
@@ -158,6 +159,43 @@ MemoryInfo FITSMemoryMonitor::getMemoryInfo()
     return info;
 }
 
+quint64 FITSMemoryMonitor::peakProcessMemory()
+{
+    quint64 peak = 0;
+
+#ifdef Q_OS_LINUX
+    // High water mark of resident memory from /proc/self/status
+    QFile status("/proc/self/status");
+    if (status.open(QIODevice::ReadOnly))
+    {
+        QTextStream stream(&status);
+        QString line;
+        while (stream.readLineInto(&line))
+        {
+            QStringList parts = line.split(QRegularExpression("\\s+"));
+            if (parts.size() >= 2 && line.startsWith("VmHWM:"))
+            {
+                peak = parts[1].toULongLong() * 1024;
+                break;
+            }
+        }
+    }
+
+#elif defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        peak = pmc.PeakWorkingSetSize;
+
+#elif defined(Q_OS_MACOS)
+    // ru_maxrss is in bytes on macOS
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+        peak = usage.ru_maxrss;
+#endif
+
+    return peak;
+}
+
 QString FITSMemoryMonitor::formatBytes(quint64 bytes)
 {
     const quint64 GB = 1024ULL * 1024ULL * 1024ULL;
@@ -71,6 +71,12 @@ class FITSMemoryMonitor : public QWidget
          */
         void setLabelFormat(const QString &format);
 
+        /**
+         * @brief Get the peak resident memory of this process since it started
+         * @return peak memory in bytes (0 if unavailable)
+         */
+        static quint64 peakProcessMemory();
+
     protected:
         bool eventFilter(QObject *obj, QEvent *event) override;
 
@@ -16,10 +16,21 @@
 #include "Options.h"
 #include "kspaths.h"
 
+#include <algorithm>
+#include <limits>
 #include <memory>
+#include <numeric>
 #include <math.h>
+#include <QElapsedTimer>
 #include <QtConcurrent>
 
+// Tiled extraction. Tiles are about SEP_TILE_SIZE square and frames smaller than 2 tiles aren't split.
+// Each tile overlaps its neighbours by SEP_TILE_OVERLAP so stars near the edge of a tile's core are
+// measured on all their pixels, and stars closer than SEP_TILE_SEAM to a seam are checked for duplicates.
+static constexpr int SEP_TILE_SIZE = 1024;
+static constexpr int SEP_TILE_OVERLAP = 64;
+static constexpr double SEP_TILE_SEAM = 2.0;
+
 //void FITSSEPDetector::configure(const QString &param, const QVariant &value)
 //{
 //    if (param == "numStars")
@@ -65,7 +76,6 @@ bool FITSSEPDetector::findSourcesAndBackground(QRect const &boundary)
 
     int optionsProfileIndex = getValue("optionsProfileIndex", -1).toInt();
     Ekos::ProfileGroup group = static_cast<Ekos::ProfileGroup>(getValue("optionsProfileGroup", 1).toInt());
-    m_Solver.reset(new StellarSolver(m_ImageData->getStatistics(), m_ImageData->getImageBuffer()));
 
     QString filename = "";
     QPointer<FITSData> image(m_ImageData);
@@ -107,48 +117,66 @@ bool FITSSEPDetector::findSourcesAndBackground(QRect const &boundary)
                 break;
         }
     }
+    SSolver::Parameters params;  // This is default
     if (optionsProfileIndex >= 0 && optionsList.count() > optionsProfileIndex)
     {
-        auto params = optionsList[optionsProfileIndex];
-        params.partition = Options::stellarSolverPartition();
-        m_Solver->setParameters(params);
+        params = optionsList[optionsProfileIndex];
         qCDebug(KSTARS_FITS) << "Sextract with: " << optionsList[optionsProfileIndex].listName;
     }
-    else
-    {
-        auto params = SSolver::Parameters();  // This is default
-        params.partition = Options::stellarSolverPartition();
-        m_Solver->setParameters(params);
-    }
+    params.partition = Options::stellarSolverPartition();
 
     QList<FITSImage::Star> stars;
     const bool runHFR = group != Ekos::AlignProfiles;
 
-    m_Solver->setLogLevel(SSolver::LOG_NONE);
-    m_Solver->setSSLogLevel(SSolver::LOG_OFF);
+    // Large frames are split into tiles that are extracted in parallel
+    const FITSImage::Statistic &stats = m_ImageData->getStatistics();
+    const QRect frame = boundary.isValid() ? boundary : QRect(0, 0, stats.width, stats.height);
+    const int tileSize = getValue("tileSize", SEP_TILE_SIZE).toInt();
+    const bool tiled = getValue("tiledExtraction", Options::stellarSolverTiledExtraction()).toBool() && tileSize > 0 &&
+                       static_cast<qint64>(frame.width()) * frame.height() >= 2LL * tileSize * tileSize;
+    m_Aborted = false;
+
+    if (tiled)
+    {
+        if (!extractTiled(params, runHFR, frame, stars, skyBG))
+            return false;
+
+        // If m_ImageData goes out of scope, also return.
+        if (stars.empty() || image.isNull())
+            return false;
 
-    if (boundary.isValid())
-        m_Solver->extract(runHFR, boundary);
+        m_ImageData->setSkyBackground(skyBG);
+    }
     else
-        m_Solver->extract(runHFR);
+    {
+        m_Solver.reset(new StellarSolver(m_ImageData->getStatistics(), m_ImageData->getImageBuffer()));
+        m_Solver->setParameters(params);
+        m_Solver->setLogLevel(SSolver::LOG_NONE);
+        m_Solver->setSSLogLevel(SSolver::LOG_OFF);
+
+        if (boundary.isValid())
+            m_Solver->extract(runHFR, boundary);
+        else
+            m_Solver->extract(runHFR);
 
-    stars = m_Solver->getStarList();
+        stars = m_Solver->getStarList();
 
-    // If m_ImageData goes out of scope, also return.
-    if (stars.empty() || image.isNull())
-        return false;
+        // If m_ImageData goes out of scope, also return.
+        if (stars.empty() || image.isNull())
+            return false;
 
-    auto bg = m_Solver->getBackground();
+        auto bg = m_Solver->getBackground();
 
-    skyBG.mean = bg.global;
-    skyBG.sigma = bg.globalrms;
-    skyBG.numPixelsInSkyEstimate = bg.bw * bg.bh;
-    skyBG.setStarsDetected(bg.num_stars_detected);
-    m_ImageData->setSkyBackground(skyBG);
+        skyBG.mean = bg.global;
+        skyBG.sigma = bg.globalrms;
+        skyBG.numPixelsInSkyEstimate = bg.bw * bg.bh;
+        skyBG.setStarsDetected(bg.num_stars_detected);
+        m_ImageData->setSkyBackground(skyBG);
 
-    //There is more information that can be obtained by the Stellarsolver->
-    //Background info, Star positions(if a plate solve was done before), etc
-    //The information is available as long as the StellarSolver exists.
+        //There is more information that can be obtained by the Stellarsolver->
+        //Background info, Star positions(if a plate solve was done before), etc
+        //The information is available as long as the StellarSolver exists.
+    }
 
     // Let's sort edges, starting with widest
     if (runHFR)
@@ -184,6 +212,197 @@ bool FITSSEPDetector::findSourcesAndBackground(QRect const &boundary)
 #endif
 }
 
+QVector<FITSSEPDetector::Tile> FITSSEPDetector::makeTiles(const QRect &frame, const int tileSize, const int overlap)
+{
+    QVector<Tile> tiles;
+    if (!frame.isValid() || tileSize <= 0)
+        return tiles;
+
+    const int cols = std::max(1, static_cast<int>(std::lround(static_cast<double>(frame.width()) / tileSize)));
+    const int rows = std::max(1, static_cast<int>(std::lround(static_cast<double>(frame.height()) / tileSize)));
+    tiles.reserve(cols * rows);
+    for (int row = 0; row < rows; row++)
+    {
+        const int y1 = frame.y() + static_cast<int>(static_cast<qint64>(frame.height()) * row / rows);
+        const int y2 = frame.y() + static_cast<int>(static_cast<qint64>(frame.height()) * (row + 1) / rows);
+        for (int col = 0; col < cols; col++)
+        {
+            const int x1 = frame.x() + static_cast<int>(static_cast<qint64>(frame.width()) * col / cols);
+            const int x2 = frame.x() + static_cast<int>(static_cast<qint64>(frame.width()) * (col + 1) / cols);
+            Tile tile;
+            tile.core = QRect(x1, y1, x2 - x1, y2 - y1);
+            tile.frame = tile.core.adjusted(-overlap, -overlap, overlap, overlap).intersected(frame);
+            tiles.append(tile);
+        }
+    }
+    return tiles;
+}
+
+bool FITSSEPDetector::extractTiled(const SSolver::Parameters &params, const bool runHFR, const QRect &frame,
+                                   QList<FITSImage::Star> &stars, SkyBackground &skyBG)
+{
+#ifndef HAVE_STELLARSOLVER
+    Q_UNUSED(params)
+    Q_UNUSED(runHFR)
+    Q_UNUSED(frame)
+    Q_UNUSED(stars)
+    Q_UNUSED(skyBG)
+    return false;
+#else
+    QElapsedTimer timer;
+    timer.start();
+
+    const QVector<Tile> tiles = makeTiles(frame, getValue("tileSize", SEP_TILE_SIZE).toInt(), SEP_TILE_OVERLAP);
+    if (tiles.isEmpty())
+        return false;
+
+    // The count and percentage based filters of the profile are for the whole frame so they are applied
+    // once the tiles are merged. Filters on individual stars (size, shape, saturation) work the same in
+    // any tile. initialKeep still limits the HFR calculations in each tile.
+    SSolver::Parameters tileParams = params;
+    tileParams.partition = false;
+    tileParams.keepNum = std::numeric_limits<int>::max();
+    tileParams.removeBrightest = 0;
+    tileParams.removeDimmest = 0;
+
+    struct TileResult
+    {
+        QList<FITSImage::Star> stars;
+        FITSImage::Background background;
+        bool ok { false };
+    };
+    QVector<TileResult> results(tiles.size());
+    QVector<int> indexes(tiles.size());
+    std::iota(indexes.begin(), indexes.end(), 0);
+
+    QtConcurrent::blockingMap(indexes, [&](int i)
+    {
+        if (m_Aborted)
+            return;
+
+        QSharedPointer<StellarSolver> solver(new StellarSolver(m_ImageData->getStatistics(),
+                                             m_ImageData->getImageBuffer()));
+        solver->setParameters(tileParams);
+        solver->setLogLevel(SSolver::LOG_NONE);
+        solver->setSSLogLevel(SSolver::LOG_OFF);
+        {
+            QMutexLocker locker(&m_TileSolversMutex);
+            m_TileSolvers.append(solver);
+        }
+
+        if (!m_Aborted && solver->extract(runHFR, tiles[i].frame))
+        {
+            results[i].stars = solver->getStarList();
+            results[i].background = solver->getBackground();
+            results[i].ok = !m_Aborted;
+        }
+
+        QMutexLocker locker(&m_TileSolversMutex);
+        m_TileSolvers.removeOne(solver);
+    });
+
+    if (m_Aborted)
+        return false;
+
+    // Each tile keeps the stars in its core, plus a seam either side in case neighbouring tiles place
+    // the same star a little differently. Stars near a seam are then checked against the other tiles.
+    struct Candidate
+    {
+        int tile;
+        bool owned;
+    };
+    QList<FITSImage::Star> merged;
+    QVector<Candidate> candidates;
+    QVector<int> nearSeam;
+    QVector<double> globals, rmss;
+    int bgPixels = 0;
+    for (int i = 0; i < tiles.size(); i++)
+    {
+        if (!results[i].ok)
+        {
+            qCDebug(KSTARS_FITS) << "Tiled SEP extraction failed for tile" << tiles[i].frame;
+            continue;
+        }
+        globals.append(results[i].background.global);
+        rmss.append(results[i].background.globalrms);
+        bgPixels = results[i].background.bw * results[i].background.bh;
+
+        const QRectF core(tiles[i].core);
+        const QRectF seamCore = core.adjusted(-SEP_TILE_SEAM, -SEP_TILE_SEAM, SEP_TILE_SEAM, SEP_TILE_SEAM);
+        const QRectF inner = core.adjusted(SEP_TILE_SEAM, SEP_TILE_SEAM, -SEP_TILE_SEAM, -SEP_TILE_SEAM);
+        for (const auto &star : results[i].stars)
+        {
+            const QPointF centre(star.x, star.y);
+            if (!seamCore.contains(centre))
+                continue;
+            if (!inner.contains(centre))
+                nearSeam.append(merged.size());
+            merged.append(star);
+            candidates.append({i, core.contains(centre)});
+        }
+    }
+    if (globals.isEmpty())
+        return false;
+
+    QVector<bool> duplicate(merged.size(), false);
+    for (int a = 0; a < nearSeam.size(); a++)
+    {
+        const int i = nearSeam[a];
+        for (int b = a + 1; b < nearSeam.size() && !duplicate[i]; b++)
+        {
+            const int j = nearSeam[b];
+            if (duplicate[j] || candidates[i].tile == candidates[j].tile)
+                continue;
+            const double dx = merged[i].x - merged[j].x;
+            const double dy = merged[i].y - merged[j].y;
+            if (dx * dx + dy * dy >= SEP_TILE_SEAM * SEP_TILE_SEAM)
+                continue;
+            // Keep the measurement from the tile that owns the star
+            if (candidates[j].owned || !candidates[i].owned)
+                duplicate[i] = true;
+            else
+                duplicate[j] = true;
+        }
+    }
+
+    stars.clear();
+    stars.reserve(merged.size());
+    for (int i = 0; i < merged.size(); i++)
+    {
+        if (!duplicate[i])
+            stars.append(merged[i]);
+    }
+    const int detected = stars.size();
+
+    // The profile's count based filters, brightest first
+    std::sort(stars.begin(), stars.end(), [](const FITSImage::Star & star1, const FITSImage::Star & star2)
+    {
+        return star1.flux > star2.flux;
+    });
+    if (params.removeBrightest > 0 && params.removeBrightest < 100)
+        stars.erase(stars.begin(), stars.begin() + static_cast<int>(stars.size() * params.removeBrightest / 100.0));
+    if (params.removeDimmest > 0 && params.removeDimmest < 100)
+        stars.erase(stars.end() - static_cast<int>(stars.size() * params.removeDimmest / 100.0), stars.end());
+    if (params.keepNum > 0 && stars.size() > params.keepNum)
+        stars.erase(stars.begin() + params.keepNum, stars.end());
+
+    // The background of the frame is the median of the tiles, which ignores tiles dominated by nebulosity
+    auto median = [](QVector<double> &values)
+    {
+        std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+        return values[values.size() / 2];
+    };
+    skyBG.mean = median(globals);
+    skyBG.sigma = median(rmss);
+    skyBG.numPixelsInSkyEstimate = bgPixels;
+    skyBG.setStarsDetected(detected);
+
+    qCDebug(KSTARS_FITS) << QString("Tiled SEP extraction of %1 tiles found %2 stars (%3 on seams) in %4 ms")
+                         .arg(tiles.size()).arg(detected).arg(merged.size() - detected).arg(timer.elapsed());
+    return true;
+#endif
+}
+
 template <typename T>
 void FITSSEPDetector::getFloatBuffer(float * buffer, int x, int y, int w, int h, FITSData const *data) const
 {
@@ -211,8 +430,13 @@ void FITSSEPDetector::getFloatBuffer(float * buffer, int x, int y, int w, int h,
 
 void FITSSEPDetector::abort()
 {
+    m_Aborted = true;
     if (m_Solver)
         m_Solver->abort();
+
+    QMutexLocker locker(&m_TileSolversMutex);
+    for (auto &solver : m_TileSolvers)
+        solver->abort();
 }
 
 SkyBackground::SkyBackground(double mean_, double sigma_, double numPixels_)
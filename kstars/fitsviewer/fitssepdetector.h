@@ -21,7 +21,11 @@
 #include <cstring>
 #include "sep/sep.h"
 #endif
+#include <QMutex>
 #include <QPointer>
+#include <QSharedPointer>
+
+#include <atomic>
 
 
 class FITSSEPDetector : public FITSStarDetector
@@ -42,6 +46,24 @@ class FITSSEPDetector : public FITSStarDetector
 
         void abort() override;
 
+        /** @brief A piece of a frame that is extracted on its own. The tile's frame is its core plus
+         * an overlap so that stars near the edge of the core are measured on complete pixels.
+         * Stars belong to the tile whose core contains their centre.
+         */
+        struct Tile
+        {
+            QRect core;
+            QRect frame;
+        };
+
+        /** @brief Split a frame into tiles for parallel extraction.
+         * @param frame to split.
+         * @param tileSize is the approximate side of each tile's core in pixels.
+         * @param overlap is the number of pixels each tile extends beyond its core, clipped to the frame.
+         * @return The tiles, whose cores exactly cover the frame.
+         */
+        static QVector<Tile> makeTiles(const QRect &frame, const int tileSize, const int overlap);
+
     protected:
         /** @internal Consolidate a float data buffer from FITS data.
          * @param buffer is the destination float block.
@@ -55,6 +77,18 @@ class FITSSEPDetector : public FITSStarDetector
 
         void clearSolver();
 
+        /** @internal Extract stars from overlapping tiles of the frame in parallel, then merge them,
+         * removing the duplicates where tiles meet.
+         * @param params are the extraction parameters of the selected profile.
+         * @param runHFR calculates the HFR of each star.
+         * @param frame to extract stars from.
+         * @param stars is the merged list of stars, after the profile's count based filters.
+         * @param skyBG is the background of the frame.
+         * @return False if extraction failed or was aborted.
+         */
+        bool extractTiled(const SSolver::Parameters &params, const bool runHFR, const QRect &frame,
+                          QList<FITSImage::Star> &stars, SkyBackground &skyBG);
+
         //        int numStars = 100;
         //        double fractionRemoved = 0.2;
         //        int deblendNThresh = 32;
@@ -62,5 +96,10 @@ class FITSSEPDetector : public FITSStarDetector
         //        bool radiusIsBoundary = true;
 
         QScopedPointer<StellarSolver, QScopedPointerDeleteLater> m_Solver;
+
+        // Solvers of a tiled extraction, so they can be aborted
+        QMutex m_TileSolversMutex;
+        QList<QSharedPointer<StellarSolver>> m_TileSolvers;
+        std::atomic<bool> m_Aborted { false };
 };
 
@@ -8,11 +8,13 @@
 
 #include "fitsstack.h"
 #include "fitsdata.h"
+#include "fitsmemmonitor.h"
 #include <fits_debug.h>
 #include "fitscommon.h"
 #include "ekos/auxiliary/solverutils.h"
 #include "kstars.h"
 #include "../auxiliary/robuststatistics.h"
+#include "../auxiliary/histogrammedian.h"
 
 #include <wcshdr.h>
 #include <fitsio.h>
@@ -49,11 +51,17 @@
  * - Calibration: calibrateSub(), addMaster()
  * - Alignment: addAlignMasterWCS, calcWarpMatrix(), solverDone()
  * - Stacking logic: stack(), stackn(), stackSubs(), stackSubsSigmaClipping()
+ * - Out-of-core stacking: spillSub(), stackSubsSigmaClippingTiled()
+ * - Running statistics: addSubStatistics(), updateStatistics() (see FITSStackStatistics)
+ * - Drizzle: stackSubsDrizzle(), normalizeDrizzleSub() (see FITSDrizzle)
  * - Post-processing: postProcessImage(), wienerDeconvolution()
  * - PSF utilities: calculatePSF()
  * - Stack management: setupRunningStack(), updateRunningStack(), tidyUpInitialStack()
  */
 
+// Longest side of the noise map image sent to the Stack Monitor
+static constexpr int NOISE_MAP_SIZE = 512;
+
 FITSStack::FITSStack(FITSData *parent, LiveStackChannel channel, LiveStackData params)
     : QObject(parent)
 {
@@ -170,7 +178,31 @@ bool FITSStack::addSub(void * imageBuffer, const int cvType, const int width, co
             subs += m_RunningStackImageData.numSubs;
         m_MeanSubSNR = ((m_MeanSubSNR * (subs - 1)) + snr) / subs;
 
-        m_StackImageData.last().image = newImage;
+        if (useTiledClipping())
+        {
+            // Keep the sub out of RAM until it is needed for calibration and alignment
+            // The spill file is sized from the first sub so any other geometry is rejected
+            if (m_Spill && !m_Spill->matches(newImage) && m_Spill->size() > 0)
+            {
+                qCDebug(KSTARS_FITS) << QString("%1 sub is inconsistent with the spill file").arg(__FUNCTION__);
+                return false;
+            }
+            if (!m_Spill || !m_Spill->matches(newImage))
+            {
+                m_Spill.reset(new FITSStackSpill());
+                if (!m_Spill->init(newImage.cols, newImage.rows, newImage.channels()))
+                {
+                    m_Spill.reset();
+                    return false;
+                }
+            }
+            int spillIndex = m_Spill->append(newImage);
+            if (spillIndex < 0)
+                return false;
+            m_StackImageData.last().spillIndex = spillIndex;
+        }
+        else
+            m_StackImageData.last().image = newImage;
         return true;
     }
     catch (const cv::Exception &ex)
@@ -187,6 +219,52 @@ void FITSStack::addAlignMasterWCS(const QSharedPointer<wcsprm> &wcs)
     setWCSStackImage(m_AlignMasterWCS);
 }
 
+void FITSStack::addAlignMasterStars(const std::vector<cv::Point2d> &stars)
+{
+    m_StarMatcher.setReference(stars);
+    if (!m_StarMatcher.hasReference())
+        qCDebug(KSTARS_FITS) << QString("Too few stars (%1) in align master for star matching").arg(stars.size());
+}
+
+bool FITSStack::starMatchSub(const std::vector<cv::Point2d> &stars, const double hfr)
+{
+    if (m_StackImageData.size() <= 0)
+    {
+        // This shouldn't happen
+        qCDebug(KSTARS_FITS) << "starMatchSub called but no m_StackImageData";
+        return false;
+    }
+
+    try
+    {
+        cv::Mat affine, warp;
+        int numMatched = 0;
+        if (!m_StarMatcher.match(stars, affine, numMatched))
+        {
+            qCDebug(KSTARS_FITS) << QString("Unable to star match %1 with %2 stars")
+                                 .arg(m_StackImageData.last().sub.file).arg(stars.size());
+            return false;
+        }
+
+        if (!finaliseWarpMatrix(affine, warp))
+            return false;
+
+        qCDebug(KSTARS_FITS) << QString("Star matched %1 on %2 of %3 stars")
+                             .arg(m_StackImageData.last().sub.file).arg(numMatched).arg(stars.size());
+        m_StackImageData.last().starWarp = warp;
+        m_StackImageData.last().hfr = hfr;
+        m_StackImageData.last().numStars = static_cast<int>(stars.size());
+        m_StackImageData.last().status = OK;
+        return true;
+    }
+    catch (const cv::Exception &ex)
+    {
+        QString s1 = ex.what();
+        qCDebug(KSTARS_FITS) << QString("openCV exception %1 called from %2").arg(s1).arg(__FUNCTION__);
+    }
+    return false;
+}
+
 void FITSStack::addMaster(const bool dark, void * imageBuffer, const int width, const int height,
                           const int bytesPerPixel, const int cvType)
 {
@@ -269,11 +347,8 @@ void FITSStack::addMaster(const bool dark, void * imageBuffer, const int width,
 
             for (unsigned int c = 0; c < channels.size(); c++)
             {
-                std::vector<float> values;
-                values.assign((float*)channels[c].data, (float*)channels[c].data + channels[c].total());
-
-                float median = Mathematics::RobustStatistics::ComputeLocation(
-                                   Mathematics::RobustStatistics::LOCATION_MEDIAN, values);
+                const float median = Mathematics::HistogramMedian::compute(channels[c].ptr<float>(), channels[c].total(),
+                                     1, nullptr, false).median;
 
                 if (median <= 0.0f)
                     qCDebug(KSTARS_FITS) << QString("%1 Unable to calculate median of Master flat channel %2")
@@ -329,6 +404,15 @@ bool FITSStack::convertMat(const cv::Mat &input, cv::Mat &output)
     }
 }
 
+double FITSStack::getDrizzleScaleFactor() const
+{
+    if (m_StackData.drizzleScale == LiveStackDrizzleScale::X1_5)
+        return 1.5;
+    else if (m_StackData.drizzleScale == LiveStackDrizzleScale::X3)
+        return 3.0;
+    return 2.0;
+}
+
 double FITSStack::getDownscaleFactor()
 {
     double factor = 1.0;
@@ -475,6 +559,16 @@ bool FITSStack::stack()
                                                 LSStatus::LSStatusOK) };
             Q_EMIT updateStackMon(subs, infos);
 
+            // Subs already in the spill file were fully processed by an earlier stack
+            if (m_StackImageData[i].isSpilled)
+                continue;
+
+            if (!loadSpilledSub(i))
+            {
+                m_StackImageData[i].status = CALIBRATION_FAILED;
+                continue;
+            }
+
             // Calibrate sub
             if (!m_StackImageData[i].isCalibrated)
             {
@@ -499,16 +593,23 @@ bool FITSStack::stack()
                 }
             }
 
-            if (m_StackData.alignMethod == LiveStackAlignMethod::NONE || m_AlignMasterWCS.isNull())
+            if (m_StackData.alignMethod == LiveStackAlignMethod::NONE ||
+                    (m_StackData.alignMethod == LiveStackAlignMethod::PLATE_SOLVE && m_AlignMasterWCS.isNull()))
                 // No alignment needed (or not setup) so skip this stage
                 m_StackImageData[i].isAligned = true;
             else if (!m_StackImageData[i].isAligned)
             {
                 // Align this image to the reference image
                 cv::Mat warp, warpedImage;
-                bool ok = calcWarpMatrix(m_AlignMasterWCS.get(), m_StackImageData[i].wcsprm, warp);
+                bool ok = calcSubWarpMatrix(m_StackImageData[i], warp);
                 if (!ok)
                     m_StackImageData[i].status = ALIGNMENT_FAILED;
+                else if (m_StackData.stackingMethod == LiveStackStackingMethod::DRIZZLE)
+                {
+                    // Drizzle drops the unwarped pixels through the warp, so don't resample here
+                    m_StackImageData[i].drizzleWarp = warp;
+                    m_StackImageData[i].isAligned = true;
+                }
                 else
                 {
                     // Use LINEAR interpolation. LANCZOS4 theoretically should be better but gives edge artifacts
@@ -530,6 +631,10 @@ bool FITSStack::stack()
                 QVector<LiveStackFile> subs { m_StackImageData[i].sub };
                 Q_EMIT updateStackMon(subs, infos);
             }
+
+            // Tiled clipping: move the processed sub out of RAM
+            if (m_StackImageData[i].spillIndex >= 0 && m_StackImageData[i].status == OK && !spillSub(i, true))
+                m_StackImageData[i].status = ALIGNMENT_FAILED;
         }
         // Stack the aligned subs
         float totalWeight = 0.0;
@@ -580,6 +685,16 @@ bool FITSStack::stackn()
                                                 LSStatus::LSStatusOK) };
             Q_EMIT updateStackMon(subs, infos);
 
+            // Subs already in the spill file were fully processed by an earlier stack
+            if (m_StackImageData[i].isSpilled)
+                continue;
+
+            if (!loadSpilledSub(i))
+            {
+                m_StackImageData[i].status = CALIBRATION_FAILED;
+                continue;
+            }
+
             // Calibrate sub
             if (!m_StackImageData[i].isCalibrated)
             {
@@ -611,9 +726,15 @@ bool FITSStack::stackn()
                 m_StackImageData[i].isAligned = true;
             else
             {
-                bool ok = calcWarpMatrix(m_AlignMasterWCS.get(), m_StackImageData[i].wcsprm, warp);
+                bool ok = calcSubWarpMatrix(m_StackImageData[i], warp);
                 if (!ok)
                     m_StackImageData[i].status = ALIGNMENT_FAILED;
+                else if (m_StackData.stackingMethod == LiveStackStackingMethod::DRIZZLE)
+                {
+                    // Drizzle drops the unwarped pixels through the warp, so don't resample here
+                    m_StackImageData[i].drizzleWarp = warp;
+                    m_StackImageData[i].isAligned = true;
+                }
                 else
                 {
                     // Use LINEAR interpolation. LANCZOS4 theoretically should be better but gives edge artifacts
@@ -635,6 +756,10 @@ bool FITSStack::stackn()
                 QVector<LiveStackFile> subs { m_StackImageData[i].sub };
                 Q_EMIT updateStackMon(subs, infos);
             }
+
+            // Tiled clipping: move the processed sub out of RAM
+            if (m_StackImageData[i].spillIndex >= 0 && m_StackImageData[i].status == OK && !spillSub(i, false))
+                m_StackImageData[i].status = ALIGNMENT_FAILED;
         }
         // Stack the aligned subs
         float totalWeight = m_RunningStackImageData.totalWeight;
@@ -724,6 +849,36 @@ bool FITSStack::calcWarpMatrix(struct wcsprm * wcs1, struct wcsprm * wcs2, cv::M
             return false;
         }
 
+        return finaliseWarpMatrix(affine, warp);
+    }
+    catch (const cv::Exception &ex)
+    {
+        QString s1 = ex.what();
+        qCDebug(KSTARS_FITS) << QString("openCV exception %1 called from %2").arg(s1).arg(__FUNCTION__);
+        return false;
+    }
+}
+
+bool FITSStack::calcSubWarpMatrix(const StackImageData &subData, cv::Mat &warp)
+{
+    if (!subData.starWarp.empty())
+    {
+        warp = subData.starWarp;
+        return true;
+    }
+
+    if (m_AlignMasterWCS.isNull() || subData.wcsprm == nullptr)
+    {
+        qCDebug(KSTARS_FITS) << QString("No alignment available for %1").arg(subData.sub.file);
+        return false;
+    }
+    return calcWarpMatrix(m_AlignMasterWCS.get(), subData.wcsprm, warp);
+}
+
+bool FITSStack::finaliseWarpMatrix(const cv::Mat &affine, cv::Mat &warp)
+{
+    try
+    {
         // Convert the 2x3 Affine matrix to a 3x3 Homography matrix
         warp = cv::Mat::eye(3, 3, CV_64F);
         affine.copyTo(warp.rowRange(0, 2));
@@ -876,16 +1031,11 @@ bool FITSStack::correctSub(const LiveStackFile &subFile, cv::Mat &sub)
                 cv::Mat absDiff;
                 cv::absdiff(channel, median, absDiff);
 
-                // Flatten diff to 1D
-                cv::Mat diffFlat = absDiff.reshape(0, 1);
-                std::vector<ushort> v;
-                diffFlat.copyTo(v);
-
-                if (!v.empty())
+                if (!absDiff.empty())
                 {
-                    // Compute median of diff (MAD)
-                    std::nth_element(v.begin(), v.begin() + v.size() / 2, v.end());
-                    double mad = v[v.size() / 2];
+                    // Compute median of diff (MAD). Subs are CV_32F by now (see convertMat)
+                    const double mad = Mathematics::HistogramMedian::compute(absDiff.ptr<float>(), absDiff.total(),
+                                       1, nullptr, false).median;
                     threshold =  std::max(mad * 5.0, 1.0); // 5-sigma threshold, min=1
                 }
 
@@ -958,14 +1108,43 @@ bool FITSStack::stackSubs(const bool initial, float &totalWeight, cv::Mat &hitMa
         weights = getWeights();
         cv::Mat origHitMap;
 
-        if (m_StackData.normalization == LiveStackNormalization::LINEAR)
+        const bool drizzle = m_StackData.stackingMethod == LiveStackStackingMethod::DRIZZLE;
+
+        // Drizzled subs aren't on the stack's grid so are normalized as they are drizzled
+        if (m_StackData.normalization == LiveStackNormalization::LINEAR && !drizzle)
         {
             origHitMap = hitMap.clone();
-            normalizeSubs(initial, weights, hitMap, stack);
+            if (useTiledClipping())
+                // Spilled subs were normalized before they were written out
+                hitMap = m_TiledHitMap.clone();
+            else
+                normalizeSubs(initial, weights, hitMap, stack);
+        }
+
+        // Spilled subs were added to the running statistics as they were spilled. Drizzled subs
+        // aren't aligned to a common grid so can't be added
+        if (!useTiledClipping() && !drizzle)
+        {
+            for (auto &sub : m_StackImageData)
+                addSubStatistics(sub);
         }
 
-        if (m_StackData.stackingMethod == LiveStackStackingMethod::SIGMA ||
-                m_StackData.stackingMethod == LiveStackStackingMethod::WINDSOR)
+        bool tiledFailed = false;
+        if (useTiledClipping())
+        {
+            // An empty Mat reports a failure, and mustn't replace the incremental stack
+            cv::Mat tiledStack = stackSubsSigmaClippingTiled(initial, weights);
+            tiledFailed = tiledStack.empty();
+            if (!tiledFailed)
+                stack = tiledStack;
+        }
+        else if (drizzle)
+        {
+            stack = stackSubsDrizzle(weights);
+            totalWeight = m_Drizzle.totalWeight();
+        }
+        else if (m_StackData.stackingMethod == LiveStackStackingMethod::SIGMA ||
+                 m_StackData.stackingMethod == LiveStackStackingMethod::WINDSOR)
         {
             // Sigma clipping (standard or Windsorized
             if (initial)
@@ -1033,7 +1212,8 @@ bool FITSStack::stackSubs(const bool initial, float &totalWeight, cv::Mat &hitMa
                 // Global average
                 cv::multiply(stack, 1.0 / totalWeight, stack, 1.0, m_CVType);
         }
-        ok = true;
+        // Drizzle returns an empty stack on failure
+        ok = !tiledFailed && !stack.empty();
     }
     catch (const cv::Exception &ex)
     {
@@ -1057,41 +1237,68 @@ bool FITSStack::stackSubs(const bool initial, float &totalWeight, cv::Mat &hitMa
         }
         Q_EMIT updateStackMon(subs, infos);
     }
+
+    // Report memory usage for this stack
+    Q_EMIT updateStackMemory(FITSMemoryMonitor::peakProcessMemory(), m_Spill ? m_Spill->peakMappedBytes() : 0,
+                             m_Spill ? m_Spill->spilledBytes() : 0);
+    if (ok)
+        updateStatistics();
     return ok;
 }
 
+// Fold a sub into the running statistics. Subs stay in m_StackImageData until the initial stack is
+// complete and may be stacked more than once before then, so each is only added the first time.
+void FITSStack::addSubStatistics(StackImageData &sub)
+{
+    if (!m_StackData.calcSNR || sub.inStatistics || sub.image.empty())
+        return;
+    sub.inStatistics = m_Statistics.add(sub.image, getWeight(sub));
+}
+
+// Summarise the running statistics, O(pixels) however many subs have been stacked
+void FITSStack::updateStatistics()
+{
+    if (m_Statistics.isEmpty())
+        return;
+
+    QElapsedTimer timer;
+    timer.start();
+    const cv::Mat noiseMap = m_Statistics.noiseMap();
+    m_StatisticsSummary = m_Statistics.summarise(noiseMap);
+    Q_EMIT updateStackNoise(FITSStackStatistics::noiseImage(noiseMap, m_StatisticsSummary.noise, NOISE_MAP_SIZE),
+                            m_StatisticsSummary.subs, m_StatisticsSummary.noise, m_StatisticsSummary.snr);
+    qCDebug(KSTARS_FITS) << QString("Stack statistics for %1 subs: noise %2 SNR %3 in %4 ms")
+                         .arg(m_StatisticsSummary.subs).arg(m_StatisticsSummary.noise).arg(m_StatisticsSummary.snr)
+                         .arg(timer.elapsed());
+}
+
 // Get the weight for each sub for the stacking process
 QVector<float> FITSStack::getWeights()
 {
     QVector<float> weights(m_StackImageData.size());
 
     for (int i = 0; i < weights.size(); i++)
-    {
-        switch (m_StackData.weighting)
-        {
-            case LiveStackFrameWeighting::EQUAL:
-                weights[i] = 1.0;
-                break;
-            case LiveStackFrameWeighting::HFR:
-                if (m_StackImageData[i].hfr > 0.0)
-                    weights[i] = 1.0 / m_StackImageData[i].hfr;
-                else
-                    weights[i] = 1.0;
-                break;
-            case LiveStackFrameWeighting::NUM_STARS:
-                if (m_StackImageData[i].numStars > 0)
-                    weights[i] = m_StackImageData[i].numStars;
-                else
-                    weights[i] = 1.0;
-                break;
-            default:
-                qCDebug(KSTARS_FITS) << QString("Error calculating weights in %1").arg(__FUNCTION__);
-                weights[i] = 1.0;
-        }
-    }
+        weights[i] = getWeight(m_StackImageData[i]);
     return weights;
 }
 
+// Get the weight of the passed in sub based on user setting
+float FITSStack::getWeight(const StackImageData &sub) const
+{
+    switch (m_StackData.weighting)
+    {
+        case LiveStackFrameWeighting::EQUAL:
+            return 1.0;
+        case LiveStackFrameWeighting::HFR:
+            return (sub.hfr > 0.0) ? 1.0 / sub.hfr : 1.0;
+        case LiveStackFrameWeighting::NUM_STARS:
+            return (sub.numStars > 0) ? sub.numStars : 1.0;
+        default:
+            qCDebug(KSTARS_FITS) << QString("Error calculating weights in %1").arg(__FUNCTION__);
+            return 1.0;
+    }
+}
+
 // Control routine to normalize subs before stacking
 void FITSStack::normalizeSubs(const bool initial, const QVector<float> &weights, cv::Mat &hitMap, cv::Mat &stack)
 {
@@ -1197,18 +1404,23 @@ void FITSStack::linearNormalization(cv::Mat &sub, const cv::Mat &subMask, const
 
         for (int i = 0; i < channels; i++)
         {
-            cv::Scalar muSub, sigSub, muRef, sigRef;
+            // Calculate Median/MAD using the 1-channel 8U overlap mask. These are robust against stars,
+            // satellite trails and hot pixels that would skew the mean and standard deviation.
+            const auto statsSub = Mathematics::HistogramMedian::compute(subChannels[i].ptr<float>(), subChannels[i].total(), 1,
+                                  overlapMask.ptr<uint8_t>());
+            const auto statsRef = Mathematics::HistogramMedian::compute(refChannels[i].ptr<float>(), refChannels[i].total(), 1,
+                                  overlapMask.ptr<uint8_t>());
 
-            // Calculate Mean/StdDev using the 1-channel 8U overlap mask
-            cv::meanStdDev(subChannels[i], muSub, sigSub, overlapMask);
-            cv::meanStdDev(refChannels[i], muRef, sigRef, overlapMask);
+            // Gaussian equivalent sigma
+            const double sigSub = 1.4826 * statsSub.mad;
+            const double sigRef = 1.4826 * statsRef.mad;
 
             float scale = 1.0f;
-            if (sigSub[0] > 0.0001f)
-                scale = static_cast<float>(sigRef[0] / sigSub[0]);
+            if (sigSub > 0.0001f)
+                scale = static_cast<float>(sigRef / sigSub);
 
             scale = std::max(0.1f, std::min(scale, 10.0f));
-            float offset = static_cast<float>(muRef[0] - (scale * muSub[0]));
+            float offset = static_cast<float>(statsRef.median - (scale * statsSub.median));
 
             // Apply transformation (New = Old * scale + offset)
             subChannels[i].convertTo(subChannels[i], -1, scale, offset);
@@ -1562,53 +1774,346 @@ cv::Mat FITSStack::stacknSubsSigmaClipping(const QVector<float> &weights)
                 sigmaClipPtr[ch] = m_SigmaClip32FC4[ch].ptr<cv::Vec4f>(y);
 
             for (int x = 0; x < cols; x++)
+                stacknSigmaClipPixel(x, imagesPtrs, finalImagePtr, sigmaClipPtr, weights);
+        }
+        return finalImage;
+    }
+    catch (const cv::Exception &ex)
+    {
+        QString s1 = ex.what();
+        qCDebug(KSTARS_FITS) << QString("openCV exception %1 called from %2").arg(s1).arg(__FUNCTION__);
+        return m_StackedImage32F;
+    }
+}
+
+// Add new subs to an existing sigma clipped stack at pixel x using the bounds saved by the initial stack
+void FITSStack::stacknSigmaClipPixel(int x, const std::vector<const float *> &imagesPtrs, float* finalImagePtr,
+                                     const QVector<cv::Vec4f *> &sigmaClipPtr, const QVector<float> &weights)
+{
+    int numImages = imagesPtrs.size();
+
+    for (int ch = 0; ch < m_Channels; ch++)
+    {
+        // Get the sigma clip data from the current pixel/channel
+        cv::Vec4f sigmaClip = sigmaClipPtr[ch][x];
+        float lower = sigmaClip[0];
+        float upper = sigmaClip[1];
+        float sum = sigmaClip[2];
+        float weightSum = sigmaClip[3];
+
+        // Process each image
+        for (int image = 0; image < numImages; image++)
+        {
+            float pixel = imagesPtrs[image][x * m_Channels + ch];
+            if (pixel > 0.0001f)
             {
-                for (int ch = 0; ch < m_Channels; ch++)
+                if (lower < 0.0 || (pixel >= lower && pixel <= upper))
                 {
-                    // Get the sigma clip data from the current pixel/channel
-                    cv::Vec4f sigmaClip = sigmaClipPtr[ch][x];
-                    float lower = sigmaClip[0];
-                    float upper = sigmaClip[1];
-                    float sum = sigmaClip[2];
-                    float weightSum = sigmaClip[3];
-
-                    // Process each image
-                    for (int image = 0; image < numImages; image++)
-                    {
-                        float pixel = imagesPtrs[image][x * m_Channels + ch];
-                        if (pixel > 0.0001f)
-                        {
-                            if (lower < 0.0 || (pixel >= lower && pixel <= upper))
-                            {
-                                sum += pixel * weights[image];
-                                weightSum += weights[image];
-                            }
-                        }
-                    }
+                    sum += pixel * weights[image];
+                    weightSum += weights[image];
+                }
+            }
+        }
 
-                    // Update image pixel with new value
-                    if (weightSum > 0.0f)
-                    {
-                        finalImagePtr[x * m_Channels + ch] = sum / weightSum;
+        // Update image pixel with new value
+        if (weightSum > 0.0f)
+        {
+            finalImagePtr[x * m_Channels + ch] = sum / weightSum;
 
-                        // Save the new intermediate results for next time
-                        sigmaClip[2] = sum;
-                        sigmaClip[3] = weightSum;
-                        sigmaClipPtr[ch][x] = sigmaClip;
-                    }
+            // Save the new intermediate results for next time
+            sigmaClip[2] = sum;
+            sigmaClip[3] = weightSum;
+            sigmaClipPtr[ch][x] = sigmaClip;
+        }
+        else
+            // If no data exists for this pixel, keep it black
+            finalImagePtr[x * m_Channels + ch] = 0.0f;
+    }
+}
+
+// Tiled clipping is only relevant to the sigma clipping methods
+bool FITSStack::useTiledClipping() const
+{
+    return m_StackData.tiledClipping && (m_StackData.stackingMethod == LiveStackStackingMethod::SIGMA ||
+                                         m_StackData.stackingMethod == LiveStackStackingMethod::WINDSOR);
+}
+
+// Read a spilled sub back into memory ready for calibration and alignment
+bool FITSStack::loadSpilledSub(const int index)
+{
+    StackImageData &data = m_StackImageData[index];
+    if (data.spillIndex < 0 || !data.image.empty())
+        return true;
+
+    if (!m_Spill || !m_Spill->read(data.spillIndex, data.image))
+    {
+        qCDebug(KSTARS_FITS) << QString("%1 unable to read sub %2 from spill file").arg(__FUNCTION__).arg(data.sub.file);
+        return false;
+    }
+    return true;
+}
+
+// Normalize the processed sub (see normalizeSubs), write it back to the spill file and free its memory.
+// The initial stack normalizes to the first sub, an incremental stack to the existing stack.
+bool FITSStack::spillSub(const int index, const bool initial)
+{
+    try
+    {
+        StackImageData &data = m_StackImageData[index];
+
+        // Reject a sub the spill file can't hold before it is added to the hit map and statistics
+        if (!m_Spill || !m_Spill->matches(data.image))
+        {
+            qCDebug(KSTARS_FITS) << QString("%1 sub %2 is inconsistent with the spill file").arg(__FUNCTION__)
+                                 .arg(data.sub.file);
+            return false;
+        }
+
+        if (m_StackData.normalization == LiveStackNormalization::LINEAR)
+        {
+            const float weight = getWeight(data);
+            cv::Mat subMask = getBinaryMask(data.image);
+
+            if (initial && m_TiledRef.empty())
+            {
+                // Reference sub so no need to normalize or erode the mask
+                m_TiledRef = data.image.clone();
+                subMask.convertTo(m_TiledRefMask, CV_8U, 255.0);
+                m_TiledHitMap = cv::Mat::zeros(data.image.size(), CV_32F);
+                cv::multiply(subMask, weight, subMask);
+                cv::add(m_TiledHitMap, subMask, m_TiledHitMap);
+            }
+            else
+            {
+                const cv::Mat &ref = initial ? m_TiledRef : m_StackedImage32F;
+                if (m_TiledRefMask.empty())
+                    getBinaryMask(ref).convertTo(m_TiledRefMask, CV_8U, 255.0);
+                if (m_TiledHitMap.empty())
+                    m_TiledHitMap = m_RunningStackImageData.hitMap.empty() ?
+                                    cv::Mat::zeros(data.image.size(), CV_32F) : m_RunningStackImageData.hitMap.clone();
+
+                // Erode the mask to remove interpolation edges
+                cv::Mat subMask8U;
+                subMask.convertTo(subMask8U, CV_8U, 255.0);
+                cv::Mat element = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3));
+                cv::erode(subMask8U, subMask8U, element);
+
+                linearNormalization(data.image, subMask8U, ref, m_TiledRefMask);
+
+                subMask8U.convertTo(subMask, CV_32F, 1.0 / 255.0);
+                cv::multiply(subMask, weight, subMask);
+                cv::add(m_TiledHitMap, subMask, m_TiledHitMap);
+            }
+        }
+
+        addSubStatistics(data);
+
+        if (!m_Spill || !m_Spill->write(data.spillIndex, data.image))
+        {
+            qCDebug(KSTARS_FITS) << QString("%1 unable to write sub %2 to spill file").arg(__FUNCTION__).arg(data.sub.file);
+            return false;
+        }
+        data.image.release();
+        data.isSpilled = true;
+        return true;
+    }
+    catch (const cv::Exception &ex)
+    {
+        qCDebug(KSTARS_FITS) << QString("openCV exception %1 called from %2").arg(ex.what()).arg(__FUNCTION__);
+        return false;
+    }
+}
+
+// Out-of-core version of stackSubsSigmaClipping / stacknSubsSigmaClipping. The subs are already calibrated,
+// aligned and normalized in the spill file. The image is processed in horizontal bands sized so that the
+// mapped rows of all the subs fit in the user's memory budget. Each band is contiguous so is processed as
+// a 1D array of pixels split into chunks across the available threads.
+cv::Mat FITSStack::stackSubsSigmaClippingTiled(const bool initial, const QVector<float> &weights)
+{
+    try
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        int numImages = m_StackImageData.size();
+        if (!m_Spill || numImages != weights.size())
+        {
+            qCDebug(KSTARS_FITS) << QString("Inconsistent subs and weights in %1").arg(__FUNCTION__);
+            return cv::Mat();
+        }
+
+        QVector<int> indices(numImages);
+        for (int i = 0; i < numImages; i++)
+        {
+            if (!m_StackImageData[i].isSpilled)
+            {
+                qCDebug(KSTARS_FITS) << QString("%1 sub %2 not in spill file").arg(__FUNCTION__)
+                                     .arg(m_StackImageData[i].sub.file);
+                return cv::Mat();
+            }
+            indices[i] = m_StackImageData[i].spillIndex;
+        }
+
+        const int rows = static_cast<int>(m_Height);
+        const int cols = static_cast<int>(m_Width);
+        cv::Mat finalImage;
+        if (initial)
+        {
+            finalImage = cv::Mat::zeros(rows, cols, CV_32FC(m_Channels));
+
+            // Keep the clipping state for incremental stacking in a file backed mapping
+            m_SigmaClip32FC4.clear();
+            m_Spill->releaseState();
+            m_SigmaClip32FC4.resize(m_Channels);
+            for (int ch = 0; ch < m_Channels; ch++)
+            {
+                m_SigmaClip32FC4[ch] = m_Spill->createStateMat(rows, cols, CV_32FC4);
+                if (m_SigmaClip32FC4[ch].empty())
+                    m_SigmaClip32FC4[ch] = cv::Mat::zeros(rows, cols, CV_32FC4);
+            }
+        }
+        else
+        {
+            finalImage = m_StackedImage32F;
+            if (!finalImage.isContinuous())
+                finalImage = finalImage.clone();
+        }
+
+        if (m_SigmaClip32FC4.size() != m_Channels)
+        {
+            qCDebug(KSTARS_FITS) << QString("%1 missing sigma clipping state").arg(__FUNCTION__);
+            return cv::Mat();
+        }
+
+        const qint64 budget = static_cast<qint64>(std::max(1, m_StackData.tiledBudgetMB)) * 1024 * 1024;
+        const int bandRows = m_Spill->bandRows(numImages, budget);
+        qCDebug(KSTARS_FITS) << QString("Starting tiled sigma clipping: %1 subs in bands of %2 rows on %3 threads")
+                             .arg(numImages).arg(bandRows).arg(QThread::idealThreadCount());
+
+        std::vector<const float *> imagesPtrs;
+        QVector<cv::Vec4f *> sigmaClipPtr(m_Channels);
+        for (int y0 = 0; y0 < rows; y0 += bandRows)
+        {
+            const int bandHeight = std::min(bandRows, rows - y0);
+            if (!m_Spill->mapBand(indices, y0, bandHeight, imagesPtrs))
+            {
+                qCDebug(KSTARS_FITS) << QString("%1 unable to map rows %2-%3 of spilled subs").arg(__FUNCTION__)
+                                     .arg(y0).arg(y0 + bandHeight - 1);
+                return cv::Mat();
+            }
+
+            float *finalImagePtr = finalImage.ptr<float>(y0);
+            for (int ch = 0; ch < m_Channels; ch++)
+                sigmaClipPtr[ch] = m_SigmaClip32FC4[ch].ptr<cv::Vec4f>(y0);
+
+            // Chunk up the band for available threads
+            const int pixels = bandHeight * cols;
+            const int chunkSize = std::max(1, pixels / (QThread::idealThreadCount() * 2));
+            QVector<QPair<int, int>> pixelChunks;
+            for (int start = 0; start < pixels; start += chunkSize)
+                pixelChunks.append(qMakePair(start, std::min(start + chunkSize, pixels)));
+
+            auto processPixelChunk = [&](const QPair<int, int> &chunk)
+            {
+                for (int x = chunk.first; x < chunk.second; x++)
+                {
+                    if (initial)
+                        stackSigmaClipPixel(x, imagesPtrs, finalImagePtr, sigmaClipPtr, weights);
                     else
-                        // If no data exists for this pixel, keep it black
-                        finalImagePtr[x * m_Channels + ch] = 0.0f;
+                        stacknSigmaClipPixel(x, imagesPtrs, finalImagePtr, sigmaClipPtr, weights);
                 }
-            }
+            };
+
+            QtConcurrent::blockingMap(pixelChunks, processPixelChunk);
+            m_Spill->unmapBand();
         }
+        qCDebug(KSTARS_FITS) << QString("Tiled sigma clipping completed in %1 ms").arg(timer.elapsed());
         return finalImage;
     }
     catch (const cv::Exception &ex)
     {
+        if (m_Spill)
+            m_Spill->unmapBand();
         QString s1 = ex.what();
         qCDebug(KSTARS_FITS) << QString("openCV exception %1 called from %2").arg(s1).arg(__FUNCTION__);
-        return m_StackedImage32F;
+        return cv::Mat();
+    }
+}
+
+// Drizzle the subs onto a grid finer than the alignment master. Subs stay in m_StackImageData until the
+// initial stack is complete and may be stacked more than once before then, so each is only dropped once.
+// The drizzle accumulators hold the whole stack so the initial and incremental stacks are the same.
+cv::Mat FITSStack::stackSubsDrizzle(const QVector<float> &weights)
+{
+    try
+    {
+        for (int i = 0; i < m_StackImageData.size(); i++)
+        {
+            StackImageData &sub = m_StackImageData[i];
+            if (sub.isDrizzled || sub.image.empty())
+                continue;
+
+            if (!m_Drizzle.isInitialised() && !m_Drizzle.init(sub.image.cols, sub.image.rows, sub.image.channels(),
+                    getDrizzleScaleFactor(), m_StackData.drizzlePixFrac))
+                return cv::Mat();
+
+            if (m_StackData.normalization == LiveStackNormalization::LINEAR)
+                normalizeDrizzleSub(sub.image);
+
+            QElapsedTimer timer;
+            timer.start();
+            if (!m_Drizzle.add(sub.image, sub.drizzleWarp, weights[i]))
+            {
+                qCDebug(KSTARS_FITS) << QString("%1 failed to drizzle %2").arg(__FUNCTION__).arg(sub.sub.file);
+                continue;
+            }
+            sub.isDrizzled = true;
+            qCDebug(KSTARS_FITS) << QString("Drizzled %1 in %2 ms").arg(sub.sub.file).arg(timer.elapsed());
+        }
+        return m_Drizzle.result();
+    }
+    catch (const cv::Exception &ex)
+    {
+        qCDebug(KSTARS_FITS) << QString("openCV exception %1 called from %2").arg(ex.what()).arg(__FUNCTION__);
+        return cv::Mat();
+    }
+}
+
+// As linearNormalization but against the whole of the first drizzled sub
+void FITSStack::normalizeDrizzleSub(cv::Mat &sub)
+{
+    try
+    {
+        std::vector<cv::Mat> channels;
+        cv::split(sub, channels);
+        const bool reference = m_DrizzleRef.isEmpty();
+
+        for (int i = 0; i < static_cast<int>(channels.size()); i++)
+        {
+            const auto stats = Mathematics::HistogramMedian::compute(channels[i].ptr<float>(), channels[i].total(), 1,
+                               nullptr);
+            const double sigma = 1.4826 * stats.mad;
+            if (reference)
+            {
+                m_DrizzleRef.append(std::make_pair(stats.median, sigma));
+                continue;
+            }
+            if (i >= m_DrizzleRef.size())
+                break;
+
+            float scale = 1.0f;
+            if (sigma > 0.0001f)
+                scale = static_cast<float>(m_DrizzleRef[i].second / sigma);
+            scale = std::max(0.1f, std::min(scale, 10.0f));
+            const float offset = static_cast<float>(m_DrizzleRef[i].first - (scale * stats.median));
+            channels[i].convertTo(channels[i], -1, scale, offset);
+        }
+        if (!reference)
+            cv::merge(channels, sub);
+    }
+    catch (const cv::Exception &ex)
+    {
+        qCDebug(KSTARS_FITS) << QString("openCV exception %1 called from %2").arg(ex.what()).arg(__FUNCTION__);
     }
 }
 
@@ -2342,6 +2847,17 @@ void FITSStack::setWCSStackImage(const QSharedPointer<wcsprm> &wcs)
         m_WCSStackImage->crpix[1] /= downscale;
     }
 
+    // The drizzle grid is finer than the subs. Output pixel centres are at s * (x + 0.5) - 0.5
+    if (m_StackData.stackingMethod == LiveStackStackingMethod::DRIZZLE)
+    {
+        const double scale = getDrizzleScaleFactor();
+        for (int i = 0; i < 2; i++)
+        {
+            m_WCSStackImage->cdelt[i] /= scale;
+            m_WCSStackImage->crpix[i] = scale * (m_WCSStackImage->crpix[i] - 0.5) + 0.5;
+        }
+    }
+
     if ((status = wcsset(m_WCSStackImage)) != 0)
     {
         qCDebug(KSTARS_FITS) << QString("%1 wcsset error processing %2").arg(__FUNCTION__).arg(status)
@@ -2987,6 +3503,13 @@ void FITSStack::tidyUpInitalStack()
         m_StackImageData[i].psfKernel.release();
     }
     m_StackImageData.clear();
+
+    // Tiled clipping: the clipping state is kept for the running stack but spilled subs are done with
+    if (m_Spill)
+        m_Spill->clearSubs();
+    m_TiledRef.release();
+    m_TiledRefMask.release();
+    m_TiledHitMap.release();
 }
 
 // Release FITS and openCV memory used in the running stack
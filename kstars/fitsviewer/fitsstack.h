@@ -21,7 +21,11 @@
 #include "fitscommon.h"
 #include "ekos/auxiliary/solverutils.h"
 #include "fits_debug.h"
+#include "fitsdrizzle.h"
 #include "fitsstackmonitor.h"
+#include "fitsstackspill.h"
+#include "fitsstackstatistics.h"
+#include "fitsstarmatcher.h"
 
 #include <QObject>
 #include <QPointer>
@@ -77,7 +81,9 @@ class StellarSolverProfileEditor;
  * - **Alignment**: An alignment master is selected and all frames aligned to the master.
  *   Plate solving is used for alignment. WCS is used to workout the transformation from the
  *   existing sub to the aligned sub and openCV functions warp the sub based on the
- *   transformation.
+ *   transformation. Alternatively, stars detected in each sub can be matched directly to those
+ *   in the alignment master (see FITSStarMatcher), falling back to plate solving for subs that
+ *   cannot be matched.
  *
  * - **Calibration Support**: Master darks and flats can be optionally applied before stacking.
  *   Flats and darks may be stacked separately and saved as masters to be applied during
@@ -135,6 +141,28 @@ class FITSStack : public QObject
          */
         void addAlignMasterWCS(const QSharedPointer<wcsprm> &wcs);
 
+        /**
+         * @brief add the stars detected in the align master for star matching alignment
+         * @param stars pixel positions, brightest first
+         */
+        void addAlignMasterStars(const std::vector<cv::Point2d> &stars);
+
+        /**
+         * @brief whether align master stars are available for star matching
+         */
+        bool hasAlignMasterStars() const
+        {
+            return m_StarMatcher.hasReference();
+        }
+
+        /**
+         * @brief align the current sub by matching its stars to the align master. Call after addSub.
+         * @param stars pixel positions, brightest first
+         * @param hfr of the sub
+         * @return success. On failure the sub should be plate solved instead
+         */
+        bool starMatchSub(const std::vector<cv::Point2d> &stars, const double hfr);
+
         /**
          * @brief add a master dark or flat.
          * @param dark (or flat)
@@ -243,6 +271,12 @@ class FITSStack : public QObject
          */
         double getDownscaleFactor();
 
+        /**
+         * @brief Gets the output scale for the Drizzle stacking method
+         * @return drizzle scale factor
+         */
+        double getDrizzleScaleFactor() const;
+
         const double &getMeanSubSNR() const
         {
             return m_MeanSubSNR;
@@ -263,6 +297,24 @@ class FITSStack : public QObject
             return (m_RunningStackImageData.numSubs == 0) ? m_StackImageData.size() : m_RunningStackImageData.numSubs;
         }
 
+        /**
+         * @brief Get the running per-pixel statistics of the stack. Only maintained when calculating SNR.
+         * @return statistics
+         */
+        const FITSStackStatistics &getStatistics() const
+        {
+            return m_Statistics;
+        }
+
+        /**
+         * @brief Get the summary of the running statistics as of the last stack
+         * @return summary (subs = 0 if not available)
+         */
+        const FITSStackStatistics::Summary &getStatisticsSummary() const
+        {
+            return m_StatisticsSummary;
+        }
+
     Q_SIGNALS:
         /**
          * @brief Update the Stack Monitor
@@ -271,6 +323,23 @@ class FITSStack : public QObject
          */
         void updateStackMon(const QVector<LiveStackFile> &subs, const QVector<LiveStackStageInfo> &infos);
 
+        /**
+         * @brief Update the Stack Monitor with memory used by the last stack
+         * @param peakProcess is the peak resident memory of the process
+         * @param peakMapped is the largest amount of spilled sub data mapped at once
+         * @param spilled is the amount of data in the spill file
+         */
+        void updateStackMemory(const qint64 peakProcess, const qint64 peakMapped, const qint64 spilled);
+
+        /**
+         * @brief Update the Stack Monitor with the noise of the stack
+         * @param noiseMap is a downscaled image of the per-pixel noise, white = 3x median noise
+         * @param subs in the statistics
+         * @param noise is the median per-pixel noise of the stack
+         * @param snr of the stack
+         */
+        void updateStackNoise(const QImage &noiseMap, const int subs, const double noise, const double snr);
+
     public Q_SLOTS:
     private:
         typedef enum
@@ -302,6 +371,12 @@ class FITSStack : public QObject
             double hfr = -1;
             int numStars = 0;
             float weight = -1.0f;
+            int spillIndex = -1;       // Position in the spill file when tiled clipping
+            bool isSpilled = false;    // Calibrated, aligned and normalized sub is in the spill file
+            cv::Mat starWarp;          // Alignment from star matching (empty if plate solved)
+            bool inStatistics = false; // Added to m_Statistics
+            cv::Mat drizzleWarp;       // Alignment to apply when drizzling (empty for identity)
+            bool isDrizzled = false;   // Dropped onto m_Drizzle
         };
 
         /**
@@ -361,6 +436,24 @@ class FITSStack : public QObject
          */
         bool calcWarpMatrix(struct wcsprm * wcs1, struct wcsprm * wcs2, cv::Mat &warp);
 
+        /**
+         * @brief Calculate the warp matrix to align a sub to the align master, using star matching
+         *        if the sub was star matched or its WCS otherwise
+         * @param subData sub to align
+         * @param warp matrix
+         * @return success (or not)
+         */
+        bool calcSubWarpMatrix(const StackImageData &subData, cv::Mat &warp);
+
+        /**
+         * @brief Check a rigid 2x3 transform calculated on full size images and convert it to a 3x3
+         *        warp matrix, allowing for any downscaling
+         * @param affine transform
+         * @param warp matrix
+         * @return success (or not)
+         */
+        bool finaliseWarpMatrix(const cv::Mat &affine, cv::Mat &warp);
+
         /**
          * @brief Decompose the warp matrix into transation and rotation elements
          * @param warp matrix
@@ -415,6 +508,47 @@ class FITSStack : public QObject
         void stackSigmaClipPixel(int x, const std::vector<const float *> &imagesPtrs, float* finalImagePtr,
                                  const QVector<cv::Vec4f *> &sigmaClipPtr, const QVector<float> &weights);
 
+        /**
+         * @brief Called by stacknSubsSigmaClipping to add new subs to an existing stack at pixel position x
+         * using the clipping bounds stored by the initial stack
+         * @param x position to process
+         * @param imagesPtrs array of pointers to each image
+         * @param finalImagePtr results image
+         * @param sigmaClipPtr intermediate results pointer
+         * @param weights to apply to sigma clipping
+         */
+        void stacknSigmaClipPixel(int x, const std::vector<const float *> &imagesPtrs, float* finalImagePtr,
+                                  const QVector<cv::Vec4f *> &sigmaClipPtr, const QVector<float> &weights);
+
+        /**
+         * @brief Whether subs are spilled to disk and sigma clipped in bands to bound memory use
+         * @return tiled clipping in use
+         */
+        bool useTiledClipping() const;
+
+        /**
+         * @brief Read a spilled sub back into memory so it can be calibrated and aligned
+         * @param index of sub in m_StackImageData
+         * @return success (or not)
+         */
+        bool loadSpilledSub(const int index);
+
+        /**
+         * @brief Normalize a calibrated and aligned sub, write it to the spill file and release its memory
+         * @param index of sub in m_StackImageData
+         * @param initial stack (or incremental)
+         * @return success (or not)
+         */
+        bool spillSub(const int index, const bool initial);
+
+        /**
+         * @brief Sigma clip the spilled subs band by band within the configured memory budget
+         * @param initial stack (or incremental)
+         * @param weights of each sub for the stack
+         * @return stack, empty on failure
+         */
+        cv::Mat stackSubsSigmaClippingTiled(const bool initial, const QVector<float> &weights);
+
         /**
          * @brief Stack the passed in vector of subs to an existing stack using Sigma Clipping
          * @param weights of each sub for the stack
@@ -430,6 +564,20 @@ class FITSStack : public QObject
          */
         cv::Mat stackSubsImageMM(const QVector<float> &weights, const LiveStackData &lsd);
 
+        /**
+         * @brief Drop any subs not already drizzled onto the drizzle grid
+         * @param weights of each sub for the stack
+         * @return The drizzled stack (empty on failure)
+         */
+        cv::Mat stackSubsDrizzle(const QVector<float> &weights);
+
+        /**
+         * @brief Linear normalization of an unaligned sub for drizzling. The sub's median and MAD per
+         * channel are matched to the first drizzled sub as there is no overlap mask on its own grid.
+         * @param sub to normalize in place
+         */
+        void normalizeDrizzleSub(cv::Mat &sub);
+
         /**
          * @brief Incrementally update the ImageMM stack using new subframes.
          * @param weights     Per-subframe relative weights (same size as current subframe list).
@@ -558,12 +706,30 @@ class FITSStack : public QObject
          */
         cv::Mat postProcessImage(const cv::Mat &image);
 
+        /**
+         * @brief Add an aligned and normalized sub to the running statistics, if not already added
+         * @param sub to add
+         */
+        void addSubStatistics(StackImageData &sub);
+
+        /**
+         * @brief Summarise the running statistics after a stack and update the Stack Monitor
+         */
+        void updateStatistics();
+
         /**
          * @brief Return the weights for each sub for the stacking process
          * @return weights
          */
         QVector<float> getWeights();
 
+        /**
+         * @brief Return the weight for the passed in sub for the stacking process
+         * @param sub
+         * @return weight
+         */
+        float getWeight(const StackImageData &sub) const;
+
         /**
          * @brief normalize brightness of subs to be stacked
          * @param initial stack (or incremental)
@@ -697,11 +863,22 @@ class FITSStack : public QObject
 
         // Aligning
         QSharedPointer < wcsprm > m_AlignMasterWCS;
+        FITSStarMatcher m_StarMatcher;
 
         // Stacking
         cv::Mat m_StackedImage32F;
         QVector < cv::Mat > m_SigmaClip32FC4;
+        QScopedPointer<FITSStackSpill> m_Spill;
+        cv::Mat m_TiledRef;
+        cv::Mat m_TiledRefMask;
+        cv::Mat m_TiledHitMap;
         cv::Mat m_StackedImageFinal;
+        FITSStackStatistics m_Statistics;
+        FITSStackStatistics::Summary m_StatisticsSummary;
+
+        // Drizzle stacking method
+        FITSDrizzle m_Drizzle;
+        QVector<std::pair<double, double>> m_DrizzleRef; // Median and sigma per channel of the first drizzled sub
         double m_ImageMMLastSigma = -1.0;
         float m_ImageMMTotalWeight = 0.0f;
         int m_ImageMMFrameCount = 0;
@@ -719,4 +896,6 @@ class FITSStack : public QObject
         int m_Channels { 0 };
         int m_BytesPerPixel { 0 };
         int m_CVType { 0 };
+
+        friend class TestFITSStack;
 };
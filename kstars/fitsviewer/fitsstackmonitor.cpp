@@ -16,6 +16,8 @@
 #include <QStandardItem>
 #include <QTimer>
 
+#include <KFormat>
+
 constexpr int CELL_HIGHLIGHT_ROLE = Qt::UserRole + 1;
 constexpr int ROW_HIGHLIGHT_ROLE = Qt::UserRole + 2;
 const int HIGHLIGHT_DURATION = 3000;
@@ -118,6 +120,8 @@ QVariant SubStatsModel::data(const QModelIndex &index, int role) const
             case COL_LOADED_INTERVAL:
                 return (sub.loaded == LSStatus::LSStatusUninit) ? QVariant() :
                        QString::number(sub.loadedInterval, 'f', 2);
+            case COL_READ_INTERVAL:
+                return (sub.readInterval < 0) ? QVariant() : QString::number(sub.readInterval, 'f', 2);
             case COL_SNR:
                 return (sub.loaded == LSStatus::LSStatusUninit) ? QVariant() : QString::number(sub.snr, 'f', 2);
             case COL_PLATE_SOLVED:
@@ -437,6 +441,46 @@ void StackMonitor::clear()
 
     // Reset progress bar
     updateProgress();
+    ui->StackMonitorStatusBar->clearMessage();
+
+    // Reset noise map
+    m_NoiseMap = QImage();
+    ui->StackMonitorNoiseMap->clear();
+    ui->StackMonitorNoiseMap->setText(i18nc("Stack monitor noise map", "No noise map yet"));
+    ui->StackMonitorNoiseStats->clear();
+}
+
+void StackMonitor::updateMemory(const qint64 peakProcess, const qint64 peakMapped, const qint64 spilled)
+{
+    KFormat format;
+    QString message = i18nc("Stack monitor status bar", "Peak memory: %1",
+                            peakProcess > 0 ? format.formatByteSize(peakProcess) : QString("--"));
+    if (spilled > 0)
+        message += i18nc("Stack monitor status bar", " | Tile memory: %1 | Spilled to disk: %2",
+                         format.formatByteSize(peakMapped), format.formatByteSize(spilled));
+    ui->StackMonitorStatusBar->showMessage(message);
+}
+
+void StackMonitor::updateNoise(const QImage &noiseMap, const int subs, const double noise, const double snr)
+{
+    m_NoiseMap = noiseMap;
+    ui->StackMonitorNoiseStats->setText(i18nc("Stack monitor noise map", "Subs: %1 | Median noise: %2 | SNR: %3",
+                                        subs, QString::number(noise, 'g', 3), QString::number(snr, 'f', 2)));
+    showNoiseMap();
+}
+
+void StackMonitor::showNoiseMap()
+{
+    if (m_NoiseMap.isNull())
+        return;
+    ui->StackMonitorNoiseMap->setPixmap(QPixmap::fromImage(m_NoiseMap).scaled(ui->StackMonitorNoiseMap->size(),
+                                        Qt::KeepAspectRatio, Qt::SmoothTransformation));
+}
+
+void StackMonitor::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    showNoiseMap();
 }
 
 void StackMonitor::initialize(QDateTime timestamp, const QVector<LiveStackFile> &subs)
@@ -608,9 +652,10 @@ QList<int> StackMonitor::applyUpdate(int row, const LiveStackStageInfo &info)
             sub.loaded = info.status;
             sub.loadedTime = info.timestamp;
             sub.loadedInterval = sub.waitLoadTime.msecsTo(sub.loadedTime) / 1000.0;
+            sub.readInterval = info.extraData.value("readTime", -1.0).toDouble();
             sub.snr = info.extraData.value("snr", 0.0).toDouble();
             sub.morc = info.extraData.value("morc", -1).toInt();
-            columnsToUpdate << COL_CHANNELS << COL_LOADED << COL_LOADED_INTERVAL << COL_SNR;
+            columnsToUpdate << COL_CHANNELS << COL_LOADED << COL_LOADED_INTERVAL << COL_READ_INTERVAL << COL_SNR;
             if (info.status == LSStatus::LSStatusError)
             {
                 sub.status = SubStatus::FailedLoading;
@@ -20,6 +20,7 @@
 #include <QStyleOptionHeader>
 #include <QVector>
 #include <QElapsedTimer>
+#include <QImage>
 
 // Ensure translation domain is set before any i18nc() calls in this header
 namespace
@@ -74,6 +75,7 @@ enum SubStatsColumn
     COL_WAIT_LOAD_INTERVAL,
     COL_LOADED,
     COL_LOADED_INTERVAL,
+    COL_READ_INTERVAL,
     COL_SNR,
 
     COL_PLATE_SOLVED,
@@ -277,6 +279,12 @@ static const QVector<ColumnInfo> ColumnInfos =
         i18nc("Tooltip for Loading Time column", "Time to load"),
         Qt::AlignRight | Qt::AlignVCenter
     },
+    {
+        "Loading",       i18nc("Column header", "Read\nTime(s)"),
+        i18nc("Tooltip for Read Time column",
+              "Time spent reading the sub from disk. When subs are loaded ahead this overlaps processing of earlier subs"),
+        Qt::AlignRight | Qt::AlignVCenter
+    },
     {
         "Loading",       i18nc("Column header", "SNR"),
         i18nc("Tooltip for SNR column", "Signal-to-noise ratio"),
@@ -402,6 +410,7 @@ struct SubStats
     LSStatus loaded = LSStatus::LSStatusUninit;
     QDateTime loadedTime;
     double loadedInterval = -1.0;
+    double readInterval = -1.0;
     double snr = -1.0;
     int morc = -1;
 
@@ -645,6 +654,26 @@ class StackMonitor : public QWidget
          */
         void updateSubs(const QVector<LiveStackFile> &subs, const QVector<LiveStackStageInfo> &infos);
 
+        /**
+         * @brief updateMemory shows memory used by the last stack in the status bar
+         * @param peakProcess is the peak resident memory of the process
+         * @param peakMapped is the largest amount of spilled sub data mapped at once (tiled clipping)
+         * @param spilled is the amount of data held in the spill file (tiled clipping)
+         */
+        void updateMemory(const qint64 peakProcess, const qint64 peakMapped, const qint64 spilled);
+
+        /**
+         * @brief updateNoise shows the noise map of the stack from its running statistics
+         * @param noiseMap is a downscaled image of the per-pixel noise
+         * @param subs in the stack statistics
+         * @param noise is the median per-pixel noise
+         * @param snr of the stack
+         */
+        void updateNoise(const QImage &noiseMap, const int subs, const double noise, const double snr);
+
+    protected:
+        void resizeEvent(QResizeEvent *event) override;
+
     private:
         int addSub(const SubStats &stats);
         void highlightRow(int row);
@@ -654,10 +683,12 @@ class StackMonitor : public QWidget
         int getIDForSub(const QString &sub) const;
         void restoreSettings();
         void updateProgress();
+        void showNoiseMap();
 
         Ui::StackMonitorDialog *ui;
         SubStatsModel *m_Model;
         QSortFilterProxyModel *m_ProxyModel = nullptr;
         bool m_Highlight { true };
         QElapsedTimer m_ProgressTimer;
+        QImage m_NoiseMap;
 };
@@ -0,0 +1,228 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "fitsstackspill.h"
+#include <fits_debug.h>
+
+#include <QDir>
+
+#include <algorithm>
+
+FITSStackSpill::~FITSStackSpill()
+{
+    unmapBand();
+    releaseState();
+}
+
+bool FITSStackSpill::openFile(QScopedPointer<QTemporaryFile> &file)
+{
+    if (file && file->isOpen())
+        return true;
+
+    file.reset(new QTemporaryFile(QDir::tempPath() + "/kstars_livestack_XXXXXX.spill"));
+    if (!file->open())
+    {
+        qCDebug(KSTARS_FITS) << QString("Unable to open live stack spill file %1: %2")
+                             .arg(file->fileTemplate(), file->errorString());
+        file.reset();
+        return false;
+    }
+    return true;
+}
+
+bool FITSStackSpill::init(const int width, const int height, const int channels)
+{
+    if (width <= 0 || height <= 0 || channels <= 0)
+        return false;
+
+    clearSubs();
+    m_Width = width;
+    m_Height = height;
+    m_Channels = channels;
+    return openFile(m_SubFile);
+}
+
+bool FITSStackSpill::matches(const cv::Mat &sub) const
+{
+    return sub.depth() == CV_32F && sub.cols == m_Width && sub.rows == m_Height && sub.channels() == m_Channels;
+}
+
+int FITSStackSpill::append(const cv::Mat &sub)
+{
+    if (!write(m_NumSubs, sub))
+        return -1;
+    return m_NumSubs++;
+}
+
+bool FITSStackSpill::write(const int index, const cv::Mat &sub)
+{
+    if (!m_SubFile || index < 0 || index > m_NumSubs || !matches(sub))
+    {
+        qCDebug(KSTARS_FITS) << QString("%1 sub is inconsistent with spill area").arg(__FUNCTION__);
+        return false;
+    }
+
+    const qint64 rowBytes = static_cast<qint64>(m_Width) * m_Channels * sizeof(float);
+    const qint64 subBytes = rowBytes * m_Height;
+    if (!m_SubFile->seek(subBytes * index))
+        return false;
+
+    m_Dirty = true;
+    if (sub.isContinuous())
+    {
+        if (m_SubFile->write(reinterpret_cast<const char *>(sub.data), subBytes) != subBytes)
+        {
+            qCDebug(KSTARS_FITS) << QString("Error writing live stack spill file: %1").arg(m_SubFile->errorString());
+            return false;
+        }
+    }
+    else
+    {
+        for (int y = 0; y < sub.rows; y++)
+        {
+            if (m_SubFile->write(reinterpret_cast<const char *>(sub.ptr<float>(y)), rowBytes) != rowBytes)
+            {
+                qCDebug(KSTARS_FITS) << QString("Error writing live stack spill file: %1").arg(m_SubFile->errorString());
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool FITSStackSpill::read(const int index, cv::Mat &sub)
+{
+    if (!m_SubFile || index < 0 || index >= m_NumSubs)
+        return false;
+
+    const qint64 subBytes = static_cast<qint64>(m_Width) * m_Height * m_Channels * sizeof(float);
+    sub.create(m_Height, m_Width, CV_32FC(m_Channels));
+    if (!m_SubFile->seek(subBytes * index) ||
+            m_SubFile->read(reinterpret_cast<char *>(sub.data), subBytes) != subBytes)
+    {
+        qCDebug(KSTARS_FITS) << QString("Error reading live stack spill file: %1").arg(m_SubFile->errorString());
+        sub.release();
+        return false;
+    }
+    return true;
+}
+
+int FITSStackSpill::bandRows(const int numSubs, const qint64 budgetBytes) const
+{
+    const qint64 rowBytes = static_cast<qint64>(m_Width) * m_Channels * sizeof(float);
+    if (numSubs <= 0 || rowBytes <= 0)
+        return m_Height;
+
+    const qint64 rows = budgetBytes / (rowBytes * numSubs);
+    return static_cast<int>(std::max<qint64>(1, std::min<qint64>(rows, m_Height)));
+}
+
+bool FITSStackSpill::mapBand(const QVector<int> &indices, const int y0, const int rows,
+                             std::vector<const float *> &ptrs)
+{
+    unmapBand();
+    ptrs.clear();
+
+    if (!m_SubFile || y0 < 0 || rows <= 0 || y0 + rows > m_Height)
+        return false;
+
+    // Make sure buffered writes are visible to the mapping
+    if (m_Dirty)
+    {
+        m_SubFile->flush();
+        m_Dirty = false;
+    }
+
+    const qint64 rowBytes = static_cast<qint64>(m_Width) * m_Channels * sizeof(float);
+    const qint64 subBytes = rowBytes * m_Height;
+    const qint64 bandBytes = rowBytes * rows;
+
+    ptrs.reserve(indices.size());
+    m_BandMaps.reserve(indices.size());
+    for (int index : indices)
+    {
+        if (index < 0 || index >= m_NumSubs)
+        {
+            unmapBand();
+            ptrs.clear();
+            return false;
+        }
+
+        uchar *map = m_SubFile->map(subBytes * index + rowBytes * y0, bandBytes);
+        if (map == nullptr)
+        {
+            qCDebug(KSTARS_FITS) << QString("Unable to map live stack spill file: %1").arg(m_SubFile->errorString());
+            unmapBand();
+            ptrs.clear();
+            return false;
+        }
+        m_BandMaps.push_back(map);
+        ptrs.push_back(reinterpret_cast<const float *>(map));
+    }
+    m_PeakMappedBytes = std::max(m_PeakMappedBytes, bandBytes * indices.size());
+    return true;
+}
+
+void FITSStackSpill::unmapBand()
+{
+    if (m_SubFile)
+    {
+        for (uchar *map : m_BandMaps)
+            m_SubFile->unmap(map);
+    }
+    m_BandMaps.clear();
+}
+
+cv::Mat FITSStackSpill::createStateMat(const int rows, const int cols, const int type)
+{
+    if (!openFile(m_StateFile))
+        return cv::Mat();
+
+    const qint64 bytes = static_cast<qint64>(rows) * cols * CV_ELEM_SIZE(type);
+    // Extending the file zero fills the new area
+    if (!m_StateFile->resize(m_StateBytes + bytes))
+    {
+        qCDebug(KSTARS_FITS) << QString("Unable to size live stack state file: %1").arg(m_StateFile->errorString());
+        return cv::Mat();
+    }
+
+    uchar *map = m_StateFile->map(m_StateBytes, bytes);
+    if (map == nullptr)
+    {
+        qCDebug(KSTARS_FITS) << QString("Unable to map live stack state file: %1").arg(m_StateFile->errorString());
+        return cv::Mat();
+    }
+    m_StateMaps.push_back(map);
+    m_StateBytes += bytes;
+    return cv::Mat(rows, cols, type, map);
+}
+
+void FITSStackSpill::releaseState()
+{
+    if (m_StateFile)
+    {
+        for (uchar *map : m_StateMaps)
+            m_StateFile->unmap(map);
+        m_StateFile->resize(0);
+    }
+    m_StateMaps.clear();
+    m_StateBytes = 0;
+}
+
+void FITSStackSpill::clearSubs()
+{
+    unmapBand();
+    if (m_SubFile)
+        m_SubFile->resize(0);
+    m_NumSubs = 0;
+    m_Dirty = false;
+}
+
+qint64 FITSStackSpill::spilledBytes() const
+{
+    const qint64 rowBytes = static_cast<qint64>(m_Width) * m_Channels * sizeof(float);
+    return rowBytes * m_Height * m_NumSubs + m_StateBytes;
+}
@@ -0,0 +1,174 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+// Include Windows-specific headers first with protective macros
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#undef NOMINMAX  // Remove after windows.h
+#endif
+
+#include <QScopedPointer>
+#include <QTemporaryFile>
+#include <QVector>
+
+#ifdef _WIN32
+#pragma push_macro("NOMINMAX")
+#define NOMINMAX
+#endif
+
+#include "opencv2/core.hpp"
+
+#ifdef _WIN32
+#pragma pop_macro("NOMINMAX")
+#endif
+
+#include <vector>
+
+/**
+ * @class FITSStackSpill
+ * @brief Out-of-core scratch storage used by the Live Stacker for tiled pixel rejection.
+ *
+ * Aligned and calibrated subs are appended, as 32-bit float interleaved images, to a scratch
+ * file rather than held in RAM. Pixel rejection then works through the image in horizontal
+ * bands: for each band the corresponding rows of every spilled sub are memory mapped, processed
+ * and unmapped again, so peak memory is bounded by the band size rather than the number of subs.
+ *
+ * The per-pixel sigma clipping state needed for incremental stacking can also be placed in a
+ * file backed mapping so that the kernel is free to page it out between stacking runs.
+ */
+class FITSStackSpill
+{
+    public:
+        FITSStackSpill() = default;
+        ~FITSStackSpill();
+
+        /**
+         * @brief Set the geometry of subs held in the spill area. Clears any existing subs.
+         * @param width of each sub
+         * @param height of each sub
+         * @param channels of each sub
+         * @return success
+         */
+        bool init(const int width, const int height, const int channels);
+
+        /**
+         * @brief Check a sub has the geometry passed to init() so it can be written to the spill file
+         * @param sub to check
+         * @return whether the sub is CV_32F with the width, height and channels of the spill area
+         */
+        bool matches(const cv::Mat &sub) const;
+
+        /**
+         * @brief Append a CV_32F sub to the spill file
+         * @param sub to append. Must match the geometry passed to init()
+         * @return index of the sub in the spill area or -1 on failure
+         */
+        int append(const cv::Mat &sub);
+
+        /**
+         * @brief Overwrite a sub already in the spill file, e.g. once it has been calibrated and aligned
+         * @param index of the sub (as returned by append)
+         * @param sub to write. Must match the geometry passed to init()
+         * @return success
+         */
+        bool write(const int index, const cv::Mat &sub);
+
+        /**
+         * @brief Read a whole sub back from the spill file
+         * @param index of the sub (as returned by append)
+         * @param sub is returned to the caller
+         * @return success
+         */
+        bool read(const int index, cv::Mat &sub);
+
+        /**
+         * @brief Map the same band of rows from several spilled subs
+         * @param indices of the subs to map (as returned by append)
+         * @param y0 is the first row of the band
+         * @param rows in the band
+         * @param ptrs returned pointers to the start of the band, one per index
+         * @return success. On failure any partial mapping is released
+         */
+        bool mapBand(const QVector<int> &indices, const int y0, const int rows, std::vector<const float *> &ptrs);
+
+        /**
+         * @brief Release the mapping created by the last mapBand() call
+         */
+        void unmapBand();
+
+        /**
+         * @brief Work out how many rows can be processed per band within a memory budget
+         * @param numSubs being processed together
+         * @param budgetBytes available for mapped sub data
+         * @return rows per band (at least 1)
+         */
+        int bandRows(const int numSubs, const qint64 budgetBytes) const;
+
+        /**
+         * @brief Create a zero-filled, file backed cv::Mat. The Mat does not own its data and
+         * remains valid until releaseState() or the destructor is called.
+         * @param rows of the Mat
+         * @param cols of the Mat
+         * @param type of the Mat
+         * @return the Mat (empty on failure)
+         */
+        cv::Mat createStateMat(const int rows, const int cols, const int type);
+
+        /**
+         * @brief Release all file backed state Mats. Any Mats created by createStateMat() must not
+         * be used after this call.
+         */
+        void releaseState();
+
+        /**
+         * @brief Remove all subs from the spill area (the state mapping is retained)
+         */
+        void clearSubs();
+
+        /**
+         * @brief Number of subs currently in the spill area
+         */
+        int size() const
+        {
+            return m_NumSubs;
+        }
+
+        /**
+         * @brief Bytes currently used by spilled subs and state
+         */
+        qint64 spilledBytes() const;
+
+        /**
+         * @brief Largest number of bytes mapped at once by mapBand()
+         */
+        qint64 peakMappedBytes() const
+        {
+            return m_PeakMappedBytes;
+        }
+
+    private:
+        bool openFile(QScopedPointer<QTemporaryFile> &file);
+
+        QScopedPointer<QTemporaryFile> m_SubFile;
+        QScopedPointer<QTemporaryFile> m_StateFile;
+        QVector<uchar *> m_BandMaps;
+        QVector<uchar *> m_StateMaps;
+        qint64 m_StateBytes { 0 };
+        qint64 m_PeakMappedBytes { 0 };
+        int m_Width { 0 };
+        int m_Height { 0 };
+        int m_Channels { 0 };
+        int m_NumSubs { 0 };
+        bool m_Dirty { false };
+};
@@ -0,0 +1,237 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "fitsstackstatistics.h"
+#include "../auxiliary/histogrammedian.h"
+#include <fits_debug.h>
+
+#include <QThread>
+#include <QtConcurrent>
+
+#include "opencv2/imgproc.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+template <typename Fn>
+void FITSStackStatistics::forRowBlocks(const int rows, Fn fn)
+{
+    const int numChunks = std::max(1, QThread::idealThreadCount() * 2);
+    const int chunkRows = std::max(1, (rows + numChunks - 1) / numChunks);
+
+    QVector<int> rowBlocks;
+    for (int y = 0; y < rows; y += chunkRows)
+        rowBlocks.append(y);
+
+    QtConcurrent::blockingMap(rowBlocks, [&](int yStart)
+    {
+        fn(yStart, std::min(yStart + chunkRows, rows));
+    });
+}
+
+void FITSStackStatistics::reset()
+{
+    m_Subs = 0;
+    m_Mean.release();
+    m_M2.release();
+    m_Weight.release();
+    m_Weight2.release();
+}
+
+bool FITSStackStatistics::add(const cv::Mat &sub, const float weight)
+{
+    try
+    {
+        if (sub.empty() || sub.depth() != CV_32F || (sub.channels() != 1 && sub.channels() != 3) || !(weight > 0.0f))
+            return false;
+
+        if (m_Subs > 0 && (sub.size() != m_Mean.size() || sub.type() != m_Mean.type()))
+        {
+            qCDebug(KSTARS_FITS) << QString("%1 sub geometry changed, restarting statistics").arg(__FUNCTION__);
+            reset();
+        }
+
+        if (m_Subs == 0)
+        {
+            m_Mean = cv::Mat::zeros(sub.size(), sub.type());
+            m_M2 = cv::Mat::zeros(sub.size(), sub.type());
+            m_Weight = cv::Mat::zeros(sub.size(), CV_32F);
+            m_Weight2 = cv::Mat::zeros(sub.size(), CV_32F);
+        }
+
+        const int channels = sub.channels();
+        const int width = sub.cols;
+        forRowBlocks(sub.rows, [&](const int firstRow, const int lastRow)
+        {
+            for (int y = firstRow; y < lastRow; y++)
+            {
+                const float *in = sub.ptr<float>(y);
+                float *mean = m_Mean.ptr<float>(y);
+                float *m2 = m_M2.ptr<float>(y);
+                float *w = m_Weight.ptr<float>(y);
+                float *w2 = m_Weight2.ptr<float>(y);
+                for (int x = 0; x < width; x++, in += channels, mean += channels, m2 += channels)
+                {
+                    // Outside the aligned area of the sub
+                    bool covered = false;
+                    for (int c = 0; c < channels; c++)
+                        covered |= (in[c] != 0.0f);
+                    if (!covered)
+                        continue;
+
+                    w[x] += weight;
+                    w2[x] += weight * weight;
+                    const float ratio = weight / w[x];
+                    for (int c = 0; c < channels; c++)
+                    {
+                        const float delta = in[c] - mean[c];
+                        mean[c] += delta * ratio;
+                        m2[c] += weight * delta * (in[c] - mean[c]);
+                    }
+                }
+            }
+        });
+        m_Subs++;
+        return true;
+    }
+    catch (const cv::Exception &ex)
+    {
+        qCDebug(KSTARS_FITS) << QString("openCV exception %1 called from %2").arg(ex.what()).arg(__FUNCTION__);
+        return false;
+    }
+}
+
+// Unbiased for reliability weights: M2 / (W - W2 / W). This is the usual n - 1 form for equal weights.
+cv::Mat FITSStackStatistics::variance() const
+{
+    if (m_Subs == 0)
+        return cv::Mat();
+
+    cv::Mat variance = cv::Mat::zeros(m_M2.size(), m_M2.type());
+    const int channels = m_M2.channels();
+    const int width = m_M2.cols;
+    forRowBlocks(m_M2.rows, [&](const int firstRow, const int lastRow)
+    {
+        for (int y = firstRow; y < lastRow; y++)
+        {
+            const float *m2 = m_M2.ptr<float>(y);
+            const float *w = m_Weight.ptr<float>(y);
+            const float *w2 = m_Weight2.ptr<float>(y);
+            float *out = variance.ptr<float>(y);
+            for (int x = 0; x < width; x++, m2 += channels, out += channels)
+            {
+                // Fewer than 2 subs
+                const double denominator = w[x] - (w[x] > 0.0f ? w2[x] / w[x] : 0.0);
+                if (denominator <= 1e-6 * w[x])
+                    continue;
+                for (int c = 0; c < channels; c++)
+                    out[c] = static_cast<float>(std::max(0.0f, m2[c]) / denominator);
+            }
+        }
+    });
+    return variance;
+}
+
+// The variance of a weighted mean is variance * W2 / W^2
+cv::Mat FITSStackStatistics::noiseMap() const
+{
+    if (m_Subs == 0)
+        return cv::Mat();
+
+    cv::Mat noise = cv::Mat::zeros(m_M2.size(), CV_32F);
+    const int channels = m_M2.channels();
+    const int width = m_M2.cols;
+    forRowBlocks(m_M2.rows, [&](const int firstRow, const int lastRow)
+    {
+        for (int y = firstRow; y < lastRow; y++)
+        {
+            const float *m2 = m_M2.ptr<float>(y);
+            const float *w = m_Weight.ptr<float>(y);
+            const float *w2 = m_Weight2.ptr<float>(y);
+            float *out = noise.ptr<float>(y);
+            for (int x = 0; x < width; x++, m2 += channels)
+            {
+                const double weightSq = static_cast<double>(w[x]) * w[x];
+                const double denominator = w[x] * (weightSq - w2[x]);
+                if (weightSq - w2[x] <= 1e-6 * weightSq)
+                    continue;
+                double sum = 0.0;
+                for (int c = 0; c < channels; c++)
+                    sum += std::max(0.0f, m2[c]);
+                out[x] = static_cast<float>(std::sqrt(sum / channels * w2[x] / denominator));
+            }
+        }
+    });
+    return noise;
+}
+
+FITSStackStatistics::Summary FITSStackStatistics::summarise(const cv::Mat &noiseMap) const
+{
+    Summary summary;
+    summary.subs = m_Subs;
+    if (m_Subs == 0)
+        return summary;
+
+    try
+    {
+        const cv::Mat noise = noiseMap.empty() ? this->noiseMap() : noiseMap;
+
+        cv::Mat gray;
+        if (m_Mean.channels() == 3)
+            cv::transform(m_Mean, gray, cv::Matx13f(1.0f / 3, 1.0f / 3, 1.0f / 3));
+        else
+            gray = m_Mean;
+
+        cv::Mat covered, noiseMask;
+        cv::compare(m_Weight, 0.0, covered, cv::CMP_GT);
+        cv::compare(noise, 0.0, noiseMask, cv::CMP_GT);
+
+        // Central ROI for the signal
+        const cv::Rect roi(gray.cols / 4, gray.rows / 4, gray.cols / 2, gray.rows / 2);
+        summary.signal = cv::mean(gray(roi), covered(roi))[0];
+        summary.background = Mathematics::HistogramMedian::compute(gray.ptr<float>(), gray.total(), 1,
+                             covered.ptr<uint8_t>(), false).median;
+        summary.noise = Mathematics::HistogramMedian::compute(noise.ptr<float>(), noise.total(), 1,
+                        noiseMask.ptr<uint8_t>(), false).median;
+        if (summary.noise > 0.0)
+            summary.snr = std::max(0.0, (summary.signal - summary.background) / summary.noise);
+    }
+    catch (const cv::Exception &ex)
+    {
+        qCDebug(KSTARS_FITS) << QString("openCV exception %1 called from %2").arg(ex.what()).arg(__FUNCTION__);
+    }
+    return summary;
+}
+
+QImage FITSStackStatistics::noiseImage(const cv::Mat &noiseMap, const double noise, const int maxSize)
+{
+    if (noiseMap.empty() || !(noise > 0.0) || maxSize <= 0)
+        return QImage();
+
+    try
+    {
+        const double scale = std::min(1.0, static_cast<double>(maxSize) / std::max(noiseMap.cols, noiseMap.rows));
+        cv::Mat small;
+        if (scale < 1.0)
+            cv::resize(noiseMap, small, cv::Size(), scale, scale, cv::INTER_AREA);
+        else
+            small = noiseMap;
+
+        cv::Mat display;
+        small.convertTo(display, CV_8U, 255.0 / (3.0 * noise));
+
+        QImage image(display.cols, display.rows, QImage::Format_Grayscale8);
+        for (int y = 0; y < display.rows; y++)
+            memcpy(image.scanLine(y), display.ptr<uchar>(y), display.cols);
+        return image;
+    }
+    catch (const cv::Exception &ex)
+    {
+        qCDebug(KSTARS_FITS) << QString("openCV exception %1 called from %2").arg(ex.what()).arg(__FUNCTION__);
+        return QImage();
+    }
+}
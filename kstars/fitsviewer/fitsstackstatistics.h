@@ -0,0 +1,136 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+// Include Windows-specific headers first with protective macros
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#undef NOMINMAX  // Remove after windows.h
+#endif
+
+#include <QImage>
+
+#ifdef _WIN32
+#pragma push_macro("NOMINMAX")
+#define NOMINMAX
+#endif
+
+#include "opencv2/core.hpp"
+
+#ifdef _WIN32
+#pragma pop_macro("NOMINMAX")
+#endif
+
+/**
+ * @class FITSStackStatistics
+ * @brief Running per-pixel statistics of the subs in a Live Stack.
+ *
+ * Each aligned (and normalized) sub is folded into a per-pixel weighted mean and sum of squared
+ * deviations (M2) using West's weighted form of Welford's algorithm, "Updating mean and variance
+ * estimates: an improved method", CACM 22 (1979). Adding a sub is O(pixels) and memory does not
+ * depend on the number of subs, so the noise, variance and SNR of the stack are available at any
+ * point of an overnight stack without revisiting earlier subs.
+ *
+ * Pixels outside a sub's aligned area (zero in every channel, as getBinaryMask) are not counted,
+ * so the per-pixel weights also form a coverage map.
+ */
+class FITSStackStatistics
+{
+    public:
+        struct Summary
+        {
+            int subs { 0 };
+            // Mean of the central half of the stack (as FITSData::calcStackSNR)
+            double signal { 0.0 };
+            // Median of the stack
+            double background { 0.0 };
+            // Median per-pixel noise of the stack, i.e. the standard error of the weighted mean
+            double noise { 0.0 };
+            double snr { 0.0 };
+        };
+
+        FITSStackStatistics() = default;
+
+        /**
+         * @brief Release the accumulators
+         */
+        void reset();
+
+        /**
+         * @brief Add a sub to the statistics
+         * @param sub CV_32F image with 1 or 3 channels. All subs must have the same geometry
+         * @param weight of the sub in the stack
+         * @return success
+         */
+        bool add(const cv::Mat &sub, const float weight);
+
+        /**
+         * @brief Number of subs added since the last reset
+         */
+        int count() const
+        {
+            return m_Subs;
+        }
+
+        bool isEmpty() const
+        {
+            return m_Subs == 0;
+        }
+
+        /**
+         * @brief Per-pixel weighted mean of the subs (CV_32F, channels as the subs)
+         */
+        const cv::Mat &mean() const
+        {
+            return m_Mean;
+        }
+
+        /**
+         * @brief Per-pixel weighted variance of the subs (CV_32F, channels as the subs). This is the
+         * spread of the individual subs about the mean, e.g. for pixel rejection.
+         */
+        cv::Mat variance() const;
+
+        /**
+         * @brief Per-pixel noise of the stack (single channel CV_32F). This is the standard error of
+         * the weighted mean, averaged in quadrature over the channels. Pixels covered by fewer than
+         * 2 subs are 0.
+         */
+        cv::Mat noiseMap() const;
+
+        /**
+         * @brief Signal, background, noise and SNR of the stack. O(pixels).
+         * @param noiseMap as returned by noiseMap(), if already calculated
+         */
+        Summary summarise(const cv::Mat &noiseMap = cv::Mat()) const;
+
+        /**
+         * @brief An 8-bit image of the noise map for display, scaled so that 0 is black and 3x the
+         * median noise is white.
+         * @param noiseMap as returned by noiseMap()
+         * @param noise median noise, as Summary::noise
+         * @param maxSize longest side of the image in pixels. The map is downscaled to fit.
+         */
+        static QImage noiseImage(const cv::Mat &noiseMap, const double noise, const int maxSize);
+
+    private:
+        // Apply fn(firstRow, lastRow) to blocks of rows in parallel
+        template <typename Fn>
+        static void forRowBlocks(const int rows, Fn fn);
+
+        int m_Subs { 0 };
+        cv::Mat m_Mean;           // Weighted mean per channel
+        cv::Mat m_M2;             // Weighted sum of squared deviations per channel
+        cv::Mat m_Weight;         // Sum of weights, single channel
+        cv::Mat m_Weight2;        // Sum of squared weights, single channel
+};
@@ -0,0 +1,210 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "fitsstarmatcher.h"
+
+#ifdef _WIN32
+#pragma push_macro("NOMINMAX")
+#define NOMINMAX
+#endif
+
+#include "opencv2/calib3d.hpp"
+
+#ifdef _WIN32
+#pragma pop_macro("NOMINMAX")
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
+namespace
+{
+// Number of brightest stars used to build triangles
+constexpr int TRIANGLE_STARS = 20;
+// Number of brightest stars used to refine the fit
+constexpr int REFINE_STARS = 200;
+// Tolerance on side ratios when matching triangles
+constexpr double RATIO_TOLERANCE = 0.01;
+// Ignore small triangles whose ratios are dominated by centroid errors (pixels)
+constexpr double MIN_SIDE = 10.0;
+// Ignore triangles with sides too similar to reliably label their vertices
+constexpr double MIN_SIDE_DIFF = 0.02;
+// Minimum triangle votes for a star correspondence
+constexpr int MIN_VOTES = 2;
+// RANSAC threshold for the initial fit (pixels)
+constexpr double MATCH_RADIUS = 3.0;
+// Radius used to pair stars when refining the fit (pixels)
+constexpr double REFINE_RADIUS = 1.5;
+
+cv::Point2d transformPoint(const cv::Mat &affine, const cv::Point2d &p)
+{
+    return cv::Point2d(affine.at<double>(0, 0) * p.x + affine.at<double>(0, 1) * p.y + affine.at<double>(0, 2),
+                       affine.at<double>(1, 0) * p.x + affine.at<double>(1, 1) * p.y + affine.at<double>(1, 2));
+}
+}
+
+void FITSStarMatcher::setReference(const std::vector<cv::Point2d> &stars)
+{
+    clear();
+    if (stars.size() < static_cast<size_t>(MIN_STARS))
+        return;
+
+    m_RefStars = stars;
+    m_RefTriangles = buildTriangles(m_RefStars, TRIANGLE_STARS);
+}
+
+void FITSStarMatcher::clear()
+{
+    m_RefStars.clear();
+    m_RefTriangles.clear();
+}
+
+std::vector<FITSStarMatcher::Triangle> FITSStarMatcher::buildTriangles(const std::vector<cv::Point2d> &stars,
+        const int maxStars)
+{
+    std::vector<Triangle> triangles;
+    const int n = std::min(static_cast<int>(stars.size()), maxStars);
+    if (n < 3)
+        return triangles;
+
+    triangles.reserve(n * (n - 1) * (n - 2) / 6);
+    for (int i = 0; i < n - 2; i++)
+    {
+        for (int j = i + 1; j < n - 1; j++)
+        {
+            const double dij = cv::norm(stars[i] - stars[j]);
+            for (int k = j + 1; k < n; k++)
+            {
+                // Each side paired with the vertex opposite it
+                std::array<std::pair<double, int>, 3> sides
+                {
+                    {
+                        { cv::norm(stars[j] - stars[k]), i },
+                        { cv::norm(stars[k] - stars[i]), j },
+                        { dij, k }
+                    }
+                };
+                std::sort(sides.begin(), sides.end());
+
+                if (sides[0].first < MIN_SIDE)
+                    continue;
+
+                const double ratio1 = sides[0].first / sides[2].first;
+                const double ratio2 = sides[1].first / sides[2].first;
+                if (ratio2 - ratio1 < MIN_SIDE_DIFF || 1.0 - ratio2 < MIN_SIDE_DIFF)
+                    continue;
+
+                triangles.push_back({ ratio1, ratio2, { sides[0].second, sides[1].second, sides[2].second } });
+            }
+        }
+    }
+
+    std::sort(triangles.begin(), triangles.end(), [](const Triangle & a, const Triangle & b)
+    {
+        return a.ratio1 < b.ratio1;
+    });
+    return triangles;
+}
+
+bool FITSStarMatcher::match(const std::vector<cv::Point2d> &stars, cv::Mat &affine, int &numMatched) const
+{
+    numMatched = 0;
+    if (!hasReference() || stars.size() < static_cast<size_t>(MIN_STARS))
+        return false;
+
+    // Vote for star correspondences using triangles with matching side ratios
+    const int numSub = std::min(static_cast<int>(stars.size()), TRIANGLE_STARS);
+    const int numRef = std::min(static_cast<int>(m_RefStars.size()), TRIANGLE_STARS);
+    std::vector<int> votes(numSub * numRef, 0);
+
+    const std::vector<Triangle> triangles = buildTriangles(stars, TRIANGLE_STARS);
+    for (const auto &triangle : triangles)
+    {
+        auto it = std::lower_bound(m_RefTriangles.cbegin(), m_RefTriangles.cend(), triangle.ratio1 - RATIO_TOLERANCE,
+                                   [](const Triangle & t, const double value)
+        {
+            return t.ratio1 < value;
+        });
+        for (; it != m_RefTriangles.cend() && it->ratio1 <= triangle.ratio1 + RATIO_TOLERANCE; ++it)
+        {
+            if (std::fabs(it->ratio2 - triangle.ratio2) > RATIO_TOLERANCE)
+                continue;
+            for (int v = 0; v < 3; v++)
+                votes[triangle.v[v] * numRef + it->v[v]]++;
+        }
+    }
+
+    // Keep correspondences that are the best choice for both the sub and the reference star
+    std::vector<cv::Point2d> subPts, refPts;
+    for (int s = 0; s < numSub; s++)
+    {
+        const int *row = &votes[s * numRef];
+        const int r = static_cast<int>(std::max_element(row, row + numRef) - row);
+        if (row[r] < MIN_VOTES)
+            continue;
+
+        bool best = true;
+        for (int other = 0; other < numSub && best; other++)
+            best = (other == s || votes[other * numRef + r] < row[r]);
+        if (!best)
+            continue;
+
+        subPts.push_back(stars[s]);
+        refPts.push_back(m_RefStars[r]);
+    }
+
+    if (subPts.size() < 3)
+        return false;
+
+    cv::Mat inliers;
+    cv::Mat fit = cv::estimateAffinePartial2D(subPts, refPts, inliers, cv::RANSAC, MATCH_RADIUS);
+    if (fit.empty())
+        return false;
+
+    // Refine using all the stars that land close to a reference star
+    const int refineSub = std::min(static_cast<int>(stars.size()), REFINE_STARS);
+    const int refineRef = std::min(static_cast<int>(m_RefStars.size()), REFINE_STARS);
+    std::vector<bool> used(refineRef);
+    subPts.clear();
+    refPts.clear();
+    for (int s = 0; s < refineSub; s++)
+    {
+        const cv::Point2d p = transformPoint(fit, stars[s]);
+        int nearest = -1;
+        double nearestDist = REFINE_RADIUS;
+        for (int r = 0; r < refineRef; r++)
+        {
+            const double dist = cv::norm(p - m_RefStars[r]);
+            if (!used[r] && dist < nearestDist)
+            {
+                nearest = r;
+                nearestDist = dist;
+            }
+        }
+        if (nearest < 0)
+            continue;
+
+        used[nearest] = true;
+        subPts.push_back(stars[s]);
+        refPts.push_back(m_RefStars[nearest]);
+    }
+
+    if (subPts.size() < static_cast<size_t>(MIN_MATCHES))
+        return false;
+
+    fit = cv::estimateAffinePartial2D(subPts, refPts, inliers, cv::RANSAC, REFINE_RADIUS);
+    if (fit.empty())
+        return false;
+
+    numMatched = cv::countNonZero(inliers);
+    if (numMatched < MIN_MATCHES)
+        return false;
+
+    affine = fit;
+    return true;
+}
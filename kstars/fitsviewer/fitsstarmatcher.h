@@ -0,0 +1,98 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+// Include Windows-specific headers first with protective macros
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#undef NOMINMAX  // Remove after windows.h
+#endif
+
+#ifdef _WIN32
+#pragma push_macro("NOMINMAX")
+#define NOMINMAX
+#endif
+
+#include "opencv2/core.hpp"
+
+#ifdef _WIN32
+#pragma pop_macro("NOMINMAX")
+#endif
+
+#include <vector>
+
+/**
+ * @class FITSStarMatcher
+ * @brief Aligns star fields without plate solving by matching triangles of stars.
+ *
+ * Triangles are formed from the brightest stars in the reference (align master) and in each
+ * sub. The ratios of a triangle's sides do not change with translation, rotation or scale, so
+ * triangles with matching ratios vote for the star correspondences at their vertices. The best
+ * supported correspondences are used to fit a rigid (rotation + translation + scale) transform
+ * with RANSAC, which is then refined using all detected stars.
+ *
+ * This follows the approach of Groth, "A pattern-matching algorithm for two-dimensional
+ * coordinate lists", AJ 91 (1986) and Valdes et al. "FOCAS automatic catalog matching
+ * algorithms", PASP 107 (1995).
+ */
+class FITSStarMatcher
+{
+    public:
+        FITSStarMatcher() = default;
+
+        /**
+         * @brief Set the reference stars that subs will be matched against
+         * @param stars pixel positions, brightest first
+         */
+        void setReference(const std::vector<cv::Point2d> &stars);
+
+        /**
+         * @brief Whether there are enough reference stars to attempt matching
+         */
+        bool hasReference() const
+        {
+            return !m_RefTriangles.empty();
+        }
+
+        /**
+         * @brief Remove the reference stars
+         */
+        void clear();
+
+        /**
+         * @brief Match stars against the reference stars
+         * @param stars pixel positions, brightest first
+         * @param affine is the 2x3 CV_64F transform from star positions to reference positions
+         * @param numMatched is the number of stars used in the final fit
+         * @return success
+         */
+        bool match(const std::vector<cv::Point2d> &stars, cv::Mat &affine, int &numMatched) const;
+
+        // Minimum stars needed in the reference and in a sub
+        static constexpr int MIN_STARS = 6;
+        // Minimum matched stars for a transform to be accepted
+        static constexpr int MIN_MATCHES = 6;
+
+    private:
+        struct Triangle
+        {
+            double ratio1;  // shortest side / longest side
+            double ratio2;  // middle side / longest side
+            int v[3];       // vertices opposite the shortest, middle and longest sides
+        };
+
+        static std::vector<Triangle> buildTriangles(const std::vector<cv::Point2d> &stars, const int maxStars);
+
+        std::vector<cv::Point2d> m_RefStars;
+        std::vector<Triangle> m_RefTriangles;  // Sorted by ratio1
+};
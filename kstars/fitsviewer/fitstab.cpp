@@ -1091,6 +1091,11 @@ void FITSTab::initSettings()
     m_LiveStackingUI.Alpha->setValue(Options::fitsLSAlpha());
     m_LiveStackingUI.Sigma->setValue(Options::fitsLSSigma());
     m_LiveStackingUI.PSFUpdate->setValue(Options::fitsPSFUpdate());
+    m_LiveStackingUI.TiledClipping->setChecked(Options::fitsLSTiledClipping());
+    m_LiveStackingUI.TiledBudget->setValue(Options::fitsLSTiledBudget());
+    m_LiveStackingUI.PipelineWorkers->setValue(Options::fitsLSPipelineWorkers());
+    m_LiveStackingUI.DrizzleScale->setCurrentIndex(Options::fitsLSDrizzleScale());
+    m_LiveStackingUI.PixFrac->setValue(Options::fitsLSDrizzlePixFrac());
     m_LiveStackingUI.PostProcGroupBox->setChecked(Options::fitsLSPostProc());
     m_LiveStackingUI.GradientAmt->setValue(Options::fitsLSGradientAmt() * 100.0);
     m_LiveStackingUI.DeconvAmt->setValue(Options::fitsLSDeconvAmt());
@@ -1124,6 +1129,11 @@ void FITSTab::saveSettings()
     Options::setFitsLSAlpha(m_LiveStackingUI.Alpha->value());
     Options::setFitsLSSigma(m_LiveStackingUI.Sigma->value());
     Options::setFitsPSFUpdate(m_LiveStackingUI.PSFUpdate->value());
+    Options::setFitsLSTiledClipping(m_LiveStackingUI.TiledClipping->isChecked());
+    Options::setFitsLSTiledBudget(m_LiveStackingUI.TiledBudget->value());
+    Options::setFitsLSPipelineWorkers(m_LiveStackingUI.PipelineWorkers->value());
+    Options::setFitsLSDrizzleScale(m_LiveStackingUI.DrizzleScale->currentIndex());
+    Options::setFitsLSDrizzlePixFrac(m_LiveStackingUI.PixFrac->value());
 
     Options::setFitsLSPostProc(m_LiveStackingUI.PostProcGroupBox->isChecked());
     Options::setFitsLSGradientAmt(m_LiveStackingUI.GradientAmt->value() / 100.0);
@@ -1181,6 +1191,11 @@ LiveStackData FITSTab::getAllSettings()
     data.alpha = m_LiveStackingUI.Alpha->value();
     data.sigma = m_LiveStackingUI.Sigma->value();
     data.PSFUpdate = m_LiveStackingUI.PSFUpdate->value();
+    data.tiledClipping = m_LiveStackingUI.TiledClipping->isChecked();
+    data.tiledBudgetMB = m_LiveStackingUI.TiledBudget->value();
+    data.pipelineWorkers = m_LiveStackingUI.PipelineWorkers->value();
+    data.drizzleScale = static_cast<LiveStackDrizzleScale>(m_LiveStackingUI.DrizzleScale->currentIndex());
+    data.drizzlePixFrac = m_LiveStackingUI.PixFrac->value();
     data.postProcessing = getPPSettings();
     return data;
 }
@@ -1220,6 +1235,13 @@ void FITSTab::stackMethodChanged(int index)
             m_LiveStackingUI.SigmaLabel->hide();
             m_LiveStackingUI.PSFUpdate->hide();
             m_LiveStackingUI.PSFUpdateLabel->hide();
+            m_LiveStackingUI.TiledClipping->hide();
+            m_LiveStackingUI.TiledBudget->hide();
+            m_LiveStackingUI.TiledBudgetLabel->hide();
+            m_LiveStackingUI.DrizzleScale->hide();
+            m_LiveStackingUI.DrizzleScaleLabel->hide();
+            m_LiveStackingUI.PixFrac->hide();
+            m_LiveStackingUI.PixFracLabel->hide();
             break;
         case LiveStackStackingMethod::SIGMA:
             m_LiveStackingUI.LowSigma->show();
@@ -1238,6 +1260,13 @@ void FITSTab::stackMethodChanged(int index)
             m_LiveStackingUI.SigmaLabel->hide();
             m_LiveStackingUI.PSFUpdate->hide();
             m_LiveStackingUI.PSFUpdateLabel->hide();
+            m_LiveStackingUI.TiledClipping->show();
+            m_LiveStackingUI.TiledBudget->show();
+            m_LiveStackingUI.TiledBudgetLabel->show();
+            m_LiveStackingUI.DrizzleScale->hide();
+            m_LiveStackingUI.DrizzleScaleLabel->hide();
+            m_LiveStackingUI.PixFrac->hide();
+            m_LiveStackingUI.PixFracLabel->hide();
             break;
         case LiveStackStackingMethod::WINDSOR:
             m_LiveStackingUI.LowSigma->show();
@@ -1256,6 +1285,13 @@ void FITSTab::stackMethodChanged(int index)
             m_LiveStackingUI.SigmaLabel->hide();
             m_LiveStackingUI.PSFUpdate->hide();
             m_LiveStackingUI.PSFUpdateLabel->hide();
+            m_LiveStackingUI.TiledClipping->show();
+            m_LiveStackingUI.TiledBudget->show();
+            m_LiveStackingUI.TiledBudgetLabel->show();
+            m_LiveStackingUI.DrizzleScale->hide();
+            m_LiveStackingUI.DrizzleScaleLabel->hide();
+            m_LiveStackingUI.PixFrac->hide();
+            m_LiveStackingUI.PixFracLabel->hide();
             break;
         case LiveStackStackingMethod::IMAGEMM:
             m_LiveStackingUI.LowSigma->hide();
@@ -1274,6 +1310,38 @@ void FITSTab::stackMethodChanged(int index)
             m_LiveStackingUI.SigmaLabel->show();
             m_LiveStackingUI.PSFUpdate->show();
             m_LiveStackingUI.PSFUpdateLabel->show();
+            m_LiveStackingUI.TiledClipping->hide();
+            m_LiveStackingUI.TiledBudget->hide();
+            m_LiveStackingUI.TiledBudgetLabel->hide();
+            m_LiveStackingUI.DrizzleScale->hide();
+            m_LiveStackingUI.DrizzleScaleLabel->hide();
+            m_LiveStackingUI.PixFrac->hide();
+            m_LiveStackingUI.PixFracLabel->hide();
+            break;
+        case LiveStackStackingMethod::DRIZZLE:
+            m_LiveStackingUI.LowSigma->hide();
+            m_LiveStackingUI.LowSigmaLabel->hide();
+            m_LiveStackingUI.HighSigma->hide();
+            m_LiveStackingUI.HighSigmaLabel->hide();
+            m_LiveStackingUI.WinsorCutoff->hide();
+            m_LiveStackingUI.WinsorCutoffLabel->hide();
+            m_LiveStackingUI.Iterations->hide();
+            m_LiveStackingUI.IterationsLabel->hide();
+            m_LiveStackingUI.Kappa->hide();
+            m_LiveStackingUI.KappaLabel->hide();
+            m_LiveStackingUI.Alpha->hide();
+            m_LiveStackingUI.AlphaLabel->hide();
+            m_LiveStackingUI.Sigma->hide();
+            m_LiveStackingUI.SigmaLabel->hide();
+            m_LiveStackingUI.PSFUpdate->hide();
+            m_LiveStackingUI.PSFUpdateLabel->hide();
+            m_LiveStackingUI.TiledClipping->hide();
+            m_LiveStackingUI.TiledBudget->hide();
+            m_LiveStackingUI.TiledBudgetLabel->hide();
+            m_LiveStackingUI.DrizzleScale->show();
+            m_LiveStackingUI.DrizzleScaleLabel->show();
+            m_LiveStackingUI.PixFrac->show();
+            m_LiveStackingUI.PixFracLabel->show();
             break;
         default:
             break;
@@ -1770,7 +1838,10 @@ void FITSTab::liveStack()
                 << " | Alpha: " << lsd.alpha
                 << " | Sigma: " << lsd.sigma
                 << " | PSF Update: " << lsd.PSFUpdate
+                << " | Tiled Clipping: " << (lsd.tiledClipping ? "On" : "Off")
+                << " (" << lsd.tiledBudgetMB << " MB)"
                 << " | NumInMem: " << lsd.numInMem
+                << " | Load Workers: " << lsd.pipelineWorkers
                 << " | PostProc: " << (lsd.postProcessing.postProcess ? "On" : "Off")
                 << " [Gradient=" << lsd.postProcessing.gradientAmt
                 << ", Deconv=" << lsd.postProcessing.deconvAmt
@@ -1963,11 +2034,16 @@ void FITSTab::startProgrammatically(const QString &dir, const LiveStackData &par
     m_LiveStackingUI.CalcSNR->setChecked(params.calcSNR);
     m_LiveStackingUI.LSDownscale->setCurrentIndex(static_cast<int>(params.downscale));
     m_LiveStackingUI.NumInMem->setValue(params.numInMem);
+    m_LiveStackingUI.PipelineWorkers->setValue(params.pipelineWorkers);
+    m_LiveStackingUI.TiledClipping->setChecked(params.tiledClipping);
+    m_LiveStackingUI.TiledBudget->setValue(params.tiledBudgetMB);
     m_LiveStackingUI.Weighting->setCurrentIndex(static_cast<int>(params.weighting));
     m_LiveStackingUI.AlignMethod->setCurrentIndex(static_cast<int>(params.alignMethod));
     m_LiveStackingUI.StackingMethod->setCurrentIndex(static_cast<int>(params.stackingMethod));
     m_LiveStackingUI.LowSigma->setValue(params.lowSigma);
     m_LiveStackingUI.HighSigma->setValue(params.highSigma);
+    m_LiveStackingUI.DrizzleScale->setCurrentIndex(static_cast<int>(params.drizzleScale));
+    m_LiveStackingUI.PixFrac->setValue(params.drizzlePixFrac);
 
     // Post-processing
     m_LiveStackingUI.PostProcGroupBox->setChecked(params.postProcessing.postProcess);
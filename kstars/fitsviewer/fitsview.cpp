@@ -497,6 +497,8 @@ void FITSView::loadStack(const QStringList &inDir, const LiveStackData &params)
     connect(m_ImageData.data(), &FITSData::initStackMon, m_StackMonitor, &StackMonitor::initialize);
     connect(m_ImageData.data(), &FITSData::addStackMon, m_StackMonitor, &StackMonitor::addSubs);
     connect(m_ImageData.data(), &FITSData::updateStackMon, m_StackMonitor, &StackMonitor::updateSubs);
+    connect(m_ImageData.data(), &FITSData::updateStackMemory, m_StackMonitor, &StackMonitor::updateMemory);
+    connect(m_ImageData.data(), &FITSData::updateStackNoise, m_StackMonitor, &StackMonitor::updateNoise);
 
     QString noImage = ":/images/noimage.png";
     fitsWatcher.setFuture(m_ImageData->loadFromFile(noImage));
@@ -4,6 +4,8 @@
 */
 
 #include "stretch.h"
+#include "stretchkernels.h"
+#include "auxiliary/histogrammedian.h"
 
 #include <fitsio.h>
 #include <math.h>
@@ -15,16 +17,6 @@ int Stretch::m_NumPresets = 7;
 namespace
 {
 
-// Returns the median value of the vector.
-// The vector is modified in an undefined way.
-template <typename T>
-T median(std::vector<T> &values)
-{
-    const int middle = values.size() / 2;
-    std::nth_element(values.begin(), values.begin() + middle, values.end());
-    return values[middle];
-}
-
 // Returns the rough max of the buffer.
 template <typename T>
 T sampledMax(T const *values, int size, int sampleBy)
@@ -36,18 +28,6 @@ T sampledMax(T const *values, int size, int sampleBy)
     return  maxVal;
 }
 
-// Returns the median of the sample values.
-// The values are not modified.
-template <typename T>
-T median(T const *values, int size, int sampleBy)
-{
-    const int downsampled_size = size / sampleBy;
-    std::vector<T> samples(downsampled_size);
-    for (int index = 0, i = 0; i < downsampled_size; ++i, index += sampleBy)
-        samples[i] = values[index];
-    return median(samples);
-}
-
 // This stretches one channel given the input parameters.
 // Based on the spec in section 8.5.6
 // https://pixinsight.com/doc/docs/XISF-1.0-spec/XISF-1.0-spec.html
@@ -82,6 +62,10 @@ void stretchOneChannel(T *input_buffer, QImage *output_image,
     const float k1 = (midtones - 1) * hsRangeFactor * maxOutput / maxInput;
     const float k2 = ((2 * midtones) - 1) * hsRangeFactor / maxInput;
 
+    const StretchKernels::MTF mtf { static_cast<float>(nativeShadows), static_cast<float>(nativeHighlights),
+                                    midtones, k1, k2 };
+    const int outputWidth = (image_width + sampling - 1) / sampling;
+
     // Increment the input index by the sampling, the output index increments by 1.
     for (int j = 0, jout = 0; j < image_height; j += sampling, jout++)
     {
@@ -90,16 +74,13 @@ void stretchOneChannel(T *input_buffer, QImage *output_image,
             T * inputLine  = input_buffer + j * image_width;
             auto * scanLine = output_image->scanLine(jout);
 
-            for (int i = 0, iout = 0; i < image_width; i += sampling, iout++)
+            // The line is stretched in runs that fit in the L1 cache using the vectorised kernels.
+            float samples[StretchKernels::CHUNK];
+            for (int iout = 0; iout < outputWidth; iout += StretchKernels::CHUNK)
             {
-                const T input = inputLine[i];
-                if (input < nativeShadows) scanLine[iout] = 0;
-                else if (input >= nativeHighlights) scanLine[iout] = maxOutput;
-                else
-                {
-                    const T inputFloored = (input - nativeShadows);
-                    scanLine[iout] = (inputFloored * k1) / (inputFloored * k2 - midtones);
-                }
+                const int n = std::min(StretchKernels::CHUNK, outputWidth - iout);
+                const float *values = StretchKernels::toFloat(inputLine + iout * sampling, samples, n, sampling);
+                StretchKernels::mtf(values, scanLine + iout, n, mtf);
             }
         }));
     }
@@ -157,7 +138,15 @@ void stretchThreeChannels(T *inputBuffer, QImage *outputImage,
     const float k2G = ((2 * midtonesG) - 1) * hsRangeFactorG / maxInput;
     const float k2B = ((2 * midtonesB) - 1) * hsRangeFactorB / maxInput;
 
+    const StretchKernels::MTF mtfR { static_cast<float>(nativeShadowsR), static_cast<float>(nativeHighlightsR),
+                                     midtonesR, k1R, k2R };
+    const StretchKernels::MTF mtfG { static_cast<float>(nativeShadowsG), static_cast<float>(nativeHighlightsG),
+                                     midtonesG, k1G, k2G };
+    const StretchKernels::MTF mtfB { static_cast<float>(nativeShadowsB), static_cast<float>(nativeHighlightsB),
+                                     midtonesB, k1B, k2B };
+
     const int size = imageWidth * imageHeight;
+    const int outputWidth = (imageWidth + sampling - 1) / sampling;
 
     for (int j = 0, jout = 0; j < imageHeight; j += sampling, jout++)
     {
@@ -170,38 +159,17 @@ void stretchThreeChannels(T *inputBuffer, QImage *outputImage,
 
             auto * scanLine = reinterpret_cast<QRgb*>(outputImage->scanLine(jout));
 
-            for (int i = 0, iout = 0; i < imageWidth; i += sampling, iout++)
+            // Each channel is stretched into its own plane, then the planes are interleaved into the scan line.
+            float samples[StretchKernels::CHUNK];
+            uint8_t red[StretchKernels::CHUNK], green[StretchKernels::CHUNK], blue[StretchKernels::CHUNK];
+            for (int iout = 0; iout < outputWidth; iout += StretchKernels::CHUNK)
             {
-                const T inputR = inputLineR[i];
-                const T inputG = inputLineG[i];
-                const T inputB = inputLineB[i];
-
-                uint8_t red, green, blue;
-
-                if (inputR < nativeShadowsR) red = 0;
-                else if (inputR >= nativeHighlightsR) red = maxOutput;
-                else
-                {
-                    const T inputFloored = (inputR - nativeShadowsR);
-                    red = (inputFloored * k1R) / (inputFloored * k2R - midtonesR);
-                }
-
-                if (inputG < nativeShadowsG) green = 0;
-                else if (inputG >= nativeHighlightsG) green = maxOutput;
-                else
-                {
-                    const T inputFloored = (inputG - nativeShadowsG);
-                    green = (inputFloored * k1G) / (inputFloored * k2G - midtonesG);
-                }
-
-                if (inputB < nativeShadowsB) blue = 0;
-                else if (inputB >= nativeHighlightsB) blue = maxOutput;
-                else
-                {
-                    const T inputFloored = (inputB - nativeShadowsB);
-                    blue = (inputFloored * k1B) / (inputFloored * k2B - midtonesB);
-                }
-                scanLine[iout] = qRgb(red, green, blue);
+                const int n = std::min(StretchKernels::CHUNK, outputWidth - iout);
+                const int i = iout * sampling;
+                StretchKernels::mtf(StretchKernels::toFloat(inputLineR + i, samples, n, sampling), red, n, mtfR);
+                StretchKernels::mtf(StretchKernels::toFloat(inputLineG + i, samples, n, sampling), green, n, mtfG);
+                StretchKernels::mtf(StretchKernels::toFloat(inputLineB + i, samples, n, sampling), blue, n, mtfB);
+                StretchKernels::interleave(red, green, blue, scanLine + iout, n);
             }
         }));
     }
@@ -227,26 +195,12 @@ template <typename T>
 void computeParamsOneChannel(T const *buffer, StretchParams1Channel *params,
                              int inputRange, int height, int width, float B, float C)
 {
-    // Find the median sample.
-    constexpr int maxSamples = 500000;
-    const int sampleBy = width * height < maxSamples ? 1 : width * height / maxSamples;
-
-    T medianSample = median(buffer, width * height, sampleBy);
-    // Find the Median deviation: 1.4826 * median of std::abs(sample[i] - median).
-    const int numSamples = width * height / sampleBy;
-    std::vector<T> deviations(numSamples);
-    for (int index = 0, i = 0; i < numSamples; ++i, index += sampleBy)
-    {
-        if (medianSample > buffer[index])
-            deviations[i] = medianSample - buffer[index];
-        else
-            deviations[i] = buffer[index] - medianSample;
-    }
+    // Median and median deviation of every sample, from a histogram of the channel.
+    const auto stats = Mathematics::HistogramMedian::compute(buffer, static_cast<size_t>(width) * height);
 
     // Shift everything to 0 -> 1.0.
-    const float medDev = median(deviations);
-    const float normalizedMedian = medianSample / static_cast<float>(inputRange);
-    const float MADN = 1.4826 * medDev / static_cast<float>(inputRange);
+    const float normalizedMedian = stats.median / static_cast<float>(inputRange);
+    const float MADN = 1.4826 * stats.mad / static_cast<float>(inputRange);
 
     const bool upperHalf = normalizedMedian > 0.5;
 
@@ -340,7 +294,7 @@ void Stretch::run(uint8_t const *input, QImage *outputImage, int sampling)
                             input_range, image_height, image_width, image_channels, sampling);
             break;
         case TLONG:
-            stretchChannels(reinterpret_cast<long const*>(input), outputImage, params,
+            stretchChannels(reinterpret_cast<int32_t const*>(input), outputImage, params,
                             input_range, image_height, image_width, image_channels, sampling);
             break;
         case TFLOAT:
@@ -348,7 +302,7 @@ void Stretch::run(uint8_t const *input, QImage *outputImage, int sampling)
                             input_range, image_height, image_width, image_channels, sampling);
             break;
         case TLONGLONG:
-            stretchChannels(reinterpret_cast<long long const*>(input), outputImage, params,
+            stretchChannels(reinterpret_cast<int64_t const*>(input), outputImage, params,
                             input_range, image_height, image_width, image_channels, sampling);
             break;
         case TDOUBLE:
@@ -448,7 +402,7 @@ StretchParams Stretch::computeParams(uint8_t const *input, int preset)
             }
             case TLONG:
             {
-                auto buffer = reinterpret_cast<long const*>(input);
+                auto buffer = reinterpret_cast<int32_t const*>(input);
                 computeParamsOneChannel(buffer + offset, params, input_range,
                                         image_height, image_width, m_stretchB, m_stretchC);
                 break;
@@ -462,7 +416,7 @@ StretchParams Stretch::computeParams(uint8_t const *input, int preset)
             }
             case TLONGLONG:
             {
-                auto buffer = reinterpret_cast<long long const*>(input);
+                auto buffer = reinterpret_cast<int64_t const*>(input);
                 computeParamsOneChannel(buffer + offset, params, input_range,
                                         image_height, image_width, m_stretchB, m_stretchC);
                 break;
@@ -0,0 +1,623 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "stretchkernels.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define STRETCH_KERNELS_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) && !defined(__AARCH64EB__)
+#define STRETCH_KERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+// GCC and Clang need to be told which functions may use instructions beyond the build target.
+// MSVC allows intrinsics for any instruction set.
+#if defined(__GNUC__) || defined(__clang__)
+#define STRETCH_TARGET(x) __attribute__((target(x)))
+#else
+#define STRETCH_TARGET(x)
+#endif
+
+namespace StretchKernels
+{
+
+namespace
+{
+
+Isa detectIsa()
+{
+#if defined(STRETCH_KERNELS_X86)
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return Isa::AVX2;
+    if (__builtin_cpu_supports("sse4.1"))
+        return Isa::SSE41;
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    __cpuid(info, 1);
+    const bool sse41 = info[2] & (1 << 19);
+    const bool osxsave = info[2] & (1 << 27);
+    const bool avx = info[2] & (1 << 28);
+    if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6)
+    {
+        __cpuidex(info, 7, 0);
+        if (info[1] & (1 << 5))
+            return Isa::AVX2;
+    }
+    if (sse41)
+        return Isa::SSE41;
+#endif
+    return Isa::SCALAR;
+#elif defined(STRETCH_KERNELS_NEON)
+    // NEON is mandatory on aarch64
+    return Isa::NEON;
+#else
+    return Isa::SCALAR;
+#endif
+}
+
+std::atomic<Isa> &activeIsa()
+{
+    static std::atomic<Isa> active { bestIsa() };
+    return active;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// Scalar
+////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+void toFloatScalar(const T *input, float *output, int n)
+{
+    for (int i = 0; i < n; i++)
+        output[i] = static_cast<float>(input[i]);
+}
+
+void mtfScalar(const float *input, uint8_t *output, int n, const MTF &p)
+{
+    for (int i = 0; i < n; i++)
+    {
+        const float x = input[i];
+        if (x < p.shadows)
+            output[i] = 0;
+        else if (x >= p.highlights)
+            output[i] = 255;
+        else
+        {
+            const float floored = x - p.shadows;
+            const float value = (floored * p.k1) / (floored * p.k2 - p.midtones);
+            // Written so that a NaN (e.g. midtones of 0) gives 0
+            output[i] = static_cast<uint8_t>(value > 0.0f ? std::min(value, 255.0f) : 0.0f);
+        }
+    }
+}
+
+void interleaveScalar(const uint8_t *red, const uint8_t *green, const uint8_t *blue, uint32_t *output, int n)
+{
+    for (int i = 0; i < n; i++)
+        output[i] = 0xff000000u | (uint32_t(red[i]) << 16) | (uint32_t(green[i]) << 8) | blue[i];
+}
+
+void histogramBinsScalar(const double *input, int32_t *bins, int n, double min, double binWidth, int32_t maxBin)
+{
+    for (int i = 0; i < n; i++)
+    {
+        const double bin = std::rint((input[i] - min) / binWidth);
+        bins[i] = bin > 0 ? static_cast<int32_t>(std::min(bin, static_cast<double>(maxBin))) : 0;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// x86 SSE4.1 and AVX2
+////////////////////////////////////////////////////////////////////////////////////////////
+
+#if defined(STRETCH_KERNELS_X86)
+
+STRETCH_TARGET("sse4.1")
+void toFloatSSE41(const uint8_t *input, float *output, int n)
+{
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        int32_t packed;
+        memcpy(&packed, input + i, sizeof(packed));
+        _mm_storeu_ps(output + i, _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed))));
+    }
+    toFloatScalar(input + i, output + i, n - i);
+}
+
+STRETCH_TARGET("sse4.1")
+void toFloatSSE41(const int16_t *input, float *output, int n)
+{
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        const __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(input + i));
+        _mm_storeu_ps(output + i, _mm_cvtepi32_ps(_mm_cvtepi16_epi32(v)));
+    }
+    toFloatScalar(input + i, output + i, n - i);
+}
+
+STRETCH_TARGET("sse4.1")
+void toFloatSSE41(const uint16_t *input, float *output, int n)
+{
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        const __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(input + i));
+        _mm_storeu_ps(output + i, _mm_cvtepi32_ps(_mm_cvtepu16_epi32(v)));
+    }
+    toFloatScalar(input + i, output + i, n - i);
+}
+
+STRETCH_TARGET("avx2")
+void toFloatAVX2(const uint8_t *input, float *output, int n)
+{
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(input + i));
+        _mm256_storeu_ps(output + i, _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(v)));
+    }
+    toFloatScalar(input + i, output + i, n - i);
+}
+
+STRETCH_TARGET("avx2")
+void toFloatAVX2(const int16_t *input, float *output, int n)
+{
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+        _mm256_storeu_ps(output + i, _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(v)));
+    }
+    toFloatScalar(input + i, output + i, n - i);
+}
+
+STRETCH_TARGET("avx2")
+void toFloatAVX2(const uint16_t *input, float *output, int n)
+{
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+        _mm256_storeu_ps(output + i, _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(v)));
+    }
+    toFloatScalar(input + i, output + i, n - i);
+}
+
+STRETCH_TARGET("sse4.1")
+void mtfSSE41(const float *input, uint8_t *output, int n, const MTF &p)
+{
+    const __m128 shadows = _mm_set1_ps(p.shadows);
+    const __m128 highlights = _mm_set1_ps(p.highlights);
+    const __m128 midtones = _mm_set1_ps(p.midtones);
+    const __m128 k1 = _mm_set1_ps(p.k1);
+    const __m128 k2 = _mm_set1_ps(p.k2);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 maxOutput = _mm_set1_ps(255.0f);
+
+    int i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        __m128i q[4];
+        for (int k = 0; k < 4; k++)
+        {
+            const __m128 x = _mm_loadu_ps(input + i + 4 * k);
+            const __m128 floored = _mm_sub_ps(x, shadows);
+            __m128 v = _mm_div_ps(_mm_mul_ps(floored, k1), _mm_sub_ps(_mm_mul_ps(floored, k2), midtones));
+            // max returns its second operand for NaN, so NaN gives 0 as in the scalar code
+            v = _mm_min_ps(_mm_max_ps(v, zero), maxOutput);
+            v = _mm_blendv_ps(v, maxOutput, _mm_cmpge_ps(x, highlights));
+            v = _mm_andnot_ps(_mm_cmplt_ps(x, shadows), v);
+            q[k] = _mm_cvttps_epi32(v);
+        }
+        const __m128i low = _mm_packus_epi32(q[0], q[1]);
+        const __m128i high = _mm_packus_epi32(q[2], q[3]);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i), _mm_packus_epi16(low, high));
+    }
+    mtfScalar(input + i, output + i, n - i, p);
+}
+
+STRETCH_TARGET("avx2")
+void mtfAVX2(const float *input, uint8_t *output, int n, const MTF &p)
+{
+    const __m256 shadows = _mm256_set1_ps(p.shadows);
+    const __m256 highlights = _mm256_set1_ps(p.highlights);
+    const __m256 midtones = _mm256_set1_ps(p.midtones);
+    const __m256 k1 = _mm256_set1_ps(p.k1);
+    const __m256 k2 = _mm256_set1_ps(p.k2);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 maxOutput = _mm256_set1_ps(255.0f);
+    // The packs below work within 128 bit lanes, this puts the 32 bit groups back in order
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    int i = 0;
+    for (; i + 32 <= n; i += 32)
+    {
+        __m256i q[4];
+        for (int k = 0; k < 4; k++)
+        {
+            const __m256 x = _mm256_loadu_ps(input + i + 8 * k);
+            const __m256 floored = _mm256_sub_ps(x, shadows);
+            __m256 v = _mm256_div_ps(_mm256_mul_ps(floored, k1), _mm256_sub_ps(_mm256_mul_ps(floored, k2), midtones));
+            v = _mm256_min_ps(_mm256_max_ps(v, zero), maxOutput);
+            v = _mm256_blendv_ps(v, maxOutput, _mm256_cmp_ps(x, highlights, _CMP_GE_OQ));
+            v = _mm256_andnot_ps(_mm256_cmp_ps(x, shadows, _CMP_LT_OQ), v);
+            q[k] = _mm256_cvttps_epi32(v);
+        }
+        const __m256i low = _mm256_packus_epi32(q[0], q[1]);
+        const __m256i high = _mm256_packus_epi32(q[2], q[3]);
+        const __m256i bytes = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(low, high), order);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(output + i), bytes);
+    }
+    mtfSSE41(input + i, output + i, n - i, p);
+}
+
+// QRgb is 0xAARRGGBB, i.e. B, G, R, A in memory on x86.
+STRETCH_TARGET("sse4.1")
+void interleaveSSE41(const uint8_t *red, const uint8_t *green, const uint8_t *blue, uint32_t *output, int n)
+{
+    const __m128i alpha = _mm_set1_epi8(static_cast<char>(0xff));
+    int i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        const __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i *>(red + i));
+        const __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i *>(green + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(blue + i));
+        const __m128i bgLow = _mm_unpacklo_epi8(b, g);
+        const __m128i bgHigh = _mm_unpackhi_epi8(b, g);
+        const __m128i raLow = _mm_unpacklo_epi8(r, alpha);
+        const __m128i raHigh = _mm_unpackhi_epi8(r, alpha);
+        __m128i *out = reinterpret_cast<__m128i *>(output + i);
+        _mm_storeu_si128(out, _mm_unpacklo_epi16(bgLow, raLow));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(bgLow, raLow));
+        _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(bgHigh, raHigh));
+        _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(bgHigh, raHigh));
+    }
+    interleaveScalar(red + i, green + i, blue + i, output + i, n - i);
+}
+
+STRETCH_TARGET("avx2")
+void interleaveAVX2(const uint8_t *red, const uint8_t *green, const uint8_t *blue, uint32_t *output, int n)
+{
+    const __m256i alpha = _mm256_set1_epi8(static_cast<char>(0xff));
+    int i = 0;
+    for (; i + 32 <= n; i += 32)
+    {
+        const __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(red + i));
+        const __m256i g = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(green + i));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(blue + i));
+        // Unpacks work within 128 bit lanes: pixels 0-7 and 16-23 end up in bgLow, 8-15 and 24-31 in bgHigh.
+        const __m256i bgLow = _mm256_unpacklo_epi8(b, g);
+        const __m256i bgHigh = _mm256_unpackhi_epi8(b, g);
+        const __m256i raLow = _mm256_unpacklo_epi8(r, alpha);
+        const __m256i raHigh = _mm256_unpackhi_epi8(r, alpha);
+        const __m256i p0 = _mm256_unpacklo_epi16(bgLow, raLow);   // 0-3, 16-19
+        const __m256i p1 = _mm256_unpackhi_epi16(bgLow, raLow);   // 4-7, 20-23
+        const __m256i p2 = _mm256_unpacklo_epi16(bgHigh, raHigh); // 8-11, 24-27
+        const __m256i p3 = _mm256_unpackhi_epi16(bgHigh, raHigh); // 12-15, 28-31
+        __m256i *out = reinterpret_cast<__m256i *>(output + i);
+        _mm256_storeu_si256(out, _mm256_permute2x128_si256(p0, p1, 0x20));
+        _mm256_storeu_si256(out + 1, _mm256_permute2x128_si256(p2, p3, 0x20));
+        _mm256_storeu_si256(out + 2, _mm256_permute2x128_si256(p0, p1, 0x31));
+        _mm256_storeu_si256(out + 3, _mm256_permute2x128_si256(p2, p3, 0x31));
+    }
+    interleaveSSE41(red + i, green + i, blue + i, output + i, n - i);
+}
+
+STRETCH_TARGET("sse4.1")
+void histogramBinsSSE41(const double *input, int32_t *bins, int n, double min, double binWidth, int32_t maxBin)
+{
+    const __m128d minimum = _mm_set1_pd(min);
+    const __m128d width = _mm_set1_pd(binWidth);
+    const __m128d top = _mm_set1_pd(maxBin);
+    const __m128d zero = _mm_setzero_pd();
+
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i q[2];
+        for (int k = 0; k < 2; k++)
+        {
+            __m128d v = _mm_div_pd(_mm_sub_pd(_mm_loadu_pd(input + i + 2 * k), minimum), width);
+            // min keeps a NaN (second operand), max then replaces it with 0
+            v = _mm_max_pd(_mm_min_pd(top, v), zero);
+            // Rounds to nearest even like rint()
+            q[k] = _mm_cvtpd_epi32(v);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(bins + i), _mm_unpacklo_epi64(q[0], q[1]));
+    }
+    histogramBinsScalar(input + i, bins + i, n - i, min, binWidth, maxBin);
+}
+
+STRETCH_TARGET("avx2")
+void histogramBinsAVX2(const double *input, int32_t *bins, int n, double min, double binWidth, int32_t maxBin)
+{
+    const __m256d minimum = _mm256_set1_pd(min);
+    const __m256d width = _mm256_set1_pd(binWidth);
+    const __m256d top = _mm256_set1_pd(maxBin);
+    const __m256d zero = _mm256_setzero_pd();
+
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m128i q[2];
+        for (int k = 0; k < 2; k++)
+        {
+            __m256d v = _mm256_div_pd(_mm256_sub_pd(_mm256_loadu_pd(input + i + 4 * k), minimum), width);
+            v = _mm256_max_pd(_mm256_min_pd(top, v), zero);
+            q[k] = _mm256_cvtpd_epi32(v);
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(bins + i), _mm256_inserti128_si256(_mm256_castsi128_si256(q[0]), q[1], 1));
+    }
+    histogramBinsSSE41(input + i, bins + i, n - i, min, binWidth, maxBin);
+}
+
+#endif // STRETCH_KERNELS_X86
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// aarch64 NEON
+////////////////////////////////////////////////////////////////////////////////////////////
+
+#if defined(STRETCH_KERNELS_NEON)
+
+void toFloatNEON(const uint8_t *input, float *output, int n)
+{
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        const uint16x8_t v = vmovl_u8(vld1_u8(input + i));
+        vst1q_f32(output + i, vcvtq_f32_u32(vmovl_u16(vget_low_u16(v))));
+        vst1q_f32(output + i + 4, vcvtq_f32_u32(vmovl_u16(vget_high_u16(v))));
+    }
+    toFloatScalar(input + i, output + i, n - i);
+}
+
+void toFloatNEON(const int16_t *input, float *output, int n)
+{
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+        vst1q_f32(output + i, vcvtq_f32_s32(vmovl_s16(vld1_s16(input + i))));
+    toFloatScalar(input + i, output + i, n - i);
+}
+
+void toFloatNEON(const uint16_t *input, float *output, int n)
+{
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+        vst1q_f32(output + i, vcvtq_f32_u32(vmovl_u16(vld1_u16(input + i))));
+    toFloatScalar(input + i, output + i, n - i);
+}
+
+void mtfNEON(const float *input, uint8_t *output, int n, const MTF &p)
+{
+    const float32x4_t shadows = vdupq_n_f32(p.shadows);
+    const float32x4_t highlights = vdupq_n_f32(p.highlights);
+    const float32x4_t midtones = vdupq_n_f32(p.midtones);
+    const float32x4_t k1 = vdupq_n_f32(p.k1);
+    const float32x4_t k2 = vdupq_n_f32(p.k2);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t maxOutput = vdupq_n_f32(255.0f);
+
+    int i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        uint16x4_t q[4];
+        for (int k = 0; k < 4; k++)
+        {
+            const float32x4_t x = vld1q_f32(input + i + 4 * k);
+            const float32x4_t floored = vsubq_f32(x, shadows);
+            float32x4_t v = vdivq_f32(vmulq_f32(floored, k1), vsubq_f32(vmulq_f32(floored, k2), midtones));
+            // maxnm ignores a NaN, so NaN gives 0 as in the scalar code
+            v = vminq_f32(vmaxnmq_f32(v, zero), maxOutput);
+            v = vbslq_f32(vcgeq_f32(x, highlights), maxOutput, v);
+            v = vbslq_f32(vcltq_f32(x, shadows), zero, v);
+            q[k] = vmovn_u32(vcvtq_u32_f32(v));
+        }
+        const uint8x8_t low = vmovn_u16(vcombine_u16(q[0], q[1]));
+        const uint8x8_t high = vmovn_u16(vcombine_u16(q[2], q[3]));
+        vst1q_u8(output + i, vcombine_u8(low, high));
+    }
+    mtfScalar(input + i, output + i, n - i, p);
+}
+
+void interleaveNEON(const uint8_t *red, const uint8_t *green, const uint8_t *blue, uint32_t *output, int n)
+{
+    int i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        uint8x16x4_t bgra;
+        bgra.val[0] = vld1q_u8(blue + i);
+        bgra.val[1] = vld1q_u8(green + i);
+        bgra.val[2] = vld1q_u8(red + i);
+        bgra.val[3] = vdupq_n_u8(0xff);
+        vst4q_u8(reinterpret_cast<uint8_t *>(output + i), bgra);
+    }
+    interleaveScalar(red + i, green + i, blue + i, output + i, n - i);
+}
+
+void histogramBinsNEON(const double *input, int32_t *bins, int n, double min, double binWidth, int32_t maxBin)
+{
+    const float64x2_t minimum = vdupq_n_f64(min);
+    const float64x2_t width = vdupq_n_f64(binWidth);
+    const float64x2_t top = vdupq_n_f64(maxBin);
+    const float64x2_t zero = vdupq_n_f64(0.0);
+
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        int32x2_t q[2];
+        for (int k = 0; k < 2; k++)
+        {
+            float64x2_t v = vdivq_f64(vsubq_f64(vld1q_f64(input + i + 2 * k), minimum), width);
+            const uint64x2_t isNumber = vceqq_f64(v, v);
+            v = vmaxq_f64(vminq_f64(v, top), zero);
+            v = vbslq_f64(isNumber, v, zero);
+            // Rounds to nearest even like rint()
+            q[k] = vmovn_s64(vcvtnq_s64_f64(v));
+        }
+        vst1q_s32(bins + i, vcombine_s32(q[0], q[1]));
+    }
+    histogramBinsScalar(input + i, bins + i, n - i, min, binWidth, maxBin);
+}
+
+#endif // STRETCH_KERNELS_NEON
+
+template <typename T>
+void toFloatDispatch(const T *input, float *output, int n)
+{
+    switch (isa())
+    {
+#if defined(STRETCH_KERNELS_X86)
+        case Isa::AVX2:
+            toFloatAVX2(input, output, n);
+            return;
+        case Isa::SSE41:
+            toFloatSSE41(input, output, n);
+            return;
+#elif defined(STRETCH_KERNELS_NEON)
+        case Isa::NEON:
+            toFloatNEON(input, output, n);
+            return;
+#endif
+        default:
+            toFloatScalar(input, output, n);
+            return;
+    }
+}
+
+} // namespace
+
+Isa bestIsa()
+{
+    static const Isa best = detectIsa();
+    return best;
+}
+
+Isa isa()
+{
+    return activeIsa().load(std::memory_order_relaxed);
+}
+
+void setIsa(Isa isa)
+{
+    const Isa best = bestIsa();
+    bool supported = (isa == Isa::SCALAR || isa == best);
+    // AVX2 CPUs also support SSE4.1
+    if (isa == Isa::SSE41 && best == Isa::AVX2)
+        supported = true;
+    activeIsa().store(supported ? isa : Isa::SCALAR);
+}
+
+const char *isaName(Isa isa)
+{
+    switch (isa)
+    {
+        case Isa::SSE41:
+            return "SSE4.1";
+        case Isa::AVX2:
+            return "AVX2";
+        case Isa::NEON:
+            return "NEON";
+        default:
+            return "Scalar";
+    }
+}
+
+void toFloat(const uint8_t *input, float *output, int n)
+{
+    toFloatDispatch(input, output, n);
+}
+
+void toFloat(const int16_t *input, float *output, int n)
+{
+    toFloatDispatch(input, output, n);
+}
+
+void toFloat(const uint16_t *input, float *output, int n)
+{
+    toFloatDispatch(input, output, n);
+}
+
+void mtf(const float *input, uint8_t *output, int n, const MTF &params)
+{
+    switch (isa())
+    {
+#if defined(STRETCH_KERNELS_X86)
+        case Isa::AVX2:
+            mtfAVX2(input, output, n, params);
+            return;
+        case Isa::SSE41:
+            mtfSSE41(input, output, n, params);
+            return;
+#elif defined(STRETCH_KERNELS_NEON)
+        case Isa::NEON:
+            mtfNEON(input, output, n, params);
+            return;
+#endif
+        default:
+            mtfScalar(input, output, n, params);
+            return;
+    }
+}
+
+void interleave(const uint8_t *red, const uint8_t *green, const uint8_t *blue, uint32_t *output, int n)
+{
+    switch (isa())
+    {
+#if defined(STRETCH_KERNELS_X86)
+        case Isa::AVX2:
+            interleaveAVX2(red, green, blue, output, n);
+            return;
+        case Isa::SSE41:
+            interleaveSSE41(red, green, blue, output, n);
+            return;
+#elif defined(STRETCH_KERNELS_NEON)
+        case Isa::NEON:
+            interleaveNEON(red, green, blue, output, n);
+            return;
+#endif
+        default:
+            interleaveScalar(red, green, blue, output, n);
+            return;
+    }
+}
+
+void histogramBins(const double *input, int32_t *bins, int n, double min, double binWidth, int32_t maxBin)
+{
+    switch (isa())
+    {
+#if defined(STRETCH_KERNELS_X86)
+        case Isa::AVX2:
+            histogramBinsAVX2(input, bins, n, min, binWidth, maxBin);
+            return;
+        case Isa::SSE41:
+            histogramBinsSSE41(input, bins, n, min, binWidth, maxBin);
+            return;
+#elif defined(STRETCH_KERNELS_NEON)
+        case Isa::NEON:
+            histogramBinsNEON(input, bins, n, min, binWidth, maxBin);
+            return;
+#endif
+        default:
+            histogramBinsScalar(input, bins, n, min, binWidth, maxBin);
+            return;
+    }
+}
+
+} // namespace StretchKernels
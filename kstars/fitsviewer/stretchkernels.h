@@ -0,0 +1,145 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Vectorised pixel kernels used to display FITS images.
+ *
+ * Each kernel has a scalar implementation and SSE4.1, AVX2 (x86) or NEON (aarch64)
+ * implementations. The best instruction set supported by the CPU is selected at runtime,
+ * so the binary does not need to be built for a particular CPU.
+ *
+ * The kernels work on short runs of pixels (at most CHUNK) so that intermediate buffers
+ * can live on the stack and stay in the L1 cache. Callers are expected to split rows into
+ * runs and to do their own threading.
+ */
+namespace StretchKernels
+{
+
+enum class Isa
+{
+    SCALAR,
+    SSE41,
+    AVX2,
+    NEON
+};
+
+// Best instruction set supported by this CPU
+Isa bestIsa();
+
+// Instruction set currently used by the kernels
+Isa isa();
+
+// Override the instruction set, e.g. to benchmark against the scalar code.
+// Requests for an instruction set the CPU does not support fall back to the scalar code.
+void setIsa(Isa isa);
+
+const char *isaName(Isa isa);
+
+// Maximum number of pixels handled per kernel call
+constexpr int CHUNK = 512;
+
+// Midtones transfer function constants, in the native units of the input data.
+// See Stretch for how these are derived.
+struct MTF
+{
+    float shadows;
+    float highlights;
+    float midtones;
+    float k1;
+    float k2;
+};
+
+// Widen contiguous integer samples to float
+void toFloat(const uint8_t *input, float *output, int n);
+void toFloat(const int16_t *input, float *output, int n);
+void toFloat(const uint16_t *input, float *output, int n);
+
+/**
+ * @brief toFloat Reads n samples, taking every stride'th sample from input.
+ * @param buffer scratch space for at least n floats
+ * @return the converted samples, either in buffer or input itself when no conversion is needed
+ */
+template <typename T>
+const float *toFloat(const T *input, float *buffer, int n, int stride)
+{
+    if (stride == 1)
+    {
+        if constexpr (std::is_same<T, float>::value)
+            return input;
+        if constexpr (std::is_same<T, uint8_t>::value || std::is_same<T, int16_t>::value
+                      || std::is_same<T, uint16_t>::value)
+        {
+            toFloat(input, buffer, n);
+            return buffer;
+        }
+    }
+    for (int i = 0, index = 0; i < n; i++, index += stride)
+        buffer[i] = static_cast<float>(input[index]);
+    return buffer;
+}
+
+/**
+ * @brief mtf Applies the midtones transfer function to n samples giving 0-255 output.
+ * Samples below the shadows map to 0, samples at or above the highlights map to 255.
+ */
+void mtf(const float *input, uint8_t *output, int n, const MTF &params);
+
+/**
+ * @brief interleave Combines separate red, green and blue planes into n opaque QRgb pixels.
+ */
+void interleave(const uint8_t *red, const uint8_t *green, const uint8_t *blue, uint32_t *output, int n);
+
+/**
+ * @brief histogramBins Computes the histogram bin of n samples,
+ * i.e. rint((sample - min) / binWidth) clamped to [0, maxBin]. NaNs go into bin 0.
+ */
+void histogramBins(const double *input, int32_t *bins, int n, double min, double binWidth, int32_t maxBin);
+
+/**
+ * @brief histogram Adds count samples, taking every stride'th sample from input,
+ * to frequency which must have maxBin + 1 entries.
+ */
+template <typename T>
+void histogram(const T *input, uint32_t count, uint32_t stride, double min, double binWidth, int32_t maxBin,
+               uint32_t *frequency)
+{
+    // Several partial histograms so that runs of equal bins don't serialise on one counter
+    constexpr int PARTIALS = 4;
+    const int size = maxBin + 1;
+    std::vector<uint32_t> partial(PARTIALS * size, 0);
+
+    double values[CHUNK];
+    int32_t bins[CHUNK];
+    for (uint32_t start = 0; start < count; start += CHUNK)
+    {
+        const int n = static_cast<int>(std::min<uint32_t>(CHUNK, count - start));
+        const T *samples = input + static_cast<size_t>(start) * stride;
+        for (int i = 0; i < n; i++)
+            values[i] = static_cast<double>(samples[static_cast<size_t>(i) * stride]);
+
+        histogramBins(values, bins, n, min, binWidth, maxBin);
+
+        int i = 0;
+        for (; i + PARTIALS <= n; i += PARTIALS)
+            for (int p = 0; p < PARTIALS; p++)
+                partial[p * size + bins[i + p]]++;
+        for (; i < n; i++)
+            partial[bins[i]]++;
+    }
+
+    for (int p = 0; p < PARTIALS; p++)
+        for (int bin = 0; bin < size; bin++)
+            frequency[bin] += partial[p * size + bin];
+}
+
+} // namespace StretchKernels
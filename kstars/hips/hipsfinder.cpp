@@ -193,9 +193,13 @@ bool HIPSFinder::renderPix(int level, int pix, QImage *destinationImage)
 
     m_HEALpix->getCornerPoints(level, pix, cornerSkyCoords);
 
+    const SkyPoint *cornerPoints[4] = { &cornerSkyCoords[0], &cornerSkyCoords[1], &cornerSkyCoords[2], &cornerSkyCoords[3] };
+    Eigen::Vector2f cornerScreen[4];
+    bool cornerVisible[4];
+    m_Projector->toScreenBatch(cornerPoints, 4, cornerScreen, cornerVisible);
     for (int i = 0; i < 4; i++)
     {
-        cornerScreenCoords[i] = m_Projector->toScreen(&cornerSkyCoords[i]);
+        cornerScreenCoords[i] = QPointF(cornerScreen[i].x(), cornerScreen[i].y());
         isVisible |= m_Projector->checkVisibility(&cornerSkyCoords[i]);
     }
 
@@ -236,6 +240,8 @@ bool HIPSFinder::renderPix(int level, int pix, QImage *destinationImage)
             // Find all the 4 children of the current pixel
             m_HEALpix->getPixChilds(pix, childPixelID);
 
+            // The corners of all the grandchildren, projected together below
+            SkyPoint fineSkyPoints[16][4];
             int j = 0;
             for (int id : childPixelID)
             {
@@ -247,19 +253,23 @@ bool HIPSFinder::renderPix(int level, int pix, QImage *destinationImage)
                 // system.
                 m_HEALpix->getPixChilds(id, grandChildPixelID);
 
-                QPointF fineScreenCoords[4];
-
                 for (int id2 : grandChildPixelID)
-                {
-                    SkyPoint fineSkyPoints[4];
-                    m_HEALpix->getCornerPoints(level + 2, id2, fineSkyPoints);
+                    m_HEALpix->getCornerPoints(level + 2, id2, fineSkyPoints[j++]);
+            }
 
-                    for (int i = 0; i < 4; i++)
-                        fineScreenCoords[i] = m_Projector->toScreen(&fineSkyPoints[i]);
+            const SkyPoint *finePoints[64];
+            for (int i = 0; i < 64; i++)
+                finePoints[i] = &fineSkyPoints[i / 4][i % 4];
+            Eigen::Vector2f fineScreen[64];
+            bool fineVisible[64];
+            m_Projector->toScreenBatch(finePoints, 64, fineScreen, fineVisible);
 
-                    m_ScanRender->renderPolygon(3, fineScreenCoords, destinationImage, &sourceImage, uv[j]);
-                    j++;
-                }
+            for (j = 0; j < 16; j++)
+            {
+                QPointF fineScreenCoords[4];
+                for (int i = 0; i < 4; i++)
+                    fineScreenCoords[i] = QPointF(fineScreen[4 * j + i].x(), fineScreen[4 * j + i].y());
+                m_ScanRender->renderPolygon(3, fineScreenCoords, destinationImage, &sourceImage, uv[j]);
             }
 
             return true;
@@ -22,6 +22,8 @@
 #include <QHash>
 #include <QNetworkDiskCache>
 #include <QPainter>
+#include <QThread>
+#include <QtConcurrent>
 
 static QNetworkDiskCache *g_discCache = nullptr;
 static UrlFileDownload *g_download = nullptr;
@@ -79,7 +81,11 @@ HIPSManager::HIPSManager() : QObject(KStars::Instance())
     value = Options::hIPSMemoryCache() * 1024 * 1024;
     m_cache.setMaxCost(Options::hIPSMemoryCache() * 1024 * 1024);
 
-
+    // While the store is open the tiles are only kept there, see openStore(), so it has the whole disk budget
+    m_store.setMaxSize(static_cast<qint64>(Options::hIPSNetCache()) * 1024 * 1024);
+    m_store.setKeepDecoded(Options::hIPSStoreDecoded());
+    // Reading the pack is serialized, decoding isn't
+    m_storeReaders.setMaxThreadCount(std::max(2, QThread::idealThreadCount() / 2));
 
 }
 
@@ -112,6 +118,9 @@ void HIPSManager::showSettings()
 
 void HIPSManager::slotApply()
 {
+    m_store.setMaxSize(static_cast<qint64>(Options::hIPSNetCache()) * 1024 * 1024);
+    m_store.setKeepDecoded(Options::hIPSStoreDecoded());
+
     if (Options::hIPSUseOfflineSource())
     {
         QDir hipsDirectory(Options::hIPSOfflinePath());
@@ -222,6 +231,13 @@ QImage *HIPSManager::getPix(bool allsky, int level, int pix, bool &freeImage)
         return cacheImage;
     }
 
+    // Tiles kept from earlier are read and decoded in the background, like downloads
+    if (m_store.contains(key))
+    {
+        readFromStore(key);
+        return nullptr;
+    }
+
     QString path;
 
     if (!allsky)
@@ -238,7 +254,8 @@ QImage *HIPSManager::getPix(bool allsky, int level, int pix, bool &freeImage)
 
     QUrl downloadURL(m_currentURL);
     downloadURL.setPath(downloadURL.path() + path);
-    g_download->begin(downloadURL, key);
+    // The store keeps the tile, no need for a second copy in the disk cache
+    g_download->begin(downloadURL, key, !m_store.isOpen());
     m_downloadMap.insert(key);
 
     return nullptr;
@@ -342,6 +359,7 @@ void HIPSManager::cancelAll()
 void HIPSManager::clearDiscCache()
 {
     g_discCache->clear();
+    m_store.clear();
 }
 
 void HIPSManager::slotDone(QNetworkReply::NetworkError error, QByteArray &data, pixCacheKey_t &key)
@@ -350,20 +368,25 @@ void HIPSManager::slotDone(QNetworkReply::NetworkError error, QByteArray &data,
     {
         m_downloadMap.remove(key);
 
-        auto *item = new pixCacheItem_t;
-
-        item->image = new QImage();
-        if (item->image->loadFromData(data))
+        const QImage image = m_store.decode(data);
+        if (!image.isNull())
         {
+            m_store.write(key, data, image);
+
+            auto *item = new pixCacheItem_t;
+            item->image = new QImage(image);
             addToMemoryCache(key, item);
 
             //SkyMap::Instance()->forceUpdate();
         }
         else
         {
-            delete item;
             qCWarning(KSTARS) << "no image. Data size: " << data.length();
         }
+
+        // Keep the index of the store up to date once the view is complete
+        if (m_downloadMap.isEmpty())
+            m_store.flush();
     }
     else
     {
@@ -392,6 +415,66 @@ PixCache *HIPSManager::getCache()
     return &m_cache;
 }
 
+HIPSTileStore *HIPSManager::getStore()
+{
+    return &m_store;
+}
+
+void HIPSManager::openStore()
+{
+    if (m_store.isOpen() && m_store.uid() == m_uid)
+        return;
+
+    const QString directory = QDir(KSPaths::writableLocation(QStandardPaths::CacheLocation)).filePath("hips_tiles");
+    if (!m_store.open(directory, m_uid))
+        return;
+
+    // Tiles downloaded before the store was used, or while it couldn't be opened, are in the disk cache,
+    // which only holds tiles. Drop them so that the tiles don't take the disk budget twice.
+    if (g_discCache->cacheSize() > 0)
+        g_discCache->clear();
+
+    // The tiles used last are most likely those of the view KStars starts with. Load them again in
+    // the background, up to half of the memory cache.
+    const qint64 tileBytes = 4LL * m_currentTileWidth * m_currentTileWidth;
+    if (tileBytes <= 0)
+        return;
+    const int count = static_cast<qint64>(Options::hIPSMemoryCache()) * 1024 * 1024 / 2 / tileBytes;
+    for (const auto &key : m_store.recentTiles(count))
+        readFromStore(key);
+}
+
+void HIPSManager::readFromStore(const pixCacheKey_t &key)
+{
+    m_downloadMap.insert(key);
+    m_storeReads++;
+    (void)QtConcurrent::run(&m_storeReaders, [this, key]()
+    {
+        const QImage image = m_store.read(key);
+        QMetaObject::invokeMethod(this, [this, key, image]()
+        {
+            storeRead(key, image);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void HIPSManager::storeRead(pixCacheKey_t key, const QImage &image)
+{
+    m_downloadMap.remove(key);
+    m_storeReads--;
+
+    // A tile that couldn't be read was dropped from the store and will be downloaded again
+    if (!image.isNull() && getCacheItem(key) == nullptr)
+    {
+        auto *item = new pixCacheItem_t;
+        item->image = new QImage(image);
+        addToMemoryCache(key, item);
+    }
+
+    if (m_storeReads == 0)
+        Q_EMIT sigRepaint();
+}
+
 void HIPSManager::addToMemoryCache(pixCacheKey_t &key, pixCacheItem_t *item)
 {
     Q_ASSERT(item);
@@ -420,6 +503,7 @@ bool HIPSManager::setCurrentSource(const QString &title)
         m_currentOrder = 0;
         m_currentTileWidth = 0;
         m_uid = 0;
+        m_store.close();
         return true;
     }
     // Offline DSS
@@ -432,6 +516,7 @@ bool HIPSManager::setCurrentSource(const QString &title)
         m_currentURL.setScheme("file");
         m_currentOrder = m_OfflineLevelsMap.lastKey();
         m_uid = qHash(m_currentURL);
+        openStore();
         Options::setShowHIPS(true);
         // N.B. Only DSS Colored catalog is supported for offline source
         Options::setHIPSSource("DSS Colored");
@@ -466,6 +551,7 @@ bool HIPSManager::setCurrentSource(const QString &title)
 
             m_currentURL = QUrl(source.value("hips_service_url"));
             m_uid = qHash(m_currentURL);
+            openStore();
 
             Options::setHIPSSource(title);
             Options::setShowHIPS(true);
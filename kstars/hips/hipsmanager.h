@@ -9,11 +9,13 @@
 #pragma once
 
 #include "hips.h"
+#include "hipstilestore.h"
 #include "opships.h"
 #include "pixcache.h"
 #include "urlfiledownload.h"
 
 #include <QObject>
+#include <QThreadPool>
 
 #include <memory>
 
@@ -70,6 +72,7 @@ class HIPSManager : public QObject
         int getUsableLevel(int level) const;
         int getUsableOfflineLevel(int level) const;
         PixCache *getCache();
+        HIPSTileStore *getStore();
         qint64 getDiscCacheSize() const;
         const QString &getCurrentFormat() const
         {
@@ -121,6 +124,14 @@ class HIPSManager : public QObject
         void addToMemoryCache(pixCacheKey_t &key, pixCacheItem_t *item);
         pixCacheItem_t *getCacheItem(pixCacheKey_t &key);
 
+        // Tiles of the current source kept on disk across sessions
+        HIPSTileStore m_store;
+        int m_storeReads { 0 };
+
+        void openStore();
+        void readFromStore(const pixCacheKey_t &key);
+        void storeRead(pixCacheKey_t key, const QImage &image);
+
         // List of all sources in the database
         QList<QMap<QString, QString>> m_hipsSources;
 
@@ -139,4 +150,7 @@ class HIPSManager : public QObject
         uint16_t m_currentTileWidth { 0 };
         QUrl m_currentURL;
         QMap<int, int> m_OfflineLevelsMap;
+
+        // Reads and decodes the stored tiles, destroyed first so that no read outlives the store
+        QThreadPool m_storeReaders;
 };
@@ -15,6 +15,13 @@
 #include "skyqpainter.h"
 #include "projections/projector.h"
 
+#include <QThread>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
 HIPSRenderer::HIPSRenderer()
 {
     m_scanRender.reset(new ScanRender());
@@ -97,6 +104,7 @@ bool HIPSRenderer::render(uint16_t w, uint16_t h, QImage *hipsImage, const Proje
             && (size >= HIPSManager::Instance()->getCurrentTileWidth() || allSky));
 
     renderRec(allSky, level, centerPix, hipsImage);
+    rasterize(hipsImage);
 
     m_scanRender->setBilinearInterpolationEnabled(old);
 
@@ -127,16 +135,24 @@ void HIPSRenderer::renderRec(bool allsky, int level, int pix, QImage *pDest)
 
 bool HIPSRenderer::renderPix(bool allsky, int level, int pix, QImage *pDest)
 {
+    Q_UNUSED(pDest)
     SkyPoint cornerSkyCoords[4];
-    QPointF cornerScreenCoords[4];
     bool freeImage = false;
 
     m_HEALpix->getCornerPoints(level, pix, cornerSkyCoords);
     bool isVisible = false;
 
+    PendingPix tile;
+    tile.pix   = pix;
+    tile.level = level;
+
+    const SkyPoint *cornerPoints[4] = { &cornerSkyCoords[0], &cornerSkyCoords[1], &cornerSkyCoords[2], &cornerSkyCoords[3] };
+    Eigen::Vector2f cornerScreen[4];
+    bool cornerVisible[4];
+    m_projector->toScreenBatch(cornerPoints, 4, cornerScreen, cornerVisible);
     for (int i = 0; i < 4; i++)
     {
-        cornerScreenCoords[i] = m_projector->toScreen(&cornerSkyCoords[i]);
+        tile.corners[i] = QPointF(cornerScreen[i].x(), cornerScreen[i].y());
         isVisible |= m_projector->checkVisibility(&cornerSkyCoords[i]);
     }
 
@@ -160,41 +176,16 @@ bool HIPSRenderer::renderPix(bool allsky, int level, int pix, QImage *pDest)
 
             m_size += image->sizeInBytes();
 
-            // UV Mapping to apply image unto the destination image
-            // 4x4 = 16 points are mapped from the source image unto the destination image.
-            // Starting from each grandchild pixel, each pix polygon is mapped accordingly.
-            // For example, pixel 357 will have 4 child pixels, each of them will have 4 childs pixels and so
-            // on. Each healpix pixel appears roughly as a diamond on the sky map.
-            // The corners points for HealPIX moves from NORTH -> EAST -> SOUTH -> WEST
-            // Hence first point is 0.25, 0.25 in UV coordinate system.
-            // Depending on the selected algorithm, the mapping will either utilize nearest neighbour
-            // or bilinear interpolation.
-            QPointF uv[16][4] = {{QPointF(.25, .25), QPointF(0.25, 0), QPointF(0, .0), QPointF(0, .25)},
-                {QPointF(.25, .5), QPointF(0.25, 0.25), QPointF(0, .25), QPointF(0, .5)},
-                {QPointF(.5, .25), QPointF(0.5, 0), QPointF(.25, .0), QPointF(.25, .25)},
-                {QPointF(.5, .5), QPointF(0.5, 0.25), QPointF(.25, .25), QPointF(.25, .5)},
-
-                {QPointF(.25, .75), QPointF(0.25, 0.5), QPointF(0, 0.5), QPointF(0, .75)},
-                {QPointF(.25, 1), QPointF(0.25, 0.75), QPointF(0, .75), QPointF(0, 1)},
-                {QPointF(.5, .75), QPointF(0.5, 0.5), QPointF(.25, .5), QPointF(.25, .75)},
-                {QPointF(.5, 1), QPointF(0.5, 0.75), QPointF(.25, .75), QPointF(.25, 1)},
-
-                {QPointF(.75, .25), QPointF(0.75, 0), QPointF(0.5, .0), QPointF(0.5, .25)},
-                {QPointF(.75, .5), QPointF(0.75, 0.25), QPointF(0.5, .25), QPointF(0.5, .5)},
-                {QPointF(1, .25), QPointF(1, 0), QPointF(.75, .0), QPointF(.75, .25)},
-                {QPointF(1, .5), QPointF(1, 0.25), QPointF(.75, .25), QPointF(.75, .5)},
-
-                {QPointF(.75, .75), QPointF(0.75, 0.5), QPointF(0.5, .5), QPointF(0.5, .75)},
-                {QPointF(.75, 1), QPointF(0.75, 0.75), QPointF(0.5, .75), QPointF(0.5, 1)},
-                {QPointF(1, .75), QPointF(1, 0.5), QPointF(.75, .5), QPointF(.75, .75)},
-                {QPointF(1, 1), QPointF(1, 0.75), QPointF(.75, .75), QPointF(.75, 1)},
-            };
+            // A shallow copy, which stays valid if the cache drops the image before rasterize()
+            tile.image = *image;
 
             int childPixelID[4];
 
             // Find all the 4 children of the current pixel
             m_HEALpix->getPixChilds(pix, childPixelID);
 
+            // The corners of all the grandchildren, projected together below
+            SkyPoint fineSkyPoints[16][4];
             int j = 0;
             for (int id : childPixelID)
             {
@@ -206,18 +197,25 @@ bool HIPSRenderer::renderPix(bool allsky, int level, int pix, QImage *pDest)
                 // system.
                 m_HEALpix->getPixChilds(id, grandChildPixelID);
 
-                QPointF fineScreenCoords[4];
-
                 for (int id2 : grandChildPixelID)
-                {
-                    SkyPoint fineSkyPoints[4];
-                    m_HEALpix->getCornerPoints(level + 2, id2, fineSkyPoints);
-
-                    for (int i = 0; i < 4; i++)
-                        fineScreenCoords[i] = m_projector->toScreen(&fineSkyPoints[i]);
-                    m_scanRender->renderPolygon(3, fineScreenCoords, pDest, image, uv[j]);
-                    j++;
-                }
+                    m_HEALpix->getCornerPoints(level + 2, id2, fineSkyPoints[j++]);
+            }
+
+            const SkyPoint *finePoints[64];
+            for (int i = 0; i < 64; i++)
+                finePoints[i] = &fineSkyPoints[i / 4][i % 4];
+            Eigen::Vector2f fineScreen[64];
+            bool fineVisible[64];
+            m_projector->toScreenBatch(finePoints, 64, fineScreen, fineVisible);
+
+            tile.top    = std::numeric_limits<int>::max();
+            tile.bottom = std::numeric_limits<int>::min();
+            for (int i = 0; i < 64; i++)
+            {
+                tile.fine[i / 4][i % 4] = QPointF(fineScreen[i].x(), fineScreen[i].y());
+                const int y = static_cast<int>(fineScreen[i].y());
+                tile.top    = std::min(tile.top, y);
+                tile.bottom = std::max(tile.bottom, y);
             }
 
             if (freeImage)
@@ -226,24 +224,116 @@ bool HIPSRenderer::renderPix(bool allsky, int level, int pix, QImage *pDest)
             }
         }
 
-        if (Options::hIPSShowGrid())
-        {
-            QPainter p(pDest);
-            p.setRenderHint(QPainter::Antialiasing);
-            p.setPen(gridColor);
-
-            p.drawLine(cornerScreenCoords[0].x(), cornerScreenCoords[0].y(), cornerScreenCoords[1].x(), cornerScreenCoords[1].y());
-            p.drawLine(cornerScreenCoords[1].x(), cornerScreenCoords[1].y(), cornerScreenCoords[2].x(), cornerScreenCoords[2].y());
-            p.drawLine(cornerScreenCoords[2].x(), cornerScreenCoords[2].y(), cornerScreenCoords[3].x(), cornerScreenCoords[3].y());
-            p.drawLine(cornerScreenCoords[3].x(), cornerScreenCoords[3].y(), cornerScreenCoords[0].x(), cornerScreenCoords[0].y());
-            p.drawText((cornerScreenCoords[0].x() + cornerScreenCoords[1].x() + cornerScreenCoords[2].x() + cornerScreenCoords[3].x()) /
-                       4,
-                       (cornerScreenCoords[0].y() + cornerScreenCoords[1].y() + cornerScreenCoords[2].y() + cornerScreenCoords[3].y()) / 4,
-                       QString::number(pix) + " / " + QString::number(level));
-        }
-
+        m_pending.append(tile);
         return true;
     }
 
     return false;
 }
+
+void HIPSRenderer::rasterize(QImage *pDest)
+{
+    const int height = pDest->height();
+
+    // Split the image into bands of rows, each rendered by its own thread
+    int bands = 1;
+    if (Options::tiledSkyRendering() && m_pending.size() > 1)
+        bands = std::max(1, std::min(QThread::idealThreadCount(), height / 64));
+
+    if (bands == 1)
+    {
+        for (const PendingPix &tile : m_pending)
+            renderTile(tile, m_scanRender.get(), pDest);
+    }
+    else
+    {
+        while (static_cast<int>(m_bandRenders.size()) < bands)
+            m_bandRenders.emplace_back(new ScanRender());
+
+        // Detach once here, the bands write to disjoint rows of the same pixels
+        uchar *bits = pDest->bits();
+        QVector<int> indexes(bands);
+        std::iota(indexes.begin(), indexes.end(), 0);
+        const QVector<PendingPix> &pending = m_pending;
+        const bool bilinear = m_scanRender->isBilinearInterpolationEnabled();
+        QtConcurrent::blockingMap(indexes, [&](int band)
+        {
+            const int first = height * band / bands, last = height * (band + 1) / bands - 1;
+            QImage dest(bits, pDest->width(), height, pDest->bytesPerLine(), pDest->format());
+            ScanRender *scanRender = m_bandRenders[band].get();
+            scanRender->setBilinearInterpolationEnabled(bilinear);
+            scanRender->setRowRange(first, last);
+
+            for (const PendingPix &tile : pending)
+            {
+                if (tile.bottom >= first && tile.top <= last)
+                    renderTile(tile, scanRender, &dest);
+            }
+        });
+    }
+
+    if (Options::hIPSShowGrid())
+    {
+        QPainter p(pDest);
+        p.setRenderHint(QPainter::Antialiasing);
+        p.setPen(gridColor);
+
+        for (const PendingPix &tile : m_pending)
+        {
+            const QPointF *c = tile.corners;
+            p.drawLine(c[0].x(), c[0].y(), c[1].x(), c[1].y());
+            p.drawLine(c[1].x(), c[1].y(), c[2].x(), c[2].y());
+            p.drawLine(c[2].x(), c[2].y(), c[3].x(), c[3].y());
+            p.drawLine(c[3].x(), c[3].y(), c[0].x(), c[0].y());
+            p.drawText((c[0].x() + c[1].x() + c[2].x() + c[3].x()) / 4, (c[0].y() + c[1].y() + c[2].y() + c[3].y()) / 4,
+                       QString::number(tile.pix) + " / " + QString::number(tile.level));
+        }
+    }
+
+    m_pending.clear();
+}
+
+void HIPSRenderer::renderTile(const PendingPix &tile, ScanRender *scanRender, QImage *pDest)
+{
+    if (tile.image.isNull())
+        return;
+
+    // UV Mapping to apply image unto the destination image
+    // 4x4 = 16 points are mapped from the source image unto the destination image.
+    // Starting from each grandchild pixel, each pix polygon is mapped accordingly.
+    // For example, pixel 357 will have 4 child pixels, each of them will have 4 childs pixels and so
+    // on. Each healpix pixel appears roughly as a diamond on the sky map.
+    // The corners points for HealPIX moves from NORTH -> EAST -> SOUTH -> WEST
+    // Hence first point is 0.25, 0.25 in UV coordinate system.
+    // Depending on the selected algorithm, the mapping will either utilize nearest neighbour
+    // or bilinear interpolation.
+    static const QPointF uv[16][4] = {{QPointF(.25, .25), QPointF(0.25, 0), QPointF(0, .0), QPointF(0, .25)},
+        {QPointF(.25, .5), QPointF(0.25, 0.25), QPointF(0, .25), QPointF(0, .5)},
+        {QPointF(.5, .25), QPointF(0.5, 0), QPointF(.25, .0), QPointF(.25, .25)},
+        {QPointF(.5, .5), QPointF(0.5, 0.25), QPointF(.25, .25), QPointF(.25, .5)},
+
+        {QPointF(.25, .75), QPointF(0.25, 0.5), QPointF(0, 0.5), QPointF(0, .75)},
+        {QPointF(.25, 1), QPointF(0.25, 0.75), QPointF(0, .75), QPointF(0, 1)},
+        {QPointF(.5, .75), QPointF(0.5, 0.5), QPointF(.25, .5), QPointF(.25, .75)},
+        {QPointF(.5, 1), QPointF(0.5, 0.75), QPointF(.25, .75), QPointF(.25, 1)},
+
+        {QPointF(.75, .25), QPointF(0.75, 0), QPointF(0.5, .0), QPointF(0.5, .25)},
+        {QPointF(.75, .5), QPointF(0.75, 0.25), QPointF(0.5, .25), QPointF(0.5, .5)},
+        {QPointF(1, .25), QPointF(1, 0), QPointF(.75, .0), QPointF(.75, .25)},
+        {QPointF(1, .5), QPointF(1, 0.25), QPointF(.75, .25), QPointF(.75, .5)},
+
+        {QPointF(.75, .75), QPointF(0.75, 0.5), QPointF(0.5, .5), QPointF(0.5, .75)},
+        {QPointF(.75, 1), QPointF(0.75, 0.75), QPointF(0.5, .75), QPointF(0.5, 1)},
+        {QPointF(1, .75), QPointF(1, 0.5), QPointF(.75, .5), QPointF(.75, .75)},
+        {QPointF(1, 1), QPointF(1, 0.75), QPointF(.75, .75), QPointF(.75, 1)},
+    };
+
+    // ScanRender wants mutable arguments, the tile is shared between the bands
+    QImage image = tile.image;
+    for (int j = 0; j < 16; j++)
+    {
+        QPointF fineScreenCoords[4] = { tile.fine[j][0], tile.fine[j][1], tile.fine[j][2], tile.fine[j][3] };
+        QPointF fineUV[4] = { uv[j][0], uv[j][1], uv[j][2], uv[j][3] };
+        scanRender->renderPolygon(3, fineScreenCoords, pDest, &image, fineUV);
+    }
+}
@@ -13,6 +13,7 @@
 #include "scanrender.h"
 
 #include <memory>
+#include <vector>
 
 class Projector;
 
@@ -31,12 +32,38 @@ class HIPSRenderer : public QObject
     public Q_SLOTS:
 
     private:
+        /** A visible pixel found by renderPix(), rasterized by rasterize() once all of them are found */
+        struct PendingPix
+        {
+            int pix { 0 };
+            int level { 0 };
+            /// Null if the pixel isn't available yet
+            QImage image;
+            QPointF corners[4];
+            /// Corners of the 4x4 grandchildren
+            QPointF fine[16][4];
+            /// Rows of the destination the grandchildren cover
+            int top { 0 };
+            int bottom { -1 };
+        };
+
+        /**
+         * @short Map the pending pixels onto the destination and draw their grid. With
+         * Options::tiledSkyRendering() the destination is split into bands of rows rendered
+         * concurrently.
+         */
+        void rasterize(QImage *pDest);
+        void renderTile(const PendingPix &tile, ScanRender *scanRender, QImage *pDest);
+
         int m_blocks { 0 };
         int m_rendered { 0 };
         int m_size { 0 };
         QSet<int>  m_renderedMap;
         std::unique_ptr<HEALPix> m_HEALpix;
         std::unique_ptr<ScanRender> m_scanRender;
+        /// One per band of rasterize(), they are large
+        std::vector<std::unique_ptr<ScanRender>> m_bandRenders;
+        QVector<PendingPix> m_pending;
         const Projector *m_projector;
         QColor gridColor;
 };
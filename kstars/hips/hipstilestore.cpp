@@ -0,0 +1,457 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "hipstilestore.h"
+
+#include "kstars_debug.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+namespace
+{
+constexpr quint32 INDEX_MAGIC   = 0x4b534854; // KSHT
+constexpr quint32 INDEX_VERSION = 1;
+// Don't rewrite the pack for less than this
+constexpr qint64 MIN_COMPACT_BYTES = 64 * 1024 * 1024;
+
+// A decoded tile is its width, height and QImage format followed by its pixels
+QByteArray toRaw(const QImage &tile)
+{
+    const QImage image = tile.convertToFormat(tile.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied :
+                         QImage::Format_RGB32);
+    const qint32 header[3] = { image.width(), image.height(), static_cast<qint32>(image.format()) };
+    QByteArray raw(sizeof(header) + image.sizeInBytes(), Qt::Uninitialized);
+    std::memcpy(raw.data(), header, sizeof(header));
+    std::memcpy(raw.data() + sizeof(header), image.constBits(), image.sizeInBytes());
+    return raw;
+}
+
+QImage fromRaw(const QByteArray &raw)
+{
+    qint32 header[3];
+    if (raw.size() < static_cast<int>(sizeof(header)))
+        return QImage();
+    std::memcpy(header, raw.constData(), sizeof(header));
+    if (header[2] != QImage::Format_RGB32 && header[2] != QImage::Format_ARGB32_Premultiplied)
+        return QImage();
+
+    QImage image(header[0], header[1], static_cast<QImage::Format>(header[2]));
+    if (image.isNull() || raw.size() != static_cast<int>(sizeof(header) + image.sizeInBytes()))
+        return QImage();
+    std::memcpy(image.bits(), raw.constData() + sizeof(header), image.sizeInBytes());
+    return image;
+}
+} // namespace
+
+HIPSTileStore::~HIPSTileStore()
+{
+    close();
+}
+
+bool HIPSTileStore::open(const QString &directory, qint64 uid)
+{
+    const std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_Pack.isOpen() && m_Directory == directory && m_Uid == uid)
+        return true;
+
+    closeFiles();
+    QDir().mkpath(directory);
+    m_Directory = directory;
+    m_Uid = uid;
+
+    m_Pack.setFileName(packPath());
+    if (!m_Pack.open(QIODevice::ReadWrite))
+    {
+        qCWarning(KSTARS) << "Unable to open HiPS tile store" << packPath() << m_Pack.errorString();
+        m_Uid = 0;
+        return false;
+    }
+
+    // Without an index the tiles of the pack can't be found
+    if (!readIndex())
+    {
+        m_Entries.clear();
+        m_Pack.resize(0);
+    }
+
+    m_Used = 0;
+    for (const auto &entry : std::as_const(m_Entries))
+        m_Used += entry.size;
+    m_Unused = m_Pack.size() - m_Used;
+    m_IndexChanged = false;
+
+    // The budget may be lower than when the tiles were written
+    evict();
+
+    qCDebug(KSTARS) << "HiPS tile store" << packPath() << "has" << m_Entries.size() << "tiles," << m_Used << "bytes";
+    return true;
+}
+
+void HIPSTileStore::close()
+{
+    const std::lock_guard<std::mutex> lock(m_Mutex);
+    closeFiles();
+}
+
+void HIPSTileStore::closeFiles()
+{
+    if (m_Pack.isOpen())
+    {
+        if (m_IndexChanged)
+            writeIndex();
+        m_Pack.close();
+    }
+    m_Entries.clear();
+    m_Used = m_Unused = 0;
+    m_Uid = 0;
+}
+
+bool HIPSTileStore::isOpen() const
+{
+    const std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Pack.isOpen();
+}
+
+qint64 HIPSTileStore::uid() const
+{
+    const std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Uid;
+}
+
+void HIPSTileStore::setMaxSize(qint64 bytes)
+{
+    const std::lock_guard<std::mutex> lock(m_Mutex);
+    m_MaxSize = bytes;
+    evict();
+}
+
+void HIPSTileStore::setKeepDecoded(bool enabled)
+{
+    const std::lock_guard<std::mutex> lock(m_Mutex);
+    m_KeepDecoded = enabled;
+}
+
+bool HIPSTileStore::contains(const pixCacheKey_t &key)
+{
+    const std::lock_guard<std::mutex> lock(m_Mutex);
+    const bool found = m_Pack.isOpen() && key.uid == m_Uid && m_Entries.contains(entryKey(key.level, key.pix));
+    if (!found)
+        m_Statistics.misses++;
+    return found;
+}
+
+QImage HIPSTileStore::read(const pixCacheKey_t &key)
+{
+    QByteArray data;
+    quint8 format;
+    {
+        const std::lock_guard<std::mutex> lock(m_Mutex);
+        auto it = m_Entries.find(entryKey(key.level, key.pix));
+        if (!m_Pack.isOpen() || key.uid != m_Uid || it == m_Entries.end())
+        {
+            m_Statistics.misses++;
+            return QImage();
+        }
+
+        if (!m_Pack.seek(it->offset) || (data = m_Pack.read(it->size)).size() != it->size)
+        {
+            qCWarning(KSTARS) << "Unable to read HiPS tile" << key.level << key.pix << "from" << packPath();
+            remove(it.key());
+            m_Statistics.misses++;
+            return QImage();
+        }
+
+        it->lastUse = ++m_Clock;
+        m_IndexChanged = true;
+        m_Statistics.hits++;
+        format = it->format;
+    }
+
+    if (format == ENCODED)
+        return decode(data);
+
+    QElapsedTimer timer;
+    timer.start();
+    const QImage image = fromRaw(data);
+    const std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Statistics.decodes++;
+    m_Statistics.decodeMsecs += timer.nsecsElapsed() / 1e6;
+    return image;
+}
+
+QImage HIPSTileStore::decode(const QByteArray &data)
+{
+    QElapsedTimer timer;
+    timer.start();
+    QImage image;
+    image.loadFromData(data);
+
+    const std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Statistics.decodes++;
+    m_Statistics.decodeMsecs += timer.nsecsElapsed() / 1e6;
+    return image;
+}
+
+bool HIPSTileStore::write(const pixCacheKey_t &key, const QByteArray &data, const QImage &image)
+{
+    const std::lock_guard<std::mutex> lock(m_Mutex);
+    if (!m_Pack.isOpen() || key.uid != m_Uid)
+        return false;
+
+    const bool decoded = m_KeepDecoded && !image.isNull();
+    const QByteArray record = decoded ? toRaw(image) : data;
+    if (record.isEmpty())
+        return false;
+
+    const quint64 k = entryKey(key.level, key.pix);
+    remove(k);
+
+    // Tiles are only ever appended, the space of the ones dropped is reclaimed by compact()
+    const qint64 offset = m_Pack.size();
+    if (!m_Pack.seek(offset) || m_Pack.write(record) != record.size())
+    {
+        qCWarning(KSTARS) << "Unable to write HiPS tile to" << packPath() << m_Pack.errorString();
+        m_Pack.resize(offset);
+        return false;
+    }
+
+    Entry entry;
+    entry.offset = offset;
+    entry.size = record.size();
+    entry.format = decoded ? DECODED : ENCODED;
+    entry.lastUse = ++m_Clock;
+    m_Entries.insert(k, entry);
+    m_Used += entry.size;
+    m_IndexChanged = true;
+    m_Statistics.writes++;
+
+    evict();
+    return true;
+}
+
+QVector<pixCacheKey_t> HIPSTileStore::recentTiles(int count) const
+{
+    const std::lock_guard<std::mutex> lock(m_Mutex);
+    QVector<QPair<quint32, quint64>> byUse;
+    byUse.reserve(m_Entries.size());
+    for (auto it = m_Entries.constBegin(); it != m_Entries.constEnd(); ++it)
+        byUse.append(qMakePair(it->lastUse, it.key()));
+    std::sort(byUse.begin(), byUse.end(), std::greater<QPair<quint32, quint64>>());
+
+    QVector<pixCacheKey_t> tiles;
+    for (int i = 0; i < std::min(count, static_cast<int>(byUse.size())); i++)
+    {
+        const quint64 k = byUse[i].second;
+        tiles.append({ static_cast<int>(k >> 32), static_cast<int>(static_cast<quint32>(k)), m_Uid });
+    }
+    return tiles;
+}
+
+void HIPSTileStore::clear()
+{
+    const std::lock_guard<std::mutex> lock(m_Mutex);
+    if (!m_Pack.isOpen())
+        return;
+    m_Entries.clear();
+    m_Pack.resize(0);
+    m_Used = m_Unused = 0;
+    writeIndex();
+}
+
+void HIPSTileStore::flush()
+{
+    const std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_Pack.isOpen() && m_IndexChanged)
+        writeIndex();
+}
+
+qint64 HIPSTileStore::size() const
+{
+    const std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Used;
+}
+
+int HIPSTileStore::count() const
+{
+    const std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Entries.size();
+}
+
+HIPSTileStore::Statistics HIPSTileStore::statistics() const
+{
+    const std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Statistics;
+}
+
+void HIPSTileStore::remove(quint64 key)
+{
+    auto it = m_Entries.find(key);
+    if (it == m_Entries.end())
+        return;
+    m_Used -= it->size;
+    m_Unused += it->size;
+    m_Entries.erase(it);
+    m_IndexChanged = true;
+}
+
+void HIPSTileStore::evict()
+{
+    if (m_MaxSize > 0 && m_Used > m_MaxSize)
+    {
+        // Oldest first, the lowest orders after all the others
+        QVector<QPair<quint64, quint64>> byAge;
+        byAge.reserve(m_Entries.size());
+        for (auto it = m_Entries.constBegin(); it != m_Entries.constEnd(); ++it)
+        {
+            const bool keep = static_cast<int>(it.key() >> 32) <= KEEP_ORDER;
+            byAge.append(qMakePair((static_cast<quint64>(keep) << 32) | it->lastUse, it.key()));
+        }
+        std::sort(byAge.begin(), byAge.end());
+
+        // Make some room at once, rather than evicting a tile for each new one
+        const qint64 target = m_MaxSize / 10 * 9;
+        for (const auto &tile : std::as_const(byAge))
+        {
+            if (m_Used <= target)
+                break;
+            remove(tile.second);
+            m_Statistics.evictions++;
+        }
+    }
+
+    if (m_Unused > m_Used && m_Unused > MIN_COMPACT_BYTES)
+        compact();
+}
+
+bool HIPSTileStore::compact()
+{
+    QFile newPack(packPath() + ".new");
+    if (!newPack.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qCWarning(KSTARS) << "Unable to compact HiPS tile store" << newPack.fileName() << newPack.errorString();
+        return false;
+    }
+
+    // In the order of the old pack, to read it sequentially
+    QVector<QPair<qint64, quint64>> byOffset;
+    byOffset.reserve(m_Entries.size());
+    for (auto it = m_Entries.constBegin(); it != m_Entries.constEnd(); ++it)
+        byOffset.append(qMakePair(it->offset, it.key()));
+    std::sort(byOffset.begin(), byOffset.end());
+
+    QHash<quint64, Entry> entries;
+    qint64 used = 0;
+    for (const auto &tile : std::as_const(byOffset))
+    {
+        Entry entry = m_Entries.value(tile.second);
+        if (!m_Pack.seek(entry.offset))
+            continue;
+        const QByteArray data = m_Pack.read(entry.size);
+        if (data.size() != entry.size)
+            continue;
+        entry.offset = newPack.pos();
+        if (newPack.write(data) != data.size())
+        {
+            qCWarning(KSTARS) << "Unable to compact HiPS tile store" << newPack.fileName() << newPack.errorString();
+            newPack.remove();
+            return false;
+        }
+        entries.insert(tile.second, entry);
+        used += entry.size;
+    }
+    newPack.close();
+
+    // Without an index an interrupted swap leaves an empty store, not one pointing into the wrong pack
+    QFile::remove(indexPath());
+    m_Pack.close();
+    QFile::remove(packPath());
+    const bool renamed = QFile::rename(newPack.fileName(), packPath());
+    if (!renamed || !m_Pack.open(QIODevice::ReadWrite))
+    {
+        qCWarning(KSTARS) << "Unable to replace HiPS tile store" << packPath();
+        m_Entries.clear();
+        m_Used = m_Unused = 0;
+        m_Pack.open(QIODevice::ReadWrite | QIODevice::Truncate);
+        return false;
+    }
+
+    m_Entries = entries;
+    m_Used = used;
+    m_Unused = 0;
+    return writeIndex();
+}
+
+bool HIPSTileStore::readIndex()
+{
+    QFile file(indexPath());
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream stream(&file);
+    quint32 magic = 0, version = 0, count = 0;
+    qint64 packSize = 0;
+    stream >> magic >> version;
+    if (magic != INDEX_MAGIC || version != INDEX_VERSION)
+    {
+        qCWarning(KSTARS) << "Ignoring HiPS tile index of unknown format" << indexPath();
+        return false;
+    }
+    stream >> m_Clock >> packSize >> count;
+
+    m_Entries.clear();
+    m_Entries.reserve(count);
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; i++)
+    {
+        quint8 order, format;
+        qint32 pix;
+        Entry entry;
+        stream >> order >> pix >> entry.offset >> entry.size >> format >> entry.lastUse;
+        entry.format = format;
+        // Tiles appended after the index was written can't be found, those missing are dropped
+        if (stream.status() == QDataStream::Ok && entry.offset >= 0 && entry.size > 0 &&
+                entry.offset + entry.size <= m_Pack.size() && format <= DECODED)
+            m_Entries.insert(entryKey(order, pix), entry);
+    }
+    return stream.status() == QDataStream::Ok;
+}
+
+bool HIPSTileStore::writeIndex()
+{
+    m_Pack.flush();
+
+    QSaveFile file(indexPath());
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qCWarning(KSTARS) << "Unable to write HiPS tile index" << indexPath() << file.errorString();
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream << INDEX_MAGIC << INDEX_VERSION << m_Clock << m_Pack.size() << static_cast<quint32>(m_Entries.size());
+    for (auto it = m_Entries.constBegin(); it != m_Entries.constEnd(); ++it)
+        stream << static_cast<quint8>(it.key() >> 32) << static_cast<qint32>(static_cast<quint32>(it.key()))
+               << it->offset << it->size << it->format << it->lastUse;
+
+    m_IndexChanged = !file.commit();
+    return !m_IndexChanged;
+}
+
+QString HIPSTileStore::packPath() const
+{
+    return QDir(m_Directory).filePath(QString("%1.tiles").arg(m_Uid));
+}
+
+QString HIPSTileStore::indexPath() const
+{
+    return QDir(m_Directory).filePath(QString("%1.index").arg(m_Uid));
+}
@@ -0,0 +1,150 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "hips.h"
+
+#include <QFile>
+#include <QHash>
+#include <QPair>
+#include <QVector>
+
+#include <mutex>
+
+/**
+ * @class HIPSTileStore
+ * Persistent store of the tiles of one HiPS survey.
+ *
+ * The tiles are appended to a single pack file, <uid>.tiles, and found through a compact index,
+ * <uid>.index, holding the order, pixel, place in the pack and last use of each of them. A tile is
+ * kept as it was received, or already decoded to RGB32 so that reading it back is a plain copy.
+ *
+ * When the tiles take more than the byte budget, the least recently used are dropped, those of the
+ * lowest orders last since every wide view needs them. The space they leave in the pack is reclaimed
+ * by rewriting it once it is more than half empty. The index is written when the store is flushed
+ * or closed, and the last uses it keeps tell which tiles to load first at the next start.
+ *
+ * All the methods are thread-safe, so that tiles can be read and decoded on worker threads.
+ *
+ * @short Packed on-disk cache of HiPS tiles
+ */
+class HIPSTileStore
+{
+    public:
+        struct Statistics
+        {
+            qint64 hits { 0 };
+            qint64 misses { 0 };
+            qint64 writes { 0 };
+            qint64 evictions { 0 };
+            /// Tiles decoded, read from the store or downloaded
+            qint64 decodes { 0 };
+            double decodeMsecs { 0 };
+        };
+
+        HIPSTileStore() = default;
+        ~HIPSTileStore();
+
+        /**
+         * @short Open the store of a survey, closing the current one
+         * @param directory where the pack and index files are kept
+         * @param uid of the survey, which names the files
+         * @return false if the pack file can't be opened
+         */
+        bool open(const QString &directory, qint64 uid);
+        /** @short Write the index and close the files */
+        void close();
+        bool isOpen() const;
+        /** @return the uid of the open survey, 0 if none is */
+        qint64 uid() const;
+
+        /** @short Set the byte budget of the tiles, 0 for no limit */
+        void setMaxSize(qint64 bytes);
+        /** @short Keep the tiles written from now on decoded instead of as received */
+        void setKeepDecoded(bool enabled);
+
+        /**
+         * @short Check whether a tile is in the store, not finding it counts as a miss
+         * @param key of the tile, which must be of the open survey
+         */
+        bool contains(const pixCacheKey_t &key);
+        /**
+         * @short Read and decode a tile
+         * @return the tile, or a null image if it isn't in the store or can't be read
+         */
+        QImage read(const pixCacheKey_t &key);
+        /**
+         * @short Add a tile, replacing any older copy
+         * @param data the encoded tile as received
+         * @param image the decoded tile, kept instead of the data if decoded tiles are kept
+         */
+        bool write(const pixCacheKey_t &key, const QByteArray &data, const QImage &image);
+        /** @short Decode a tile, counting the time it took in the statistics */
+        QImage decode(const QByteArray &data);
+
+        /** @return the keys of the most recently used tiles, most recent first */
+        QVector<pixCacheKey_t> recentTiles(int count) const;
+
+        /** @short Drop all the tiles of the open survey */
+        void clear();
+        /** @short Write the index, so that the tiles added so far survive a crash */
+        void flush();
+
+        /** @return the bytes taken by the tiles */
+        qint64 size() const;
+        int count() const;
+        Statistics statistics() const;
+
+        /** Tiles of this order and lower are only dropped when nothing else is left */
+        static constexpr int KEEP_ORDER = 3;
+
+    private:
+        enum Format : quint8
+        {
+            ENCODED,
+            DECODED
+        };
+
+        struct Entry
+        {
+            qint64 offset { 0 };
+            qint32 size { 0 };
+            quint8 format { ENCODED };
+            quint32 lastUse { 0 };
+        };
+
+        static quint64 entryKey(int order, int pix)
+        {
+            return (static_cast<quint64>(order) << 32) | static_cast<quint32>(pix);
+        }
+
+        // The following expect m_Mutex to be held
+        void closeFiles();
+        bool readIndex();
+        bool writeIndex();
+        void remove(quint64 key);
+        void evict();
+        bool compact();
+
+        QString packPath() const;
+        QString indexPath() const;
+
+        mutable std::mutex m_Mutex;
+        QString m_Directory;
+        qint64 m_Uid { 0 };
+        QFile m_Pack;
+        QHash<quint64, Entry> m_Entries;
+        // Bytes of the pack used by the tiles, and left by the ones dropped
+        qint64 m_Used { 0 };
+        qint64 m_Unused { 0 };
+        qint64 m_MaxSize { 0 };
+        bool m_KeepDecoded { false };
+        bool m_IndexChanged { false };
+        // Incremented on each use of a tile
+        quint32 m_Clock { 0 };
+        Statistics m_Statistics;
+};
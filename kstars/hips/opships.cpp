@@ -22,6 +22,7 @@
 #include <QFileDialog>
 #include <QPushButton>
 #include <QStringList>
+#include <QTimer>
 
 // Qt version calming
 #include <qtkeepemptyparts.h>
@@ -52,6 +53,30 @@ OpsHIPSCache::OpsHIPSCache() : QFrame(KStars::Instance())
         HIPSManager::Instance()->setOfflineLevels(orders);
         HIPSManager::Instance()->setCurrentSource("DSS Colored");
     });
+
+    QTimer *statisticsTimer = new QTimer(this);
+    connect(statisticsTimer, &QTimer::timeout, this, [this]()
+    {
+        if (isVisible())
+            updateStatistics();
+    });
+    statisticsTimer->start(1000);
+    updateStatistics();
+}
+
+void OpsHIPSCache::updateStatistics()
+{
+    const HIPSTileStore *store = HIPSManager::Instance()->getStore();
+    const HIPSTileStore::Statistics statistics = store->statistics();
+    const qint64 lookups = statistics.hits + statistics.misses;
+
+    QString text = i18n("Stored tiles: %1 (%2 MB)", store->count(),
+                        QString::number(store->size() / (1024.0 * 1024.0), 'f', 1));
+    text += '\n' + i18n("Found on disk: %1 of %2 (%3%)", statistics.hits, lookups,
+                         QString::number(lookups > 0 ? 100.0 * statistics.hits / lookups : 0.0, 'f', 0));
+    text += '\n' + i18n("Decoding: %1 ms per tile", QString::number(statistics.decodes > 0 ?
+                         statistics.decodeMsecs / statistics.decodes : 0.0, 'f', 2));
+    statisticsLabel->setText(text);
 }
 
 OpsHIPS::OpsHIPS() : QFrame(KStars::Instance())
@@ -27,6 +27,10 @@ class OpsHIPSCache : public QFrame, public Ui::OpsHIPSCache
 
     public:
         explicit OpsHIPSCache();
+
+    private:
+        /** Show the size and the hit, miss and decoding statistics of the tile store */
+        void updateStatistics();
 };
 
 /**
@@ -56,6 +56,18 @@ void ScanRender::resetScanPoly(int sx, int sy)
     m_sy = sy;
 }
 
+void ScanRender::setRowRange(int first, int last)
+{
+    m_firstRow = qMax(first, 0);
+    m_lastRow  = qMin(last, MAX_BK_SCANLINES - 1);
+}
+
+void ScanRender::clipRows()
+{
+    plMinY = qMax(plMinY, m_firstRow);
+    plMaxY = qMin(plMaxY, m_lastRow);
+}
+
 //////////////////////////////////////////////////////////
 void ScanRender::scanLine(int x1, int y1, int x2, int y2)
 //////////////////////////////////////////////////////////
@@ -232,6 +244,8 @@ void ScanRender::scanLine(int x1, int y1, int x2, int y2, float u1, float v1, fl
 void ScanRender::renderPolygon(QColor col, QImage *dst)
 ////////////////////////////////////////////////////////
 {
+    clipRows();
+
     quint32   c = col.rgb();
     quint32  *bits = (quint32 *)dst->bits();
     int       dw = dst->width();
@@ -279,6 +293,8 @@ void ScanRender::renderPolygon(QColor col, QImage *dst)
 void ScanRender::renderPolygonAlpha(QColor col, QImage *dst)
 /////////////////////////////////////////////////////////////
 {
+    clipRows();
+
     quint32   c = col.rgba();
     quint32  *bits = (quint32 *)dst->bits();
     int       dw = dst->width();
@@ -331,6 +347,7 @@ void ScanRender::setOpacity(float opacity)
 void ScanRender::renderPolygon(QImage *dst, QImage *src)
 /////////////////////////////////////////////////////////
 {
+    clipRows();
     if (bBilinear)
         renderPolygonBI(dst, src);
     else
@@ -646,6 +663,7 @@ void ScanRender::renderPolygonBI(QImage *dst, QImage *src)
 
 void ScanRender::renderPolygonAlpha(QImage *dst, QImage *src)
 {
+    clipRows();
     if (bBilinear)
         renderPolygonAlphaBI(dst, src);
     else
@@ -44,7 +44,16 @@ class ScanRender
         void renderPolygonAlpha(QColor col, QImage *dst);
         void setOpacity(float opacity);
 
+        /**
+         * @short Only render the rows from first to last of the destination, so that several
+         * instances can render parts of the same image at the same time
+         */
+        void setRowRange(int first, int last);
+
     private:
+        /** Limit the rows of the polygon to the row range */
+        void clipRows();
+
         float    m_opacity { 1.0f };
         int      plMinY { 0 };
         int      plMaxY { 0 };
@@ -52,4 +61,6 @@ class ScanRender
         int      m_sy { 0 };
         bkScan_t scLR[MAX_BK_SCANLINES];
         bool     bBilinear { false };
+        int      m_firstRow { 0 };
+        int      m_lastRow { MAX_BK_SCANLINES - 1 };
 };
@@ -16,10 +16,11 @@ UrlFileDownload::UrlFileDownload(QObject *parent, QNetworkDiskCache *cache) : QO
     m_manager.setCache(cache);
 }
 
-void UrlFileDownload::begin(const QUrl &url, const pixCacheKey_t &key)
+void UrlFileDownload::begin(const QUrl &url, const pixCacheKey_t &key, bool saveToCache)
 {
     QNetworkRequest request(url);
     request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferCache);
+    request.setAttribute(QNetworkRequest::CacheSaveControlAttribute, saveToCache);
 
     QNetworkReply *reply = m_manager.get(request);
 
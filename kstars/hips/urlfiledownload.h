@@ -18,7 +18,10 @@ class UrlFileDownload : public QObject
         Q_OBJECT
     public:
         explicit UrlFileDownload(QObject *parent, QNetworkDiskCache *cache);
-        void begin(const QUrl &url, const pixCacheKey_t &key);
+        /**
+         * @param saveToCache false for tiles kept elsewhere, which are then only read from the disk cache
+         */
+        void begin(const QUrl &url, const pixCacheKey_t &key, bool saveToCache = true);
         void abortAll();
 
     Q_SIGNALS:
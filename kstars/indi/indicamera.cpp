@@ -18,6 +18,8 @@
 //#include "ekos/manager.h"
 #ifdef HAVE_CFITSIO
 #include "fitsviewer/fitsdata.h"
+#include "fitsviewer/fitscompressor.h"
+#include "ekos/capture/placeholderpath.h"
 #endif
 
 #include <knotification.h>
@@ -662,8 +664,11 @@ QSharedPointer<FITSData> Camera::buildGuideFrameFromStream(INDI::WidgetViewBlob
     // Supports 8-bit mono, 16-bit mono (RAW16), and 8-bit RGB formats.
     // For compressed formats (JPEG, PNG …) we use Qt's image decoders.
     // For uncompressed raw blobs we operate directly on the pixel data.
-    QByteArray rawGray;
-    bool is16bit = false;
+    // The buffer is handed over to FITSData as its image buffer, so this is the only copy made.
+    FITSData::RawFrameInfo info;
+    info.width  = static_cast<uint16_t>(streamW);
+    info.height = static_cast<uint16_t>(streamH);
+    std::unique_ptr<uint8_t[]> pixels;
 
     if (fmtSupported)
     {
@@ -676,25 +681,31 @@ QSharedPointer<FITSData> Camera::buildGuideFrameFromStream(INDI::WidgetViewBlob
         }
         if (img.format() != QImage::Format_Grayscale8)
             img = img.convertToFormat(QImage::Format_Grayscale8);
-        rawGray = QByteArray(reinterpret_cast<const char *>(img.constBits()),
-                             static_cast<int>(img.width() * img.height()));
+        // Scan lines are padded to 32 bits, so copy them one by one.
+        info.width  = static_cast<uint16_t>(img.width());
+        info.height = static_cast<uint16_t>(img.height());
+        pixels.reset(new uint8_t[info.width * info.height]);
+        for (int y = 0; y < img.height(); ++y)
+            memcpy(pixels.get() + y * info.width, img.constScanLine(y), info.width);
     }
     else if (blobLen == totalPx)
     {
         // 8-bit raw monochrome — single memcpy, no conversion needed.
-        rawGray = QByteArray(reinterpret_cast<const char *>(blobPtr), static_cast<int>(blobLen));
+        pixels.reset(new uint8_t[blobLen]);
+        memcpy(pixels.get(), blobPtr, blobLen);
     }
     else if (blobLen == totalPx * 2)
     {
         // 16-bit raw monochrome (RAW16) — pass through as-is.
-        rawGray = QByteArray(reinterpret_cast<const char *>(blobPtr), static_cast<int>(blobLen));
-        is16bit = true;
+        pixels.reset(new uint8_t[blobLen]);
+        memcpy(pixels.get(), blobPtr, blobLen);
+        info.bitsPerPixel = 16;
     }
     else if (blobLen == totalPx * 3)
     {
         // 8-bit raw RGB — extract luminance in a single pass.
-        rawGray.resize(static_cast<int>(totalPx));
-        uint8_t *dst = reinterpret_cast<uint8_t *>(rawGray.data());
+        pixels.reset(new uint8_t[totalPx]);
+        uint8_t *dst = pixels.get();
         for (uint32_t i = 0; i < totalPx; ++i)
         {
             const uint8_t r = blobPtr[i * 3];
@@ -711,62 +722,23 @@ QSharedPointer<FITSData> Camera::buildGuideFrameFromStream(INDI::WidgetViewBlob
         return {};
     }
 
-    // ── Build a proper in-memory FITS using CFITSIO ───────────────────────────────────────
-    fitsfile *fptr    = nullptr;
-    void     *fitsBuf = nullptr;
-    size_t    fitsSz  = 0;
-    int       status  = 0;
-    char      errStr[FLEN_STATUS] = {};
+    // ── Metadata the guider reads from the header ─────────────────────────────────────────
+    int binx = 1, biny = 1;
+    primaryChip->getBinning(&binx, &biny);
+    info.xBinning = static_cast<uint8_t>(binx);
+    info.yBinning = static_cast<uint8_t>(biny);
+    getStreamExposure(&info.exposure);
+    info.timestamp = QDateTime::currentDateTimeUtc();
 
-    if (fits_create_memfile(&fptr, &fitsBuf, &fitsSz, 4096, realloc, &status))
+    QSharedPointer<FITSData> imageData = FITSData::fromRawBuffer(FITS_GUIDE, std::move(pixels), info);
+    if (!imageData)
     {
-        fits_get_errstatus(status, errStr);
-        qCWarning(KSTARS_INDI) << "buildGuideFrameFromStream: fits_create_memfile:" << errStr;
+        qCWarning(KSTARS_INDI) << "buildGuideFrameFromStream: FITSData::fromRawBuffer failed";
         return {};
     }
 
-    long naxes[2] = { streamW, streamH };
-    int imgType = is16bit ? USHORT_IMG : BYTE_IMG;
-    if (fits_create_img(fptr, imgType, 2, naxes, &status))
-    {
-        fits_get_errstatus(status, errStr);
-        qCWarning(KSTARS_INDI) << "buildGuideFrameFromStream: fits_create_img:" << errStr;
-        status = 0;
-        fits_close_file(fptr, &status);
-        free(fitsBuf);
-        return {};
-    }
-
-    int dataType = is16bit ? TUSHORT : TBYTE;
-    if (fits_write_img(fptr, dataType, 1, static_cast<long>(totalPx),
-                       const_cast<char *>(rawGray.constData()), &status))
-    {
-        fits_get_errstatus(status, errStr);
-        qCWarning(KSTARS_INDI) << "buildGuideFrameFromStream: fits_write_img:" << errStr;
-        status = 0;
-        fits_close_file(fptr, &status);
-        free(fitsBuf);
-        return {};
-    }
-
-    fits_flush_file(fptr, &status);
-    fits_close_file(fptr, &status);
-
-    QByteArray fitsBuffer(static_cast<const char *>(fitsBuf), static_cast<int>(fitsSz));
-    free(fitsBuf);
-
-    // ── Load into FITSData ────────────────────────────────────────────────────────────────
-    QSharedPointer<FITSData> imageData(new FITSData(FITS_GUIDE), &QObject::deleteLater);
     imageData->setProperty("device", getDeviceName());
     imageData->setProperty("chip",   static_cast<int>(CameraChip::PRIMARY_CCD));
-    imageData->setExtension("fits");
-
-    if (!imageData->loadFromBuffer(fitsBuffer))
-    {
-        qCWarning(KSTARS_INDI) << "buildGuideFrameFromStream: FITSData::loadFromBuffer failed";
-        return {};
-    }
-
     return imageData;
 #endif // HAVE_CFITSIO
 }
@@ -1814,14 +1786,56 @@ bool Camera::setScopeInfo(double focalLength, double aperture)
     return true;
 }
 
+bool Camera::canCompressCurrentImage() const
+{
+#ifdef HAVE_CFITSIO
+    return BType == BLOB_FITS && FITSCompressor::canCompress(fileWriteBuffer, fileWriteBufferSize);
+#else
+    return false;
+#endif
+}
+
 // Internal function to write an image blob to disk.
 bool Camera::WriteImageFileInternal(const QString &filename, char *buffer, const size_t size)
 {
-    QFile file(filename);
+    QString uncompressedName = filename;
+#ifdef HAVE_CFITSIO
+    // The capture module asks for tile compression by giving FITS images the .fz suffix
+    if (filename.endsWith(".fz"))
+    {
+        const auto method = static_cast<FITSCompressor::Method>(Options::captureFITSCompression());
+        const auto result = FITSCompressor::compress(buffer, size, filename, method);
+        if (result.success)
+        {
+            QFile(filename).setPermissions(QFileDevice::ReadUser |
+                                           QFileDevice::WriteUser |
+                                           QFileDevice::ReadGroup |
+                                           QFileDevice::ReadOther);
+            Q_EMIT imageCompressed(filename, result.inputSize, result.outputSize, result.elapsedMS);
+            return true;
+        }
+
+        // An uncompressed file must not keep the .fz suffix, which would tell readers it is compressed.
+        // Only the .fz name was checked for collisions, so don't overwrite an earlier frame with this one.
+        uncompressedName.chop(3);
+        if (QFile::exists(uncompressedName))
+            uncompressedName = Ekos::PlaceholderPath::repairFilename(uncompressedName);
+        if (QFile::exists(uncompressedName))
+        {
+            qCCritical(KSTARS_INDI) << "ISD:CCD Error: Unable to compress" << filename << ":" << result.error
+                                    << "and" << uncompressedName << "already exists";
+            return false;
+        }
+        qCWarning(KSTARS_INDI) << "ISD:CCD Error: Unable to compress" << filename << ":" << result.error
+                               << "Saving it uncompressed as" << uncompressedName;
+    }
+#endif
+
+    QFile file(uncompressedName);
     if (!file.open(QIODevice::WriteOnly))
     {
         qCCritical(KSTARS_INDI) << "ISD:CCD Error: Unable to open write file: " <<
-                                filename;
+                                uncompressedName;
         return false;
     }
     int n = 0;
@@ -1842,6 +1856,8 @@ bool Camera::WriteImageFileInternal(const QString &filename, char *buffer, const
                         QFileDevice::WriteUser |
                         QFileDevice::ReadGroup |
                         QFileDevice::ReadOther);
+    if (ok && uncompressedName != filename)
+        Q_EMIT imageSavedUncompressed(filename, uncompressedName);
     return ok;
 }
 
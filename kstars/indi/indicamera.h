@@ -234,6 +234,12 @@ class Camera : public ConcreteDevice
          */
         bool saveCurrentImage(QString &filename);
 
+        /**
+         * @brief canCompressCurrentImage check that the image in the image data buffer is a FITS image
+         * that can be saved tile compressed, i.e. under a .fits.fz name.
+         */
+        bool canCompressCurrentImage() const;
+
 
     public Q_SLOTS:
         void StreamWindowHidden();
@@ -261,6 +267,10 @@ class Camera : public ConcreteDevice
         void newVideoFrame(const QSharedPointer<QImage> &frame);
         // Data
         void newImage(const QSharedPointer<FITSData> &data, const QString &extension = "");
+        // Emitted from the file writing thread once a tile compressed image is saved
+        void imageCompressed(const QString &filename, qint64 inputSize, qint64 outputSize, qint64 elapsedMS);
+        // Emitted from the file writing thread when compression failed and the image was saved uncompressed instead
+        void imageSavedUncompressed(const QString &requestedFilename, const QString &filename);
         // View
         void newView(const QSharedPointer<FITSView> &view);
 
@@ -271,7 +281,7 @@ class Camera : public ConcreteDevice
         /**
          * @brief buildGuideFrameFromStream Convert a raw stream BLOB into a FITSData object for guide processing.
          *        Handles 8-bit grayscale raw, 8-bit RGB raw (green-channel extraction), and image-reader formats (e.g. JPEG).
-         *        Constructs a minimal in-memory FITS buffer to avoid any unnecessary format conversions.
+         *        The pixels are adopted by FITSData::fromRawBuffer(), so no FITS file is written or parsed per frame.
          * @param bp Pointer to the BLOB widget containing stream data
          * @return Shared pointer to FITSData on success, empty shared pointer on failure
          */
@@ -586,6 +586,17 @@ class KStars : public KXmlGuiWindow
          */
         Q_SCRIPTABLE QString getToggleableActionStates();
 
+        /** DBUS interface function. Predict the passes of the satellites of all the groups over the current location.
+         * @param days number of days to search, from the current simulation time
+         * @param minElevation elevation in degrees over which a satellite is in view
+         * @param nameFilter only the satellites whose name contains it, regardless of case, or all of them if empty
+         * @return a JSON array of the passes ordered by AOS, each with the name of the satellite, the AOS, TCA and LOS
+         * as UTC dates and their azimuths, the maximum elevation, the fraction of the pass spent in the sunlight and
+         * whether the satellite can be seen in a dark sky. The search runs on other threads while the sky map goes on.
+         * An empty string is returned if days isn't in ]0, 30] or minElevation in [0, 90[.
+         */
+        Q_SCRIPTABLE QString getSatellitePasses(double days, double minElevation, const QString &nameFilter);
+
         /** DBUS interface function. Activate the given action
          * @param actionName name of the action
          * @note Although KMainWindow does expose this on DBus, it is convenient to have it in our own interface
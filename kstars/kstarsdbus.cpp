@@ -18,10 +18,13 @@
 #include "skymap.h"
 #include "fov.h"
 #include "skycomponents/constellationboundarylines.h"
+#include "skycomponents/satellitescomponent.h"
 #include "skycomponents/skymapcomposite.h"
 #include "skyobjects/catalogobject.h"
 #include "catalogsdb.h"
 #include "skyobjects/ksplanetbase.h"
+#include "skyobjects/satellitegroup.h"
+#include "skyobjects/satellitepasspredictor.h"
 #include "skyobjects/starobject.h"
 #include "tools/whatsinteresting/wiview.h"
 #include "dialogs/finddialog.h"
@@ -39,8 +42,13 @@
 #include <QPrintDialog>
 #include <QPrinter>
 #include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFutureWatcher>
+#include <QtConcurrent>
 #include <QJsonArray>
 
+#include <memory>
+
 #include "kstars_debug.h"
 
 void KStars::setRaDec(double ra, double dec)
@@ -1175,6 +1183,62 @@ QString KStars::getToggleableActionStates()
     return QString::fromUtf8(QJsonDocument(actionStates).toJson());
 }
 
+QString KStars::getSatellitePasses(double days, double minElevation, const QString &nameFilter)
+{
+    if (!(days > 0 && days <= SatellitePassPredictor::MAX_DAYS) || !(minElevation >= 0 && minElevation < 90))
+    {
+        qCWarning(KSTARS) << "Satellite passes: invalid range of" << days << "days or minimum elevation of"
+                          << minElevation << "degrees";
+        return QString();
+    }
+
+    QVector<Satellite *> satellites;
+    const auto groups = data()->skyComposite()->satellites()->groups();
+    for (const SatelliteGroup *group : groups)
+    {
+        for (Satellite *sat : *group)
+        {
+            if (nameFilter.isEmpty() || sat->name().contains(nameFilter, Qt::CaseInsensitive))
+                satellites.append(sat);
+        }
+    }
+
+    // The predictor copies the satellites, so the search can run on another thread while the sky map
+    // goes on, as in SatellitePassesDialog
+    auto predictor = std::make_shared<SatellitePassPredictor>(satellites, data()->geo());
+    predictor->setMinElevation(minElevation);
+    const double startJD = data()->ut().djd();
+
+    QFutureWatcher<QVector<SatellitePass>> watcher;
+    QEventLoop loop;
+    connect(&watcher, &QFutureWatcher<QVector<SatellitePass>>::finished, &loop, &QEventLoop::quit);
+    watcher.setFuture(QtConcurrent::run([predictor, startJD, days]()
+    {
+        return predictor->predict(startJD, days);
+    }));
+    if (!watcher.isFinished())
+        loop.exec(); // wait for the prediction to complete
+    const QVector<SatellitePass> passes = watcher.result();
+
+    QJsonArray result;
+    for (const SatellitePass &pass : passes)
+    {
+        QJsonObject passObject;
+        passObject.insert("name", pass.name);
+        passObject.insert("aos", KStarsDateTime(pass.aos).toString(Qt::ISODate));
+        passObject.insert("tca", KStarsDateTime(pass.tca).toString(Qt::ISODate));
+        passObject.insert("los", KStarsDateTime(pass.los).toString(Qt::ISODate));
+        passObject.insert("aosAzimuth", pass.aosAzimuth);
+        passObject.insert("tcaAzimuth", pass.tcaAzimuth);
+        passObject.insert("losAzimuth", pass.losAzimuth);
+        passObject.insert("maxElevation", pass.maxElevation);
+        passObject.insert("illuminated", pass.illuminated);
+        passObject.insert("visible", pass.visible);
+        result.append(passObject);
+    }
+    return QString::fromUtf8(QJsonDocument(result).toJson());
+}
+
 QStringList KStars::getActions()
 {
     QStringList result;
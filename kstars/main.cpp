@@ -18,6 +18,7 @@
 #if !defined(KSTARS_LITE)
 #include "kstars.h"
 #include "skymap.h"
+#include "auxiliary/batchchartrenderer.h"
 #endif
 #include "fitsviewer/fitsviewer.h"
 
@@ -52,6 +53,7 @@
 #include <QDebug>
 #include <QPixmap>
 #include <QScreen>
+#include <QThread>
 #include <QtGlobal>
 #include <QTranslator>
 
@@ -236,6 +238,8 @@ int main(int argc, char *argv[])
     parser.addOption(QCommandLineOption("height", i18n("Height of sky image."), "value"));
     parser.addOption(QCommandLineOption("date", i18n("Date and time."), "string"));
     parser.addOption(QCommandLineOption("paused", i18n("Start with clock paused.")));
+    parser.addOption(QCommandLineOption("batch", i18n("Render the sky charts listed in a JSON or CSV file."), "file"));
+    parser.addOption(QCommandLineOption("batch-workers", i18n("Number of threads writing the sky charts."), "value"));
     parser.addOption(QCommandLineOption("live-stacker", i18n("Run Live Stacker standalone mode")));
 
     // urls to open
@@ -255,6 +259,41 @@ int main(int argc, char *argv[])
         return app.exec();
     }
 
+    if (parser.isSet("batch"))
+    {
+        QVector<BatchChartRenderer::Job> jobs;
+        QString error;
+        if (!BatchChartRenderer::readJobs(parser.value("batch"), jobs, error))
+        {
+            qCWarning(KSTARS) << error;
+            return 1;
+        }
+
+        bool ok(false);
+        int workers = parser.value("batch-workers").toInt(&ok);
+        if (!ok)
+            workers = QThread::idealThreadCount();
+
+        KStarsData *dat = KStarsData::Create();
+        QObject::connect(dat, SIGNAL(progressText(QString)), dat,
+                         SLOT(slotConsoleMessage(QString)));
+        dat->initialize();
+        dat->setLocationFromOptions();
+        dat->colorScheme()->loadFromConfig();
+
+        SkyMap *map = SkyMap::Create();
+        int failed = 0;
+        {
+            BatchChartRenderer renderer(dat, map, workers);
+            failed = renderer.render(jobs);
+        }
+
+        // The renderer and the map use the data, so it is deleted last
+        delete map;
+        delete dat;
+        return failed > 0 ? 1 : 0;
+    }
+
     if (parser.isSet("dump"))
     {
         qCDebug(KSTARS) << "Dumping sky image";
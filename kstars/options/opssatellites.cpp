@@ -13,6 +13,7 @@
 #include "skymapcomposite.h"
 #include "skycomponents/satellitescomponent.h"
 #include "skymap.h"
+#include "tools/satellitepassesdialog.h"
 
 #include <QStandardItemModel>
 #include <QStatusBar>
@@ -61,6 +62,7 @@ OpsSatellites::OpsSatellites() : QFrame(KStars::Instance())
 
     // Signals and slots connections
     connect(UpdateTLEButton, SIGNAL(clicked()), this, SLOT(slotUpdateTLEs()));
+    connect(PredictPassesButton, SIGNAL(clicked()), this, SLOT(slotPredictPasses()));
     connect(kcfg_ShowSatellites, SIGNAL(toggled(bool)), SLOT(slotShowSatellites(bool)));
     connect(m_ConfigDialog->button(QDialogButtonBox::Apply), SIGNAL(clicked()), SLOT(slotApply()));
     connect(m_ConfigDialog->button(QDialogButtonBox::Ok), SIGNAL(clicked()), SLOT(slotApply()));
@@ -99,6 +101,25 @@ void OpsSatellites::slotUpdateTLEs()
     updateListView();
 }
 
+void OpsSatellites::slotPredictPasses()
+{
+    // The satellites of all the groups which match the filter of the list
+    const QRegularExpression filter(FilterEdit->text(), QRegularExpression::CaseInsensitiveOption);
+    QVector<Satellite *> satellites;
+    for (auto sat_group : KStarsData::Instance()->skyComposite()->satellites()->groups())
+    {
+        for (int i = 0; i < sat_group->count(); ++i)
+        {
+            if (sat_group->at(i)->name().contains(filter))
+                satellites.append(sat_group->at(i));
+        }
+    }
+
+    SatellitePassesDialog *dialog = new SatellitePassesDialog(satellites, this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->show();
+}
+
 void OpsSatellites::updateListView()
 {
     KStarsData *data = KStarsData::Instance();
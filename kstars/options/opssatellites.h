@@ -56,6 +56,7 @@ class OpsSatellites : public QFrame, public Ui::OpsSatellites
 
     private Q_SLOTS:
         void slotUpdateTLEs();
+        void slotPredictPasses();
         void slotShowSatellites(bool on);
         void slotApply();
         void slotCancel();
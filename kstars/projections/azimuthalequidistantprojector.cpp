@@ -35,3 +35,12 @@ double AzimuthalEquidistantProjector::projectionL(double x) const
 {
     return x;
 }
+
+void AzimuthalEquidistantProjector::toScreenBatch(const double *ra, const double *dec, const double *alt, const double *az, int count,
+                                                  Eigen::Vector2f *screen, bool *visible, bool oRefract) const
+{
+    projectBatch(ra, dec, alt, az, count, screen, visible, oRefract, cosMaxFieldAngle(), [this](double c)
+    {
+        return AzimuthalEquidistantProjector::projectionK(c);
+    });
+}
@@ -60,6 +60,29 @@ Eigen::Vector2f EquirectangularProjector::toScreenVec(const SkyPoint *o, bool oR
     return p;
 }
 
+void EquirectangularProjector::toScreenBatch(const double *ra, const double *dec, const double *alt, const double *az,
+                                             int count, Eigen::Vector2f *screen, bool *visible, bool oRefract) const
+{
+    if (count <= 0)
+        return;
+
+    Eigen::ArrayXd Y(count), dX(count);
+    batchOffsets(ra, dec, alt, az, count, oRefract, Y.data(), dX.data());
+
+    double Y0;
+    if (m_vp.useAltAz)
+        Y0 = SkyPoint::refract(m_vp.focus->alt(), oRefract && m_vp.useRefraction).radians();
+    else
+        Y0 = m_vp.focus->dec().radians();
+    Y -= Y0;
+
+    batchFinish(dX.data(), Y.data(), nullptr, 0, alt, count, screen, visible);
+
+    // As in toScreenVec(), only the part of the map within the width is visible
+    for (int i = 0; i < count; i++)
+        visible[i] = visible[i] && screen[i][0] > 0 && screen[i][0] < m_vp.width;
+}
+
 SkyPoint EquirectangularProjector::fromScreen(const QPointF &p, KStarsData* data, bool onlyAltAz) const
 {
     SkyPoint result;
@@ -23,6 +23,8 @@ class EquirectangularProjector : public Projector
         double radius() const override;
         bool unusablePoint(const QPointF &p) const override;
         Eigen::Vector2f toScreenVec(const SkyPoint *o, bool oRefract = true, bool *onVisibleHemisphere = nullptr) const override;
+        void toScreenBatch(const double *ra, const double *dec, const double *alt, const double *az, int count,
+                           Eigen::Vector2f *screen, bool *visible, bool oRefract = true) const override;
         SkyPoint fromScreen(const QPointF &p, KStarsData* data, bool onlyAltAz = false) const override;
         QVector<Eigen::Vector2f> groundPoly(SkyPoint *labelpoint = nullptr, bool *drawLabel = nullptr) const override;
         void updateClipPoly() override;
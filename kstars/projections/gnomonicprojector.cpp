@@ -36,3 +36,12 @@ double GnomonicProjector::cosMaxFieldAngle() const
     //Don't let things approach infty.
     return 0.02;
 }
+
+void GnomonicProjector::toScreenBatch(const double *ra, const double *dec, const double *alt, const double *az, int count,
+                                      Eigen::Vector2f *screen, bool *visible, bool oRefract) const
+{
+    projectBatch(ra, dec, alt, az, count, screen, visible, oRefract, cosMaxFieldAngle(), [this](double c)
+    {
+        return GnomonicProjector::projectionK(c);
+    });
+}
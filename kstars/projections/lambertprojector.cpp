@@ -30,3 +30,12 @@ double LambertProjector::projectionL(double x) const
 {
     return 2.0 * asin(0.5 * x);
 }
+
+void LambertProjector::toScreenBatch(const double *ra, const double *dec, const double *alt, const double *az, int count,
+                                     Eigen::Vector2f *screen, bool *visible, bool oRefract) const
+{
+    projectBatch(ra, dec, alt, az, count, screen, visible, oRefract, cosMaxFieldAngle(), [this](double c)
+    {
+        return LambertProjector::projectionK(c);
+    });
+}
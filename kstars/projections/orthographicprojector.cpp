@@ -31,3 +31,12 @@ double OrthographicProjector::projectionL(double x) const
 {
     return asin(x);
 }
+
+void OrthographicProjector::toScreenBatch(const double *ra, const double *dec, const double *alt, const double *az, int count,
+                                          Eigen::Vector2f *screen, bool *visible, bool oRefract) const
+{
+    projectBatch(ra, dec, alt, az, count, screen, visible, oRefract, cosMaxFieldAngle(), [this](double c)
+    {
+        return OrthographicProjector::projectionK(c);
+    });
+}
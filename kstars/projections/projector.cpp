@@ -12,6 +12,8 @@
 #endif
 #include "skycomponents/skylabeler.h"
 
+#include <vector>
+
 namespace
 {
 void toXYZ(const SkyPoint *p, double *x, double *y, double *z)
@@ -95,6 +97,78 @@ QPointF Projector::toScreen(const SkyPoint *o, bool oRefract, bool *onVisibleHem
     return KSUtils::vecToPoint(toScreenVec(o, oRefract, onVisibleHemisphere));
 }
 
+void Projector::toScreenBatch(const double *ra, const double *dec, const double *alt, const double *az, int count,
+                              Eigen::Vector2f *screen, bool *visible, bool oRefract) const
+{
+    projectBatch(ra, dec, alt, az, count, screen, visible, oRefract, cosMaxFieldAngle(), [this](double c)
+    {
+        return projectionK(c);
+    });
+}
+
+void Projector::toScreenBatch(const SkyPoint *const *points, int count, Eigen::Vector2f *screen, bool *visible,
+                              bool oRefract) const
+{
+    if (count <= 0)
+        return;
+
+    std::vector<double> ra(count), dec(count), alt(count), az(count);
+    for (int i = 0; i < count; i++)
+    {
+        ra[i]  = points[i]->ra().Degrees();
+        dec[i] = points[i]->dec().Degrees();
+        alt[i] = points[i]->alt().Degrees();
+        az[i]  = points[i]->az().Degrees();
+    }
+    toScreenBatch(ra.data(), dec.data(), alt.data(), az.data(), count, screen, visible, oRefract);
+}
+
+void Projector::batchOffsets(const double *ra, const double *dec, const double *alt, const double *az, int count,
+                             bool oRefract, double *Y, double *dX) const
+{
+    oRefract &= m_vp.useRefraction;
+    if (m_vp.useAltAz)
+    {
+        const double focusAz = m_vp.focus->az().radians();
+        for (int i = 0; i < count; i++)
+        {
+            Y[i]  = (oRefract ? SkyPoint::refract(alt[i]) : alt[i]) * dms::DegToRad;
+            dX[i] = focusAz - az[i] * dms::DegToRad;
+        }
+    }
+    else
+    {
+        const double focusRA = m_vp.focus->ra().radians();
+        for (int i = 0; i < count; i++)
+        {
+            Y[i]  = dec[i] * dms::DegToRad;
+            dX[i] = ra[i] * dms::DegToRad - focusRA;
+        }
+    }
+
+    Eigen::Map<Eigen::ArrayXd> DX(dX, count);
+    DX -= 2 * dms::PI * ((DX + dms::PI) / (2 * dms::PI)).floor();
+}
+
+void Projector::batchFinish(const double *x, const double *y, const double *c, double cosMaxField,
+                            const double *alt, int count, Eigen::Vector2f *screen, bool *visible) const
+{
+    // rst() over the arrays
+    const double sgn = m_vp.mirror ? -1. : 1.;
+    const double cosR = m_vp.rotationAngle.cos(), sinR = m_vp.rotationAngle.sin();
+    const Eigen::Map<const Eigen::ArrayXd> X(x, count), Y(y, count);
+    const Eigen::ArrayXf sx = (m_vp.width / 2 - m_vp.zoomFactor * (X * (sgn * cosR) - Y * sinR)).cast<float>();
+    const Eigen::ArrayXf sy = (m_vp.height / 2 - m_vp.zoomFactor * (X * (sgn * sinR) + Y * cosR)).cast<float>();
+
+    const bool cullGround = m_vp.fillGround && alt;
+    for (int i = 0; i < count; i++)
+    {
+        const bool finite = std::isfinite(sx[i]) && std::isfinite(sy[i]);
+        screen[i] = finite ? Eigen::Vector2f(sx[i], sy[i]) : Eigen::Vector2f(0, 0);
+        visible[i] = finite && (!c || c[i] > cosMaxField) && !(cullGround && alt[i] <= SkyPoint::altCrit);
+    }
+}
+
 bool Projector::onScreen(const QPointF &p) const
 {
     return (0 <= p.x() && p.x() <= m_vp.width && 0 <= p.y() && p.y() <= m_vp.height);
@@ -127,6 +127,38 @@ class Projector
         virtual Eigen::Vector2f toScreenVec(const SkyPoint *o, bool oRefract = true,
                                             bool *onVisibleHemisphere = nullptr) const;
 
+        /**
+         * @short Project many points at once.
+         *
+         * The result is the same as toScreenVec() for each point, but the focus, the
+         * refraction setting and the projection are looked up once for all of them and the
+         * trigonometry runs over whole arrays. Projectors reimplement this with their own
+         * projectionK() so the inner loop makes no virtual calls.
+         *
+         * The coordinates are in degrees. RA and Dec are only read in the equatorial mode
+         * and may be null otherwise. Alt and Az are read in the horizontal mode, and Alt is
+         * also read when the ground is filled.
+         *
+         * @param ra, dec current equatorial coordinates of the points
+         * @param alt, az horizontal coordinates of the points, without refraction
+         * @param count number of points
+         * @param screen filled with the screen pixel coordinates
+         * @param visible filled with whether each point is on the visible hemisphere and not
+         *   under the ground if it is filled. It is false for points without finite
+         *   coordinates, whose screen position is (0, 0). Whether the point is within the
+         *   screen is left to onScreen().
+         * @param oRefract false to not apply refraction, as toScreenVec()
+         */
+        virtual void toScreenBatch(const double *ra, const double *dec, const double *alt, const double *az, int count,
+                                   Eigen::Vector2f *screen, bool *visible, bool oRefract = true) const;
+
+        /**
+         * @short Project many SkyPoints at once, as toScreenBatch() above.
+         * @note The horizontal coordinates of the points must be current, as for checkVisibility()
+         */
+        void toScreenBatch(const SkyPoint *const *points, int count, Eigen::Vector2f *screen, bool *visible,
+                           bool oRefract = true) const;
+
         /**
          * This is exactly the same as toScreenVec but it returns a QPointF.
          * It just calls toScreenVec and converts the result.
@@ -320,6 +352,50 @@ class Projector
             };
         }
 
+        /**
+         * @short The body of toScreenBatch() for the azimuthal projections
+         * @param cosMaxField cosMaxFieldAngle() of the projection
+         * @param k projectionK() of the projection, called once per point
+         */
+        template <typename ProjectionK>
+        void projectBatch(const double *ra, const double *dec, const double *alt, const double *az, int count,
+                          Eigen::Vector2f *screen, bool *visible, bool oRefract, double cosMaxField,
+                          ProjectionK k) const
+        {
+            if (count <= 0)
+                return;
+
+            Eigen::ArrayXd Y(count), dX(count);
+            batchOffsets(ra, dec, alt, az, count, oRefract, Y.data(), dX.data());
+
+            const Eigen::ArrayXd sinY = Y.sin(), cosY = Y.cos(), sindX = dX.sin(), cosdX = dX.cos();
+            const Eigen::ArrayXd cosYcosdX = cosY * cosdX;
+
+            //c is the cosine of the angular distance from the center
+            const Eigen::ArrayXd c = m_sinY0 * sinY + m_cosY0 * cosYcosdX;
+            const Eigen::ArrayXd K = c.unaryExpr(k);
+            const Eigen::ArrayXd x = K * cosY * sindX;
+            const Eigen::ArrayXd y = K * (m_cosY0 * sinY - m_sinY0 * cosYcosdX);
+
+            batchFinish(x.data(), y.data(), c.data(), cosMaxField, alt, count, screen, visible);
+        }
+
+        /**
+         * @short Fill Y with the latitude, refracted if needed, and dX with the longitude
+         * offset from the focus, both in radians as toScreenVec() uses them. Points without
+         * finite coordinates get NaN in Y.
+         */
+        void batchOffsets(const double *ra, const double *dec, const double *alt, const double *az, int count,
+                          bool oRefract, double *Y, double *dX) const;
+
+        /**
+         * @short Apply rst() to the projected x and y, and fill the visibility as
+         * toScreenBatch() describes it
+         * @param c cosine of the field angle of each point, or null to not check it
+         */
+        void batchFinish(const double *x, const double *y, const double *c, double cosMaxField, const double *alt,
+                         int count, Eigen::Vector2f *screen, bool *visible) const;
+
         /**
          * Transform screen (x, y) to projector (x, y) accounting for scale, rotation
          *
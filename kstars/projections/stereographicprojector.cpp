@@ -37,3 +37,12 @@ double StereographicProjector::cosMaxFieldAngle() const
     // Allow everything
     return -1.0;
 }
+
+void StereographicProjector::toScreenBatch(const double *ra, const double *dec, const double *alt, const double *az, int count,
+                                           Eigen::Vector2f *screen, bool *visible, bool oRefract) const
+{
+    projectBatch(ra, dec, alt, az, count, screen, visible, oRefract, cosMaxFieldAngle(), [this](double c)
+    {
+        return StereographicProjector::projectionK(c);
+    });
+}
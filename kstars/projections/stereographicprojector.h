@@ -23,6 +23,8 @@ class StereographicProjector : public Projector
         double radius() const override;
         double projectionK(double x) const override;
         double projectionL(double x) const override;
+        void toScreenBatch(const double *ra, const double *dec, const double *alt, const double *az, int count,
+                           Eigen::Vector2f *screen, bool *visible, bool oRefract = true) const override;
         double cosMaxFieldAngle() const override;
 };
 
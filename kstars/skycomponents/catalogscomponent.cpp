@@ -13,6 +13,7 @@
 #include "MeshIterator.h"
 #include "projections/projector.h"
 #include "skylabeler.h"
+#include "skyobjects/apparenttransform.h"
 #include "kstars_debug.h"
 #include "kstars.h"
 #include "skymapcomposite.h"
@@ -22,6 +23,7 @@
 #include <QtConcurrent>
 
 #include <cmath>
+#include <vector>
 
 constexpr std::size_t expectedKnownMagObjectsPerTrixel = 500;
 constexpr std::size_t expectedUnknownMagObjectsPerTrixel = 1500;
@@ -158,14 +160,29 @@ void CatalogsComponent::draw(SkyPainter *skyp)
     };
 
     // Helper lambda to JIT update and draw
+    const ApparentTransform transform(data->updateNum(), *data->lst(), *data->geo()->lat());
+    std::vector<const SkyPoint*> points;
+    std::vector<Eigen::Vector2f> screen;
+    // Not std::vector<bool>, which has no data()
+    QVector<bool> visible;
     auto drawObjects = [&](std::vector<CatalogObject*> &objects)
     {
-        // TODO: If we are sure that JITupdate has no side effects
-        // that may cause races etc, it will be worth parallelizing
+        // All the objects of the trixel are updated and projected together
+        CatalogObject::JITupdate(objects, transform);
 
-        for (CatalogObject *object : objects)
+        const int count = static_cast<int>(objects.size());
+        points.assign(objects.begin(), objects.end());
+        screen.resize(count);
+        visible.resize(count);
+        proj.toScreenBatch(points.data(), count, screen.data(), visible.data());
+
+        for (int i = 0; i < count; i++)
         {
-            object->JITupdate();
+            const QPointF pos(screen[i].x(), screen[i].y());
+            if (!visible[i] || !proj.onScreen(pos))
+                continue;
+
+            CatalogObject *object = objects[i];
             auto &color = m_catalog_colors[object->catalogId()][color_scheme];
             if (!color.isValid())
             {
@@ -182,9 +199,9 @@ void CatalogsComponent::draw(SkyPainter *skyp)
             if (Options::showInlineImages())
                 object->load_image();
 
-            if (skyp->drawCatalogObject(*object) && !hideLabels)
+            if (skyp->drawCatalogObject(*object, pos) && !hideLabels)
             {
-                labeler.drawNameLabel(object, proj.toScreen(object), label_padding);
+                labeler.drawNameLabel(object, pos, label_padding);
             }
         }
     };
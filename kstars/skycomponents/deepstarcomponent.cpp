@@ -18,8 +18,12 @@
 #include "starcomponent.h"
 #include "htmesh/MeshIterator.h"
 #include "projections/projector.h"
+#include "skyobjects/apparenttransform.h"
 
 #include <qplatformdefs.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <QtConcurrent>
 #include <QElapsedTimer>
 
@@ -42,9 +46,12 @@ DeepStarComponent::DeepStarComponent(SkyComposite *parent, QString fileName, flo
 
 DeepStarComponent::~DeepStarComponent()
 {
+    // The loader reads the mapping of the file
+    m_Loader.reset();
     if (fileOpened)
         starReader.closeFile();
     fileOpened = false;
+    qDeleteAll(m_StaticObjects);
 }
 
 bool DeepStarComponent::loadStaticStars()
@@ -96,6 +103,15 @@ bool DeepStarComponent::loadStaticStars()
     if (htm_level != m_skyMesh->level())
         qCWarning(KSTARS) << "HTM Level in shallow star data file and HTM Level in m_skyMesh do not match. EXPECT TROUBLE!";
 
+    // Records are copied from the mapping when the file is mapped, otherwise read in sequence from the file
+    const bool mapped = starReader.isMapped();
+
+#ifndef KSTARS_LITE
+    // The stars are packed into arrays, a StarObject is only made of those that are asked for
+    m_StaticArrays.reset(m_skyMesh->size());
+    StarObject star;
+#endif
+
     // JM 2012-12-05: Breaking into 2 loops instead of one previously with multiple IF checks for recordSize
     // While the CPU branch prediction might not suffer any penalties since the branch prediction after a few times
     // should always gets it right. It's better to do it this way to avoid any chances since the compiler might not optimize it.
@@ -105,6 +121,7 @@ bool DeepStarComponent::loadStaticStars()
         {
             Trixel trixel   = i;
             quint64 records = starReader.getRecordCount(i);
+#ifdef KSTARS_LITE
             std::shared_ptr<StarBlock> SB(new StarBlock(records));
 
             if (!SB.get())
@@ -112,10 +129,22 @@ bool DeepStarComponent::loadStaticStars()
                                    << trixel;
 
             m_starBlockList.at(trixel)->setStaticBlock(SB);
+#endif
+
+            const uchar *record = mapped ? starReader.getRecords(trixel) : nullptr;
+            if (mapped && !record)
+                qCCritical(KSTARS) << "ERROR: Records of trixel #" << trixel << " lie outside the catalog file";
 
             for (quint64 j = 0; j < records; ++j)
             {
-                bool fread_success = fread(&stardata, sizeof(StarData), 1, dataFile);
+                bool fread_success = false;
+                if (mapped)
+                {
+                    if ((fread_success = (record != nullptr)))
+                        memcpy(&stardata, record + j * sizeof(StarData), sizeof(StarData));
+                }
+                else
+                    fread_success = fread(&stardata, sizeof(StarData), 1, dataFile);
 
                 if (!fread_success)
                 {
@@ -127,13 +156,9 @@ bool DeepStarComponent::loadStaticStars()
                 if (starReader.getByteSwap())
                     byteSwap(&stardata);
 
-                /* Initialize star with data just read. */
-                StarObject *star;
 #ifdef KSTARS_LITE
-                star = &(SB->addStar(stardata)->star);
-#else
-                star = SB->addStar(stardata);
-#endif
+                /* Initialize star with data just read. */
+                StarObject *star = &(SB->addStar(stardata)->star);
                 if (star)
                 {
                     //KStarsData* data = KStarsData::Instance();
@@ -147,6 +172,12 @@ bool DeepStarComponent::loadStaticStars()
                     qCCritical(KSTARS) << "CODE ERROR: More unnamed static stars in trixel " << trixel
                                        << " than we allocated space for!";
                 }
+#else
+                star.init(&stardata);
+                m_StaticArrays.append(trixel, star, static_cast<quint32>(j));
+                if (stardata.HD)
+                    m_HDRecords.insert(stardata.HD, (static_cast<quint64>(trixel) << 32) | j);
+#endif
             }
         }
     }
@@ -156,6 +187,7 @@ bool DeepStarComponent::loadStaticStars()
         {
             Trixel trixel   = i;
             quint64 records = starReader.getRecordCount(i);
+#ifdef KSTARS_LITE
             std::shared_ptr<StarBlock> SB(new StarBlock(records));
 
             if (!SB.get())
@@ -163,11 +195,22 @@ bool DeepStarComponent::loadStaticStars()
                                    << trixel;
 
             m_starBlockList.at(trixel)->setStaticBlock(SB);
+#endif
+
+            const uchar *record = mapped ? starReader.getRecords(trixel) : nullptr;
+            if (mapped && !record)
+                qCCritical(KSTARS) << "Records of trixel #" << trixel << " lie outside the catalog file";
 
             for (quint64 j = 0; j < records; ++j)
             {
                 bool fread_success = false;
-                fread_success      = fread(&deepstardata, sizeof(DeepStarData), 1, dataFile);
+                if (mapped)
+                {
+                    if ((fread_success = (record != nullptr)))
+                        memcpy(&deepstardata, record + j * sizeof(DeepStarData), sizeof(DeepStarData));
+                }
+                else
+                    fread_success = fread(&deepstardata, sizeof(DeepStarData), 1, dataFile);
 
                 if (!fread_success)
                 {
@@ -179,13 +222,9 @@ bool DeepStarComponent::loadStaticStars()
                 if (starReader.getByteSwap())
                     byteSwap(&deepstardata);
 
-                /* Initialize star with data just read. */
-                StarObject *star;
 #ifdef KSTARS_LITE
-                star = &(SB->addStar(stardata)->star);
-#else
-                star = SB->addStar(deepstardata);
-#endif
+                /* Initialize star with data just read. */
+                StarObject *star = &(SB->addStar(stardata)->star);
                 if (star)
                 {
                     //KStarsData* data = KStarsData::Instance();
@@ -199,10 +238,23 @@ bool DeepStarComponent::loadStaticStars()
                     qCCritical(KSTARS) << "CODE ERROR: More unnamed static stars in trixel " << trixel
                                        << " than we allocated space for!";
                 }
+#else
+                star.init(&deepstardata);
+                m_StaticArrays.append(trixel, star, static_cast<quint32>(j));
+#endif
             }
         }
     }
 
+#ifndef KSTARS_LITE
+    m_StaticArrays.finish();
+    qCInfo(KSTARS) << "Packed" << m_StaticArrays.size() << "stars of" << dataFileName << "into"
+                   << m_StaticArrays.memoryUsage() / 1024 << "KiB";
+#endif
+
+    // All the stars are loaded, nothing more is read from a static catalog
+    starReader.unmapFile();
+
     return true;
 }
 
@@ -288,6 +340,50 @@ void DeepStarComponent::draw(SkyPainter *skyp)
     if (hideFaintStars && maglim > hideStarsMag)
         maglim = hideStarsMag;
 
+    // Stars not yet loaded are read in the background and drawn once they are in, if enabled
+    StarBlockLoader *loader = Options::asyncStarLoading() ? m_Loader.get() : nullptr;
+
+    // Read ahead the trixels the map is likely to move onto, so they are in memory when it does
+    if (!staticStars && starReader.isMapped())
+    {
+        QList<SkyPoint> ahead;
+        ahead.append(*focus);
+
+        // Where the pan is heading in a few frames
+        if (m_HasLastFocus)
+        {
+            double dRA = focus->ra().Degrees() - m_LastFocus.ra().Degrees();
+            if (dRA > 180.0)
+                dRA -= 360.0;
+            else if (dRA < -180.0)
+                dRA += 360.0;
+            const double dDec = focus->dec().Degrees() - m_LastFocus.dec().Degrees();
+            const double step = std::hypot(dRA * cos(focus->dec().radians()), dDec);
+            if (step > 0.01 * radius && step < radius)
+            {
+                const double dec = std::max(-90.0, std::min(90.0, focus->dec().Degrees() + 4 * dDec));
+                ahead.append(SkyPoint(dms(focus->ra().Degrees() + 4 * dRA).reduce(), dms(dec)));
+            }
+        }
+        m_LastFocus = *focus;
+        m_HasLastFocus = true;
+
+        if (map->isSlewing() && map->destination())
+            ahead.append(*map->destination());
+
+        for (const auto &point : ahead)
+        {
+            m_skyMesh->index(&point, std::min(radius * 1.5 + 2.0, 90.0), PREFETCH_BUF);
+            MeshIterator around(m_skyMesh, PREFETCH_BUF);
+            while (around.hasNext())
+            {
+                Trixel trixel = around.next();
+                if (trixel < static_cast<Trixel>(m_starBlockList.size()))
+                    m_starBlockList.at(trixel)->prefetch(maglim, loader);
+            }
+        }
+    }
+
     StarBlockFactory *m_StarBlockFactory = StarBlockFactory::Instance();
     //    m_StarBlockFactory->drawID = m_skyMesh->drawID();
     //    qDebug() << Q_FUNC_INFO << "Mesh size = " << m_skyMesh->size() << "; drawID = " << m_skyMesh->drawID();
@@ -299,6 +395,14 @@ void DeepStarComponent::draw(SkyPainter *skyp)
     t_drawUnnamed = 0;
 
     visibleStarCount = 0;
+    const ApparentTransform transform(data->updateNum(), *data->lst(), *data->geo()->lat());
+
+    // Stars are projected and drawn a trixel or a block at a time
+    const bool equatorial = !map->projector()->viewParams().useAltAz;
+    QVector<double> ra, dec, alt, az;
+    QVector<float> mags;
+    QVector<char> spchars;
+    QVector<bool> drawn;
 
     t.start();
 
@@ -341,11 +445,37 @@ void DeepStarComponent::draw(SkyPainter *skyp)
         if (currentRegion >= m_starBlockList.size())
             continue;
 
-        if (!staticStars)
+        if (staticStars)
         {
-            m_starBlockList.at(currentRegion)->fillToMag(maglim);
+            // Static stars are drawn from the arrays, without making StarObjects of them
+            m_StaticArrays.update(currentRegion, transform, data->updateNumID(), updateID, maglim);
+
+            const int begin = m_StaticArrays.begin(currentRegion), end = m_StaticArrays.end(currentRegion);
+            int count = 0;
+            while (begin + count < end && m_StaticArrays.mag(begin + count) <= maglim)
+                count++;
+
+            if (count > 0)
+            {
+                if (equatorial)
+                {
+                    ra.resize(count);
+                    dec.resize(count);
+                    m_StaticArrays.equatorial(begin, count, ra.data(), dec.data());
+                }
+                drawn.resize(count);
+                skyp->drawPointSources(equatorial ? ra.constData() : nullptr, equatorial ? dec.constData() : nullptr,
+                                       m_StaticArrays.alts() + begin, m_StaticArrays.azs() + begin,
+                                       m_StaticArrays.mags() + begin, m_StaticArrays.spchars() + begin, count,
+                                       drawn.data());
+                visibleStarCount += std::count(drawn.constBegin(), drawn.constEnd(), true);
+            }
+            t_drawUnnamed += t.restart();
+            continue;
         }
 
+        m_starBlockList.at(currentRegion)->fillToMag(maglim, loader);
+
         //        if (!staticStars && !m_starBlockList.at(currentRegion)->fillToMag(maglim) &&
         //            maglim <= m_FaintMagnitude * (1 - 1.5 / 16))
         //        {
@@ -357,16 +487,17 @@ void DeepStarComponent::draw(SkyPainter *skyp)
         //        qDebug() << Q_FUNC_INFO << "Drawing SBL for trixel " << currentRegion << ", SBL has "
         //                 <<  m_starBlockList[ currentRegion ]->getBlockCount() << " blocks";
 
-        // REMARK: The following should never carry state, except for const parameters like updateID and maglim
-        std::function<void(std::shared_ptr<StarBlock>)> mapFunction = [&updateID, &maglim](std::shared_ptr<StarBlock> myBlock)
+        // REMARK: The following should never carry state, except for const parameters like the transform and maglim
+        std::function<void(std::shared_ptr<StarBlock>)> mapFunction = [&transform, &maglim](std::shared_ptr<StarBlock> myBlock)
         {
-            for (StarObject &star : myBlock->contents())
-            {
-                if (star.updateID != updateID)
-                    star.JITupdate();
-                if (star.mag() > maglim)
-                    break;
-            }
+            // Up to and including the first star fainter than maglim, the stars the loop below looks at
+            QVector<StarObject> &stars = myBlock->contents();
+            int count = 0;
+            while (count < stars.size() && stars[count].mag() <= maglim)
+                count++;
+            if (count < stars.size())
+                count++;
+            StarObject::JITupdate(stars.data(), count, transform);
         };
 
         QtConcurrent::blockingMap(m_starBlockList.at(currentRegion)->contents(), mapFunction);
@@ -376,21 +507,33 @@ void DeepStarComponent::draw(SkyPainter *skyp)
             std::shared_ptr<StarBlock> block = m_starBlockList.at(currentRegion)->block(i);
             //            qDebug() << Q_FUNC_INFO << "---> Drawing stars from block " << i << " of trixel " <<
             //                currentRegion << ". SB has " << block->getStarCount() << " stars";
-            for (int j = 0; j < block->getStarCount(); j++)
+            int count = 0;
+            while (count < block->getStarCount() && block->star(count)->mag() <= maglim)
+                count++;
+            if (count == 0)
+                continue;
+
+            // Gather the block's stars to draw, which the map function above has updated
+            ra.resize(count);
+            dec.resize(count);
+            alt.resize(count);
+            az.resize(count);
+            mags.resize(count);
+            spchars.resize(count);
+            drawn.resize(count);
+            for (int j = 0; j < count; j++)
             {
-                StarObject *curStar = block->star(j);
-
-                //                qDebug() << Q_FUNC_INFO << "We claim that he's from trixel " << currentRegion
-                //<< ", and indexStar says he's from " << m_skyMesh->indexStar( curStar );
-
-                float mag = curStar->mag();
-
-                if (mag > maglim)
-                    break;
-
-                if (skyp->drawPointSource(curStar, mag, curStar->spchar()))
-                    visibleStarCount++;
+                const StarObject *curStar = block->star(j);
+                ra[j]      = curStar->ra().Degrees();
+                dec[j]     = curStar->dec().Degrees();
+                alt[j]     = curStar->alt().Degrees();
+                az[j]      = curStar->az().Degrees();
+                mags[j]    = curStar->mag();
+                spchars[j] = curStar->spchar();
             }
+            skyp->drawPointSources(ra.constData(), dec.constData(), alt.constData(), az.constData(), mags.constData(),
+                                   spchars.constData(), count, drawn.data());
+            visibleStarCount += std::count(drawn.constBegin(), drawn.constEnd(), true);
         }
 
         // DEBUG: Uncomment to identify problems with Star Block Factory / preservation of Magnitude Order in the LRU Cache
@@ -461,6 +604,19 @@ bool DeepStarComponent::openDataFile()
         ret = fread(&MSpT, 2, 1, starReader.getFileHandle());
         if (starReader.getByteSwap())
             MSpT = bswap_16(MSpT);
+        if (!starReader.mapFile())
+            qCInfo(KSTARS) << "  Could not map" << dataFileName << ", reading it instead";
+#ifndef KSTARS_LITE
+        else if (!staticStars)
+        {
+            m_Loader.reset(new StarBlockLoader(&starReader));
+            QObject::connect(m_Loader.get(), &StarBlockLoader::recordsReady, m_Loader.get(), []()
+            {
+                if (SkyMap::Instance())
+                    SkyMap::Instance()->forceUpdate();
+            });
+        }
+#endif
         fileOpened = true;
         qCInfo(KSTARS) << "  Sky Mesh Size: " << m_skyMesh->size();
         for (long int i = 0; i < m_skyMesh->size(); i++)
@@ -473,6 +629,7 @@ bool DeepStarComponent::openDataFile()
             }
             m_starBlockList.append(sbl);
         }
+        m_StaticArrays.reset(m_skyMesh->size());
         m_zoomMagLimit = 0.06;
     }
 
@@ -481,10 +638,54 @@ bool DeepStarComponent::openDataFile()
 
 StarObject *DeepStarComponent::findByHDIndex(int HDnum)
 {
+#ifndef KSTARS_LITE
+    auto record = m_HDRecords.constFind(HDnum);
+    if (record != m_HDRecords.constEnd())
+        return staticStar(static_cast<Trixel>(record.value() >> 32), static_cast<quint32>(record.value()));
+#endif
     // Currently, we only handle HD catalog indexes
     return m_CatalogNumber.value(HDnum, nullptr); // TODO: Maybe, make this more general.
 }
 
+StarObject *DeepStarComponent::staticStar(Trixel trixel, quint32 record)
+{
+    const quint64 key = (static_cast<quint64>(trixel) << 32) | record;
+    StarObject *star  = m_StaticObjects.value(key, nullptr);
+
+    if (!star)
+    {
+        FILE *dataFile = starReader.getFileHandle();
+        if (!dataFile || record >= starReader.getRecordCount(trixel))
+            return nullptr;
+
+        const int recordSize = starReader.guessRecordSize();
+        QT_FSEEK(dataFile, starReader.getOffset(trixel) + static_cast<qint64>(record) * recordSize, SEEK_SET);
+        if (recordSize == 32)
+        {
+            if (1 != fread(&stardata, sizeof(StarData), 1, dataFile))
+                return nullptr;
+            if (starReader.getByteSwap())
+                byteSwap(&stardata);
+            star = new StarObject;
+            star->init(&stardata);
+        }
+        else
+        {
+            if (1 != fread(&deepstardata, sizeof(DeepStarData), 1, dataFile))
+                return nullptr;
+            if (starReader.getByteSwap())
+                byteSwap(&deepstardata);
+            star = new StarObject;
+            star->init(&deepstardata);
+        }
+        m_StaticObjects.insert(key, star);
+    }
+
+    if (star->updateID != KStarsData::Instance()->updateID())
+        star->JITupdate();
+    return star;
+}
+
 // This uses the main star index for looking up nearby stars but then
 // filters out objects with the generic name "star".  We could easily
 // build an index for just the named stars which would make this go
@@ -505,6 +706,41 @@ SkyObject *DeepStarComponent::objectNearest(SkyPoint *p, double &maxrad)
 
     MeshIterator region(m_skyMesh, OBJ_NEAREST_BUF);
 
+#ifndef KSTARS_LITE
+    if (staticStars)
+    {
+        KStarsData *data = KStarsData::Instance();
+        SkyPoint point;
+        Trixel bestTrixel = 0;
+        int best = -1;
+        const ApparentTransform transform(data->updateNum(), *data->lst(), *data->geo()->lat());
+
+        while (region.hasNext())
+        {
+            Trixel currentRegion = region.next();
+            m_StaticArrays.update(currentRegion, transform, data->updateNumID(), data->updateID(), m_zoomMagLimit);
+
+            const int end = m_StaticArrays.end(currentRegion);
+            for (int i = m_StaticArrays.begin(currentRegion); i < end; i++)
+            {
+                if (m_StaticArrays.mag(i) > m_zoomMagLimit)
+                    break;
+
+                m_StaticArrays.position(i, point);
+                double r = point.angularDistanceTo(p).Degrees();
+                if (r < maxrad)
+                {
+                    bestTrixel = currentRegion;
+                    best       = i;
+                    maxrad     = r;
+                }
+            }
+        }
+
+        return best >= 0 ? staticStar(bestTrixel, m_StaticArrays.id(best)) : nullptr;
+    }
+#endif
+
     while (region.hasNext())
     {
         Trixel currentRegion = region.next();
@@ -570,9 +806,31 @@ bool DeepStarComponent::starsInAperture(QList<StarObject *> &list, const SkyPoin
     if (maglim < -28)
         maglim = m_FaintMagnitude;
 
+#ifndef KSTARS_LITE
+    double centerVector[3];
+    StarArrays::unitVector(center, centerVector);
+    const double chord2 = StarArrays::chord2(radius);
+#endif
+
     while (region.hasNext())
     {
         Trixel currentRegion = region.next();
+#ifndef KSTARS_LITE
+        if (staticStars)
+        {
+            const int end = m_StaticArrays.end(currentRegion);
+            for (int i = m_StaticArrays.begin(currentRegion); i < end; i++)
+            {
+                if (m_StaticArrays.mag(i) > maglim)
+                    break;
+                if (!m_StaticArrays.within(i, centerVector, chord2))
+                    continue;
+                if (StarObject *star = staticStar(currentRegion, m_StaticArrays.id(i)))
+                    list.append(star);
+            }
+            continue;
+        }
+#endif
         // FIXME: Build a better way to iterate over all stars.
         // Ideally, StarBlockList should have such a facility.
         std::shared_ptr<StarBlockList> sbl = m_starBlockList[currentRegion];
@@ -620,6 +878,11 @@ void DeepStarComponent::byteSwap(StarData *stardata)
     stardata->bv_index = bswap_16(stardata->bv_index);
 }
 
+StarBlockLoader::Statistics DeepStarComponent::loaderStatistics() const
+{
+    return m_Loader ? m_Loader->statistics() : StarBlockLoader::Statistics();
+}
+
 bool DeepStarComponent::verifySBLIntegrity()
 {
     float faintMag = -5.0;
@@ -21,6 +21,10 @@
 #include "starblockfactory.h"
 #include "skyobjects/deepstardata.h"
 #include "skyobjects/stardata.h"
+#include "stararrays.h"
+#include "starblockloader.h"
+
+#include <memory>
 
 class SkyLabeler;
 class SkyMesh;
@@ -90,6 +94,20 @@ class DeepStarComponent : public ListComponent
 
         bool verifySBLIntegrity();
 
+        /**
+         * @return The loader reading this catalog in the background, or nullptr if the catalog is
+         * static or not memory mapped.
+         */
+        inline StarBlockLoader *getLoader()
+        {
+            return m_Loader.get();
+        }
+
+        /**
+         * @return Counters of the background loader, all zero if there is none
+         */
+        StarBlockLoader::Statistics loaderStatistics() const;
+
         /**
          * @short Add to the given list, the stars from this component,
          * that lie within the specified circular aperture, and that are
@@ -114,6 +132,15 @@ class DeepStarComponent : public ListComponent
         static StarBlockFactory m_StarBlockFactory;
 
     private:
+        /**
+         * @short Make a StarObject of a star of a static catalog, reading its record again. The
+         * star is kept until the component is destroyed.
+         * @param trixel where the star is
+         * @param record number of the star in the trixel
+         * @return the star, or nullptr if its record can't be read
+         */
+        StarObject *staticStar(Trixel trixel, quint32 record);
+
         SkyMesh *m_skyMesh { nullptr };
         KSNumbers m_reindexNum;
 
@@ -136,6 +163,13 @@ class DeepStarComponent : public ListComponent
         QVector<std::shared_ptr<StarBlockList>> m_starBlockList;
         QHash<int, StarObject *> m_CatalogNumber;
 
+        /// The stars of a static catalog, the ids are the record numbers in the trixel
+        StarArrays m_StaticArrays;
+        /// Trixel and record number of the stars of a static catalog with HD numbers
+        QHash<int, quint64> m_HDRecords;
+        /// Static stars made into StarObjects, by trixel and record number
+        QHash<quint64, StarObject *> m_StaticObjects;
+
         bool staticStars { false };
 
         // Stuff required for reading data
@@ -143,4 +177,10 @@ class DeepStarComponent : public ListComponent
         StarData stardata;
         BinFileHelper starReader;
         QString dataFileName;
+
+        /// Background reader of the catalog, for dynamic catalogs that could be mapped
+        std::unique_ptr<StarBlockLoader> m_Loader;
+        /// Focus at the last draw, to follow the pan
+        SkyPoint m_LastFocus;
+        bool m_HasLastFocus { false };
 };
@@ -85,9 +85,11 @@ void SatellitesComponent::update(KSNumbers *)
     if (!selected())
         return;
 
+    // Satellites under the horizon are hidden by the ground, their equatorial coordinates aren't needed
+    const Satellite::Observer observer = Satellite::observer(KStarsData::Instance()->clock()->utc().djd());
     for (auto group : m_groups)
     {
-        group->updateSatellitesPos();
+        group->updateSatellitesPos(observer, Options::showGround());
     }
 }
 
@@ -0,0 +1,234 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "stararrays.h"
+
+#include "ksnumbers.h"
+#include "Options.h"
+#include "skyobjects/apparenttransform.h"
+#include "skyobjects/starobject.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+void StarArrays::reset(int trixels)
+{
+    m_Trixels = trixels;
+    m_Staged.clear();
+    m_Start.fill(0, trixels + 1);
+    m_Mag.clear();
+    m_X.clear();
+    m_Y.clear();
+    m_Z.clear();
+    m_PMRA.clear();
+    m_PMDec.clear();
+    m_SpType.clear();
+    m_Id.clear();
+    m_AX.clear();
+    m_AY.clear();
+    m_AZ.clear();
+    m_Alt.clear();
+    m_Az.clear();
+    m_Cache.fill(Cache(), trixels);
+}
+
+void StarArrays::append(Trixel trixel, const StarObject &star, quint32 id)
+{
+    if (trixel < 0 || trixel >= m_Trixels)
+        return;
+
+    double v[3];
+    unitVector(star, v);
+    m_Staged.append(Entry { trixel, star.mag(), static_cast<float>(v[0]), static_cast<float>(v[1]),
+                            static_cast<float>(v[2]), static_cast<float>(star.pmRA()), static_cast<float>(star.pmDec()),
+                            star.spchar(), id });
+}
+
+void StarArrays::finish()
+{
+    std::stable_sort(m_Staged.begin(), m_Staged.end(), [](const Entry & a, const Entry & b)
+    {
+        return a.trixel < b.trixel || (a.trixel == b.trixel && a.mag < b.mag);
+    });
+
+    const int count = m_Staged.size();
+    m_Mag.resize(count);
+    m_X.resize(count);
+    m_Y.resize(count);
+    m_Z.resize(count);
+    m_PMRA.resize(count);
+    m_PMDec.resize(count);
+    m_SpType.resize(count);
+    m_Id.resize(count);
+    m_AX.fill(0, count);
+    m_AY.fill(0, count);
+    m_AZ.fill(0, count);
+    m_Alt.fill(0, count);
+    m_Az.fill(0, count);
+    m_Start.fill(0, m_Trixels + 1);
+
+    for (int i = 0; i < count; i++)
+    {
+        const Entry &entry = m_Staged[i];
+        m_Mag[i] = entry.mag;
+        m_X[i] = entry.x;
+        m_Y[i] = entry.y;
+        m_Z[i] = entry.z;
+        m_PMRA[i] = entry.pmRA;
+        m_PMDec[i] = entry.pmDec;
+        m_SpType[i] = entry.sp;
+        m_Id[i] = entry.id;
+        m_Start[entry.trixel + 1]++;
+    }
+    for (int t = 0; t < m_Trixels; t++)
+        m_Start[t + 1] += m_Start[t];
+
+    m_Staged.clear();
+    m_Staged.squeeze();
+    m_Cache.fill(Cache(), m_Trixels);
+}
+
+void StarArrays::update(Trixel trixel, const ApparentTransform &transform, UpdateID updateNumID,
+                        UpdateID updateID, float maglim)
+{
+    const KSNumbers *num = transform.num();
+    Cache &cache = m_Cache[trixel];
+    if (cache.updateNumID != updateNumID)
+    {
+        cache.updateNumID = updateNumID;
+        // Once per solar minute, as StarObject::JITupdate()
+        if (Options::alwaysRecomputeCoordinates() || std::abs(cache.precessJD - num->getJD()) >= 0.00069444)
+        {
+            cache.precessJD = num->getJD();
+            cache.updated = 0;
+            cache.horizontal = 0;
+        }
+    }
+    if (cache.updateID != updateID)
+    {
+        cache.updateID = updateID;
+        cache.horizontal = 0;
+    }
+
+    const int first = begin(trixel), last = end(trixel);
+    int count = cache.updated;
+    while (first + count < last && m_Mag[first + count] <= maglim)
+        count++;
+
+    if (count > cache.updated)
+    {
+        apparent(first + cache.updated, first + count, transform);
+        cache.updated = count;
+    }
+    if (count > cache.horizontal)
+    {
+        const int from = first + cache.horizontal;
+        transform.toHorizontal(m_AX.constData() + from, m_AY.constData() + from, m_AZ.constData() + from,
+                               count - cache.horizontal, m_Alt.data() + from, m_Az.data() + from);
+        cache.horizontal = count;
+    }
+}
+
+void StarArrays::apparent(int first, int last, const ApparentTransform &transform)
+{
+    const KSNumbers *num = transform.num();
+    const int count = last - first;
+
+    if (Options::useRelativistic())
+    {
+        // The bending of light near the Sun is left to StarObject
+        StarObject star;
+        dms ra0, dec0;
+        double sinRa, cosRa, sinDec, cosDec;
+        for (int i = first; i < last; i++)
+        {
+            const double x = m_X[i], y = m_Y[i], z = m_Z[i];
+            ra0.setRadians(std::atan2(y, x));
+            dec0.setRadians(std::atan2(z, std::sqrt(x * x + y * y)));
+            star.setRA0(ra0.reduce());
+            star.setDec0(dec0);
+            star.setProperMotion(m_PMRA[i], m_PMDec[i]);
+            star.updateCoords(num, true, nullptr, nullptr, true);
+            star.ra().SinCos(sinRa, cosRa);
+            star.dec().SinCos(sinDec, cosDec);
+            m_AX[i] = cosDec * cosRa;
+            m_AY[i] = cosDec * sinRa;
+            m_AZ[i] = sinDec;
+        }
+        return;
+    }
+
+    // Proper motion along the great circle, as in StarObject::getIndexCoords(), with the sines and
+    // cosines of RA and Dec taken from the unit vector
+    const double millenia = num->julianMillenia();
+    const double scale = millenia * (M_PI / (180.0 * 3600.0));
+    std::vector<double> x(count), y(count), z(count);
+    for (int k = 0; k < count; k++)
+    {
+        const int i = first + k;
+        x[k] = m_X[i];
+        y[k] = m_Y[i];
+        z[k] = m_Z[i];
+
+        const double pmRA = m_PMRA[i], pmDec = m_PMDec[i];
+        const double cosDec = std::sqrt(x[k] * x[k] + y[k] * y[k]);
+        if ((pmRA * pmRA + pmDec * pmDec) * millenia * millenia < .01 || cosDec == 0)
+            continue;
+
+        const double cosRa = x[k] / cosDec, sinRa = y[k] / cosDec, sinDec = z[k];
+        const double netRA = pmRA * scale, netDec = pmDec * scale;
+        x[k] += -netRA * sinRa - netDec * sinDec * cosRa;
+        y[k] += netRA * cosRa - netDec * sinDec * sinRa;
+        z[k] += netDec * cosDec;
+    }
+
+    // Normalized along with the aberration
+    transform.toApparent(x.data(), y.data(), z.data(), count, m_AX.data() + first, m_AY.data() + first,
+                         m_AZ.data() + first);
+}
+
+void StarArrays::position(int i, SkyPoint &point) const
+{
+    ApparentTransform::setEquatorial(point, m_AX[i], m_AY[i], m_AZ[i]);
+    point.setAlt(m_Alt[i]);
+    point.setAz(m_Az[i]);
+}
+
+void StarArrays::equatorial(int first, int count, double *ra, double *dec) const
+{
+    for (int i = 0; i < count; i++)
+    {
+        const double x = m_AX[first + i], y = m_AY[first + i], z = m_AZ[first + i];
+        const double r = std::atan2(y, x) * (180.0 / M_PI);
+        ra[i]  = r < 0 ? r + 360.0 : r;
+        dec[i] = std::atan2(z, std::sqrt(x * x + y * y)) * (180.0 / M_PI);
+    }
+}
+
+void StarArrays::unitVector(const SkyPoint &p, double v[3])
+{
+    double sinRa, cosRa, sinDec, cosDec;
+    p.ra0().SinCos(sinRa, cosRa);
+    p.dec0().SinCos(sinDec, cosDec);
+    v[0] = cosDec * cosRa;
+    v[1] = cosDec * sinRa;
+    v[2] = sinDec;
+}
+
+double StarArrays::chord2(double radius)
+{
+    if (radius >= 180.0)
+        return 4.0;
+    const double chord = 2.0 * std::sin(radius * M_PI / 360.0);
+    return chord * chord;
+}
+
+qint64 StarArrays::memoryUsage() const
+{
+    return m_Start.capacity() * sizeof(int) + m_Mag.capacity() * (7 * sizeof(float) + sizeof(char) + sizeof(quint32) +
+            5 * sizeof(double)) + m_Cache.capacity() * sizeof(Cache);
+}
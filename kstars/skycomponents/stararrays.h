@@ -0,0 +1,201 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "typedef.h"
+
+#include <QVector>
+
+class ApparentTransform;
+class SkyPoint;
+class StarObject;
+
+/**
+ * @class StarArrays
+ * Stars of a catalog that is always in memory, packed as arrays.
+ *
+ * Drawing the static catalogs touches every star brighter than the magnitude limit in the visible
+ * trixels. As StarObjects each of them is a few hundred bytes spread over the heap, and drawing
+ * them chases pointers for the magnitude, the update and the projection. Here the stars are kept
+ * as one array per field, sorted by trixel and then by magnitude, so the draw loop reads a few
+ * contiguous arrays and stops at the first star that is too faint.
+ *
+ * The J2000 position is kept as a unit vector, which is exact enough for single precision and lets
+ * starsInAperture() do without trigonometry. The apparent position is cached per trixel as a unit
+ * vector too, and recomputed once per solar minute, as StarObject::JITupdate() does. The
+ * horizontal coordinates are cached until the next update of the sky. Both are computed for all
+ * the stars of a trixel at once with ApparentTransform.
+ *
+ * Each star carries an id given by the owner, which is used to make a StarObject of it when one
+ * is needed for selection, labels or popups.
+ *
+ * @short Structure of arrays for the stars of a static catalog
+ */
+class StarArrays
+{
+    public:
+        StarArrays() = default;
+
+        /** @short Drop all the stars and prepare for a mesh of the given number of trixels */
+        void reset(int trixels);
+
+        /**
+         * @short Add a star. The star isn't found before finish() is called.
+         * @param trixel where the star is indexed
+         * @param star to take the position, proper motion, magnitude and spectral type of
+         * @param id of the star for the owner of the arrays
+         */
+        void append(Trixel trixel, const StarObject &star, quint32 id);
+
+        /**
+         * @short Sort the stars appended since reset() by trixel and magnitude, which makes them
+         * available. Stars appended after that are only found after the next reset() and finish().
+         */
+        void finish();
+
+        /** @return the number of stars */
+        inline int size() const
+        {
+            return m_Mag.size();
+        }
+
+        /** @return the index of the first star of the trixel */
+        inline int begin(Trixel trixel) const
+        {
+            return m_Start[trixel];
+        }
+
+        /** @return the index after the last star of the trixel */
+        inline int end(Trixel trixel) const
+        {
+            return m_Start[trixel + 1];
+        }
+
+        inline float mag(int i) const
+        {
+            return m_Mag[i];
+        }
+
+        inline char spchar(int i) const
+        {
+            return m_SpType[i];
+        }
+
+        inline quint32 id(int i) const
+        {
+            return m_Id[i];
+        }
+
+        /**
+         * @short Bring the apparent and horizontal positions of the stars of a trixel up to date
+         * @param trixel whose stars are to be updated
+         * @param transform to the time and horizon to update to
+         * @param updateNumID KStarsData::updateNumID() of the time
+         * @param updateID KStarsData::updateID() of the horizon
+         * @param maglim stars up to this magnitude are updated, the others when they are needed
+         */
+        void update(Trixel trixel, const ApparentTransform &transform, UpdateID updateNumID, UpdateID updateID,
+                    float maglim);
+
+        /**
+         * @short Set the current RA, Dec, Alt and Az of the point to the position of a star, as of
+         * the last update() of its trixel
+         */
+        void position(int i, SkyPoint &point) const;
+
+        /**
+         * @short Fill ra and dec with the current RA and Dec, in degrees, of count stars from
+         * first on, as of the last update() of their trixel
+         */
+        void equatorial(int first, int count, double *ra, double *dec) const;
+
+        /** @return the magnitudes of all the stars, to pass a range of them at once */
+        inline const float *mags() const
+        {
+            return m_Mag.constData();
+        }
+
+        /** @return the spectral classes of all the stars */
+        inline const char *spchars() const
+        {
+            return m_SpType.constData();
+        }
+
+        /** @return the altitudes of all the stars in degrees, as of the last update() of their trixel */
+        inline const double *alts() const
+        {
+            return m_Alt.constData();
+        }
+
+        /** @return the azimuths of all the stars in degrees, as of the last update() of their trixel */
+        inline const double *azs() const
+        {
+            return m_Az.constData();
+        }
+
+        /**
+         * @short Find out if a star is within a circle around a J2000 position
+         * @param i index of the star
+         * @param center J2000 unit vector of the center, from unitVector()
+         * @param chord2 square of the chord length of the radius, from chord2()
+         */
+        inline bool within(int i, const double center[3], double chord2) const
+        {
+            const double dx = m_X[i] - center[0], dy = m_Y[i] - center[1], dz = m_Z[i] - center[2];
+            return dx * dx + dy * dy + dz * dz <= chord2;
+        }
+
+        /** @short Fill v with the unit vector of the J2000 position of p */
+        static void unitVector(const SkyPoint &p, double v[3]);
+
+        /** @return the square of the chord length subtending the angle, in degrees */
+        static double chord2(double radius);
+
+        /** @return the bytes used by the arrays */
+        qint64 memoryUsage() const;
+
+    private:
+        struct Entry
+        {
+            Trixel trixel;
+            float mag;
+            float x, y, z;
+            float pmRA, pmDec;
+            char sp;
+            quint32 id;
+        };
+
+        /** Apparent positions of the stars of a trixel */
+        struct Cache
+        {
+            UpdateID updateNumID { 0 };
+            UpdateID updateID { 0 };
+            double precessJD { 0 };
+            /// The first stars of the trixel whose apparent position is current
+            int updated { 0 };
+            /// The first stars of the trixel whose horizontal position is current
+            int horizontal { 0 };
+        };
+
+        /** Compute the apparent positions of the stars from first to last */
+        void apparent(int first, int last, const ApparentTransform &transform);
+
+        int m_Trixels { 0 };
+        QVector<Entry> m_Staged;
+
+        QVector<int> m_Start;
+        QVector<float> m_Mag;
+        QVector<float> m_X, m_Y, m_Z;
+        QVector<float> m_PMRA, m_PMDec;
+        QVector<char> m_SpType;
+        QVector<quint32> m_Id;
+
+        // Apparent unit vectors, and Alt and Az in degrees
+        QVector<double> m_AX, m_AY, m_AZ;
+        QVector<double> m_Alt, m_Az;
+        QVector<Cache> m_Cache;
+};
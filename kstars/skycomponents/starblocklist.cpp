@@ -9,6 +9,7 @@
 #include "binfilehelper.h"
 #include "deepstarcomponent.h"
 #include "starblock.h"
+#include "starblockloader.h"
 #include "starcomponent.h"
 
 #ifdef KSTARS_LITE
@@ -18,6 +19,8 @@
 
 #include <QDebug>
 
+#include <cstring>
+
 StarBlockList::StarBlockList(const Trixel &tr, DeepStarComponent *parent)
 {
     trixel       = tr;
@@ -59,7 +62,7 @@ int StarBlockList::releaseBlock(StarBlock *block)
     return 0;
 }
 
-bool StarBlockList::fillToMag(float maglim)
+bool StarBlockList::fillToMag(float maglim, StarBlockLoader *loader)
 {
     // TODO: Remove staticity of BinFileHelper
     BinFileHelper *dSReader;
@@ -76,7 +79,11 @@ bool StarBlockList::fillToMag(float maglim)
         return false;
 
     if (faintMag >= maglim)
+    {
+        if (loader)
+            loader->countHit();
         return true;
+    }
 
     if (!dataFile)
     {
@@ -92,7 +99,35 @@ bool StarBlockList::fillToMag(float maglim)
 
     Q_ASSERT(nBlocks == (unsigned int)blocks.size());
 
-    BinFileHelper::unsigned_KDE_fseek(dataFile, readOffset, SEEK_SET);
+    // If the catalog is memory mapped, the records are decoded straight from the mapping
+    const uchar *mapped = dSReader->getRecords(trixelId) ? dSReader->getMappedData() : nullptr;
+    const uchar *next = mapped ? mapped + readOffset : nullptr;
+    const uchar *end = nullptr;
+
+    // With a loader, only the records it has staged are decoded and the rest are asked for
+    QByteArray staged;
+    if (loader && mapped)
+    {
+        if (nStars >= dSReader->getRecordCount(trixelId))
+        {
+            loader->countHit();
+            return false;
+        }
+
+        staged = loader->take(trixelId, nStars);
+        if (staged.isEmpty())
+        {
+            loader->countMiss();
+            loader->request(trixelId, nStars, maglim, true);
+            return false;
+        }
+        loader->countHit();
+        next = reinterpret_cast<const uchar *>(staged.constData());
+        end = next + staged.size();
+    }
+
+    if (!mapped)
+        BinFileHelper::unsigned_KDE_fseek(dataFile, readOffset, SEEK_SET);
 
     /*
     qDebug() << Q_FUNC_INFO << "Reading trixel" << trixel << ", id on disk =" << trixelId << ", currently nStars =" << nStars
@@ -100,7 +135,7 @@ bool StarBlockList::fillToMag(float maglim)
              << "to maglim =" << maglim << "with current faintMag =" << faintMag;
     */
 
-    while (maglim >= faintMag && nStars < dSReader->getRecordCount(trixelId))
+    while (maglim >= faintMag && nStars < dSReader->getRecordCount(trixelId) && (!end || next < end))
     {
         int ret = 0;
 
@@ -126,7 +161,13 @@ bool StarBlockList::fillToMag(float maglim)
         // TODO: Make this more general
         if (dSReader->guessRecordSize() == 32)
         {
-            ret = fread(&stardata, sizeof(StarData), 1, dataFile);
+            if (next)
+            {
+                memcpy(&stardata, next, sizeof(StarData));
+                next += sizeof(StarData);
+            }
+            else
+                ret = fread(&stardata, sizeof(StarData), 1, dataFile);
             if (dSReader->getByteSwap())
                 DeepStarComponent::byteSwap(&stardata);
             readOffset += sizeof(StarData);
@@ -134,7 +175,13 @@ bool StarBlockList::fillToMag(float maglim)
         }
         else
         {
-            ret = fread(&deepstardata, sizeof(DeepStarData), 1, dataFile);
+            if (next)
+            {
+                memcpy(&deepstardata, next, sizeof(DeepStarData));
+                next += sizeof(DeepStarData);
+            }
+            else
+                ret = fread(&deepstardata, sizeof(DeepStarData), 1, dataFile);
             if (dSReader->getByteSwap())
                 DeepStarComponent::byteSwap(&deepstardata);
             readOffset += sizeof(DeepStarData);
@@ -151,9 +198,28 @@ bool StarBlockList::fillToMag(float maglim)
         nStars++;
     }
 
+    // The staged records ran out, e.g. because the map zoomed in since they were asked for
+    if (loader && mapped && maglim >= faintMag && nStars < dSReader->getRecordCount(trixelId))
+        loader->request(trixelId, nStars, maglim, true);
+
     return ((maglim < faintMag) ? true : false);
 }
 
+void StarBlockList::prefetch(float maglim, StarBlockLoader *loader)
+{
+    if (staticStars || !parent || faintMag >= maglim)
+        return;
+
+    BinFileHelper *dSReader = parent->getStarReader();
+    if (nStars >= dSReader->getRecordCount(trixel))
+        return;
+
+    if (loader)
+        loader->request(trixel, nStars, maglim, false);
+    else
+        dSReader->prefetchRecords(trixel, nStars);
+}
+
 void StarBlockList::setStaticBlock(std::shared_ptr<StarBlock> &block)
 {
     if (!block)
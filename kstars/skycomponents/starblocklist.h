@@ -10,6 +10,7 @@
 
 class DeepStarComponent;
 class StarBlock;
+class StarBlockLoader;
 
 /**
  * @class StarBlockList
@@ -33,9 +34,23 @@ class StarBlockList
          * @short Ensures that the list is loaded with stars to given magnitude limit
          *
          * @param maglim Magnitude limit to load stars upto
-         * @return true on success, false on failure (data file not found, bad seek etc)
+         * @param loader If given, and the catalog is memory mapped, only the records the loader has
+         * staged are loaded and the others are requested from it, so this never waits for the disk.
+         * @return true on success, false on failure (data file not found, bad seek, records not yet
+         * loaded etc)
          */
-        bool fillToMag(float maglim);
+        bool fillToMag(float maglim, StarBlockLoader *loader = nullptr);
+
+        /**
+         * @short Asks for the records that fillToMag() would read next to be read ahead, so that
+         * they are in memory when this trixel comes into view. Only effective if the catalog file
+         * is memory mapped.
+         *
+         * @param maglim Magnitude limit that the trixel will be drawn to
+         * @param loader If given, the records are requested from the loader, otherwise the kernel
+         * is asked to read them ahead.
+         */
+        void prefetch(float maglim, StarBlockLoader *loader = nullptr);
 
         /**
          * @short Sets the first StarBlock in the list to point to the given StarBlock
@@ -0,0 +1,224 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "starblockloader.h"
+
+#include "binfilehelper.h"
+#include "byteorder.h"
+#include "skyobjects/deepstardata.h"
+#include "skyobjects/stardata.h"
+
+#include <QMutexLocker>
+#include <QtConcurrent>
+
+#include <kstars_debug.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+// Limits on the queue and the staged records. Requests are a few KiB each, the limits are only reached
+// when slewing over a large area.
+static constexpr int MAX_QUEUED = 512;
+static constexpr int MAX_STAGED_KIB = 32 * 1024;
+// Records read for one request, at most
+static constexpr quint32 MAX_REQUEST_BYTES = 1024 * 1024;
+
+StarBlockLoader::StarBlockLoader(const BinFileHelper *reader, QObject *parent) : QObject(parent), m_Reader(reader)
+{
+    m_Pool.setMaxThreadCount(1);
+    m_Staged.setMaxCost(MAX_STAGED_KIB);
+    m_LogTimer.start();
+}
+
+StarBlockLoader::~StarBlockLoader()
+{
+    m_Stopping = true;
+    {
+        QMutexLocker locker(&m_Mutex);
+        m_Queue.clear();
+    }
+    m_Pool.waitForDone();
+}
+
+void StarBlockLoader::request(Trixel trixel, quint32 firstRecord, float maglim, bool visible)
+{
+    QMutexLocker locker(&m_Mutex);
+
+    // Already staged, or already asked for
+    const Staged *staged = m_Staged.object(trixel);
+    if (staged && staged->firstRecord == firstRecord)
+        return;
+    for (int i = 0; i < m_Queue.size(); i++)
+    {
+        Request &queued = m_Queue[i];
+        if (queued.trixel != trixel)
+            continue;
+        if (queued.firstRecord == firstRecord && queued.maglim >= maglim && (queued.visible || !visible))
+            return;
+        // Replace it, a visible request jumps the queue
+        m_Queue.removeAt(i);
+        break;
+    }
+
+    const Request request { trixel, firstRecord, maglim, visible };
+    if (visible)
+    {
+        // Behind the other visible requests
+        int i = 0;
+        while (i < m_Queue.size() && m_Queue[i].visible)
+            i++;
+        m_Queue.insert(i, request);
+    }
+    else
+        m_Queue.append(request);
+
+    // Give up on the oldest predictions
+    while (m_Queue.size() > MAX_QUEUED && !m_Queue.last().visible)
+        m_Queue.removeLast();
+
+    if (!m_Running)
+    {
+        m_Running = true;
+        (void)QtConcurrent::run(&m_Pool, [this]()
+        {
+            run();
+        });
+    }
+}
+
+QByteArray StarBlockLoader::take(Trixel trixel, quint32 firstRecord)
+{
+    QMutexLocker locker(&m_Mutex);
+    Staged *staged = m_Staged.take(trixel);
+    if (!staged)
+        return QByteArray();
+
+    QByteArray records;
+    if (staged->firstRecord == firstRecord)
+        records = staged->records;
+    delete staged;
+    return records;
+}
+
+void StarBlockLoader::clear()
+{
+    QMutexLocker locker(&m_Mutex);
+    m_Queue.clear();
+    m_Staged.clear();
+}
+
+StarBlockLoader::Statistics StarBlockLoader::statistics() const
+{
+    Statistics statistics;
+    statistics.hits = m_Hits;
+    statistics.misses = m_Misses;
+    statistics.loaded = m_Loaded;
+
+    QMutexLocker locker(&m_Mutex);
+    statistics.queueDepth = m_Queue.size();
+    statistics.staged = m_Staged.size();
+    return statistics;
+}
+
+void StarBlockLoader::run()
+{
+    bool visibleStaged = false;
+    while (!m_Stopping)
+    {
+        Request request;
+        {
+            QMutexLocker locker(&m_Mutex);
+            if (m_Queue.isEmpty())
+            {
+                m_Running = false;
+                break;
+            }
+            request = m_Queue.takeFirst();
+        }
+
+        // The page faults happen here, without the lock
+        QByteArray records = read(request);
+
+        bool ready = false;
+        {
+            QMutexLocker locker(&m_Mutex);
+            if (!records.isEmpty())
+            {
+                Staged *staged = new Staged { request.firstRecord, records };
+                m_Staged.insert(request.trixel, staged, std::max(1, static_cast<int>(records.size() / 1024)));
+                visibleStaged |= request.visible;
+            }
+
+            // Let the map draw what is staged before reading the predictions
+            const bool endOfVisible = m_Queue.isEmpty() || !m_Queue.first().visible;
+            ready = visibleStaged && endOfVisible;
+        }
+        m_Loaded++;
+        if (ready)
+        {
+            visibleStaged = false;
+            Q_EMIT recordsReady();
+        }
+    }
+
+    if (m_LogTimer.elapsed() > 10000)
+    {
+        m_LogTimer.restart();
+        const Statistics s = statistics();
+        qCDebug(KSTARS) << "Star block loader: hits" << s.hits << "misses" << s.misses << "loaded" << s.loaded
+                        << "queued" << s.queueDepth << "staged" << s.staged;
+    }
+}
+
+QByteArray StarBlockLoader::read(const Request &request) const
+{
+    const uchar *records = m_Reader->getRecords(request.trixel);
+    const quint32 count = m_Reader->getRecordCount(request.trixel);
+    const int recordSize = m_Reader->guessRecordSize();
+    if (!records || recordSize <= 0 || request.firstRecord >= count)
+        return QByteArray();
+
+    // Records are sorted by magnitude. Read up to and including the first one fainter than maglim,
+    // which is where fillToMag() stops.
+    const quint32 maxRecords = std::max(1U, MAX_REQUEST_BYTES / recordSize);
+    quint32 end = request.firstRecord;
+    while (end < count && end - request.firstRecord < maxRecords)
+    {
+        const float mag = recordMagnitude(records + static_cast<qint64>(end) * recordSize, recordSize,
+                                          m_Reader->getByteSwap());
+        end++;
+        if (mag > request.maglim)
+            break;
+    }
+
+    return QByteArray(reinterpret_cast<const char *>(records + static_cast<qint64>(request.firstRecord) * recordSize),
+                      (end - request.firstRecord) * recordSize);
+}
+
+float StarBlockLoader::recordMagnitude(const uchar *record, int recordSize, bool byteSwap)
+{
+    if (recordSize == 32)
+    {
+        qint16 mag;
+        memcpy(&mag, record + offsetof(StarData, mag), sizeof(mag));
+        if (byteSwap)
+            mag = bswap_16(mag);
+        return mag / 100.0;
+    }
+
+    qint16 B, V;
+    memcpy(&B, record + offsetof(DeepStarData, B), sizeof(B));
+    memcpy(&V, record + offsetof(DeepStarData, V), sizeof(V));
+    if (byteSwap)
+    {
+        B = bswap_16(B);
+        V = bswap_16(V);
+    }
+    if (V == 30000 && B != 30000)
+        return (B - 1600) / 1000.0;
+    return V / 1000.0;
+}
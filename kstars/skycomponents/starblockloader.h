@@ -0,0 +1,148 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "typedef.h"
+
+#include <QByteArray>
+#include <QCache>
+#include <QElapsedTimer>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QThreadPool>
+
+#include <atomic>
+
+class BinFileHelper;
+
+/**
+ * @class StarBlockLoader
+ * Reads the records of a memory mapped deep star catalog in the background.
+ *
+ * Reading a trixel that hasn't been visited yet means waiting for the disk. Rather than do that in
+ * the paint event, StarBlockList::fillToMag() asks for the records it is missing and the map draws
+ * the stars that are already loaded. A worker thread copies the requested records out of the
+ * mapping, which takes the page faults, and stages them. The next draw turns the staged records
+ * into stars, which only copies memory. When records for a visible trixel are staged, recordsReady()
+ * is emitted so the map can be redrawn.
+ *
+ * Trixels the map is expected to move onto, following the pan or slew, are requested too but
+ * behind the visible ones and without a redraw.
+ *
+ * StarBlocks and the StarBlockFactory cache belong to the thread drawing the map so they are only
+ * ever filled there. The loader never touches them.
+ *
+ * @short Background reader of deep star catalog records
+ */
+class StarBlockLoader : public QObject
+{
+        Q_OBJECT
+
+    public:
+        /** Counters for tuning the StarBlockFactory cache and the read ahead */
+        struct Statistics
+        {
+            /// fillToMag() calls that found the stars loaded or the records staged
+            quint64 hits { 0 };
+            /// fillToMag() calls that had to wait for records
+            quint64 misses { 0 };
+            /// Requests read by the worker
+            quint64 loaded { 0 };
+            /// Requests waiting for the worker
+            int queueDepth { 0 };
+            /// Trixels whose records are staged
+            int staged { 0 };
+        };
+
+        /**
+         * @param reader of the catalog, which must stay mapped while the loader exists
+         */
+        explicit StarBlockLoader(const BinFileHelper *reader, QObject *parent = nullptr);
+
+        /** Stops the worker, waiting for the record it is reading */
+        ~StarBlockLoader() override;
+
+        /**
+         * @short Ask for the records of a trixel to be staged
+         * @param trixel whose records are wanted
+         * @param firstRecord the first record wanted, i.e. the number of stars already loaded
+         * @param maglim records are wanted up to this magnitude
+         * @param visible trixels are read before the others, and recordsReady() is emitted when
+         * they are staged
+         */
+        void request(Trixel trixel, quint32 firstRecord, float maglim, bool visible);
+
+        /**
+         * @short Take the staged records of a trixel
+         * @param trixel whose records are wanted
+         * @param firstRecord the first record wanted. Records staged from a different record are dropped.
+         * @return The records as they are in the file, or an empty array if none are staged
+         */
+        QByteArray take(Trixel trixel, quint32 firstRecord);
+
+        /** Drop the queued requests and the staged records */
+        void clear();
+
+        void countHit()
+        {
+            m_Hits++;
+        }
+        void countMiss()
+        {
+            m_Misses++;
+        }
+
+        Statistics statistics() const;
+
+        /**
+         * @short Magnitude of a record, as StarObject::init() calculates it
+         * @param record in the file
+         * @param recordSize 32 for StarData, otherwise DeepStarData
+         * @param byteSwap if the file has the other byte order
+         */
+        static float recordMagnitude(const uchar *record, int recordSize, bool byteSwap);
+
+    Q_SIGNALS:
+        /** Records of a visible trixel are staged */
+        void recordsReady();
+
+    private:
+        struct Request
+        {
+            Trixel trixel { 0 };
+            quint32 firstRecord { 0 };
+            float maglim { 0 };
+            bool visible { false };
+        };
+
+        struct Staged
+        {
+            quint32 firstRecord { 0 };
+            QByteArray records;
+        };
+
+        /** Worker, reads requests until the queue is empty */
+        void run();
+        /** Copy the records of a request out of the mapping */
+        QByteArray read(const Request &request) const;
+
+        const BinFileHelper *m_Reader { nullptr };
+        QThreadPool m_Pool;
+
+        mutable QMutex m_Mutex;
+        QList<Request> m_Queue;
+        // Staged records, cost in KiB
+        QCache<Trixel, Staged> m_Staged;
+        bool m_Running { false };
+        std::atomic<bool> m_Stopping { false };
+
+        std::atomic<quint64> m_Hits { 0 };
+        std::atomic<quint64> m_Misses { 0 };
+        std::atomic<quint64> m_Loaded { 0 };
+        QElapsedTimer m_LogTimer;
+};
@@ -20,6 +20,7 @@
 #include "skymesh.h"
 #ifndef KSTARS_LITE
 #include "skyqpainter.h"
+#include "skyobjects/apparenttransform.h"
 #endif
 #include "htmesh/MeshIterator.h"
 #include "projections/projector.h"
@@ -54,6 +55,7 @@ StarComponent::StarComponent(SkyComposite *parent)
     m_starIndex.reset(new StarIndex());
     for (int i = 0; i < m_skyMesh->size(); i++)
         m_starIndex->append(new StarList());
+    m_Arrays.reset(m_skyMesh->size());
     m_highPMStars.append(new HighPMStarList(840.0));
     m_highPMStars.append(new HighPMStarList(304.0));
     m_reindexInterval = StarObject::reindexInterval(304.0);
@@ -146,6 +148,7 @@ bool StarComponent::reindex(KSNumbers *num)
     if (std::abs(num->julianCenturies() - m_reindexNum.julianCenturies()) > m_reindexInterval)
     {
         reindexAll(num);
+        indexArrays();
         return true;
     }
 
@@ -155,9 +158,31 @@ bool StarComponent::reindex(KSNumbers *num)
     for (auto &star : m_highPMStars)
         highPM &= !(star->reindex(num, m_starIndex.get()));
 
+    if (!highPM)
+        indexArrays();
+
     return !(highPM);
 }
 
+void StarComponent::indexArrays()
+{
+    QHash<const SkyObject *, Trixel> trixels;
+    for (int trixel = 0; trixel < m_starIndex->size(); trixel++)
+    {
+        for (const auto &star : *m_starIndex->at(trixel))
+            trixels.insert(star, trixel);
+    }
+
+    m_Arrays.reset(m_skyMesh->size());
+    for (int i = 0; i < m_ObjectList.size(); i++)
+    {
+        auto trixel = trixels.constFind(m_ObjectList[i]);
+        if (trixel != trixels.constEnd())
+            m_Arrays.append(trixel.value(), *static_cast<StarObject *>(m_ObjectList[i]), i);
+    }
+    m_Arrays.finish();
+}
+
 void StarComponent::reindexAll(KSNumbers *num)
 {
 #if 0
@@ -299,6 +324,9 @@ void StarComponent::draw(SkyPainter *skyp)
         sizeMagLim = faintMagnitude() * (1 - 1.5 / 16);
     skyp->setSizeMagLimit(sizeMagLim);
 
+    // The stars may be painted on several threads, up to endPointSourceLayer()
+    skyp->beginPointSourceLayer();
+
     //Loop for drawing star images
 
     MeshIterator region(m_skyMesh, DRAW_BUF);
@@ -311,32 +339,56 @@ void StarComponent::draw(SkyPainter *skyp)
     m_StarBlockFactory->drawID = m_skyMesh->drawID();
 
     int nTrixels = 0;
+    SkyPoint point;
+    const ApparentTransform transform(data->updateNum(), *data->lst(), *data->geo()->lat());
+
+    // The stars of a trixel are projected and drawn together. RA and Dec are only needed by the
+    // equatorial projection.
+    const bool equatorial = !proj->viewParams().useAltAz;
+    QVector<double> ra, dec;
+    QVector<bool> drawn;
 
     while (region.hasNext())
     {
         ++nTrixels;
         Trixel currentRegion = region.next();
-        StarList *starList   = m_starIndex->at(currentRegion);
-
-        for (auto &star : *starList)
-        {
-            if (!star)
-                continue;
-
-            float mag = star->mag();
+        m_Arrays.update(currentRegion, transform, data->updateNumID(), data->updateID(), maglim);
 
-            // break loop if maglim is reached
-            if (mag > maglim)
-                break;
+        // Sorted by magnitude, so the stars to draw come first
+        const int begin = m_Arrays.begin(currentRegion), end = m_Arrays.end(currentRegion);
+        int count = 0;
+        while (begin + count < end && m_Arrays.mag(begin + count) <= maglim)
+            count++;
+        if (count == 0)
+            continue;
 
-            if (star->updateID != updateID)
-                star->JITupdate();
+        if (equatorial)
+        {
+            ra.resize(count);
+            dec.resize(count);
+            m_Arrays.equatorial(begin, count, ra.data(), dec.data());
+        }
+        drawn.resize(count);
+        skyp->drawPointSources(equatorial ? ra.constData() : nullptr, equatorial ? dec.constData() : nullptr,
+                               m_Arrays.alts() + begin, m_Arrays.azs() + begin, m_Arrays.mags() + begin,
+                               m_Arrays.spchars() + begin, count, drawn.data());
 
-            bool drawn = skyp->drawPointSource(star, mag, star->spchar());
+        if (m_hideLabels)
+            continue;
 
+        for (int i = 0; i < count; i++)
+        {
             //FIXME_SKYPAINTER: find a better way to do this.
-            if (drawn && !(m_hideLabels || mag > labelMagLim))
-                addLabel(proj->toScreen(star), star);
+            if (drawn[i] && m_Arrays.mag(begin + i) <= labelMagLim)
+            {
+                m_Arrays.position(begin + i, point);
+
+                // The labeler wants the star itself
+                StarObject *star = arrayStar(begin + i);
+                if (star->updateID != updateID)
+                    star->JITupdate();
+                addLabel(proj->toScreen(&point), star);
+            }
         }
     }
 
@@ -354,6 +406,8 @@ void StarComponent::draw(SkyPainter *skyp)
     {
         component->draw(skyp);
     }
+
+    skyp->endPointSourceLayer();
 #else
     Q_UNUSED(skyp)
 #endif
@@ -572,6 +626,9 @@ bool StarComponent::loadStaticData()
     dataReader.closeFile();
     nameReader.closeFile();
 
+    indexArrays();
+    qCInfo(KSTARS) << "Packed" << m_Arrays.size() << "named stars into" << m_Arrays.memoryUsage() / 1024 << "KiB";
+
     starsLoaded = true;
     return true;
 }
@@ -680,31 +737,42 @@ SkyObject *StarComponent::objectNearest(SkyPoint *p, double &maxrad)
     m_zoomMagLimit = zoomMagnitudeLimit();
 
     SkyObject *oBest = nullptr;
+    KStarsData *data = KStarsData::Instance();
+    SkyPoint point;
+    int best = -1;
+    const ApparentTransform transform(data->updateNum(), *data->lst(), *data->geo()->lat());
 
     MeshIterator region(m_skyMesh, OBJ_NEAREST_BUF);
 
     while (region.hasNext())
     {
         Trixel currentRegion = region.next();
-        StarList *starList   = m_starIndex->at(currentRegion);
+        m_Arrays.update(currentRegion, transform, data->updateNumID(), data->updateID(), m_zoomMagLimit);
 
-        for (auto &star : *starList)
+        const int end = m_Arrays.end(currentRegion);
+        for (int i = m_Arrays.begin(currentRegion); i < end; i++)
         {
-            if (!star)
-                continue;
-            if (star->mag() > m_zoomMagLimit)
-                continue;
+            if (m_Arrays.mag(i) > m_zoomMagLimit)
+                break;
 
-            double r = star->angularDistanceTo(p).Degrees();
+            m_Arrays.position(i, point);
+            double r = point.angularDistanceTo(p).Degrees();
 
             if (r < maxrad)
             {
-                oBest  = star;
+                best   = i;
                 maxrad = r;
             }
         }
     }
 
+    if (best >= 0)
+    {
+        StarObject *star = arrayStar(best);
+        star->JITupdate();
+        oBest = star;
+    }
+
     // Check up with our Deep Star Components too!
     double rTry, rBest;
     SkyObject *oTry;
@@ -738,19 +806,28 @@ void StarComponent::starsInAperture(QList<StarObject *> &list, const SkyPoint &c
     if (maglim < -28)
         maglim = m_FaintMagnitude;
 
+    // Compared in J2000, which the index is in too
+    double centerVector[3];
+    StarArrays::unitVector(center, centerVector);
+    const double chord2 = StarArrays::chord2(radius);
+    const UpdateID updateID = KStarsData::Instance()->updateID();
+
     while (region.hasNext())
     {
         Trixel currentRegion = region.next();
-        StarList *starList   = m_starIndex->at(currentRegion);
 
-        for (auto &star : *starList)
+        const int end = m_Arrays.end(currentRegion);
+        for (int i = m_Arrays.begin(currentRegion); i < end; i++)
         {
-            if (!star)
-                continue;
-            if (star->mag() > m_FaintMagnitude)
+            if (m_Arrays.mag(i) > maglim)
+                break;
+            if (!m_Arrays.within(i, centerVector, chord2))
                 continue;
-            if (star->angularDistanceTo(&center).Degrees() <= radius)
-                list.append(star);
+
+            StarObject *star = arrayStar(i);
+            if (star->updateID != updateID)
+                star->JITupdate();
+            list.append(star);
         }
     }
 
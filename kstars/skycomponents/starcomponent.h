@@ -9,6 +9,7 @@
 #include "ksnumbers.h"
 #include "listcomponent.h"
 #include "skylabel.h"
+#include "stararrays.h"
 #include "stardata.h"
 #include "skyobjects/starobject.h"
 
@@ -166,6 +167,15 @@ class StarComponent : public ListComponent
 
         void reindexAll(KSNumbers *num);
 
+        /** Pack the stars of the index into m_Arrays, after loading or re-indexing them */
+        void indexArrays();
+
+        /** @return the named star of the given index of m_Arrays */
+        inline StarObject *arrayStar(int i) const
+        {
+            return static_cast<StarObject *>(m_ObjectList[m_Arrays.id(i)]);
+        }
+
         /** Load available deep star catalogs */
         int loadDeepStarCatalogs();
 
@@ -173,6 +183,8 @@ class StarComponent : public ListComponent
 
         SkyMesh *m_skyMesh { nullptr };
         std::unique_ptr<StarIndex> m_starIndex;
+        /// The stars of m_starIndex packed for drawing, the ids are indexes of m_ObjectList
+        StarArrays m_Arrays;
 
         KSNumbers m_reindexNum;
         double m_reindexInterval { 0 };
@@ -0,0 +1,98 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "apparenttransform.h"
+
+#include "cachingdms.h"
+#include "ksnumbers.h"
+#include "skypoint.h"
+
+#include <Eigen/Geometry>
+
+#include <cmath>
+
+ApparentTransform::ApparentTransform(const KSNumbers *num, const dms &LST, const dms &lat) : m_Num(num)
+{
+    // Nutation rotates the ecliptic of date by the nutation in longitude and tilts the equator
+    // by the nutation in obliquity, Seidelmann (3.222-3). To first order this is Meeus (23.1).
+    const double obliquity = num->obliquity()->radians();
+    const double dObliquity = dms(num->dObliq()).radians();
+    const double dLongitude = dms(num->dEcLong()).radians();
+    const Eigen::Matrix3d nutation = (Eigen::AngleAxisd(obliquity + dObliquity, Eigen::Vector3d::UnitX()) *
+                                      Eigen::AngleAxisd(dLongitude, Eigen::Vector3d::UnitZ()) *
+                                      Eigen::AngleAxisd(-obliquity, Eigen::Vector3d::UnitX())).toRotationMatrix();
+    m_Apparent.noalias() = nutation * num->p2();
+
+    // The velocity of the Earth of Meeus (23.2), in the frame of date. Adding it to a unit
+    // vector before normalizing gives the corrections of Meeus (23.3).
+    double sinL, cosL, sinP, cosP, sinOb, cosOb;
+    num->sunTrueLongitude().SinCos(sinL, cosL);
+    num->earthPerihelionLongitude().SinCos(sinP, cosP);
+    num->obliquity()->SinCos(sinOb, cosOb);
+    const double K = num->constAberr().radians();
+    const double e = num->earthEccentricity();
+    m_Aberration << K * (sinL - e * sinP), K * cosOb * (e * cosP - cosL), K * sinOb * (e * cosP - cosL);
+
+    double sinLST, cosLST, sinLat, cosLat;
+    LST.SinCos(sinLST, cosLST);
+    lat.SinCos(sinLat, cosLat);
+    m_Horizon << cosLat * cosLST, cosLat * sinLST, sinLat,
+              -sinLat * cosLST, -sinLat * sinLST, cosLat,
+              -sinLST, cosLST, 0;
+}
+
+void ApparentTransform::toApparent(const double *x, const double *y, const double *z, int count, double *ax,
+                                   double *ay, double *az) const
+{
+    if (count <= 0)
+        return;
+
+    const Eigen::Map<const Eigen::ArrayXd> X(x, count), Y(y, count), Z(z, count);
+    Eigen::Map<Eigen::ArrayXd> AX(ax, count), AY(ay, count), AZ(az, count);
+    const Eigen::Matrix3d &m = m_Apparent;
+
+    AX = m(0, 0) * X + m(0, 1) * Y + m(0, 2) * Z + m_Aberration(0);
+    AY = m(1, 0) * X + m(1, 1) * Y + m(1, 2) * Z + m_Aberration(1);
+    AZ = m(2, 0) * X + m(2, 1) * Y + m(2, 2) * Z + m_Aberration(2);
+
+    const Eigen::ArrayXd scale = (AX.square() + AY.square() + AZ.square()).rsqrt();
+    AX *= scale;
+    AY *= scale;
+    AZ *= scale;
+}
+
+void ApparentTransform::toHorizontal(const double *x, const double *y, const double *z, int count, double *alt,
+                                     double *az) const
+{
+    if (count <= 0)
+        return;
+
+    const Eigen::Map<const Eigen::ArrayXd> X(x, count), Y(y, count), Z(z, count);
+    Eigen::Map<Eigen::ArrayXd> up(alt, count), north(az, count);
+    const Eigen::Matrix3d &h = m_Horizon;
+
+    up = h(0, 0) * X + h(0, 1) * Y + h(0, 2) * Z;
+    north = h(1, 0) * X + h(1, 1) * Y + h(1, 2) * Z;
+    const Eigen::ArrayXd east = h(2, 0) * X + h(2, 1) * Y;
+
+    for (int i = 0; i < count; i++)
+    {
+        const double n = north[i], e = east[i];
+        alt[i] = std::atan2(up[i], std::sqrt(n * n + e * e)) * (180.0 / M_PI);
+        double a = std::atan2(e, n) * (180.0 / M_PI);
+        az[i] = a < 0 ? a + 360.0 : a;
+    }
+}
+
+void ApparentTransform::setEquatorial(SkyPoint &point, double x, double y, double z)
+{
+    CachingDms ra, dec;
+    ra.setUsing_atan2(y, x);
+    ra.reduceToRange(dms::ZERO_TO_2PI);
+    dec.setUsing_atan2(z, std::sqrt(x * x + y * y));
+    point.setRA(ra);
+    point.setDec(dec);
+}
@@ -0,0 +1,90 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <Eigen/Core>
+
+class dms;
+class KSNumbers;
+class SkyPoint;
+
+/**
+ * @class ApparentTransform
+ * Apparent and horizontal coordinates of many J2000 positions at once.
+ *
+ * SkyPoint::updateCoords() goes from the catalog position to the apparent one in steps, each
+ * of them turning the position into RA and Dec and back: precession as a rotation of the unit
+ * vector, then nutation and aberration as corrections to RA and Dec. EquatorialToHorizontal()
+ * then takes another round of trigonometry. For the thousands of stars drawn per frame this is
+ * most of the time spent outside of painting.
+ *
+ * Here the precession and the nutation of a given time are folded into a single rotation, and
+ * the aberration, which is the same for every position, into a vector added before normalizing,
+ * so the apparent position of a J2000 unit vector is a 3x3 product, an addition and a scaling.
+ * The horizon of a given LST and latitude is another rotation. Positions are given as separate
+ * arrays of x, y and z so these steps run over whole arrays, which Eigen vectorizes. Only the
+ * final angles are left to scalar atan2().
+ *
+ * The results agree with SkyPoint::updateCoords() and EquatorialToHorizontal() to a few
+ * milliarcseconds, which is the second order of the nutation and aberration Meeus neglects.
+ * The bending of light near the Sun isn't included, see Options::useRelativistic().
+ *
+ * Vectors are in the frame of the equator and equinox: x towards RA 0h, z towards the pole.
+ *
+ * @short Batched J2000 to apparent to horizontal transform
+ */
+class ApparentTransform
+{
+    public:
+        /**
+         * @short Prepare the transform for a given time and place
+         * @param num time to transform to
+         * @param LST local sidereal time of the horizon
+         * @param lat latitude of the horizon
+         */
+        ApparentTransform(const KSNumbers *num, const dms &LST, const dms &lat);
+
+        /** @return the time the transform was made for */
+        inline const KSNumbers *num() const
+        {
+            return m_Num;
+        }
+
+        /**
+         * @short Find the apparent positions of J2000 unit vectors
+         * @param x, y, z components of the J2000 unit vectors
+         * @param count number of vectors
+         * @param ax, ay, az filled with the components of the apparent unit vectors. They may not
+         * overlap the input.
+         */
+        void toApparent(const double *x, const double *y, const double *z, int count, double *ax, double *ay,
+                        double *az) const;
+
+        /**
+         * @short Find the horizontal coordinates of apparent unit vectors
+         * @param x, y, z components of the apparent unit vectors, from toApparent()
+         * @param count number of vectors
+         * @param alt filled with the altitudes in degrees, without refraction
+         * @param az filled with the azimuths in degrees, from north through east
+         */
+        void toHorizontal(const double *x, const double *y, const double *z, int count, double *alt, double *az) const;
+
+        /**
+         * @short Set the current RA and Dec of a point to those of a unit vector, along with
+         * their sines and cosines
+         */
+        static void setEquatorial(SkyPoint &point, double x, double y, double z);
+
+    private:
+        const KSNumbers *m_Num { nullptr };
+        /// Precession and nutation
+        Eigen::Matrix3d m_Apparent;
+        /// Velocity of the Earth in units of the speed of light, in the frame of date
+        Eigen::Vector3d m_Aberration;
+        /// Rows are the zenith, north and east directions in the frame of date
+        Eigen::Matrix3d m_Horizon;
+};
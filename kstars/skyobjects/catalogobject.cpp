@@ -6,6 +6,8 @@
 */
 
 #include "catalogobject.h"
+#include "apparenttransform.h"
+#include "ksnumbers.h"
 #include "ksutils.h"
 #include "Options.h"
 #include "skymap.h"
@@ -14,6 +16,7 @@
 #include "kspopupmenu.h"
 #include "catalogsdb.h"
 #include <QCryptographicHash>
+#include <cmath>
 #include <typeinfo>
 
 CatalogObject *CatalogObject::clone() const
@@ -92,6 +95,77 @@ void CatalogObject::JITupdate()
     }
 }
 
+void CatalogObject::JITupdate(const std::vector<CatalogObject *> &objects, const ApparentTransform &transform)
+{
+    KStarsData *data{ KStarsData::Instance() };
+    const KSNumbers *num = transform.num();
+
+    // The bending of light is computed object by object
+    if (Options::useRelativistic())
+    {
+        for (CatalogObject *object : objects)
+            object->JITupdate();
+        return;
+    }
+
+    // Objects whose coordinates are recomputed, once per solar minute as in
+    // `SkyPoint::updateCoords()`, and those whose horizontal coordinates are
+    std::vector<CatalogObject *> recompute, horizontal;
+    std::vector<double> x, y, z;
+    for (CatalogObject *object : objects)
+    {
+        if (object->m_updateID == data->updateID())
+            continue;
+        object->m_updateID = data->updateID();
+        horizontal.push_back(object);
+
+        if (object->m_updateNumID == data->updateNumID())
+            continue;
+        object->m_updateNumID = data->updateNumID();
+        if (!Options::alwaysRecomputeCoordinates() && std::abs(object->lastPrecessJD - num->getJD()) < 0.00069444)
+            continue;
+
+        double sinRa, cosRa, sinDec, cosDec;
+        object->ra0().SinCos(sinRa, cosRa);
+        object->dec0().SinCos(sinDec, cosDec);
+        recompute.push_back(object);
+        x.push_back(cosDec * cosRa);
+        y.push_back(cosDec * sinRa);
+        z.push_back(sinDec);
+    }
+
+    const int recomputed = static_cast<int>(recompute.size());
+    std::vector<double> ax(recomputed), ay(recomputed), az(recomputed);
+    transform.toApparent(x.data(), y.data(), z.data(), recomputed, ax.data(), ay.data(), az.data());
+    for (int i = 0; i < recomputed; i++)
+    {
+        ApparentTransform::setEquatorial(*recompute[i], ax[i], ay[i], az[i]);
+        recompute[i]->lastPrecessJD = num->getJD();
+    }
+
+    const int count = static_cast<int>(horizontal.size());
+    x.resize(count);
+    y.resize(count);
+    z.resize(count);
+    for (int i = 0; i < count; i++)
+    {
+        double sinRa, cosRa, sinDec, cosDec;
+        horizontal[i]->ra().SinCos(sinRa, cosRa);
+        horizontal[i]->dec().SinCos(sinDec, cosDec);
+        x[i] = cosDec * cosRa;
+        y[i] = cosDec * sinRa;
+        z[i] = sinDec;
+    }
+
+    std::vector<double> alt(count), azimuth(count);
+    transform.toHorizontal(x.data(), y.data(), z.data(), count, alt.data(), azimuth.data());
+    for (int i = 0; i < count; i++)
+    {
+        horizontal[i]->setAlt(alt[i]);
+        horizontal[i]->setAz(azimuth[i]);
+    }
+}
+
 void CatalogObject::initPopupMenu(KSPopupMenu *pmenu)
 {
 #ifndef KSTARS_LITE
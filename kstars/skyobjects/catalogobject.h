@@ -16,7 +16,9 @@
 #include <QImage>
 #include <array>
 #include <utility>
+#include <vector>
 
+class ApparentTransform;
 class KSPopupMenu;
 class KStarsData;
 class CatalogComponent;
@@ -166,6 +168,13 @@ class CatalogObject : public SkyObject
          */
         void JITupdate();
 
+        /**
+         * Update several objects at once, as `JITupdate()` does for each
+         * of them, with `transform` to the current time and horizon of
+         * `KStarsData`.
+         */
+        static void JITupdate(const std::vector<CatalogObject *> &objects, const ApparentTransform &transform);
+
         /**
          * Initialize the popup menu for a `CatalogObject`.
          */
@@ -0,0 +1,254 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "ephemeriscache.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+constexpr int COEFFICIENTS = EphemerisCache::DEGREE + 1;
+// The fit of a piece is checked against the series at CHECKS + 1 points, the ends included
+constexpr int CHECKS = 4 * COEFFICIENTS;
+constexpr double TWO_PI = 2.0 * dms::PI;
+
+thread_local bool enabledOnThread = false;
+
+// Bring an angle difference within [-pi, pi]
+double wrap(double angle)
+{
+    return angle - TWO_PI * std::round(angle / TWO_PI);
+}
+}
+
+EphemerisCache::Scope::Scope() : m_WasEnabled(enabledOnThread)
+{
+    enabledOnThread = true;
+}
+
+EphemerisCache::Scope::~Scope()
+{
+    enabledOnThread = m_WasEnabled;
+}
+
+EphemerisCache *EphemerisCache::Instance()
+{
+    static EphemerisCache cache;
+    return &cache;
+}
+
+bool EphemerisCache::isEnabled()
+{
+    return enabledOnThread;
+}
+
+EphemerisCache::EphemerisCache()
+{
+    // Spans over which polynomials of degree 12 are within the tolerance almost everywhere. The Earth
+    // and the Moon have terms of a few days, the outer planets move slowly but their distance has
+    // small terms of short period.
+    m_Bodies["Mercury"].span = 16;
+    m_Bodies["Venus"].span = 64;
+    m_Bodies["Earth"].span = 16;
+    m_Bodies["Mars"].span = 64;
+    m_Bodies["Jupiter"].span = 128;
+    m_Bodies["Saturn"].span = 64;
+    m_Bodies["Uranus"].span = 128;
+    m_Bodies["Neptune"].span = 128;
+    m_Bodies["Moon"].span = 8;
+}
+
+bool EphemerisCache::position(const QString &body, double days, const Series &series, EclipticPosition &position)
+{
+    double span = 0;
+    qint64 index = 0;
+    Segment segment;
+    bool found = false;
+    {
+        const std::lock_guard<std::mutex> lock(m_Mutex);
+        const auto b = m_Bodies.constFind(body);
+        if (b == m_Bodies.constEnd() || b->span <= 0)
+            return false;
+
+        span = b->span;
+        index = static_cast<qint64>(std::floor(days / span));
+        const auto s = b->segments.constFind(index);
+        if (s != b->segments.constEnd())
+        {
+            segment = s.value();
+            found = true;
+            if (segment.pieces > 0)
+                m_Statistics.hits++;
+        }
+    }
+
+    // Fitting takes a few dozen evaluations of the series, don't hold the other threads meanwhile.
+    // Two threads may fit the same segment, which is harmless.
+    if (!found)
+    {
+        segment = fit(index * span, span, series);
+
+        const std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Statistics.fits++;
+        if (segment.pieces > 1)
+            m_Statistics.splits++;
+        else if (segment.pieces == 0)
+            m_Statistics.fallbacks++;
+
+        Body &b = m_Bodies[body];
+        if (b.span == span)
+        {
+            if (b.segments.size() >= MAX_SEGMENTS)
+                b.segments.clear();
+            b.segments.insert(index, segment);
+        }
+    }
+
+    if (segment.pieces == 0)
+    {
+        series(days, position);
+        return true;
+    }
+
+    const double pieceSpan = span / segment.pieces;
+    const double offset = days - index * span;
+    const int piece = std::min(std::max(static_cast<int>(offset / pieceSpan), 0), segment.pieces - 1);
+    const double x = 2.0 * (offset - piece * pieceSpan) / pieceSpan - 1.0;
+    evaluate(segment.coefficients.constData() + piece * 3 * COEFFICIENTS, x, position);
+    return true;
+}
+
+EphemerisCache::Segment EphemerisCache::fit(double start, double span, const Series &series)
+{
+    Segment segment;
+    for (int pieces = 1; pieces <= MAX_PIECES; pieces *= 2)
+    {
+        const double pieceSpan = span / pieces;
+        segment.coefficients.clear();
+        segment.coefficients.reserve(pieces * 3 * COEFFICIENTS);
+
+        bool fitted = true;
+        for (int piece = 0; fitted && piece < pieces; piece++)
+            fitted = fitPiece(start + piece * pieceSpan, pieceSpan, series, segment.coefficients);
+
+        if (fitted)
+        {
+            segment.pieces = pieces;
+            return segment;
+        }
+    }
+
+    segment.pieces = 0;
+    segment.coefficients.clear();
+    return segment;
+}
+
+bool EphemerisCache::fitPiece(double start, double span, const Series &series, QVector<double> &coefficients) const
+{
+    const auto time = [start, span](double x)
+    {
+        return start + 0.5 * span * (x + 1.0);
+    };
+
+    // Sample the series at the Chebyshev nodes, in time order so that the longitude can be unwrapped
+    double values[3][COEFFICIENTS];
+    EclipticPosition sample;
+    for (int k = COEFFICIENTS - 1; k >= 0; k--)
+    {
+        series(time(std::cos(dms::PI * (k + 0.5) / COEFFICIENTS)), sample);
+        values[0][k] = sample.longitude.radians();
+        values[1][k] = sample.latitude.radians();
+        values[2][k] = sample.radius;
+        if (k < COEFFICIENTS - 1)
+            values[0][k] = values[0][k + 1] + wrap(values[0][k] - values[0][k + 1]);
+    }
+
+    const int first = coefficients.size();
+    for (int c = 0; c < 3; c++)
+    {
+        for (int j = 0; j < COEFFICIENTS; j++)
+        {
+            double sum = 0;
+            for (int k = 0; k < COEFFICIENTS; k++)
+                sum += values[c][k] * std::cos(dms::PI * j * (k + 0.5) / COEFFICIENTS);
+            coefficients.append((j == 0 ? 1.0 : 2.0) * sum / COEFFICIENTS);
+        }
+    }
+
+    // The error of the fit is largest at the extrema of the first term left out, the ends included, as
+    // long as the terms left out decrease quickly. Terms of the series shorter than the piece don't, and
+    // can peak between the extrema, so the fit is also checked at three points between each of them
+    EclipticPosition fitted;
+    for (int m = 0; m <= CHECKS; m++)
+    {
+        const double x = std::cos(dms::PI * m / CHECKS);
+        series(time(x), sample);
+        evaluate(coefficients.constData() + first, x, fitted);
+
+        if (std::abs(wrap(fitted.longitude.radians() - sample.longitude.radians())) > ANGLE_TOLERANCE ||
+                std::abs(fitted.latitude.radians() - sample.latitude.radians()) > ANGLE_TOLERANCE ||
+                std::abs(fitted.radius - sample.radius) > ANGLE_TOLERANCE * std::abs(sample.radius))
+        {
+            coefficients.resize(first);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void EphemerisCache::evaluate(const double *coefficients, double x, EclipticPosition &position)
+{
+    double result[3];
+    for (int c = 0; c < 3; c++)
+    {
+        // Clenshaw's recurrence
+        const double *a = coefficients + c * COEFFICIENTS;
+        double b1 = 0, b2 = 0;
+        for (int j = COEFFICIENTS - 1; j > 0; j--)
+        {
+            const double b = 2.0 * x * b1 - b2 + a[j];
+            b2 = b1;
+            b1 = b;
+        }
+        result[c] = x * b1 - b2 + a[0];
+    }
+
+    double longitude = std::fmod(result[0], TWO_PI);
+    if (longitude < 0)
+        longitude += TWO_PI;
+    position.longitude.setRadians(longitude);
+    position.latitude.setRadians(result[1]);
+    position.radius = result[2];
+}
+
+void EphemerisCache::setSpan(const QString &body, double days)
+{
+    const std::lock_guard<std::mutex> lock(m_Mutex);
+    Body &b = m_Bodies[body];
+    b.span = std::max(days, 0.0);
+    b.segments.clear();
+}
+
+double EphemerisCache::span(const QString &body) const
+{
+    const std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Bodies.value(body).span;
+}
+
+void EphemerisCache::clear()
+{
+    const std::lock_guard<std::mutex> lock(m_Mutex);
+    for (auto &b : m_Bodies)
+        b.segments.clear();
+}
+
+EphemerisCache::Statistics EphemerisCache::statistics() const
+{
+    const std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Statistics;
+}
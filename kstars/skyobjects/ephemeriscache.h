@@ -0,0 +1,135 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "ksplanetbase.h"
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+#include <functional>
+#include <mutex>
+
+/**
+ * @class EphemerisCache
+ * Chebyshev approximations of the ecliptic positions of the major planets and of the Moon.
+ *
+ * The time is cut in segments of a fixed span for each body. The first time a position within a
+ * segment is asked for, the full series (VSOP87 for the planets, the ELP terms of Meeus for the
+ * Moon) are evaluated at the Chebyshev nodes of the segment and the polynomials fitted to them.
+ * The polynomials are then checked against the series at 4 * (DEGREE + 1) + 1 points, the
+ * extrema of the first neglected term, where the error of the fit is usually the largest, and
+ * three points between each of them. A segment that is off by more than ANGLE_TOLERANCE at any
+ * of them is cut in halves, up to MAX_PIECES, and one that still is falls back to the series.
+ * The check is a dense sampling, not a proof: a term of the series much shorter than a piece
+ * could still exceed the tolerance between the points, which the segment spans are chosen to
+ * make negligible, and the tests measure the error at random times against the series.
+ *
+ * Positions in a segment already fitted cost a few dozen multiplications instead of thousands
+ * of cosines, which pays off when scanning time as the conjunction, eclipse and calendar tools
+ * do. The sky map, which computes each body once per update, does not use the cache.
+ *
+ * The cache is only used on the threads that enable it with a Scope, and is thread-safe.
+ *
+ * @short Cached Chebyshev ephemerides of the planets and the Moon
+ */
+class EphemerisCache
+{
+    public:
+        /**
+         * Computes the position of a body from the full series.
+         * @param days since J2000
+         * @param position ecliptic longitude, latitude and distance in AU
+         */
+        typedef std::function<void (double days, EclipticPosition &position)> Series;
+
+        /** Enables the cache on the current thread while it lives */
+        class Scope
+        {
+            public:
+                Scope();
+                ~Scope();
+
+            private:
+                bool m_WasEnabled { false };
+        };
+
+        static EphemerisCache *Instance();
+
+        /** @return true if the cache is enabled on the current thread */
+        static bool isEnabled();
+
+        /**
+         * @short Find the position of a body
+         * @param body untranslated name of the body, e.g. "Mars" or "Moon"
+         * @param days since J2000
+         * @param series computes the position of the body from the full series
+         * @param position set to the position of the body
+         * @return false if the body has no span set, in which case position is left unchanged
+         */
+        bool position(const QString &body, double days, const Series &series, EclipticPosition &position);
+
+        /**
+         * @short Set the span of the segments of a body, dropping those already fitted
+         * @param days span of each segment, 0 to not cache the body
+         */
+        void setSpan(const QString &body, double days);
+        /** @return the span of the segments of a body in days, 0 if it isn't cached */
+        double span(const QString &body) const;
+
+        /** @short Drop all the segments */
+        void clear();
+
+        struct Statistics
+        {
+            qint64 hits { 0 };
+            /// Segments fitted
+            qint64 fits { 0 };
+            /// Segments cut in pieces to meet the tolerance
+            qint64 splits { 0 };
+            /// Segments left to the full series
+            qint64 fallbacks { 0 };
+        };
+        Statistics statistics() const;
+
+        /** Largest error allowed in longitude and latitude, in radians, and in distance relative to it */
+        static constexpr double ANGLE_TOLERANCE { 5e-9 };
+        /** Degree of the Chebyshev polynomials */
+        static constexpr int DEGREE { 12 };
+        /** Most pieces a segment is cut into before falling back to the series */
+        static constexpr int MAX_PIECES { 8 };
+        /** Segments kept for each body before they are all dropped */
+        static constexpr int MAX_SEGMENTS { 4096 };
+
+    private:
+        EphemerisCache();
+
+        struct Segment
+        {
+            /// Number of pieces of equal span, 0 if the segment is left to the series
+            int pieces { 0 };
+            /// For each piece, the coefficients of longitude, latitude and distance
+            QVector<double> coefficients;
+        };
+
+        struct Body
+        {
+            double span { 0 };
+            QHash<qint64, Segment> segments;
+        };
+
+        // Fit a segment starting at start, cutting it until it meets the tolerance
+        Segment fit(double start, double span, const Series &series);
+        // Fit one piece, appending its coefficients, return false if it is off by more than the tolerance
+        bool fitPiece(double start, double span, const Series &series, QVector<double> &coefficients) const;
+        static void evaluate(const double *coefficients, double x, EclipticPosition &position);
+
+        mutable std::mutex m_Mutex;
+        QHash<QString, Body> m_Bodies;
+        Statistics m_Statistics;
+};
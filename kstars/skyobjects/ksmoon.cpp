@@ -6,6 +6,7 @@
 
 #include "ksmoon.h"
 
+#include "ephemeriscache.h"
 #include "ksnumbers.h"
 #include "ksutils.h"
 #include "kssun.h"
@@ -151,17 +152,42 @@ bool KSMoon::loadData()
 }
 
 bool KSMoon::findGeocentricPosition(const KSNumbers *num, const KSPlanetBase *)
+{
+    if (!loadData())
+        return false;
+
+    // Tools scanning time use the Chebyshev fits of the series
+    const double T = num->julianCenturies();
+    const auto series = [](double days, EclipticPosition & position)
+    {
+        calcEclipticSeries(days / 36525.0, position);
+    };
+    EclipticPosition position;
+    if (!EphemerisCache::isEnabled() || !EphemerisCache::Instance()->position("Moon", T * 36525.0, series, position))
+        calcEclipticSeries(T, position);
+
+    //Geocentric coordinates
+    setEcLong(position.longitude);
+    setEcLat(position.latitude);
+    Rearth = position.radius;
+
+    EclipticToEquatorial(num->obliquity());
+
+    //Determine position angle
+    findPA(num);
+
+    return true;
+}
+
+void KSMoon::calcEclipticSeries(double T, EclipticPosition &position)
 {
     //Algorithms in this subroutine are taken from Chapter 45 of "Astronomical Algorithms"
     //by Jean Meeus (1991, Willmann-Bell, Inc. ISBN 0-943396-35-2.  https://www.willbell.com/math/mc1.htm)
     //updated to Jean Messus (1998, Willmann-Bell, http://www.naughter.com/aa.html )
 
-    double T, L, D, M, M1, F, A1, A2, A3;
+    double L, D, M, M1, F, A1, A2, A3;
     double sumL, sumR, sumB;
 
-    //Julian centuries since J2000
-    T = num->julianCenturies();
-
     double Et = 1.0 - 0.002516 * T - 0.0000074 * T * T;
 
     //Moon's mean longitude
@@ -188,9 +214,6 @@ bool KSMoon::findGeocentricPosition(const KSNumbers *num, const KSPlanetBase *)
     sumL = 0.0;
     sumR = 0.0;
 
-    if (!loadData())
-        return false;
-
     for (const auto &mlrd : LRData)
     {
         double E = 1.0;
@@ -224,17 +247,9 @@ bool KSMoon::findGeocentricPosition(const KSNumbers *num, const KSPlanetBase *)
     sumB += (-2235.0 * sin(L) + 382.0 * sin(A3) + 175.0 * sin(A1 - F) + 175.0 * sin(A1 + F) + 127.0 * sin(L - M1) -
              115.0 * sin(L + M1));
 
-    //Geocentric coordinates
-    setEcLong(dms(sumL / 1000000.0 + L * 180.0 / dms::PI)); //convert radians to degrees
-    setEcLat(dms(sumB / 1000000.0));
-    Rearth = (385000.56 + sumR / 1000.0) / AU_KM; //distance from Earth, in AU
-
-    EclipticToEquatorial(num->obliquity());
-
-    //Determine position angle
-    findPA(num);
-
-    return true;
+    position.longitude = dms(sumL / 1000000.0 + L * 180.0 / dms::PI).reduce(); //convert radians to degrees
+    position.latitude = dms(sumB / 1000000.0);
+    position.radius = (385000.56 + sumR / 1000.0) / AU_KM; //distance from Earth, in AU
 }
 
 void KSMoon::findMagnitude(const KSNumbers *)
@@ -93,6 +93,13 @@ class KSMoon : public KSPlanetBase
     private:
         void findMagnitude(const KSNumbers *) override;
 
+        /**
+         * Sum the series for the geocentric ecliptic coordinates of the Moon, the data must be loaded.
+         * @param T Julian Centuries since J2000
+         * @param position the longitude, latitude and distance from Earth in AU
+         */
+        static void calcEclipticSeries(double T, EclipticPosition &position);
+
         static bool data_loaded;
         static int instance_count;
 
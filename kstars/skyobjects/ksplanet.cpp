@@ -6,6 +6,7 @@
 
 #include "ksplanet.h"
 
+#include "ephemeriscache.h"
 #include "ksnumbers.h"
 #include "ksutils.h"
 #include "ksfilereader.h"
@@ -190,6 +191,22 @@ bool KSPlanet::loadData()
 }
 
 void KSPlanet::calcEcliptic(double Tau, EclipticPosition &epret) const
+{
+    // Tools scanning time use the Chebyshev fits of the series
+    if (EphemerisCache::isEnabled())
+    {
+        const auto series = [this](double days, EclipticPosition & position)
+        {
+            calcEclipticSeries(days / 365250.0, position);
+        };
+        if (EphemerisCache::Instance()->position(untranslatedName(), Tau * 365250.0, series, epret))
+            return;
+    }
+
+    calcEclipticSeries(Tau, epret);
+}
+
+void KSPlanet::calcEclipticSeries(double Tau, EclipticPosition &epret) const
 {
     double sum[6];
     OrbitDataColl odc;
@@ -73,6 +73,14 @@ class KSPlanet : public KSPlanetBase
          */
         virtual void calcEcliptic(double jm, EclipticPosition &ret) const;
 
+        /**
+         * Calculate the ecliptic coordinates as calcEcliptic() does, always summing the
+         * series rather than using the EphemerisCache.
+         * @param jm Julian Millenia (=jd/1000)
+         * @param ret The ecliptic coordinates are returned by reference through this argument.
+         */
+        void calcEclipticSeries(double jm, EclipticPosition &ret) const;
+
     protected:
         /**
          * Calculate the geocentric RA, Dec coordinates of the Planet.
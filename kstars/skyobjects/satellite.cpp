@@ -11,9 +11,7 @@
 #include "kspopupmenu.h"
 #endif
 #include "kstarsdata.h"
-#include "kssun.h"
 #include "Options.h"
-#include "skymapcomposite.h"
 #include "kstars_debug.h"
 
 #include <cmath>
@@ -702,30 +700,94 @@ void Satellite::init()
     }
 }
 
+Satellite::Observer Satellite::observer(double jd)
+{
+    return observer(jd, KStarsData::Instance()->geo());
+}
+
+Satellite::Observer Satellite::observer(double jd, GeoLocation *geo)
+{
+    Observer observer;
+    observer.jd = jd;
+
+    // Observer ECI position
+    observer.lat = *geo->lat();
+    observer.lat.SinCos(observer.sinLat, observer.cosLat);
+    observer.lst.setRadians(geo->LMST(jd));
+    observer.lst.SinCos(observer.sinTheta, observer.cosTheta);
+    const double c     = 1.0 / sqrt(1.0 + F * (F - 2.0) * observer.sinLat * observer.sinLat);
+    const double sq    = (1.0 - F) * (1.0 - F) * c;
+    const double achcp = (RADIUSEARTHKM * c + MEANALT) * observer.cosLat;
+    observer.position[0] = achcp * observer.cosTheta;
+    observer.position[1] = achcp * observer.sinTheta;
+    observer.position[2] = (RADIUSEARTHKM * sq + MEANALT) * observer.sinLat;
+    observer.distance    = sqrt(observer.position[0] * observer.position[0] + observer.position[1] * observer.position[1] +
+                                observer.position[2] * observer.position[2]);
+
+    // Find ECI coordinates of the sun
+    double mjd, year, T, M, L, e, C, O, Lsa, nu, R, eps;
+
+    mjd  = jd - 2415020.0;
+    year = 1900.0 + mjd / 365.25;
+    T    = (mjd + deltaET(year) / (MINPD * 60.0)) / 36525.0;
+    M    = DEG2RAD * (Modulus(358.47583 + Modulus(35999.04975 * T, 360.0) - (0.000150 + 0.0000033 * T) * T * T, 360.0));
+    L    = DEG2RAD * (Modulus(279.69668 + Modulus(36000.76892 * T, 360.0) + 0.0003025 * T * T, 360.0));
+    e    = 0.01675104 - (0.0000418 + 0.000000126 * T) * T;
+    C    = DEG2RAD * ((1.919460 - (0.004789 + 0.000014 * T) * T) * sin(M) + (0.020094 - 0.000100 * T) * sin(2 * M) +
+                      0.000293 * sin(3 * M));
+    O    = DEG2RAD * (Modulus(259.18 - 1934.142 * T, 360.0));
+    Lsa  = Modulus(L + C - DEG2RAD * (0.00569 - 0.00479 * sin(O)), TWOPI);
+    nu   = Modulus(M + C, TWOPI);
+    R    = 1.0000002 * (1.0 - e * e) / (1.0 + e * cos(nu));
+    eps  = DEG2RAD * (23.452294 - (0.0130125 + (0.00000164 - 0.000000503 * T) * T) * T + 0.00256 * cos(O));
+    R    = AU * R;
+
+    observer.sun[0]      = R * cos(Lsa);
+    observer.sun[1]      = R * sin(Lsa) * cos(eps);
+    observer.sun[2]      = R * sin(Lsa) * sin(eps);
+    observer.sunDistance = R;
+
+    // Elevation of the sun seen from the observer, which is good enough for twilight
+    const double up[3] = { observer.cosLat * observer.cosTheta, observer.cosLat * observer.sinTheta, observer.sinLat };
+    double sunUp = 0, sunRange = 0;
+    for (int i = 0; i < 3; i++)
+    {
+        const double d = observer.sun[i] - observer.position[i];
+        sunUp += d * up[i];
+        sunRange += d * d;
+    }
+    observer.dark = sunUp / sqrt(sunRange) <= sin(-12.0 * DEG2RAD);
+
+    return observer;
+}
+
 int Satellite::updatePos()
 {
     KStarsData *data = KStarsData::Instance();
-    return sgp4((data->clock()->utc().djd() - m_tle_jd) * MINPD);
+    return updatePos(observer(data->clock()->utc().djd()));
 }
 
-int Satellite::sgp4(double tsince)
+int Satellite::updatePos(const Observer &observer)
 {
-    KStarsData *data = KStarsData::Instance();
+    double position[3], velocity;
+    int rc = sgp4((observer.jd - m_tle_jd) * MINPD, position, velocity);
+    if (rc == 0)
+        setPosition(observer, position, velocity, false);
+    return rc;
+}
 
+int Satellite::sgp4(double tsince, double position[3], double &velocity)
+{
     int ktr;
     double am, axnl, aynl, betal, cosim, cnod, cos2u, coseo1 = 0, cosi, cosip, cosisq, cossu, cosu, delm, delomg, em,
                                                       ecose, el2, eo1, ep, esine, argpm, argpp, argpdf, pl,
                                                       mrt = 0.0, mvt, rdotl, rl, rvdot, rvdotl, sinim, dndt, sin2u, sineo1 = 0, sini, sinip, sinsu, sinu, snod, su, t2,
                                                                                                                     t3, t4, tem5, temp, temp1, temp2, tempa, tempe, templ, u, ux, uy, uz, vx, vy, vz, inclm, mm, nm, nodem, xinc,
-                                                                                                                    xincp, xl, xlm, mp, xmdf, xmx, xmy, nodedf, xnode, nodep, tc, sat_posx, sat_posy, sat_posz, sat_posw, sat_velx,
-                                                                                                                    sat_vely, sat_velz, sinlat, obs_posx, obs_posy, obs_posz, obs_posw, /*obs_velx, obs_vely, obs_velz,*/
-                                                                                                                    coslat, thetageo, sintheta, costheta, c, sq, achcp, vkmpersec;
+                                                                                                                    xincp, xl, xlm, mp, xmdf, xmx, xmy, nodedf, xnode, nodep, tc, sat_velx, sat_vely, sat_velz, vkmpersec;
     //    double emsq;
 
     const double temp4 = 1.5e-12;
 
-    double jul_utc = data->clock()->utc().djd();
-
     vkmpersec = RADIUSEARTHKM * XKE / 60.0;
 
     // Update for secular gravity and atmospheric drag
@@ -1111,22 +1173,13 @@ int Satellite::sgp4(double tsince)
     vz    = sini * cossu;
 
     // Position and velocity (in km and km/sec)
-    sat_posx   = (mrt * ux) * RADIUSEARTHKM;
-    sat_posy   = (mrt * uy) * RADIUSEARTHKM;
-    sat_posz   = (mrt * uz) * RADIUSEARTHKM;
-    sat_posw   = sqrt(sat_posx * sat_posx + sat_posy * sat_posy + sat_posz * sat_posz);
-    sat_velx   = (mvt * ux + rvdot * vx) * vkmpersec;
-    sat_vely   = (mvt * uy + rvdot * vy) * vkmpersec;
-    sat_velz   = (mvt * uz + rvdot * vz) * vkmpersec;
-    m_velocity = sqrt(sat_velx * sat_velx + sat_vely * sat_vely + sat_velz * sat_velz);
-
-    //     printf("tsince=%.15f\n", tsince);
-    //     printf("sat_posx=%.15f\n", sat_posx);
-    //     printf("sat_posy=%.15f\n", sat_posy);
-    //     printf("sat_posz=%.15f\n", sat_posz);
-    //     printf("sat_velx=%.15f\n", sat_velx);
-    //     printf("sat_vely=%.15f\n", sat_vely);
-    //     printf("sat_velz=%.15f\n", sat_velz);
+    position[0] = (mrt * ux) * RADIUSEARTHKM;
+    position[1] = (mrt * uy) * RADIUSEARTHKM;
+    position[2] = (mrt * uz) * RADIUSEARTHKM;
+    sat_velx    = (mvt * ux + rvdot * vx) * vkmpersec;
+    sat_vely    = (mvt * uy + rvdot * vy) * vkmpersec;
+    sat_velz    = (mvt * uz + rvdot * vz) * vkmpersec;
+    velocity    = sqrt(sat_velx * sat_velx + sat_vely * sat_vely + sat_velz * sat_velz);
 
     if (mrt < 1.0)
     {
@@ -1134,98 +1187,86 @@ int Satellite::sgp4(double tsince)
         return (6);
     }
 
-    // Observer ECI position and velocity
-    sinlat   = sin(data->geo()->lat()->radians());
-    coslat   = cos(data->geo()->lat()->radians());
-    thetageo = data->geo()->LMST(jul_utc);
-    sintheta = sin(thetageo);
-    costheta = cos(thetageo);
-    c        = 1.0 / sqrt(1.0 + F * (F - 2.0) * sinlat * sinlat);
-    sq       = (1.0 - F) * (1.0 - F) * c;
-    achcp    = (RADIUSEARTHKM * c + MEANALT) * coslat;
-    obs_posx = achcp * costheta;
-    obs_posy = achcp * sintheta;
-    obs_posz = (RADIUSEARTHKM * sq + MEANALT) * sinlat;
-    obs_posw = sqrt(obs_posx * obs_posx + obs_posy * sat_posy + obs_posz * obs_posz);
-    /*obs_velx = -MFACTOR * obs_posy;
-    obs_vely = MFACTOR * obs_posx;
-    obs_velz = 0.;*/
-
-    m_altitude = sat_posw - obs_posw + MEANALT;
+    return (0);
+}
+
+void Satellite::setPosition(const Observer &observer, const double position[3], double velocity, bool aboveHorizonOnly)
+{
+    const double sat_posw = sqrt(position[0] * position[0] + position[1] * position[1] + position[2] * position[2]);
+
+    m_velocity = velocity;
+    m_altitude = sat_posw - observer.distance + MEANALT;
 
     // Az and Dec
-    double range_posx = sat_posx - obs_posx;
-    double range_posy = sat_posy - obs_posy;
-    double range_posz = sat_posz - obs_posz;
-    m_range           = sqrt(range_posx * range_posx + range_posy * range_posy + range_posz * range_posz);
-    //     double range_velx = sat_velx - obs_velx;
-    //     double range_vely = sat_velx - obs_vely;
-    //     double range_velz = sat_velx - obs_velz;
+    double azimuth, elevation;
+    horizontal(observer, position, azimuth, elevation, m_range);
+    setAz(azimuth / DEG2RAD);
+    setAlt(elevation / DEG2RAD);
+
+    // RA and Dec are cheap, and the find dialog, centring and objectNearest() read them wherever the satellite is
+    HorizontalToEquatorial(&observer.lst, &observer.lat);
+
+    // Below the horizon, a satellite can't be seen, so skip the eclipse test
+    if (aboveHorizonOnly && alt().Degrees() <= SkyPoint::altCrit)
+    {
+        m_is_eclipsed = false;
+        m_is_visible  = false;
+        return;
+    }
 
+    // is the satellite visible ?
+    m_is_eclipsed = isEclipsed(observer, position);
+    m_is_visible  = !m_is_eclipsed && observer.dark && elevation >= 0.0;
+}
+
+void Satellite::horizontal(const Observer &observer, const double position[3], double &azimuth, double &elevation,
+                           double &range)
+{
+    double range_posx = position[0] - observer.position[0];
+    double range_posy = position[1] - observer.position[1];
+    double range_posz = position[2] - observer.position[2];
+    range             = sqrt(range_posx * range_posx + range_posy * range_posy + range_posz * range_posz);
+
+    const double sinlat = observer.sinLat, coslat = observer.cosLat;
+    const double sintheta = observer.sinTheta, costheta = observer.cosTheta;
     double top_s = sinlat * costheta * range_posx + sinlat * sintheta * range_posy - coslat * range_posz;
     double top_e = -sintheta * range_posx + costheta * range_posy;
     double top_z = coslat * costheta * range_posx + coslat * sintheta * range_posy + sinlat * range_posz;
 
-    double azimuth = atan(-top_e / top_s);
+    azimuth = atan(-top_e / top_s);
     if (top_s > 0.)
         azimuth += M_PI;
     if (azimuth < 0.)
         azimuth += TWOPI;
-    double elevation = arcSin(top_z / m_range);
-
-    //     printf("azimuth=%.15f\n\r", azimuth / DEG2RAD);
-    //     printf("elevation=%.15f\n\r", elevation / DEG2RAD);
-
-    setAz(azimuth / DEG2RAD);
-    setAlt(elevation / DEG2RAD);
-    HorizontalToEquatorial(data->lst(), data->geo()->lat());
-
-    // is the satellite visible ?
-    // Find ECI coordinates of the sun
-    double mjd, year, T, M, L, e, C, O, Lsa, nu, R, eps;
-
-    mjd  = jul_utc - 2415020.0;
-    year = 1900.0 + mjd / 365.25;
-    T    = (mjd + deltaET(year) / (MINPD * 60.0)) / 36525.0;
-    M    = DEG2RAD * (Modulus(358.47583 + Modulus(35999.04975 * T, 360.0) - (0.000150 + 0.0000033 * T) * T * T, 360.0));
-    L    = DEG2RAD * (Modulus(279.69668 + Modulus(36000.76892 * T, 360.0) + 0.0003025 * T * T, 360.0));
-    e    = 0.01675104 - (0.0000418 + 0.000000126 * T) * T;
-    C    = DEG2RAD * ((1.919460 - (0.004789 + 0.000014 * T) * T) * sin(M) + (0.020094 - 0.000100 * T) * sin(2 * M) +
-                      0.000293 * sin(3 * M));
-    O    = DEG2RAD * (Modulus(259.18 - 1934.142 * T, 360.0));
-    Lsa  = Modulus(L + C - DEG2RAD * (0.00569 - 0.00479 * sin(O)), TWOPI);
-    nu   = Modulus(M + C, TWOPI);
-    R    = 1.0000002 * (1.0 - e * e) / (1.0 + e * cos(nu));
-    eps  = DEG2RAD * (23.452294 - (0.0130125 + (0.00000164 - 0.000000503 * T) * T) * T + 0.00256 * cos(O));
-    R    = AU * R;
+    elevation = arcSin(top_z / range);
+}
 
-    double sun_posx = R * cos(Lsa);
-    double sun_posy = R * sin(Lsa) * cos(eps);
-    double sun_posz = R * sin(Lsa) * sin(eps);
-    double sun_posw = R;
+bool Satellite::isEclipsed(const Observer &observer, const double position[3])
+{
+    const double sat_posx = position[0];
+    const double sat_posy = position[1];
+    const double sat_posz = position[2];
+    const double sat_posw = sqrt(sat_posx * sat_posx + sat_posy * sat_posy + sat_posz * sat_posz);
 
     // Calculates satellite's eclipse status and depth
     double sd_sun, sd_earth, delta, depth;
 
     // Determine partial eclipse
     sd_earth       = arcSin(RADIUSEARTHKM / sat_posw);
-    double rho_x   = sun_posx - sat_posx;
-    double rho_y   = sun_posy - sat_posy;
-    double rho_z   = sun_posz - sat_posz;
+    double rho_x   = observer.sun[0] - sat_posx;
+    double rho_y   = observer.sun[1] - sat_posy;
+    double rho_z   = observer.sun[2] - sat_posz;
     double rho_w   = sqrt(rho_x * rho_x + rho_y * rho_y + rho_z * rho_z);
     sd_sun         = arcSin(SR / rho_w);
     double earth_x = -1.0 * sat_posx;
     double earth_y = -1.0 * sat_posy;
     double earth_z = -1.0 * sat_posz;
     double earth_w = sat_posw;
-    delta      = PIO2 - arcSin((sun_posx * earth_x + sun_posy * earth_y + sun_posz * earth_z) / (sun_posw * earth_w));
-    depth      = sd_earth - sd_sun - delta;
-    KSSun *sun = dynamic_cast<KSSun *>(data->skyComposite()->findByName(i18n("Sun")));
+    delta = PIO2 - arcSin((observer.sun[0] * earth_x + observer.sun[1] * earth_y + observer.sun[2] * earth_z) /
+                          (observer.sunDistance * earth_w));
+    depth = sd_earth - sd_sun - delta;
 
-    m_is_eclipsed = sd_earth >= sd_sun && depth >= 0;
-    m_is_visible  = !m_is_eclipsed && sun->alt().Degrees() <= -12.0 && elevation >= 0.0;
-
-    return (0);
+    return sd_earth >= sd_sun && depth >= 0;
 }
 
 QString Satellite::sgp4ErrorString(int code)
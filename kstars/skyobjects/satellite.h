@@ -6,10 +6,12 @@
 
 #pragma once
 
+#include "cachingdms.h"
 #include "skyobject.h"
 
 #include <QString>
 
+class GeoLocation;
 class KSPopupMenu;
 
 /**
@@ -34,9 +36,47 @@ class Satellite : public SkyObject
         /** @short Destructor */
         virtual ~Satellite() override = default;
 
-        /** @short Update satellite position */
+        /**
+         * @struct Satellite::Observer
+         * The position of the observer and of the Sun in the ECI frame at a given time, which are the
+         * same for all the satellites updated together.
+         */
+        struct Observer
+        {
+            /// Julian date (UTC)
+            double jd { 0 };
+            /// Sine and cosine of the geodetic latitude
+            double sinLat { 0 }, cosLat { 1 };
+            /// Sine and cosine of the local mean sidereal time
+            double sinTheta { 0 }, cosTheta { 1 };
+            /// Observer position (km) and distance to the center of the Earth
+            double position[3] { 0, 0, 0 };
+            double distance { 0 };
+            /// Sun position (km) and distance to the center of the Earth
+            double sun[3] { 0, 0, 0 };
+            double sunDistance { 0 };
+            /// True if the Sun is at least 12° under horizon
+            bool dark { false };
+            /// Local mean sidereal time and latitude of the observer
+            CachingDms lst, lat;
+        };
+
+        /** @return the observer at the geographic location of KStarsData, at jd */
+        static Observer observer(double jd);
+
+        /** @return the observer at geo, at jd */
+        static Observer observer(double jd, GeoLocation *geo);
+
+        /** @short Update satellite position at the time of the simulation clock */
         int updatePos();
 
+        /**
+         * @short Update satellite position
+         * @param observer the observer and the time to compute the position for
+         * @return 0 on success, otherwise an error code for sgp4ErrorString()
+         */
+        int updatePos(const Observer &observer);
+
         /**
          * @return True if the satellite is visible (above horizon, in the sunlight and sun at least 12° under horizon)
          */
@@ -73,14 +113,44 @@ class Satellite : public SkyObject
         void initPopupMenu(KSPopupMenu *pmenu) override;
 
     private:
+        friend class SatellitePassPredictor;
+        friend class SatellitePropagator;
+
         /** @short Compute non time dependent parameters */
         void init();
 
-        /** @short Compute satellite position */
-        int sgp4(double tsince);
+        /**
+         * @short Compute satellite position
+         * @param tsince minutes since the TLE epoch
+         * @param position set to the ECI position in km
+         * @param velocity set to the velocity in km/s
+         * @return 0 on success, otherwise an error code for sgp4ErrorString()
+         */
+        int sgp4(double tsince, double position[3], double &velocity);
+
+        /**
+         * @short Set the horizontal and equatorial coordinates, altitude, range and visibility
+         * @param position ECI position in km
+         * @param velocity in km/s
+         * @param aboveHorizonOnly don't test whether a satellite below the horizon is eclipsed
+         */
+        void setPosition(const Observer &observer, const double position[3], double velocity, bool aboveHorizonOnly);
+
+        /**
+         * @short Find where a satellite is seen from observer
+         * @param position ECI position in km
+         * @param azimuth set to the azimuth in radians
+         * @param elevation set to the elevation in radians
+         * @param range set to the distance from the observer in km
+         */
+        static void horizontal(const Observer &observer, const double position[3], double &azimuth, double &elevation,
+                               double &range);
+
+        /** @return true if a satellite at the ECI position is in the shadow of the Earth */
+        static bool isEclipsed(const Observer &observer, const double position[3]);
 
         /** @return Arcsine of the argument */
-        double arcSin(double arg);
+        static double arcSin(double arg);
 
         /**
          * Provides the difference between UT (approximately the same as UTC)
@@ -88,10 +158,10 @@ class Satellite : public SkyObject
          * This function is based on a least squares fit of data from 1950
          * to 1991 and will need to be updated periodically.
          */
-        double deltaET(double year);
+        static double deltaET(double year);
 
         /** @return arg1 mod arg2 */
-        double Modulus(double arg1, double arg2);
+        static double Modulus(double arg1, double arg2);
 
         // TLE
         /// Satellite Number
@@ -8,7 +8,9 @@
 
 #include "ksutils.h"
 #include "kspaths.h"
-#include "skyobjects/satellite.h"
+#include "kstarsdata.h"
+#include "Options.h"
+#include "kstars_debug.h"
 
 #include <QTextStream>
 
@@ -27,9 +29,11 @@ void SatelliteGroup::readTLE()
     QFile file;
     QString line1, line2;
 
-    // Delete all satellites
+    // Delete all satellites. The new ones may be allocated where the old ones were, so the propagator
+    // must forget them too.
     qDeleteAll(*this);
     clear();
+    m_propagator.setSatellites({});
 
     // Read TLE file
     if (KSUtils::openDataFile(file, m_tle_file))
@@ -51,18 +55,33 @@ void SatelliteGroup::readTLE()
 
 void SatelliteGroup::updateSatellitesPos()
 {
-    QMutableListIterator<Satellite *> sats(*this);
+    KStarsData *data = KStarsData::Instance();
+    updateSatellitesPos(Satellite::observer(data->clock()->utc().djd()), Options::showGround());
+}
 
-    while (sats.hasNext())
+void SatelliteGroup::updateSatellitesPos(const Satellite::Observer &observer, bool aboveHorizonOnly)
+{
+    QVector<Satellite *> selected;
+    for (Satellite *sat : *this)
     {
-        Satellite *sat = sats.next();
-
         if (sat->selected())
+            selected.append(sat);
+    }
+
+    // The constants of the satellites are only copied again when the selection changes
+    if (selected != m_propagator.satellites())
+        m_propagator.setSatellites(selected);
+
+    m_propagator.updatePositions(observer, aboveHorizonOnly);
+
+    // If position cannot be calculated, remove it from list
+    for (int i = 0; i < selected.size(); i++)
+    {
+        const int rc = m_propagator.error(i);
+        if (rc != 0)
         {
-            int rc = sat->updatePos();
-            // If position cannot be calculated, remove it from list
-            if (rc != 0)
-                sats.remove();
+            qCDebug(KSTARS) << selected[i]->name() << selected[i]->sgp4ErrorString(rc);
+            removeOne(selected[i]);
         }
     }
 }
@@ -6,11 +6,11 @@
 
 #pragma once
 
+#include "satellitepropagator.h"
+
 #include <QString>
 #include <QUrl>
 
-class Satellite;
-
 /**
  * @class SatelliteGroup
  * Represents a group of artificial satellites.
@@ -37,6 +37,13 @@ class SatelliteGroup : public QList<Satellite *>
          */
         void updateSatellitesPos();
 
+        /**
+         * Compute the position of the selected satellites of the group as seen from observer. The
+         * satellites whose position cannot be computed are removed from the group.
+         * @param aboveHorizonOnly don't test whether the satellites below the horizon are eclipsed
+         */
+        void updateSatellitesPos(const Satellite::Observer &observer, bool aboveHorizonOnly);
+
         /**
          * @return TLE filename
          */
@@ -59,4 +66,6 @@ class SatelliteGroup : public QList<Satellite *>
         QString m_tle_file;
         /// URL used to update TLE file
         QUrl m_tle_url;
+        /// Propagates the selected satellites
+        SatellitePropagator m_propagator;
 };
@@ -0,0 +1,296 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "satellitepasspredictor.h"
+
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+constexpr double RADIUSEARTHKM = 6378.135;
+constexpr double XKE           = 0.07436691613317;
+constexpr double MINPD         = 1440;
+constexpr double DEG2RAD       = M_PI / 180.0;
+// Rotation of the Earth in radians per minute
+constexpr double EARTH_RATE = 2.0 * M_PI / 1436.07;
+// How far under the minimum elevation a maximum between two samples is refined, in radians
+constexpr double NEAR_MISS = 2.0 * DEG2RAD;
+// Margin on the geocentric angle at which a satellite rises, for the flattening and the elevation of the observer
+constexpr double HORIZON_MARGIN = 2.0 * DEG2RAD;
+constexpr double GOLDEN = 0.6180339887498949;
+
+// Where a satellite is at a given time
+struct Look
+{
+    double position[3] { 0, 0, 0 };
+    double azimuth { 0 };
+    double elevation { 0 };
+    bool valid { false };
+};
+}
+
+SatellitePassPredictor::SatellitePassPredictor(const QVector<Satellite *> &satellites, const GeoLocation *geo)
+    : m_Geo(*geo->lng(), *geo->lat())
+{
+    m_Satellites.reserve(satellites.size());
+    for (const Satellite *sat : satellites)
+        m_Satellites.emplace_back(sat->clone());
+}
+
+SatellitePassPredictor::~SatellitePassPredictor() = default;
+
+QVector<SatellitePass> SatellitePassPredictor::predict(double startJD, double days)
+{
+    // The observer moves with the Earth, the same for all satellites
+    const int steps = static_cast<int>(std::floor(days / STEP + 1e-6));
+    std::vector<Satellite::Observer> observers;
+    observers.reserve(steps + 1);
+    for (int k = 0; k <= steps; k++)
+        observers.push_back(Satellite::observer(startJD + k * STEP, &m_Geo));
+
+    QVector<QVector<SatellitePass>> results(static_cast<int>(m_Satellites.size()));
+    QVector<int> indexes;
+    for (int i = 0; i < results.size(); i++)
+        indexes.append(i);
+
+    QtConcurrent::blockingMap(indexes, [&](int i)
+    {
+        results[i] = predict(*m_Satellites[i], observers, startJD);
+    });
+
+    QVector<SatellitePass> passes;
+    for (const auto &result : results)
+        passes.append(result);
+    std::sort(passes.begin(), passes.end(), [](const SatellitePass & a, const SatellitePass & b)
+    {
+        return a.aos < b.aos;
+    });
+    return passes;
+}
+
+QVector<SatellitePass> SatellitePassPredictor::predict(Satellite &satellite,
+        const std::vector<Satellite::Observer> &observers, double startJD)
+{
+    QVector<SatellitePass> passes;
+    const double minElevation = m_MinElevation * DEG2RAD;
+
+    const auto look = [&](double jd, const Satellite::Observer & observer)
+    {
+        Look result;
+        double velocity, range;
+        if (satellite.sgp4((jd - satellite.m_tle_jd) * MINPD, result.position, velocity) != 0)
+            return result;
+        Satellite::horizontal(observer, result.position, result.azimuth, result.elevation, range);
+        result.valid = true;
+        return result;
+    };
+    const auto lookAt = [&](double jd)
+    {
+        return look(jd, Satellite::observer(jd, &m_Geo));
+    };
+
+    // The satellite rises or sets between a and b
+    const auto crossing = [&](double a, double b, bool rising)
+    {
+        while (b - a > PRECISION)
+        {
+            const double middle = 0.5 * (a + b);
+            const Look l = lookAt(middle);
+            if (l.valid && (l.elevation >= minElevation) == rising)
+                b = middle;
+            else
+                a = middle;
+        }
+        return 0.5 * (a + b);
+    };
+
+    // The highest point between a and b, a tenth of the precision as the elevation turns sharply at the zenith
+    const auto highest = [&](double a, double b)
+    {
+        double c = b - GOLDEN * (b - a), d = a + GOLDEN * (b - a);
+        Look lc = lookAt(c), ld = lookAt(d);
+        while (b - a > 0.1 * PRECISION)
+        {
+            if (lc.elevation > ld.elevation)
+            {
+                b = d;
+                d = c;
+                ld = lc;
+                c = b - GOLDEN * (b - a);
+                lc = lookAt(c);
+            }
+            else
+            {
+                a = c;
+                c = d;
+                lc = ld;
+                d = a + GOLDEN * (b - a);
+                ld = lookAt(d);
+            }
+        }
+        return lc.elevation > ld.elevation ? c : d;
+    };
+
+    // Orbits of several hours are sampled less often
+    const double n = satellite.m_mean_motion;
+    const double e = satellite.m_eccentricity;
+    const int stride = std::max(1, std::min(10, static_cast<int>(2.0 * M_PI / n / 90.0)));
+
+    // How fast the angle between the satellite and the observer can close, in radians per minute, and at
+    // which angle the satellite may rise at its farthest from the Earth
+    const double rate = 1.25 * (n * (1 + e) * (1 + e) / std::pow(1 - e * e, 1.5) + EARTH_RATE);
+    const double apogee = 1.05 * std::pow(XKE / n, 2.0 / 3.0) * (1 + e) * RADIUSEARTHKM;
+    const double horizon = std::acos(std::min(1.0, RADIUSEARTHKM * std::cos(minElevation) / apogee)) - minElevation +
+                           HORIZON_MARGIN;
+
+    SatellitePass pass;
+    bool inPass = false;
+    int lit = 0, samples = 0;
+    double bestJD = 0, bestElevation = -M_PI, aosElevation = -M_PI;
+
+    const auto addSample = [&](const Satellite::Observer & observer, const Look & l)
+    {
+        samples++;
+        if (!Satellite::isEclipsed(observer, l.position))
+        {
+            lit++;
+            if (observer.dark)
+                pass.visible = true;
+        }
+    };
+
+    const auto begin = [&](double aos)
+    {
+        pass = SatellitePass();
+        pass.name = satellite.name();
+        pass.aos = aos;
+        const Satellite::Observer observer = Satellite::observer(aos, &m_Geo);
+        const Look l = look(aos, observer);
+        pass.aosAzimuth = l.azimuth / DEG2RAD;
+        aosElevation = l.elevation;
+        addSample(observer, l);
+        inPass = true;
+        bestElevation = -M_PI;
+    };
+
+    const auto end = [&](double los, double tcaFrom, double tcaTo)
+    {
+        pass.los = los;
+        Satellite::Observer observer = Satellite::observer(los, &m_Geo);
+        Look l = look(los, observer);
+        pass.losAzimuth = l.azimuth / DEG2RAD;
+        addSample(observer, l);
+        const double losElevation = l.elevation;
+
+        // Highest at the start or the end of the search when under way there
+        pass.tca = highest(std::max(pass.aos, tcaFrom), std::min(los, tcaTo));
+        observer = Satellite::observer(pass.tca, &m_Geo);
+        l = look(pass.tca, observer);
+        if (aosElevation > l.elevation || losElevation > l.elevation)
+        {
+            pass.tca = aosElevation > losElevation ? pass.aos : los;
+            observer = Satellite::observer(pass.tca, &m_Geo);
+            l = look(pass.tca, observer);
+        }
+        pass.tcaAzimuth = l.azimuth / DEG2RAD;
+        pass.maxElevation = l.elevation / DEG2RAD;
+        addSample(observer, l);
+
+        pass.illuminated = static_cast<double>(lit) / samples;
+        passes.append(pass);
+        inPass = false;
+        lit = samples = 0;
+    };
+
+    // The last two samples, for the crossings and the maxima between samples
+    double previousJD = 0, previousElevation = 0, beforeJD = 0, beforeElevation = 0;
+    int previous = 0;
+
+    // Step by stride, the last step landing on the end of the search
+    const int count = static_cast<int>(observers.size());
+    for (int k = 0; k < count; k = (k < count - 1 && k + stride >= count) ? count - 1 : k + stride)
+    {
+        const double jd = startJD + k * STEP;
+        const Satellite::Observer &observer = observers[k];
+        const Look l = look(jd, observer);
+        if (!l.valid)
+            break;
+
+        if (previous == 0 && l.elevation >= minElevation)
+        {
+            // Under way at the start
+            begin(jd);
+        }
+        else if (previous > 0 && !inPass && l.elevation >= minElevation)
+        {
+            begin(crossing(previousJD, jd, true));
+        }
+        else if (inPass && l.elevation < minElevation)
+        {
+            const double los = crossing(previousJD, jd, false);
+            end(los, bestJD - stride * STEP, bestJD + stride * STEP);
+        }
+        else if (!inPass && previous > 1 && previousElevation > beforeElevation && previousElevation >= l.elevation &&
+                 previousElevation > minElevation - NEAR_MISS)
+        {
+            // A maximum close to the minimum elevation, the pass may be between the samples
+            const double tca = highest(beforeJD, jd);
+            const Look top = lookAt(tca);
+            if (top.valid && top.elevation >= minElevation)
+            {
+                begin(crossing(beforeJD, tca, true));
+                end(crossing(tca, jd, false), tca, tca);
+            }
+        }
+
+        if (inPass)
+        {
+            addSample(observer, l);
+            if (l.elevation > bestElevation)
+            {
+                bestElevation = l.elevation;
+                bestJD = jd;
+            }
+        }
+        else if (l.elevation < minElevation - NEAR_MISS)
+        {
+            // Far enough under the horizon, skip the steps during which the satellite can't rise
+            double dot = 0, satellite2 = 0, observer2 = 0;
+            for (int i = 0; i < 3; i++)
+            {
+                dot += l.position[i] * observer.position[i];
+                satellite2 += l.position[i] * l.position[i];
+                observer2 += observer.position[i] * observer.position[i];
+            }
+            const double angle = std::acos(std::max(-1.0, std::min(1.0, dot / std::sqrt(satellite2 * observer2))));
+            const int skip = static_cast<int>((angle - horizon) / (rate * STEP * MINPD));
+            if (skip > stride)
+            {
+                // The next sample looks back to this one only, no maximum can be between them
+                k += skip - stride;
+                previousJD = jd;
+                previousElevation = l.elevation;
+                previous = 1;
+                continue;
+            }
+        }
+
+        beforeJD = previousJD;
+        beforeElevation = previousElevation;
+        previousJD = jd;
+        previousElevation = l.elevation;
+        previous++;
+    }
+
+    // Under way at the end
+    if (inPass)
+        end(previousJD, bestJD - stride * STEP, bestJD + stride * STEP);
+
+    return passes;
+}
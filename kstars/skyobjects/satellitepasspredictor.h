@@ -0,0 +1,99 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "geolocation.h"
+#include "satellite.h"
+
+#include <QString>
+#include <QVector>
+
+#include <memory>
+#include <vector>
+
+/**
+ * @struct SatellitePass
+ * A pass of a satellite over the horizon. Times are Julian dates (UTC), angles are in degrees.
+ */
+struct SatellitePass
+{
+    /// Name of the satellite
+    QString name;
+    /// Acquisition of signal, when the satellite rises over the minimum elevation
+    double aos { 0 };
+    /// Time of closest approach, when the satellite is highest
+    double tca { 0 };
+    /// Loss of signal, when the satellite sets under the minimum elevation
+    double los { 0 };
+    double aosAzimuth { 0 };
+    double tcaAzimuth { 0 };
+    double losAzimuth { 0 };
+    /// Elevation at the time of closest approach
+    double maxElevation { 0 };
+    /// Fraction of the pass the satellite spends in the sunlight
+    double illuminated { 0 };
+    /// True if the satellite is in the sunlight while the Sun is at least 12° under the horizon
+    bool visible { false };
+};
+
+/**
+ * @class SatellitePassPredictor
+ * Finds the passes of satellites over the horizon of an observer.
+ *
+ * The elevation of each satellite is sampled once a minute, once every few minutes for the higher
+ * orbits. While a satellite is well below the horizon, the angle between it and the observer seen
+ * from the center of the Earth, which can't close faster than the satellite and the Earth turn, tells
+ * how many samples can be skipped. The rise and set are then refined by bisection and the highest
+ * point by golden section search, to a second. Passes between two samples are found by refining the
+ * maxima of the elevation which come close to the minimum elevation.
+ *
+ * The satellites are copied when the predictor is made, so that it can run on another thread than
+ * the sky map, and are spread over all the cores.
+ *
+ * @short Prediction of the passes of satellites
+ */
+class SatellitePassPredictor
+{
+    public:
+        /**
+         * @param satellites the satellites to predict the passes of, which are copied
+         * @param geo the location of the observer, which is copied
+         */
+        SatellitePassPredictor(const QVector<Satellite *> &satellites, const GeoLocation *geo);
+        ~SatellitePassPredictor();
+
+        /** @short Set the elevation in degrees over which a satellite is considered in view, 0 by default */
+        void setMinElevation(double degrees)
+        {
+            m_MinElevation = degrees;
+        }
+
+        /**
+         * @short Find the passes of all the satellites
+         * @param startJD Julian date (UTC) to start from
+         * @param days number of days to search
+         * @return the passes of all the satellites, ordered by AOS. A pass under way at the start or at the
+         * end of the search has its AOS or LOS at that time.
+         */
+        QVector<SatellitePass> predict(double startJD, double days);
+
+        /** @short Longest search, in days, beyond which the elements of the TLEs are of little use */
+        static constexpr int MAX_DAYS { 30 };
+        /** @short Time step of the search for low orbits, in days */
+        static constexpr double STEP { 1.0 / 1440.0 };
+        /** @short Precision of AOS, TCA and LOS, in days */
+        static constexpr double PRECISION { 1.0 / 86400.0 };
+
+    private:
+        // The passes of one satellite, observers holding the observer at each step from startJD
+        QVector<SatellitePass> predict(Satellite &satellite, const std::vector<Satellite::Observer> &observers,
+                                       double startJD);
+
+        std::vector<std::unique_ptr<Satellite>> m_Satellites;
+        GeoLocation m_Geo;
+        double m_MinElevation { 0 };
+};
@@ -0,0 +1,269 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "satellitepropagator.h"
+
+#include <QThread>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+// The WGS-72 constants of Satellite
+constexpr double RADIUSEARTHKM = 6378.135;
+constexpr double XKE           = 0.07436691613317;
+constexpr double J2            = 0.001082616;
+constexpr double TWOPI         = 6.2831853071795864769;
+constexpr double X2O3          = .66666666666666666667;
+constexpr double MINPD         = 1440;
+
+// Satellites propagated by each task
+constexpr int CHUNK = 256;
+
+// Run fn(first, last) over [0, count) in chunks on all the cores
+template <typename Fn>
+void forChunks(int count, Fn fn)
+{
+    QVector<int> chunks;
+    for (int first = 0; first < count; first += CHUNK)
+        chunks.append(first);
+
+    QtConcurrent::blockingMap(chunks, [&](int first)
+    {
+        fn(first, std::min(first + CHUNK, count));
+    });
+}
+}
+
+void SatellitePropagator::setSatellites(const QVector<Satellite *> &satellites)
+{
+    m_Satellites = satellites;
+    m_DeepSpace.clear();
+    m_NearEarth = NearEarth();
+
+    NearEarth &n = m_NearEarth;
+    for (int i = 0; i < satellites.size(); i++)
+    {
+        const Satellite *sat = satellites[i];
+        if (sat->method == 'd')
+        {
+            m_DeepSpace.append(i);
+            continue;
+        }
+
+        // The terms Satellite::sgp4() skips for the simple drag model are left out by zeroing them
+        const double notSimple = sat->isimp ? 0.0 : 1.0;
+
+        n.index.push_back(i);
+        n.epoch.push_back(sat->m_tle_jd);
+        n.mo.push_back(sat->m_mean_anomaly);
+        n.mdot.push_back(sat->mdot);
+        n.argpo.push_back(sat->m_arg_perigee);
+        n.argpdot.push_back(sat->argpdot);
+        n.nodeo.push_back(sat->m_ra);
+        n.nodedot.push_back(sat->nodedot);
+        n.nodecf.push_back(sat->nodecf);
+        n.no.push_back(sat->m_mean_motion);
+        n.ao.push_back(std::pow(XKE / sat->m_mean_motion, X2O3));
+        n.ecco.push_back(sat->m_eccentricity);
+        n.inclo.push_back(sat->m_inclination);
+        n.sinio.push_back(std::sin(sat->m_inclination));
+        n.cosio.push_back(std::cos(sat->m_inclination));
+        n.cc1.push_back(sat->cc1);
+        n.bstarcc4.push_back(sat->m_bstar * sat->cc4);
+        n.bstarcc5.push_back(notSimple * sat->m_bstar * sat->cc5);
+        n.t2cof.push_back(sat->t2cof);
+        n.t3cof.push_back(notSimple * sat->t3cof);
+        n.t4cof.push_back(notSimple * sat->t4cof);
+        n.t5cof.push_back(notSimple * sat->t5cof);
+        n.omgcof.push_back(notSimple * sat->omgcof);
+        n.xmcof.push_back(notSimple * sat->xmcof);
+        n.eta.push_back(sat->eta);
+        n.delmo.push_back(sat->delmo);
+        n.sinmao.push_back(sat->sinmao);
+        n.d2.push_back(notSimple * sat->d2);
+        n.d3.push_back(notSimple * sat->d3);
+        n.d4.push_back(notSimple * sat->d4);
+        n.aycof.push_back(sat->aycof);
+        n.xlcof.push_back(sat->xlcof);
+        n.con41.push_back(sat->con41);
+        n.x1mth2.push_back(sat->x1mth2);
+        n.x7thm1.push_back(sat->x7thm1);
+    }
+
+    m_Position.assign(3 * satellites.size(), 0.0);
+    m_Velocity.assign(satellites.size(), 0.0);
+    m_Error.assign(satellites.size(), 0);
+}
+
+void SatellitePropagator::propagate(double jd)
+{
+    forChunks(static_cast<int>(m_NearEarth.index.size()), [this, jd](int first, int last)
+    {
+        propagateNearEarth(jd, first, last);
+    });
+
+    forChunks(m_DeepSpace.size(), [this, jd](int first, int last)
+    {
+        for (int d = first; d < last; d++)
+        {
+            const int i = m_DeepSpace[d];
+            Satellite *sat = m_Satellites[i];
+            m_Error[i] = sat->sgp4((jd - sat->m_tle_jd) * MINPD, &m_Position[3 * i], m_Velocity[i]);
+        }
+    });
+}
+
+void SatellitePropagator::propagateNearEarth(double jd, int first, int last)
+{
+    const NearEarth &n = m_NearEarth;
+    const double vkmpersec = RADIUSEARTHKM * XKE / 60.0;
+
+    for (int k = first; k < last; k++)
+    {
+        const double tsince = (jd - n.epoch[k]) * MINPD;
+        const int i = n.index[k];
+
+        // Update for secular gravity and atmospheric drag
+        const double xmdf   = n.mo[k] + n.mdot[k] * tsince;
+        const double argpdf = n.argpo[k] + n.argpdot[k] * tsince;
+        const double nodedf = n.nodeo[k] + n.nodedot[k] * tsince;
+        const double t2     = tsince * tsince;
+        const double t3     = t2 * tsince;
+        const double t4     = t3 * tsince;
+        const double delm0  = 1.0 + n.eta[k] * std::cos(xmdf);
+        const double temp0  = n.omgcof[k] * tsince + n.xmcof[k] * (delm0 * delm0 * delm0 - n.delmo[k]);
+        double mm           = xmdf + temp0;
+        double argpm        = argpdf - temp0;
+        double nodem        = nodedf + n.nodecf[k] * t2;
+        const double tempa  = 1.0 - n.cc1[k] * tsince - n.d2[k] * t2 - n.d3[k] * t3 - n.d4[k] * t4;
+        const double tempe  = n.bstarcc4[k] * tsince + n.bstarcc5[k] * (std::sin(mm) - n.sinmao[k]);
+        const double templ  = n.t2cof[k] * t2 + n.t3cof[k] * t3 + t4 * (n.t4cof[k] + tsince * n.t5cof[k]);
+
+        if (n.no[k] <= 0.0)
+        {
+            m_Error[i] = 2;
+            continue;
+        }
+
+        const double am = n.ao[k] * tempa * tempa;
+        const double nm = XKE / (am * std::sqrt(am));
+        double em       = n.ecco[k] - tempe;
+
+        if ((em >= 1.0) || (em < -0.001))
+        {
+            m_Error[i] = 1;
+            continue;
+        }
+
+        if (em < 1.0e-6)
+            em = 1.0e-6;
+
+        mm += n.no[k] * templ;
+        double xlm = mm + argpm + nodem;
+        nodem      = std::fmod(nodem, TWOPI);
+        argpm      = std::fmod(argpm, TWOPI);
+        xlm        = std::fmod(xlm, TWOPI);
+        mm         = std::fmod(xlm - argpm - nodem, TWOPI);
+
+        // Long period periodics
+        const double ep   = em;
+        const double axnl = ep * std::cos(argpm);
+        double temp       = 1.0 / (am * (1.0 - ep * ep));
+        const double aynl = ep * std::sin(argpm) + temp * n.aycof[k];
+        const double xl   = mm + argpm + nodem + temp * n.xlcof[k] * axnl;
+
+        // Solve kepler's equation
+        const double u = std::fmod(xl - nodem, TWOPI);
+        double eo1 = u, sineo1 = 0, coseo1 = 0, tem5 = 9999.9;
+        for (int ktr = 1; std::abs(tem5) >= 1.0e-12 && ktr <= 10; ktr++)
+        {
+            sineo1 = std::sin(eo1);
+            coseo1 = std::cos(eo1);
+            tem5   = 1.0 - coseo1 * axnl - sineo1 * aynl;
+            tem5   = (u - aynl * coseo1 + axnl * sineo1 - eo1) / tem5;
+            if (std::abs(tem5) >= 0.95)
+                tem5 = tem5 > 0.0 ? 0.95 : -0.95;
+            eo1 = eo1 + tem5;
+        }
+
+        // Short period preliminary quantities
+        const double ecose = axnl * coseo1 + aynl * sineo1;
+        const double esine = axnl * sineo1 - aynl * coseo1;
+        const double el2   = axnl * axnl + aynl * aynl;
+        const double pl    = am * (1.0 - el2);
+
+        if (pl < 0.0)
+        {
+            m_Error[i] = 4;
+            continue;
+        }
+
+        const double rl     = am * (1.0 - ecose);
+        const double rdotl  = std::sqrt(am) * esine / rl;
+        const double rvdotl = std::sqrt(pl) / rl;
+        const double betal  = std::sqrt(1.0 - el2);
+        temp                = esine / (1.0 + betal);
+        const double sinu   = am / rl * (sineo1 - aynl - axnl * temp);
+        const double cosu   = am / rl * (coseo1 - axnl + aynl * temp);
+        double su           = std::atan2(sinu, cosu);
+        const double sin2u  = (cosu + cosu) * sinu;
+        const double cos2u  = 1.0 - 2.0 * sinu * sinu;
+        temp                = 1.0 / pl;
+        const double temp1  = 0.5 * J2 * temp;
+        const double temp2  = temp1 * temp;
+
+        // Update for short period periodics
+        const double sinip = n.sinio[k], cosip = n.cosio[k];
+        const double mrt   = rl * (1.0 - 1.5 * temp2 * betal * n.con41[k]) + 0.5 * temp1 * n.x1mth2[k] * cos2u;
+        su                 = su - 0.25 * temp2 * n.x7thm1[k] * sin2u;
+        const double xnode = nodem + 1.5 * temp2 * cosip * sin2u;
+        const double xinc  = n.inclo[k] + 1.5 * temp2 * cosip * sinip * cos2u;
+        const double mvt   = rdotl - nm * temp1 * n.x1mth2[k] * sin2u / XKE;
+        const double rvdot = rvdotl + nm * temp1 * (n.x1mth2[k] * cos2u + 1.5 * n.con41[k]) / XKE;
+
+        // Orientation vectors
+        const double sinsu = std::sin(su), cossu = std::cos(su);
+        const double snod = std::sin(xnode), cnod = std::cos(xnode);
+        const double sini = std::sin(xinc), cosi = std::cos(xinc);
+        const double xmx = -snod * cosi;
+        const double xmy = cnod * cosi;
+        const double ux  = xmx * sinsu + cnod * cossu;
+        const double uy  = xmy * sinsu + snod * cossu;
+        const double uz  = sini * sinsu;
+        const double vx  = xmx * cossu - cnod * sinsu;
+        const double vy  = xmy * cossu - snod * sinsu;
+        const double vz  = sini * cossu;
+
+        // Position and velocity (in km and km/sec)
+        m_Position[3 * i]     = (mrt * ux) * RADIUSEARTHKM;
+        m_Position[3 * i + 1] = (mrt * uy) * RADIUSEARTHKM;
+        m_Position[3 * i + 2] = (mrt * uz) * RADIUSEARTHKM;
+        const double velx     = (mvt * ux + rvdot * vx) * vkmpersec;
+        const double vely     = (mvt * uy + rvdot * vy) * vkmpersec;
+        const double velz     = (mvt * uz + rvdot * vz) * vkmpersec;
+        m_Velocity[i]         = std::sqrt(velx * velx + vely * vely + velz * velz);
+
+        // Decayed
+        m_Error[i] = mrt < 1.0 ? 6 : 0;
+    }
+}
+
+void SatellitePropagator::updatePositions(const Satellite::Observer &observer, bool aboveHorizonOnly)
+{
+    propagate(observer.jd);
+
+    forChunks(m_Satellites.size(), [&](int first, int last)
+    {
+        for (int i = first; i < last; i++)
+        {
+            if (m_Error[i] == 0)
+                m_Satellites[i]->setPosition(observer, position(i), m_Velocity[i], aboveHorizonOnly);
+        }
+    });
+}
@@ -0,0 +1,95 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "satellite.h"
+
+#include <QVector>
+
+#include <vector>
+
+/**
+ * @class SatellitePropagator
+ * SGP4 propagation of many satellites at once.
+ *
+ * The constants Satellite computes from the TLE of the near Earth satellites, those with a period
+ * under 225 minutes, are copied in arrays holding one value per satellite. They are all propagated
+ * by one loop with none of the deep space branches, the terms which don't apply to a satellite being
+ * zero. The deep space satellites, a small part of the usual sets, are propagated by Satellite itself
+ * as they carry the state of the resonance integration. Both are spread over all the cores.
+ *
+ * The horizontal and equatorial coordinates are then set as Satellite::updatePos() does. When asked
+ * to, the satellites below the horizon are not tested for eclipse, as they can't be seen anyway,
+ * which is most of the work of setting the coordinates of a satellite.
+ *
+ * @short Batched SGP4 propagation of satellites
+ */
+class SatellitePropagator
+{
+    public:
+        /** @short Set the satellites to propagate, copying their constants */
+        void setSatellites(const QVector<Satellite *> &satellites);
+
+        /** @return the satellites propagated */
+        const QVector<Satellite *> &satellites() const
+        {
+            return m_Satellites;
+        }
+
+        /**
+         * @short Propagate all the satellites to jd
+         * @param jd Julian date (UTC)
+         */
+        void propagate(double jd);
+
+        /**
+         * @short Propagate all the satellites and set their coordinates as seen from observer
+         * @param aboveHorizonOnly don't test whether the satellites below the horizon are eclipsed
+         */
+        void updatePositions(const Satellite::Observer &observer, bool aboveHorizonOnly);
+
+        /** @return the ECI position of satellite i in km, after propagate() */
+        const double *position(int i) const
+        {
+            return &m_Position[3 * i];
+        }
+
+        /** @return the velocity of satellite i in km/s, after propagate() */
+        double velocity(int i) const
+        {
+            return m_Velocity[i];
+        }
+
+        /** @return 0 if satellite i was propagated, otherwise an error code for Satellite::sgp4ErrorString() */
+        int error(int i) const
+        {
+            return m_Error[i];
+        }
+
+    private:
+        // Propagate the near Earth satellites from first to last
+        void propagateNearEarth(double jd, int first, int last);
+
+        QVector<Satellite *> m_Satellites;
+        // Indexes of the deep space satellites in m_Satellites
+        QVector<int> m_DeepSpace;
+
+        // The near Earth satellites, with their index in m_Satellites and the constants of Satellite::init()
+        struct NearEarth
+        {
+            std::vector<int> index;
+            std::vector<double> epoch, mo, mdot, argpo, argpdot, nodeo, nodedot, nodecf, no, ao, ecco, inclo, sinio,
+                cosio;
+            std::vector<double> cc1, bstarcc4, bstarcc5, t2cof, t3cof, t4cof, t5cof, omgcof, xmcof, eta, delmo, sinmao,
+                d2, d3, d4;
+            std::vector<double> aycof, xlcof, con41, x1mth2, x7thm1;
+        } m_NearEarth;
+
+        std::vector<double> m_Position;
+        std::vector<double> m_Velocity;
+        std::vector<int> m_Error;
+};
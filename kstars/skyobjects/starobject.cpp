@@ -18,6 +18,7 @@
 #include "stardata.h"
 
 #include <typeinfo>
+#include <vector>
 
 #ifdef PROFILE_UPDATECOORDS
 double StarObject::updateCoordsCpuTime = 0.;
@@ -255,7 +256,7 @@ void StarObject::initPopupMenu(KSPopupMenu *pmenu)
 #endif
 }
 
-void StarObject::updateCoords(const KSNumbers *num, bool, const CachingDms *, const CachingDms *, bool)
+void StarObject::updateCoords(const KSNumbers *num, bool, const CachingDms *, const CachingDms *, bool forceRecompute)
 {
     //Correct for proper motion of stars.  Determine RA and Dec offsets.
     //Proper motion is given im milliarcsec per year by the pmRA() and pmDec() functions.
@@ -276,7 +277,7 @@ void StarObject::updateCoords(const KSNumbers *num, bool, const CachingDms *, co
 
     setRA0(newRA);
     setDec0(newDec);
-    SkyPoint::updateCoords(num);
+    SkyPoint::updateCoords(num, true, nullptr, nullptr, forceRecompute);
     setRA0(saveRA);
     setDec0(saveDec);
 
@@ -546,6 +547,105 @@ void StarObject::JITupdate()
     updateID = data->updateID();
 }
 
+void StarObject::JITupdate(StarObject *stars, int count, const ApparentTransform &transform)
+{
+    static KStarsData *data = KStarsData::Instance();
+
+    // The bending of light is computed star by star
+    if (Options::useRelativistic())
+    {
+        for (int i = 0; i < count; i++)
+        {
+            if (stars[i].updateID != data->updateID())
+                stars[i].JITupdate();
+        }
+        return;
+    }
+
+    const KSNumbers *num = transform.num();
+    const double julianMillenia = num->julianMillenia();
+    const double scale = julianMillenia * (M_PI / (180.0 * 3600.0));
+
+    // Stars whose coordinates are recomputed, and their catalog positions with the proper motion applied
+    std::vector<StarObject *> recompute;
+    std::vector<double> x, y, z;
+    // Stars whose horizontal coordinates are recomputed, and their apparent positions
+    std::vector<StarObject *> horizontal;
+
+    for (int i = 0; i < count; i++)
+    {
+        StarObject &star = stars[i];
+        if (star.updateID == data->updateID())
+            continue;
+        horizontal.push_back(&star);
+
+        if (star.updateNumID != data->updateNumID())
+        {
+            star.updateNumID = data->updateNumID();
+            if (Options::alwaysRecomputeCoordinates() || std::abs(star.lastPrecessJD - num->getJD()) >= 0.00069444)
+            {
+                // As getIndexCoords(), using the sines and cosines cached in ra0() and dec0()
+                double sinRa, cosRa, sinDec, cosDec;
+                star.ra0().SinCos(sinRa, cosRa);
+                star.dec0().SinCos(sinDec, cosDec);
+                double vx = cosDec * cosRa, vy = cosDec * sinRa, vz = sinDec;
+                const double pmms = star.pmMagnitudeSquared();
+                if (!std::isnan(pmms) && pmms * julianMillenia * julianMillenia >= .01)
+                {
+                    const double netRA = star.pmRA() * scale, netDec = star.pmDec() * scale;
+                    vx += -netRA * sinRa - netDec * sinDec * cosRa;
+                    vy += netRA * cosRa - netDec * sinDec * sinRa;
+                    vz += netDec * cosDec;
+                }
+                recompute.push_back(&star);
+                x.push_back(vx);
+                y.push_back(vy);
+                z.push_back(vz);
+            }
+        }
+    }
+
+    const int recomputed = static_cast<int>(recompute.size());
+    std::vector<double> ax(recomputed), ay(recomputed), az(recomputed);
+    transform.toApparent(x.data(), y.data(), z.data(), recomputed, ax.data(), ay.data(), az.data());
+    for (int i = 0; i < recomputed; i++)
+    {
+        ApparentTransform::setEquatorial(*recompute[i], ax[i], ay[i], az[i]);
+        recompute[i]->lastPrecessJD = num->getJD();
+    }
+
+    // Horizontal coordinates of all the stars, from the apparent positions of the others
+    const int stale = static_cast<int>(horizontal.size());
+    std::vector<double> hx(stale), hy(stale), hz(stale);
+    for (int i = 0, j = 0; i < stale; i++)
+    {
+        // Both lists are in the order of the stars
+        if (j < recomputed && horizontal[i] == recompute[j])
+        {
+            hx[i] = ax[j];
+            hy[i] = ay[j];
+            hz[i] = az[j];
+            j++;
+            continue;
+        }
+        double sinRa, cosRa, sinDec, cosDec;
+        horizontal[i]->ra().SinCos(sinRa, cosRa);
+        horizontal[i]->dec().SinCos(sinDec, cosDec);
+        hx[i] = cosDec * cosRa;
+        hy[i] = cosDec * sinRa;
+        hz[i] = sinDec;
+    }
+
+    std::vector<double> alt(stale), azimuth(stale);
+    transform.toHorizontal(hx.data(), hy.data(), hz.data(), stale, alt.data(), azimuth.data());
+    for (int i = 0; i < stale; i++)
+    {
+        horizontal[i]->setAlt(alt[i]);
+        horizontal[i]->setAz(azimuth[i]);
+        horizontal[i]->updateID = data->updateID();
+    }
+}
+
 QString StarObject::sptype(void) const
 {
     return QString(QByteArray(SpType, 2));
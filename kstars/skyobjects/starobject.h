@@ -13,6 +13,7 @@
 
 #include <QString>
 
+class ApparentTransform;
 struct DeepStarData;
 class KSPopupMenu;
 struct StarData;
@@ -206,6 +207,14 @@ class StarObject : public SkyObject
         /** @short added for JIT updates from both StarComponent and ConstellationLines */
         void JITupdate();
 
+        /**
+         * @short Bring several stars up to date at once, as JITupdate() does for each of them
+         * @param stars to update
+         * @param count number of stars
+         * @param transform to the current time and horizon of KStarsData
+         */
+        static void JITupdate(StarObject *stars, int count, const ApparentTransform &transform);
+
         /** @short returns the magnitude of the proper motion correction in milliarcsec/year */
         inline double pmMagnitude() const
         {
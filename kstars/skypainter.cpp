@@ -27,6 +27,29 @@ void SkyPainter::setSizeMagLimit(float sizeMagLim)
     m_sizeMagLim = sizeMagLim;
 }
 
+void SkyPainter::drawPointSources(const double *ra, const double *dec, const double *alt, const double *az,
+                                  const float *mag, const char *sp, int count, bool *drawn)
+{
+    SkyPoint point;
+    for (int i = 0; i < count; i++)
+    {
+        if (ra && dec)
+        {
+            point.setRA(CachingDms(ra[i]));
+            point.setDec(CachingDms(dec[i]));
+        }
+        point.setAlt(alt[i]);
+        point.setAz(az[i]);
+        drawn[i] = drawPointSource(&point, mag[i], sp[i]);
+    }
+}
+
+bool SkyPainter::drawCatalogObject(const CatalogObject &obj, const QPointF &pos)
+{
+    Q_UNUSED(pos)
+    return drawCatalogObject(obj);
+}
+
 float SkyPainter::starWidth(float mag) const
 {
     //adjust maglimit for ZoomLevel
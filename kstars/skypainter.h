@@ -128,6 +128,31 @@ class SkyPainter
          */
         virtual bool drawPointSource(const SkyPoint *loc, float mag, char sp = 'A') = 0;
 
+        /**
+         * @short Start a layer of point sources. The sources drawn until endPointSourceLayer()
+         * may be held back and painted together, possibly on several threads, so nothing else
+         * should be drawn in between. The default paints them as they come.
+         */
+        virtual void beginPointSourceLayer() {}
+
+        /** @short Paint the point sources held back since beginPointSourceLayer() */
+        virtual void endPointSourceLayer() {}
+
+        /**
+         * @short Draw many point sources at once, e.g. the stars of a trixel.
+         *
+         * The coordinates are in degrees, as Projector::toScreenBatch() takes them. The default
+         * draws the sources one by one with drawPointSource().
+         * @param ra, dec current equatorial coordinates, which may be null in the horizontal mode
+         * @param alt, az horizontal coordinates
+         * @param mag magnitudes of the sources
+         * @param sp spectral classes of the sources
+         * @param count number of sources
+         * @param drawn filled with whether each source was drawn
+         */
+        virtual void drawPointSources(const double *ra, const double *dec, const double *alt, const double *az,
+                                      const float *mag, const char *sp, int count, bool *drawn);
+
         /**
         * @short Draw a deep sky object (loaded from the new implementation)
         * @param obj the object to draw
@@ -136,6 +161,15 @@ class SkyPainter
         */
         virtual bool drawCatalogObject(const CatalogObject &obj) = 0;
 
+        /**
+         * @short Draw a deep sky object whose screen position is already known, e.g. from
+         * Projector::toScreenBatch(). The default ignores the position and calls the above.
+         * @param obj the object to draw
+         * @param pos the on-screen position of the object
+         * @return true if it was drawn
+         */
+        virtual bool drawCatalogObject(const CatalogObject &obj, const QPointF &pos);
+
         /**
              * @short Draw a planet
              * @param planet the planet to draw
@@ -40,6 +40,13 @@
 #include <QElapsedTimer>
 #include "auxiliary/rectangleoverlap.h"
 
+#include <QThread>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 namespace
 {
 // Convert spectral class to numerical index.
@@ -85,6 +92,11 @@ const int nSPclasses = 7;
 //
 // These pixmaps are never deallocated. Not really good...
 QPixmap *imageCache[nSPclasses][nStarSizes] = { { nullptr } };
+// The same images for painting off the GUI thread, where pixmaps can't be used
+QImage threadImageCache[nSPclasses][nStarSizes];
+
+// Fewer stars than this are not worth the threads of a point source layer
+const int minThreadedPointSources = 2000;
 
 std::unique_ptr<QPixmap> visibleSatPixmap, invisibleSatPixmap;
 } // namespace
@@ -105,6 +117,7 @@ void SkyQPainter::releaseImageCache()
                 delete pmap[size];
 
             pmap[size] = nullptr;
+            threadImageCache[harvardToIndex(color)][size] = QImage();
         }
     }
 }
@@ -357,6 +370,7 @@ void SkyQPainter::initStarImages()
                 pmap[size] = new QPixmap();
             *pmap[size] = BigImage.scaled(size, size, Qt::KeepAspectRatio,
                                           Qt::SmoothTransformation);
+            threadImageCache[harvardToIndex(color)][size] = pmap[size]->toImage();
         }
     }
     starColorMode = Options::starColorMode();
@@ -733,39 +747,165 @@ bool SkyQPainter::drawPointSource(const SkyPoint * loc, float mag, char sp)
     }
 }
 
+void SkyQPainter::drawPointSources(const double *ra, const double *dec, const double *alt, const double *az,
+                                   const float *mag, const char *sp, int count, bool *drawn)
+{
+    if (count <= 0)
+        return;
+
+    // Project them all first, then paint the ones on screen
+    std::vector<Eigen::Vector2f> screen(count);
+    m_proj->toScreenBatch(ra, dec, alt, az, count, screen.data(), drawn);
+    for (int i = 0; i < count; i++)
+    {
+        drawn[i] = drawn[i] && m_proj->onScreen(screen[i]);
+        if (drawn[i])
+            drawPointSource(QPointF(screen[i].x(), screen[i].y()), starWidth(mag[i]), sp[i]);
+    }
+}
+
+void SkyQPainter::beginPointSourceLayer()
+{
+    // Only raster devices can be split into images, printers and SVG get the sources as they come
+    if (!Options::tiledSkyRendering() || !isActive())
+        return;
+    const int type = device()->devType();
+    if ((type != QInternal::Image && type != QInternal::Pixmap) || device()->devicePixelRatioF() != 1.0)
+        return;
+
+    m_inPointSourceLayer = true;
+    m_layerSources.clear();
+}
+
+void SkyQPainter::endPointSourceLayer()
+{
+    if (!m_inPointSourceLayer)
+        return;
+    m_inPointSourceLayer = false;
+
+    const int width  = device()->width();
+    const int height = device()->height();
+    const int bands  = std::max(1, std::min(QThread::idealThreadCount(), height / 64));
+    if (bands == 1 || m_layerSources.size() < minThreadedPointSources)
+    {
+        for (const auto &source : m_layerSources)
+            paintPointSource(*this, source.pos, source.size, source.sp, false);
+        m_layerSources.clear();
+        return;
+    }
+
+    // Each band of rows is painted by its own thread into its own image, with the sources that
+    // reach into it. Stars are blended over what is below them, so blending them over transparent
+    // bands first and then the bands over the sky gives the same result.
+    struct Band
+    {
+        int top;
+        int bottom;
+        QImage image;
+    };
+    QVector<Band> bandList(bands);
+    for (int i = 0; i < bands; i++)
+    {
+        bandList[i].top    = height * i / bands;
+        bandList[i].bottom = height * (i + 1) / bands;
+    }
+
+    const QTransform transform = combinedTransform();
+    const RenderHints hints    = renderHints();
+    // Device rows of the sources, and how far the largest star image reaches from them
+    QVector<double> rows(m_layerSources.size());
+    for (int i = 0; i < m_layerSources.size(); i++)
+        rows[i] = transform.map(m_layerSources[i].pos).y();
+    const double reach = 0.5 * (nStarSizes - 1) * std::sqrt(std::abs(transform.determinant())) + 2;
+
+    // Only read from the threads
+    const QVector<PointSource> &sources = m_layerSources;
+    const QVector<double> &sourceRows   = rows;
+    QtConcurrent::blockingMap(bandList, [&](Band & band)
+    {
+        QPainter painter;
+        for (int i = 0; i < sources.size(); i++)
+        {
+            if (sourceRows[i] + reach < band.top || sourceRows[i] - reach >= band.bottom)
+                continue;
+
+            if (!painter.isActive())
+            {
+                band.image = QImage(width, band.bottom - band.top, QImage::Format_ARGB32_Premultiplied);
+                band.image.fill(Qt::transparent);
+                painter.begin(&band.image);
+                painter.setRenderHints(hints);
+                painter.setTransform(transform * QTransform::fromTranslate(0, -band.top));
+            }
+            paintPointSource(painter, sources[i].pos, sources[i].size, sources[i].sp, true);
+        }
+        if (painter.isActive())
+            painter.end();
+    });
+
+    // Labels and everything else stay on this thread
+    save();
+    resetTransform();
+    for (const auto &band : bandList)
+    {
+        if (!band.image.isNull())
+            drawImage(0, band.top, band.image);
+    }
+    restore();
+
+    m_layerSources.clear();
+}
+
 void SkyQPainter::drawPointSource(const QPointF &pos, float size, char sp)
+{
+    if (m_inPointSourceLayer)
+        m_layerSources.append({ pos, size, sp });
+    else
+        paintPointSource(*this, pos, size, sp, false);
+}
+
+void SkyQPainter::paintPointSource(QPainter &painter, const QPointF &pos, float size, char sp, bool threaded) const
 {
     int isize = qMin(static_cast<int>(size), 14);
     if (!m_vectorStars || starColorMode == 0)
     {
         // Draw stars as bitmaps, either because we were asked to, or because we're painting real colors
-        QPixmap *im  = imageCache[harvardToIndex(sp)][isize];
-        float offset = 0.5 * im->width();
-        drawPixmap(QPointF(pos.x() - offset, pos.y() - offset), *im);
+        if (threaded)
+        {
+            const QImage &im = threadImageCache[harvardToIndex(sp)][isize];
+            float offset     = 0.5 * im.width();
+            painter.drawImage(QPointF(pos.x() - offset, pos.y() - offset), im);
+        }
+        else
+        {
+            QPixmap *im  = imageCache[harvardToIndex(sp)][isize];
+            float offset = 0.5 * im->width();
+            painter.drawPixmap(QPointF(pos.x() - offset, pos.y() - offset), *im);
+        }
     }
     else
     {
         // Draw stars as vectors, for better printing / SVG export etc.
         if (starColorMode != 4)
         {
-            setPen(m_starColor);
-            setBrush(m_starColor);
+            painter.setPen(m_starColor);
+            painter.setBrush(m_starColor);
         }
         else
         {
             // Note: This is not efficient, but we use vector stars only when plotting SVG, not when drawing the skymap, so speed is not very important.
             QColor c = ColorMap.value(sp, Qt::white);
-            setPen(c);
-            setBrush(c);
+            painter.setPen(c);
+            painter.setBrush(c);
         }
 
         // Be consistent with old raster representation
         if (size > 14)
             size = 14;
         if (size >= 2)
-            drawEllipse(pos.x() - 0.5 * size, pos.y() - 0.5 * size, int(size), int(size));
+            painter.drawEllipse(pos.x() - 0.5 * size, pos.y() - 0.5 * size, int(size), int(size));
         else if (size >= 1)
-            drawPoint(pos.x(), pos.y());
+            painter.drawPoint(pos.x(), pos.y());
     }
 }
 
@@ -971,6 +1111,11 @@ bool SkyQPainter::drawCatalogObject(const CatalogObject &obj)
     if (!visible || !m_proj->onScreen(pos))
         return false;
 
+    return drawCatalogObject(obj, pos);
+}
+
+bool SkyQPainter::drawCatalogObject(const CatalogObject &obj, const QPointF &pos)
+{
     // if size is 0.0 set it to 1.0, this are normally stars (type 0 and 1)
     // if we use size 0.0 the star wouldn't be drawn
     float majorAxis = obj.a();
@@ -12,6 +12,7 @@
 
 #include <QColor>
 #include <QMap>
+#include <QVector>
 
 class Projector;
 class QWidget;
@@ -88,7 +89,12 @@ class SkyQPainter : public SkyPainter, public QPainter
                              LineListLabel *label = nullptr) override;
         void drawSkyPolygon(LineList *list, bool forceClip = true) override;
         bool drawPointSource(const SkyPoint *loc, float mag, char sp = 'A') override;
+        void drawPointSources(const double *ra, const double *dec, const double *alt, const double *az,
+                              const float *mag, const char *sp, int count, bool *drawn) override;
+        void beginPointSourceLayer() override;
+        void endPointSourceLayer() override;
         bool drawCatalogObject(const CatalogObject &obj) override;
+        bool drawCatalogObject(const CatalogObject &obj, const QPointF &pos) override;
         void drawCatalogObjectImage(const QPointF &pos, const CatalogObject &obj,
                                     float positionAngle);
         bool drawPlanet(KSPlanetBase *planet) override;
@@ -115,10 +121,26 @@ class SkyQPainter : public SkyPainter, public QPainter
         void setSize(int width, int height);
 
     private:
+        /** A point source held back between beginPointSourceLayer() and endPointSourceLayer() */
+        struct PointSource
+        {
+            QPointF pos;
+            float size;
+            char sp;
+        };
+
+        /**
+         * @short Paint a point source with the given painter
+         * @param threaded true when not on the GUI thread, which may not use pixmaps
+         */
+        void paintPointSource(QPainter &painter, const QPointF &pos, float size, char sp, bool threaded) const;
+
         QColor skyColor() const;
         QPaintDevice *m_pd{ nullptr };
         const Projector *m_proj{ nullptr };
         bool m_vectorStars{ false };
+        bool m_inPointSourceLayer{ false };
+        QVector<PointSource> m_layerSources;
         HIPSRenderer *m_hipsRender{ nullptr };
         TerrainRenderer *m_terrainRender{ nullptr };
         QSize m_size;
@@ -6,6 +6,7 @@
 */
 
 #include "approachsolver.h"
+#include "skyobjects/ephemeriscache.h"
 #include <kstars_debug.h>
 
 ApproachSolver::ApproachSolver(QObject *parent) : QObject(parent)
@@ -26,6 +27,9 @@ void ApproachSolver::setGeoLocation(GeoLocation *geo)
 QMap<long double, dms> ApproachSolver::findClosestApproach(long double startJD,
         long double stopJD, std::function<void (long double, dms)> const &callback)
 {
+    // The positions are computed many times over, use the cached ephemerides
+    EphemerisCache::Scope ephemerides;
+
     QMap<long double, dms> Separations;
     QPair<long double, dms> extremum;
     dms Dist;
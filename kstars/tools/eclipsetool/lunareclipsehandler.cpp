@@ -5,6 +5,7 @@
 */
 
 #include "lunareclipsehandler.h"
+#include "skyobjects/ephemeriscache.h"
 #include "skymapcomposite.h"
 #include "solarsystemcomposite.h"
 #include "dms.h"
@@ -18,6 +19,9 @@ EclipseHandler::EclipseVector LunarEclipseHandler::computeEclipses(long double s
 {
     m_mode = CLOSEST_APPROACH;
 
+    // Finding the full moons scans the whole range, use the cached ephemerides
+    EphemerisCache::Scope ephemerides;
+
     const long double SEARCH_INTERVAL = 5.l; // Days
 
     QVector<EclipseEvent_s> eclipses;
@@ -0,0 +1,149 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "satellitepassesdialog.h"
+
+#include "kstarsdata.h"
+
+#include <KLocalizedString>
+
+#include <QCheckBox>
+#include <QDialogButtonBox>
+#include <QDoubleSpinBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTableWidget>
+#include <QVBoxLayout>
+#include <QtConcurrent>
+
+#include <memory>
+
+SatellitePassesDialog::SatellitePassesDialog(const QVector<Satellite *> &satellites, QWidget *parent)
+    : QDialog(parent)
+{
+    m_Satellites.reserve(satellites.size());
+    for (const Satellite *sat : satellites)
+        m_Satellites.emplace_back(sat->clone());
+
+    setWindowTitle(i18nc("@title:window", "Satellite Passes"));
+
+    m_Days = new QSpinBox(this);
+    m_Days->setRange(1, SatellitePassPredictor::MAX_DAYS);
+    m_Days->setValue(3);
+    m_Days->setSuffix(i18n(" days"));
+
+    m_MinElevation = new QDoubleSpinBox(this);
+    m_MinElevation->setRange(0, 80);
+    m_MinElevation->setDecimals(0);
+    m_MinElevation->setValue(10);
+    m_MinElevation->setSuffix(QString::fromUtf8("°"));
+
+    m_VisibleOnly = new QCheckBox(i18n("Visible only"), this);
+    m_VisibleOnly->setToolTip(i18n("Only list the passes during which the satellite is in the sunlight while the sky is dark"));
+
+    m_PredictButton = new QPushButton(i18n("Predict"), this);
+
+    QHBoxLayout *settingsLayout = new QHBoxLayout();
+    settingsLayout->addWidget(new QLabel(i18n("Next:"), this));
+    settingsLayout->addWidget(m_Days);
+    settingsLayout->addWidget(new QLabel(i18n("Minimum elevation:"), this));
+    settingsLayout->addWidget(m_MinElevation);
+    settingsLayout->addWidget(m_VisibleOnly);
+    settingsLayout->addStretch();
+    settingsLayout->addWidget(m_PredictButton);
+
+    m_Table = new QTableWidget(0, 8, this);
+    m_Table->setHorizontalHeaderLabels(QStringList() << i18n("Satellite") << i18n("Rise") << i18n("Highest")
+                                       << i18n("Set") << i18n("Max. Elevation") << i18n("Azimuth")
+                                       << i18n("Sunlit") << i18n("Visible"));
+    m_Table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_Table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_Table->verticalHeader()->hide();
+    m_Table->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+
+    m_Status = new QLabel(this);
+
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Close, this);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(settingsLayout);
+    layout->addWidget(m_Table);
+    layout->addWidget(m_Status);
+    layout->addWidget(buttons);
+    resize(900, 500);
+
+    connect(m_PredictButton, &QPushButton::clicked, this, &SatellitePassesDialog::slotPredict);
+    connect(m_VisibleOnly, &QCheckBox::toggled, this, &SatellitePassesDialog::slotShowPasses);
+    connect(&m_Watcher, &QFutureWatcher<QVector<SatellitePass>>::finished, this, [this]()
+    {
+        m_Passes = m_Watcher.result();
+        m_PredictButton->setEnabled(true);
+        slotShowPasses();
+    });
+
+    slotPredict();
+}
+
+void SatellitePassesDialog::slotPredict()
+{
+    if (m_Watcher.isRunning())
+        return;
+
+    KStarsData *data = KStarsData::Instance();
+
+    // The satellites are copied again here, for the thread predicting the passes
+    QVector<Satellite *> satellites;
+    satellites.reserve(static_cast<int>(m_Satellites.size()));
+    for (const auto &sat : m_Satellites)
+        satellites.append(sat.get());
+    auto predictor = std::make_shared<SatellitePassPredictor>(satellites, data->geo());
+    predictor->setMinElevation(m_MinElevation->value());
+    const double startJD = data->ut().djd();
+    const double days = m_Days->value();
+
+    m_PredictButton->setEnabled(false);
+    m_Status->setText(i18np("Predicting the passes of 1 satellite...", "Predicting the passes of %1 satellites...",
+                            static_cast<int>(m_Satellites.size())));
+
+    m_Watcher.setFuture(QtConcurrent::run([predictor, startJD, days]()
+    {
+        return predictor->predict(startJD, days);
+    }));
+}
+
+void SatellitePassesDialog::slotShowPasses()
+{
+    const GeoLocation *geo = KStarsData::Instance()->geo();
+    const auto localTime = [geo](double jd)
+    {
+        return geo->UTtoLT(KStarsDateTime(jd)).toString("yyyy-MM-dd hh:mm:ss");
+    };
+
+    m_Table->setRowCount(0);
+    for (const SatellitePass &pass : m_Passes)
+    {
+        if (m_VisibleOnly->isChecked() && !pass.visible)
+            continue;
+
+        const int row = m_Table->rowCount();
+        m_Table->insertRow(row);
+        m_Table->setItem(row, 0, new QTableWidgetItem(pass.name));
+        m_Table->setItem(row, 1, new QTableWidgetItem(localTime(pass.aos)));
+        m_Table->setItem(row, 2, new QTableWidgetItem(localTime(pass.tca)));
+        m_Table->setItem(row, 3, new QTableWidgetItem(localTime(pass.los)));
+        m_Table->setItem(row, 4, new QTableWidgetItem(QString("%1°").arg(pass.maxElevation, 0, 'f', 1)));
+        m_Table->setItem(row, 5, new QTableWidgetItem(QString("%1° → %2° → %3°").arg(pass.aosAzimuth, 0, 'f', 0)
+                         .arg(pass.tcaAzimuth, 0, 'f', 0).arg(pass.losAzimuth, 0, 'f', 0)));
+        m_Table->setItem(row, 6, new QTableWidgetItem(QString("%1%").arg(100 * pass.illuminated, 0, 'f', 0)));
+        m_Table->setItem(row, 7, new QTableWidgetItem(pass.visible ? i18n("Yes") : i18n("No")));
+    }
+
+    m_Status->setText(i18np("1 pass", "%1 passes", m_Table->rowCount()));
+}
@@ -0,0 +1,59 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers <kstars-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "skyobjects/satellitepasspredictor.h"
+
+#include <QDialog>
+#include <QFutureWatcher>
+#include <QVector>
+
+#include <memory>
+#include <vector>
+
+class QCheckBox;
+class QDoubleSpinBox;
+class QLabel;
+class QPushButton;
+class QSpinBox;
+class QTableWidget;
+
+/**
+ * @class SatellitePassesDialog
+ * Lists the passes of satellites over the current location for the next days, predicted on another
+ * thread by SatellitePassPredictor.
+ *
+ * @short Satellite pass prediction dialog
+ */
+class SatellitePassesDialog : public QDialog
+{
+        Q_OBJECT
+
+    public:
+        /**
+         * @param satellites the satellites to predict the passes of, which are copied since updating the TLEs
+         * replaces the satellites of the groups while the dialog is open
+         * @param parent parent widget
+         */
+        SatellitePassesDialog(const QVector<Satellite *> &satellites, QWidget *parent = nullptr);
+
+    private Q_SLOTS:
+        void slotPredict();
+        void slotShowPasses();
+
+    private:
+        std::vector<std::unique_ptr<Satellite>> m_Satellites;
+        QFutureWatcher<QVector<SatellitePass>> m_Watcher;
+        QVector<SatellitePass> m_Passes;
+
+        QSpinBox *m_Days { nullptr };
+        QDoubleSpinBox *m_MinElevation { nullptr };
+        QCheckBox *m_VisibleOnly { nullptr };
+        QPushButton *m_PredictButton { nullptr };
+        QLabel *m_Status { nullptr };
+        QTableWidget *m_Table { nullptr };
+};
@@ -6,6 +6,7 @@
 
 #include "skycalendar.h"
 
+#include "ephemeriscache.h"
 #include "geolocation.h"
 #include "ksplanetbase.h"
 #include "kstarsdata.h"
@@ -176,6 +177,9 @@ void SkyCalendar::drawEventLabel( float x1, float y1, float x2, float y2, QStrin
 
 void SkyCalendar::addPlanetEvents(int nPlanet)
 {
+    // Rise, set and transit times are found by iterating on the positions, use the cached ephemerides
+    EphemerisCache::Scope ephemerides;
+
     KSPlanetBase *ksp = KStarsData::Instance()->skyComposite()->planet(nPlanet);
     QColor pColor     = ksp->color();
     //QVector<QPointF> vRise, vSet, vTransit;